@@ -0,0 +1,214 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Benchmarks
+// 'log_header_encoder_benchmark.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <array>
+#include <chrono>
+#include <string>
+#include <format>
+#include <cstdint>
+#include <iostream>
+#include <unistd.h>
+#include <algorithm>
+#include <functional>
+#include <string_view>
+#include <sys/syscall.h>
+#include <source_location>
+#include "../src/logger/log_header_encoder.hh"
+#include "../src/utils/time_utilities.hh"
+
+namespace
+{
+
+//
+// Settings of a benchmark run.
+//
+struct benchmark_options
+{
+
+    std::uint64_t m_records_count = 1'000'000u;
+
+    std::uint32_t m_repetitions_count = 5u;
+
+};
+
+//
+// Fields of a record rendered by both header paths.
+//
+struct benchmark_record
+{
+
+    std::uint64_t m_timestamp_ns;
+
+    echo::log_level m_log_level;
+
+    std::source_location m_source_location;
+
+    const char* m_title;
+
+    const char* m_message;
+
+};
+
+//
+// Rendering of a record by the std::format call the encoder replaced.
+//
+auto
+format_reference_record(
+    const std::string& p_session_id,
+    const pid_t p_process_id,
+    const bool p_utc_enabled,
+    const std::uint64_t p_sequence_number,
+    const benchmark_record& p_record) -> std::string
+{
+    constexpr std::array<const char*, 4u> log_level_texts = {"Info", "Warning", "Error", "Critical"};
+
+    return std::format(
+        "[{}] ({}) PID={}, TID={}, Seq={}, ActivityID={}, File={}, Function={}, Line={}. <{}> [{}] {}\n",
+        echo::timestamp_to_string(p_record.m_timestamp_ns, p_utc_enabled),
+        p_session_id.c_str(),
+        p_process_id,
+        syscall(SYS_gettid),
+        p_sequence_number,
+        "123",
+        p_record.m_source_location.file_name(),
+        p_record.m_source_location.function_name(),
+        p_record.m_source_location.line(),
+        log_level_texts[static_cast<std::size_t>(p_record.m_log_level)],
+        p_record.m_title,
+        p_record.m_message);
+}
+
+//
+// Renders every record with the given header path and returns the time in nanoseconds of
+// the fastest repetition. The rendered sizes are summed so that no rendering is optimized out.
+//
+auto
+measure(
+    const benchmark_options& p_options,
+    const std::function<std::size_t(std::uint64_t)>& p_render,
+    std::uint64_t& p_rendered_bytes_count) -> std::uint64_t
+{
+    std::uint64_t best_duration_ns = UINT64_MAX;
+
+    for (std::uint32_t repetition = 0u; repetition < p_options.m_repetitions_count; ++repetition)
+    {
+        const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+        for (std::uint64_t record_index = 0u; record_index < p_options.m_records_count; ++record_index)
+        {
+            p_rendered_bytes_count += p_render(record_index);
+        }
+
+        best_duration_ns = std::min(
+            best_duration_ns,
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count()));
+    }
+
+    return best_duration_ns;
+}
+
+auto
+report(
+    const std::string_view p_path_name,
+    const benchmark_options& p_options,
+    const std::uint64_t p_duration_ns) -> void
+{
+    std::cout << "header=" << p_path_name
+        << " records=" << p_options.m_records_count
+        << " rate=" << p_options.m_records_count * 1'000'000'000u / std::max<std::uint64_t>(p_duration_ns, 1u) << "/s"
+        << " ns_per_record=" << static_cast<double>(p_duration_ns) / static_cast<double>(std::max<std::uint64_t>(p_options.m_records_count, 1u)) << "\n";
+}
+
+} // namespace.
+
+//
+// Compares the header encoder against the std::format call it replaced, rendering the same
+// records of varied levels, titles, call sites and timestamps into a reused buffer.
+// Usage: log_header_encoder_benchmark [records] [repetitions]
+//
+int main(int argc, char** argv)
+{
+    benchmark_options options;
+
+    try
+    {
+        if (argc > 1)
+        {
+            options.m_records_count = std::stoull(argv[1]);
+        }
+
+        if (argc > 2)
+        {
+            options.m_repetitions_count = std::max(1u, static_cast<std::uint32_t>(std::stoul(argv[2])));
+        }
+    }
+    catch (const std::exception& p_exception)
+    {
+        std::cerr << "Usage: " << argv[0] << " [records] [repetitions]\n";
+
+        return 1;
+    }
+
+    const std::string session_id = "7f3e2a10-5b4c-4d8e-9f01-23456789abcd";
+    const pid_t process_id = getpid();
+    constexpr bool utc_enabled = true;
+    const std::uint64_t base_timestamp_ns = echo::get_current_timestamp_ns();
+
+    const std::array<benchmark_record, 4u> records = {
+        benchmark_record{base_timestamp_ns, echo::log_level::info, std::source_location::current(), "Main", "Request served"},
+        benchmark_record{base_timestamp_ns, echo::log_level::warning, std::source_location::current(), "Cache", "Entry evicted before expiry"},
+        benchmark_record{base_timestamp_ns, echo::log_level::error, std::source_location::current(), "Storage", "Write failed, retrying"},
+        benchmark_record{base_timestamp_ns, echo::log_level::critical, std::source_location::current(), "A rather long title of a component", ""}};
+
+    const echo::log_header_encoder encoder {session_id, process_id, utc_enabled};
+    std::string output;
+    std::uint64_t rendered_bytes_count = 0u;
+
+    //
+    // Records a few microseconds apart, so that the rendered timestamps differ as they do under load.
+    //
+    const std::uint64_t format_duration_ns = measure(
+        options,
+        [&](const std::uint64_t p_record_index)
+        {
+            benchmark_record record = records[p_record_index % records.size()];
+            record.m_timestamp_ns += p_record_index * 3'001u;
+
+            output = format_reference_record(session_id, process_id, utc_enabled, p_record_index, record);
+
+            return output.size();
+        },
+        rendered_bytes_count);
+
+    const std::uint64_t encoder_duration_ns = measure(
+        options,
+        [&](const std::uint64_t p_record_index)
+        {
+            const benchmark_record& record = records[p_record_index % records.size()];
+
+            encoder.encode(
+                output,
+                record.m_timestamp_ns + p_record_index * 3'001u,
+                p_record_index,
+                record.m_log_level,
+                record.m_source_location,
+                record.m_title,
+                record.m_message);
+
+            return output.size();
+        },
+        rendered_bytes_count);
+
+    report("std_format", options, format_duration_ns);
+    report("encoder", options, encoder_duration_ns);
+
+    std::cout << "speedup=" << static_cast<double>(format_duration_ns) / static_cast<double>(std::max<std::uint64_t>(encoder_duration_ns, 1u))
+        << " rendered_bytes=" << rendered_bytes_count << "\n";
+
+    return 0;
+}
@@ -0,0 +1,200 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Benchmarks
+// 'policy_logging_engine_benchmark.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <chrono>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <unistd.h>
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <string_view>
+#include "../src/logger/logger.hh"
+#include "../src/logger/policy_logging_engine.hh"
+
+namespace
+{
+
+//
+// Settings of a benchmark run.
+//
+struct benchmark_options
+{
+
+    std::uint64_t m_records_count_per_thread = 200'000u;
+
+    std::uint32_t m_threads_count = 1u;
+
+    std::uint32_t m_repetitions_count = 3u;
+
+};
+
+//
+// Runs a log call from every thread and returns the wall time in nanoseconds of the fastest
+// repetition, including the flush that hands the records over to the filesystem.
+//
+auto
+measure(
+    const benchmark_options& p_options,
+    const std::function<void(std::uint32_t, std::uint64_t)>& p_log,
+    const std::function<void()>& p_flush) -> std::uint64_t
+{
+    std::uint64_t best_duration_ns = UINT64_MAX;
+
+    for (std::uint32_t repetition = 0u; repetition < p_options.m_repetitions_count; ++repetition)
+    {
+        std::vector<std::thread> threads;
+        const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+        for (std::uint32_t thread_index = 0u; thread_index < p_options.m_threads_count; ++thread_index)
+        {
+            threads.emplace_back([&p_options, &p_log, thread_index]()
+            {
+                for (std::uint64_t record_index = 0u; record_index < p_options.m_records_count_per_thread; ++record_index)
+                {
+                    p_log(thread_index, record_index);
+                }
+            });
+        }
+
+        for (std::thread& thread : threads)
+        {
+            thread.join();
+        }
+
+        p_flush();
+
+        best_duration_ns = std::min(
+            best_duration_ns,
+            static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count()));
+    }
+
+    return best_duration_ns;
+}
+
+auto
+report(
+    const std::string_view p_engine_name,
+    const bool p_async_mode_enabled,
+    const benchmark_options& p_options,
+    const std::uint64_t p_duration_ns) -> void
+{
+    const std::uint64_t records_count = p_options.m_records_count_per_thread * p_options.m_threads_count;
+
+    std::cout << "engine=" << p_engine_name
+        << " mode=" << (p_async_mode_enabled ? "async" : "sync")
+        << " threads=" << p_options.m_threads_count
+        << " records=" << records_count
+        << " rate=" << records_count * 1'000'000'000u / std::max<std::uint64_t>(p_duration_ns, 1u) << "/s"
+        << " ns_per_record=" << p_duration_ns / std::max<std::uint64_t>(records_count, 1u) << "\n";
+}
+
+auto
+create_configuration(
+    const std::filesystem::path& p_logs_directory_path,
+    const bool p_async_mode_enabled) -> echo::logger_configuration
+{
+    echo::logger_configuration configuration;
+    configuration.logs_directory_path = p_logs_directory_path;
+    configuration.async_mode_enabled = p_async_mode_enabled;
+    configuration.debug_mode_enabled = false;
+    configuration.include_source_location = true;
+
+    //
+    // Async runs measure the log path; records are not shed while the flusher catches up.
+    //
+    configuration.info_lane_size_mib = 1024u;
+
+    return configuration;
+}
+
+} // namespace.
+
+//
+// Compares the log path of the policy logging engine with the minimal policy against the
+// runtime engine of the logger with every feature on, in sync and async modes.
+// Usage: policy_logging_engine_benchmark [records_per_thread] [threads] [repetitions]
+//
+int main(int argc, char** argv)
+{
+    benchmark_options options;
+
+    try
+    {
+        if (argc > 1)
+        {
+            options.m_records_count_per_thread = std::stoull(argv[1]);
+        }
+
+        if (argc > 2)
+        {
+            options.m_threads_count = std::max(1u, static_cast<std::uint32_t>(std::stoul(argv[2])));
+        }
+
+        if (argc > 3)
+        {
+            options.m_repetitions_count = std::max(1u, static_cast<std::uint32_t>(std::stoul(argv[3])));
+        }
+    }
+    catch (const std::exception& p_exception)
+    {
+        std::cerr << "Usage: " << argv[0] << " [records_per_thread] [threads] [repetitions]\n";
+
+        return 1;
+    }
+
+    const std::filesystem::path logs_directory_path =
+        std::filesystem::temp_directory_path() / ("echo_policy_logging_engine_benchmark-" + std::to_string(getpid()));
+
+    for (const bool async_mode_enabled : {false, true})
+    {
+        echo::logger_configuration configuration = create_configuration(logs_directory_path, async_mode_enabled);
+
+        {
+            echo::policy_logging_engine<echo::minimal_engine_policy> engine {configuration};
+
+            const std::uint64_t duration_ns = measure(
+                options,
+                [&engine](const std::uint32_t p_thread_index, const std::uint64_t p_record_index)
+                {
+                    engine.log(echo::log_level::info, "Benchmark", "t={} n={} payload", p_thread_index, p_record_index);
+                },
+                [&engine]()
+                {
+                    engine.flush();
+                });
+
+            report("minimal_policy", async_mode_enabled, options, duration_ns);
+        }
+
+        echo::logger::initialize(&configuration);
+
+        const std::uint64_t duration_ns = measure(
+            options,
+            [](const std::uint32_t p_thread_index, const std::uint64_t p_record_index)
+            {
+                echo::logger::log(echo::log_level::info, "Benchmark", "t={} n={} payload", p_thread_index, p_record_index);
+            },
+            []()
+            {
+                echo::logger::flush();
+            });
+
+        echo::logger::shutdown();
+
+        report("runtime", async_mode_enabled, options, duration_ns);
+    }
+
+    std::error_code error_code;
+    std::filesystem::remove_all(logs_directory_path, error_code);
+
+    return 0;
+}
@@ -0,0 +1,289 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'call_site_profiler.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <format>
+#include <atomic>
+#include <fstream>
+#include <iterator>
+#include "call_site_profiler.hh"
+
+namespace echo
+{
+
+namespace
+{
+
+//
+// Gets the text of a level as rendered in the report.
+//
+auto
+get_report_log_level_text(
+    const log_level p_log_level) -> const char*
+{
+    switch (p_log_level)
+    {
+        case log_level::critical:
+            return "Critical";
+        case log_level::error:
+            return "Error";
+        case log_level::warning:
+            return "Warning";
+        default:
+            return "Info";
+    }
+}
+
+} // namespace.
+
+call_site_profiler::call_site_profiler(
+    const std::string& p_session_id,
+    const std::filesystem::path& p_logging_session_directory_path,
+    const std::uint32_t p_report_interval_ms,
+    const std::uint32_t p_report_call_sites_count)
+    : m_profiler_id{allocate_profiler_id()},
+      m_session_id{p_session_id},
+      m_logging_session_directory_path{p_logging_session_directory_path},
+      m_report_interval_ms{p_report_interval_ms},
+      m_report_call_sites_count{std::max(p_report_call_sites_count, 1u)},
+      m_calibration_tick{read_timestamp_counter()},
+      m_calibration_time{std::chrono::steady_clock::now()},
+      m_stop_requested{false}
+{
+    if (m_report_interval_ms != 0u)
+    {
+        m_reporter_thread = std::thread(&call_site_profiler::reporter_loop, this);
+    }
+}
+
+call_site_profiler::~call_site_profiler()
+{
+    {
+        std::scoped_lock<std::mutex> lock {m_stop_lock};
+        m_stop_requested = true;
+    }
+
+    m_stop_condition.notify_one();
+
+    if (m_reporter_thread.joinable())
+    {
+        m_reporter_thread.join();
+    }
+
+    write_report();
+}
+
+auto
+call_site_profiler::write_report() -> status_code
+{
+    std::scoped_lock<std::mutex> report_lock {m_report_lock};
+
+    //
+    // Merge the tables of every thread; the owners only wait for the copy of their own table.
+    //
+    std::vector<std::shared_ptr<thread_table>> thread_tables;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_thread_tables_lock};
+
+        thread_tables.reserve(m_thread_tables.size());
+
+        for (const auto& [thread_id, table] : m_thread_tables)
+        {
+            thread_tables.push_back(table);
+        }
+    }
+
+    std::unordered_map<call_site_key, call_site_counters, call_site_key_hash> merged_counters;
+
+    for (const std::shared_ptr<thread_table>& table : thread_tables)
+    {
+        std::scoped_lock<std::mutex> lock {table->m_lock};
+
+        for (const auto& [key, counters] : table->m_counters)
+        {
+            call_site_counters& merged = merged_counters[key];
+
+            merged.m_log_level = std::max(merged.m_log_level, counters.m_log_level);
+            merged.m_records_count += counters.m_records_count;
+            merged.m_size_bytes += counters.m_size_bytes;
+            merged.m_formatting_ticks += counters.m_formatting_ticks;
+        }
+    }
+
+    std::vector<std::pair<call_site_key, call_site_counters>> call_sites(merged_counters.begin(), merged_counters.end());
+    std::uint64_t total_records_count = 0u;
+    std::uint64_t total_size_bytes = 0u;
+    std::uint64_t total_formatting_ticks = 0u;
+
+    for (const auto& [key, counters] : call_sites)
+    {
+        total_records_count += counters.m_records_count;
+        total_size_bytes += counters.m_size_bytes;
+        total_formatting_ticks += counters.m_formatting_ticks;
+    }
+
+    const std::size_t reported_call_sites_count = std::min<std::size_t>(call_sites.size(), m_report_call_sites_count);
+
+    std::partial_sort(
+        call_sites.begin(),
+        call_sites.begin() + reported_call_sites_count,
+        call_sites.end(),
+        [](const auto& p_left, const auto& p_right)
+        {
+            return p_left.second.m_size_bytes > p_right.second.m_size_bytes;
+        });
+
+    //
+    // Counter frequency over the whole life of the profiler; reports are rare enough to afford it.
+    //
+    const std::uint64_t elapsed_ticks = read_timestamp_counter() - m_calibration_tick;
+    const std::chrono::nanoseconds elapsed_time = std::chrono::steady_clock::now() - m_calibration_time;
+    const double nanoseconds_per_tick = elapsed_ticks != 0u ?
+        static_cast<double>(elapsed_time.count()) / static_cast<double>(elapsed_ticks) :
+        1.0;
+
+    std::string output = std::format(
+        "Call site profile of session {}\n"
+        "Records: {}, bytes: {}, formatting time: {:.3f} ms, call sites: {}\n"
+        "Top {} call sites by bytes:\n\n"
+        "{:>4}  {:>12}  {:>16}  {:>7}  {:>9}  {:>10}  {:<8}  {}\n",
+        m_session_id,
+        total_records_count,
+        total_size_bytes,
+        static_cast<double>(total_formatting_ticks) * nanoseconds_per_tick / 1'000'000.0,
+        call_sites.size(),
+        reported_call_sites_count,
+        "Rank",
+        "Records",
+        "Bytes",
+        "Bytes%",
+        "Avg bytes",
+        "Format ns",
+        "Level",
+        "Call site");
+
+    for (std::size_t call_site_index = 0u; call_site_index < reported_call_sites_count; ++call_site_index)
+    {
+        const auto& [key, counters] = call_sites[call_site_index];
+
+        std::format_to(
+            std::back_inserter(output),
+            "{:>4}  {:>12}  {:>16}  {:>6.2f}%  {:>9}  {:>10.0f}  {:<8}  [{}] {}:{} {}\n",
+            call_site_index + 1u,
+            counters.m_records_count,
+            counters.m_size_bytes,
+            total_size_bytes != 0u ? 100.0 * static_cast<double>(counters.m_size_bytes) / static_cast<double>(total_size_bytes) : 0.0,
+            counters.m_size_bytes / counters.m_records_count,
+            static_cast<double>(counters.m_formatting_ticks) * nanoseconds_per_tick / static_cast<double>(counters.m_records_count),
+            get_report_log_level_text(counters.m_log_level),
+            key.m_title,
+            key.m_file_name,
+            key.m_line,
+            key.m_function_name);
+    }
+
+    //
+    // Can fail silently if the directory creation was not possible; the write reports it.
+    // Shared memory and shipping modes do not create it otherwise.
+    //
+    std::error_code error_code;
+
+    std::filesystem::create_directories(m_logging_session_directory_path, error_code);
+
+    //
+    // Replace the previous report in one step so that readers never see a partial one.
+    //
+    const std::filesystem::path report_file_path = get_report_file_path();
+    std::filesystem::path temporary_file_path = report_file_path;
+    temporary_file_path += ".tmp";
+
+    {
+        std::ofstream file;
+        file.open(temporary_file_path, std::ios_base::trunc | std::ios_base::binary);
+        file.write(output.data(), static_cast<std::streamsize>(output.size()));
+
+        if (!file)
+        {
+            return status::file_write_failed;
+        }
+    }
+
+    std::filesystem::rename(temporary_file_path, report_file_path, error_code);
+
+    return error_code ? status::file_write_failed : status::success;
+}
+
+auto
+call_site_profiler::get_thread_table() -> std::shared_ptr<thread_table>
+{
+    std::scoped_lock<std::mutex> lock {m_thread_tables_lock};
+
+    //
+    // A thread alternating between profilers finds its table again instead of starting over.
+    //
+    std::shared_ptr<thread_table>& table = m_thread_tables[std::this_thread::get_id()];
+
+    if (table == nullptr)
+    {
+        table = std::make_shared<thread_table>();
+    }
+
+    return table;
+}
+
+auto
+call_site_profiler::reporter_loop() -> void
+{
+    std::unique_lock<std::mutex> lock {m_stop_lock};
+
+    while (!m_stop_requested)
+    {
+        m_stop_condition.wait_for(
+            lock,
+            std::chrono::milliseconds(m_report_interval_ms),
+            [this]()
+            {
+                return m_stop_requested;
+            });
+
+        if (m_stop_requested)
+        {
+            //
+            // The destructor writes the last report.
+            //
+            break;
+        }
+
+        lock.unlock();
+
+        write_report();
+
+        lock.lock();
+    }
+}
+
+auto
+call_site_profiler::get_report_file_path() const -> std::filesystem::path
+{
+    const std::string report_file_name = std::format(
+        "call_sites_{}.{}",
+        m_session_id,
+        c_report_file_extension);
+
+    return m_logging_session_directory_path / report_file_name;
+}
+
+auto
+call_site_profiler::allocate_profiler_id() -> std::uint64_t
+{
+    static std::atomic<std::uint64_t> next_profiler_id {1u};
+
+    return next_profiler_id.fetch_add(1u, std::memory_order_relaxed);
+}
+
+} // namespace echo.
@@ -0,0 +1,281 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'call_site_profiler.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <chrono>
+#include <memory>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <filesystem>
+#include <unordered_map>
+#include <source_location>
+#include <condition_variable>
+#include "log_level.hh"
+#include "../status/status.hh"
+#include "../utils/time_utilities.hh"
+
+namespace echo
+{
+
+//
+// Profiler of the log volume of every call site: records, bytes and formatting time,
+// counted in per-thread tables so that producers only ever take their own uncontended
+// lock. Writes a report of the top call sites by bytes to the logging session directory,
+// 'call_sites_<session>.txt', on demand and, if an interval is set, periodically; every
+// report replaces the previous one and covers the whole session so far. The formatting
+// time of a record spans the formatting of its message, when measured by the caller, and
+// the rendering of its header.
+// Thread-safe class.
+//
+class call_site_profiler
+{
+
+public:
+
+    //
+    // Constructor. Starts the reporter thread if a report interval is set.
+    //
+    call_site_profiler(
+        const std::string& p_session_id,
+        const std::filesystem::path& p_logging_session_directory_path,
+        const std::uint32_t p_report_interval_ms,
+        const std::uint32_t p_report_call_sites_count);
+
+    //
+    // Destructor. Stops the reporter thread and writes a last report.
+    //
+    ~call_site_profiler();
+
+    call_site_profiler(const call_site_profiler&) = delete;
+
+    call_site_profiler&
+    operator=(const call_site_profiler&) = delete;
+
+    //
+    // Counts a record of a call site in the table of the calling thread.
+    // The formatting start tick is a timestamp counter reading taken before formatting began.
+    //
+    inline
+    auto
+    record(
+        const log_level p_log_level,
+        const std::source_location& p_source_location,
+        const char* p_title,
+        const std::uint64_t p_record_size_bytes,
+        const std::uint64_t p_formatting_start_tick) -> void
+    {
+        const std::uint64_t formatting_ticks = read_timestamp_counter() - p_formatting_start_tick;
+
+        thread_local thread_table_cache cache;
+
+        if (cache.m_profiler_id != m_profiler_id)
+        {
+            cache.m_profiler_id = m_profiler_id;
+            cache.m_thread_table = get_thread_table();
+        }
+
+        thread_table& table = *cache.m_thread_table;
+        std::scoped_lock<std::mutex> lock {table.m_lock};
+
+        call_site_counters& counters = table.m_counters[call_site_key{
+            p_source_location.file_name(),
+            p_source_location.function_name(),
+            p_title,
+            p_source_location.line()}];
+
+        counters.m_log_level = std::max(counters.m_log_level, p_log_level);
+        counters.m_records_count += 1u;
+        counters.m_size_bytes += p_record_size_bytes;
+        counters.m_formatting_ticks += formatting_ticks;
+    }
+
+    //
+    // Writes the report of the top call sites so far.
+    //
+    auto
+    write_report() -> status_code;
+
+private:
+
+    //
+    // Call site of a record: its source location and title.
+    //
+    struct call_site_key
+    {
+
+        const char* m_file_name;
+
+        const char* m_function_name;
+
+        const char* m_title;
+
+        std::uint32_t m_line;
+
+        auto
+        operator==(const call_site_key&) const -> bool = default;
+
+    };
+
+    struct call_site_key_hash
+    {
+
+        auto
+        operator()(
+            const call_site_key& p_call_site_key) const -> std::size_t
+        {
+            return std::hash<const void*>{}(p_call_site_key.m_file_name) ^
+                (std::hash<const void*>{}(p_call_site_key.m_function_name) << 1u) ^
+                (std::hash<const void*>{}(p_call_site_key.m_title) << 2u) ^
+                (static_cast<std::size_t>(p_call_site_key.m_line) << 32u);
+        }
+
+    };
+
+    //
+    // Counters of a call site. The level is the highest one seen.
+    //
+    struct call_site_counters
+    {
+
+        log_level m_log_level {log_level::info};
+
+        std::uint64_t m_records_count {0u};
+
+        std::uint64_t m_size_bytes {0u};
+
+        std::uint64_t m_formatting_ticks {0u};
+
+    };
+
+    //
+    // Counters of the call sites seen by a thread. Only the owner thread and the reporter take its lock.
+    //
+    struct thread_table
+    {
+
+        std::mutex m_lock;
+
+        std::unordered_map<call_site_key, call_site_counters, call_site_key_hash> m_counters;
+
+    };
+
+    //
+    // Table of the profiler last used by a thread.
+    //
+    struct thread_table_cache
+    {
+
+        std::uint64_t m_profiler_id {0u};
+
+        std::shared_ptr<thread_table> m_thread_table;
+
+    };
+
+    //
+    // Gets the table of the calling thread, creating it on its first record.
+    //
+    auto
+    get_thread_table() -> std::shared_ptr<thread_table>;
+
+    //
+    // Reporter loop run by the reporter thread.
+    //
+    auto
+    reporter_loop() -> void;
+
+    //
+    // Gets the path of the report file.
+    //
+    auto
+    get_report_file_path() const -> std::filesystem::path;
+
+    //
+    // Gets a unique identifier for a new profiler; never zero, never reused.
+    //
+    static
+    auto
+    allocate_profiler_id() -> std::uint64_t;
+
+    //
+    // Extension of the report file.
+    //
+    static constexpr const char* c_report_file_extension = "txt";
+
+    //
+    // Identifier of the profiler, tying the per-thread table caches to it.
+    //
+    const std::uint64_t m_profiler_id;
+
+    //
+    // Logging session identifier.
+    //
+    const std::string m_session_id;
+
+    //
+    // Path to the directory where the report is written.
+    //
+    const std::filesystem::path m_logging_session_directory_path;
+
+    //
+    // Interval in milliseconds between reports. Zero for on-demand reports only.
+    //
+    const std::uint32_t m_report_interval_ms;
+
+    //
+    // Count of call sites listed by a report.
+    //
+    const std::uint32_t m_report_call_sites_count;
+
+    //
+    // Timestamp counter and steady clock sampled together when the profiler started,
+    // for converting formatting ticks to nanoseconds.
+    //
+    const std::uint64_t m_calibration_tick;
+    const std::chrono::steady_clock::time_point m_calibration_time;
+
+    //
+    // Lock for the registry of per-thread tables.
+    //
+    std::mutex m_thread_tables_lock;
+
+    //
+    // Tables of every thread that logged through the profiler, by thread.
+    // Kept after their thread exits so that their counts are not lost.
+    //
+    std::unordered_map<std::thread::id, std::shared_ptr<thread_table>> m_thread_tables;
+
+    //
+    // Lock for serializing reports.
+    //
+    std::mutex m_report_lock;
+
+    //
+    // Lock and condition variable for waking up the reporter thread on stop.
+    //
+    std::mutex m_stop_lock;
+    std::condition_variable m_stop_condition;
+
+    //
+    // Flag for signaling the reporter thread to exit.
+    //
+    bool m_stop_requested;
+
+    //
+    // Reporter thread. Only started when a report interval is set.
+    //
+    std::thread m_reporter_thread;
+
+};
+
+} // namespace echo.
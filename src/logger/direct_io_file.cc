@@ -0,0 +1,291 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'direct_io_file.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <cerrno>
+#include <utility>
+#include <cstring>
+#include <fcntl.h>
+#include <unistd.h>
+#include <algorithm>
+#include <sys/stat.h>
+#include "direct_io_file.hh"
+
+namespace echo
+{
+
+direct_io_file::direct_io_file()
+    : m_file_descriptor{-1},
+      m_buffers{
+        {static_cast<char*>(std::aligned_alloc(c_alignment_bytes, c_buffer_size_bytes)), &std::free},
+        {static_cast<char*>(std::aligned_alloc(c_alignment_bytes, c_buffer_size_bytes)), &std::free}},
+      m_active_buffer{0u},
+      m_active_buffer_offset_bytes{0u},
+      m_active_buffer_size_bytes{0u},
+      m_pending_buffer{c_no_pending_buffer},
+      m_pending_buffer_offset_bytes{0u},
+      m_io_status{status::success},
+      m_stop_requested{false}
+{}
+
+direct_io_file::~direct_io_file()
+{
+    if (m_file_descriptor == -1)
+    {
+        return;
+    }
+
+    flush();
+
+    {
+        std::scoped_lock<std::mutex> lock {m_io_lock};
+
+        m_stop_requested = true;
+    }
+
+    m_io_condition.notify_all();
+    m_io_thread.join();
+
+    close(m_file_descriptor);
+}
+
+auto
+direct_io_file::open(
+    const std::filesystem::path& p_file_path) -> status_code
+{
+    if (m_buffers[0] == nullptr ||
+        m_buffers[1] == nullptr)
+    {
+        return status::file_write_failed;
+    }
+
+    int file_descriptor = ::open(p_file_path.c_str(), O_RDWR | O_CREAT | O_DIRECT | O_CLOEXEC, 0644);
+
+    if (file_descriptor == -1 &&
+        errno == EINVAL)
+    {
+        //
+        // The filesystem does not support O_DIRECT; the aligned writes still work through the page cache.
+        //
+        file_descriptor = ::open(p_file_path.c_str(), O_RDWR | O_CREAT | O_CLOEXEC, 0644);
+    }
+
+    if (file_descriptor == -1)
+    {
+        return status::file_write_failed;
+    }
+
+    struct stat file_status {};
+
+    if (fstat(file_descriptor, &file_status) == -1)
+    {
+        ::close(file_descriptor);
+
+        return status::file_write_failed;
+    }
+
+    //
+    // Resume from the last aligned offset, reloading the partial block that follows it.
+    //
+    const std::uint64_t size_bytes = static_cast<std::uint64_t>(file_status.st_size);
+    m_active_buffer_offset_bytes = size_bytes - size_bytes % c_alignment_bytes;
+    m_active_buffer_size_bytes = static_cast<std::size_t>(size_bytes - m_active_buffer_offset_bytes);
+
+    if (m_active_buffer_size_bytes != 0u &&
+        pread(file_descriptor, m_buffers[m_active_buffer].get(), c_alignment_bytes, static_cast<off_t>(m_active_buffer_offset_bytes)) !=
+            static_cast<ssize_t>(m_active_buffer_size_bytes))
+    {
+        ::close(file_descriptor);
+
+        return status::file_write_failed;
+    }
+
+    m_file_path = p_file_path;
+    m_file_descriptor = file_descriptor;
+    m_io_thread = std::thread(&direct_io_file::io_loop, this);
+
+    return status::success;
+}
+
+auto
+direct_io_file::append(
+    const char* p_data_buffer,
+    const std::size_t p_data_size) -> status_code
+{
+    std::size_t remaining_size_bytes = p_data_size;
+
+    while (remaining_size_bytes != 0u)
+    {
+        const std::size_t chunk_size_bytes = std::min(remaining_size_bytes, c_buffer_size_bytes - m_active_buffer_size_bytes);
+
+        std::memcpy(
+            m_buffers[m_active_buffer].get() + m_active_buffer_size_bytes,
+            p_data_buffer + (p_data_size - remaining_size_bytes),
+            chunk_size_bytes);
+
+        m_active_buffer_size_bytes += chunk_size_bytes;
+        remaining_size_bytes -= chunk_size_bytes;
+
+        if (m_active_buffer_size_bytes == c_buffer_size_bytes)
+        {
+            submit_active_buffer();
+        }
+    }
+
+    std::scoped_lock<std::mutex> lock {m_io_lock};
+
+    return std::exchange(m_io_status, status::success);
+}
+
+auto
+direct_io_file::flush() -> status_code
+{
+    std::unique_lock<std::mutex> lock {m_io_lock};
+
+    wait_for_pending_buffer(lock);
+
+    status_code status = std::exchange(m_io_status, status::success);
+
+    lock.unlock();
+
+    if (m_active_buffer_size_bytes == 0u)
+    {
+        return status;
+    }
+
+    //
+    // O_DIRECT only takes whole blocks; pad the tail and cut the padding off afterwards.
+    // The active buffer keeps its data, so later appends rewrite the same block in full.
+    //
+    const std::size_t padded_size_bytes =
+        (m_active_buffer_size_bytes + c_alignment_bytes - 1u) / c_alignment_bytes * c_alignment_bytes;
+
+    std::memset(
+        m_buffers[m_active_buffer].get() + m_active_buffer_size_bytes,
+        0,
+        padded_size_bytes - m_active_buffer_size_bytes);
+
+    if (status::failed(write_block(m_buffers[m_active_buffer].get(), padded_size_bytes, m_active_buffer_offset_bytes)) ||
+        ftruncate(m_file_descriptor, static_cast<off_t>(get_size_bytes())) == -1)
+    {
+        status = status::file_write_failed;
+    }
+
+    return status;
+}
+
+auto
+direct_io_file::get_size_bytes() const -> std::uint64_t
+{
+    return m_active_buffer_offset_bytes + m_active_buffer_size_bytes;
+}
+
+auto
+direct_io_file::get_path() const -> const std::filesystem::path&
+{
+    return m_file_path;
+}
+
+auto
+direct_io_file::write_block(
+    const char* p_data_buffer,
+    const std::size_t p_data_size,
+    const std::uint64_t p_offset_bytes) const -> status_code
+{
+    std::size_t written_size_bytes = 0u;
+
+    while (written_size_bytes < p_data_size)
+    {
+        const ssize_t result = pwrite(
+            m_file_descriptor,
+            p_data_buffer + written_size_bytes,
+            p_data_size - written_size_bytes,
+            static_cast<off_t>(p_offset_bytes + written_size_bytes));
+
+        if (result == -1 &&
+            errno == EINTR)
+        {
+            continue;
+        }
+
+        if (result <= 0)
+        {
+            return status::file_write_failed;
+        }
+
+        written_size_bytes += static_cast<std::size_t>(result);
+    }
+
+    return status::success;
+}
+
+auto
+direct_io_file::submit_active_buffer() -> void
+{
+    {
+        std::unique_lock<std::mutex> lock {m_io_lock};
+
+        wait_for_pending_buffer(lock);
+
+        m_pending_buffer = m_active_buffer;
+        m_pending_buffer_offset_bytes = m_active_buffer_offset_bytes;
+    }
+
+    m_io_condition.notify_all();
+
+    m_active_buffer ^= 1u;
+    m_active_buffer_offset_bytes += c_buffer_size_bytes;
+    m_active_buffer_size_bytes = 0u;
+}
+
+auto
+direct_io_file::wait_for_pending_buffer(
+    std::unique_lock<std::mutex>& p_lock) -> void
+{
+    m_io_condition.wait(p_lock, [this]()
+    {
+        return m_pending_buffer == c_no_pending_buffer;
+    });
+}
+
+auto
+direct_io_file::io_loop() -> void
+{
+    std::unique_lock<std::mutex> lock {m_io_lock};
+
+    while (true)
+    {
+        m_io_condition.wait(lock, [this]()
+        {
+            return m_stop_requested || m_pending_buffer != c_no_pending_buffer;
+        });
+
+        if (m_pending_buffer == c_no_pending_buffer)
+        {
+            return;
+        }
+
+        const std::uint32_t pending_buffer = m_pending_buffer;
+        const std::uint64_t pending_buffer_offset_bytes = m_pending_buffer_offset_bytes;
+
+        lock.unlock();
+
+        const status_code status = write_block(m_buffers[pending_buffer].get(), c_buffer_size_bytes, pending_buffer_offset_bytes);
+
+        lock.lock();
+
+        if (status::failed(status))
+        {
+            m_io_status = status;
+        }
+
+        m_pending_buffer = c_no_pending_buffer;
+        m_io_condition.notify_all();
+    }
+}
+
+} // namespace echo.
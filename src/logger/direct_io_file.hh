@@ -0,0 +1,195 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'direct_io_file.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <cstdint>
+#include <cstdlib>
+#include <filesystem>
+#include <condition_variable>
+#include "../status/status.hh"
+
+namespace echo
+{
+
+//
+// Append-only file written through O_DIRECT, bypassing the page cache.
+// Data is staged in two page-aligned buffers: while a full buffer is written out by the
+// I/O thread of the file, appends keep filling the other one. The final partial block is
+// written out zero-padded to the alignment on flush and the file is then truncated back
+// to its true length. Readers may briefly observe the padding between both steps.
+// Falls back to regular writes on filesystems that do not support O_DIRECT.
+// Appends and flushes must be serialized by the caller.
+//
+class direct_io_file
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    direct_io_file();
+
+    //
+    // Destructor. Flushes the buffered data and closes the file.
+    //
+    ~direct_io_file();
+
+    direct_io_file(const direct_io_file&) = delete;
+
+    direct_io_file&
+    operator=(const direct_io_file&) = delete;
+
+    //
+    // Opens or creates the file, positioned at its end.
+    //
+    auto
+    open(
+        const std::filesystem::path& p_file_path) -> status_code;
+
+    //
+    // Appends data to the file. Only blocks if both buffers are full.
+    //
+    auto
+    append(
+        const char* p_data_buffer,
+        const std::size_t p_data_size) -> status_code;
+
+    //
+    // Writes out every buffered byte, padding the final partial block, and truncates
+    // the file to its true length.
+    //
+    auto
+    flush() -> status_code;
+
+    //
+    // Gets the true length of the file in bytes, including the buffered data.
+    //
+    auto
+    get_size_bytes() const -> std::uint64_t;
+
+    //
+    // Gets the path of the file.
+    //
+    auto
+    get_path() const -> const std::filesystem::path&;
+
+private:
+
+    //
+    // Writes a block at a file offset, retrying partial writes.
+    //
+    auto
+    write_block(
+        const char* p_data_buffer,
+        const std::size_t p_data_size,
+        const std::uint64_t p_offset_bytes) const -> status_code;
+
+    //
+    // Hands the active buffer over to the I/O thread and switches to the other buffer.
+    //
+    auto
+    submit_active_buffer() -> void;
+
+    //
+    // Waits until the I/O thread is done with the buffer it was handed.
+    //
+    auto
+    wait_for_pending_buffer(
+        std::unique_lock<std::mutex>& p_lock) -> void;
+
+    //
+    // I/O loop run by the I/O thread.
+    //
+    auto
+    io_loop() -> void;
+
+    //
+    // Alignment in bytes of the buffers, offsets and sizes used for O_DIRECT.
+    //
+    static constexpr std::size_t c_alignment_bytes = 4096u;
+
+    //
+    // Size in bytes of each buffer. Must be a multiple of the alignment.
+    //
+    static constexpr std::size_t c_buffer_size_bytes = 1024u * 1024u;
+
+    //
+    // Sentinel for no buffer pending to be written.
+    //
+    static constexpr std::uint32_t c_no_pending_buffer = 2u;
+
+    //
+    // Path of the file.
+    //
+    std::filesystem::path m_file_path;
+
+    //
+    // File descriptor. Set to -1 while the file is not open.
+    //
+    int m_file_descriptor;
+
+    //
+    // Page-aligned buffers.
+    //
+    std::unique_ptr<char, decltype(&std::free)> m_buffers[2];
+
+    //
+    // Buffer being filled by appends.
+    //
+    std::uint32_t m_active_buffer;
+
+    //
+    // File offset where the active buffer starts. Always aligned.
+    //
+    std::uint64_t m_active_buffer_offset_bytes;
+
+    //
+    // Bytes filled in the active buffer.
+    //
+    std::size_t m_active_buffer_size_bytes;
+
+    //
+    // Lock and condition variable for handing buffers over to the I/O thread.
+    //
+    std::mutex m_io_lock;
+
+    std::condition_variable m_io_condition;
+
+    //
+    // Buffer handed over to the I/O thread, if any.
+    //
+    std::uint32_t m_pending_buffer;
+
+    //
+    // File offset where the pending buffer is written.
+    //
+    std::uint64_t m_pending_buffer_offset_bytes;
+
+    //
+    // Status of the writes completed by the I/O thread since the last append or flush.
+    //
+    status_code m_io_status;
+
+    //
+    // Flag for signaling the I/O thread to exit.
+    //
+    bool m_stop_requested;
+
+    //
+    // I/O thread.
+    //
+    std::thread m_io_thread;
+
+};
+
+} // namespace echo.
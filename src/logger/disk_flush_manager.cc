@@ -0,0 +1,380 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'disk_flush_manager.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <chrono>
+#include <algorithm>
+#include "disk_flush_manager.hh"
+#include "../utils/time_utilities.hh"
+
+namespace echo
+{
+
+disk_flush_manager::disk_flush_manager(
+    std::shared_ptr<filesystem_writer> p_filesystem_writer,
+    const std::uint32_t p_flush_frequency_ms,
+    const std::uint32_t p_info_lane_size_mib,
+    std::shared_ptr<filesystem_writer> p_sequence_filesystem_writer)
+    : m_filesystem_writer{std::move(p_filesystem_writer)},
+      m_sequence_filesystem_writer{p_sequence_filesystem_writer != nullptr ? std::move(p_sequence_filesystem_writer) : m_filesystem_writer},
+      m_flush_frequency_ms{std::max(p_flush_frequency_ms, 1u)},
+      m_max_info_lane_size_bytes{static_cast<std::size_t>(p_info_lane_size_mib) * 1024u * 1024u},
+      m_queued_size_bytes{0u},
+      m_stop_requested{false}
+{
+    m_flusher_thread = std::thread(&disk_flush_manager::flusher_loop, this);
+}
+
+disk_flush_manager::~disk_flush_manager()
+{
+    {
+        std::scoped_lock<std::mutex> lock {m_queue_lock};
+
+        m_stop_requested = true;
+    }
+
+    m_flush_condition.notify_all();
+
+    if (m_flusher_thread.joinable())
+    {
+        m_flusher_thread.join();
+    }
+
+    flush();
+}
+
+auto
+disk_flush_manager::enqueue(
+    const log_record_metadata& p_log_record_metadata,
+    std::string&& p_log_message) -> status_code
+{
+    const std::size_t log_message_size_bytes = p_log_message.size();
+
+    return enqueue_records(
+        get_priority_lane(p_log_record_metadata.m_log_level),
+        queued_records{
+            std::move(p_log_message),
+            {log_record_extent{p_log_record_metadata, log_message_size_bytes}}});
+}
+
+auto
+disk_flush_manager::enqueue(
+    std::vector<log_record_extent>&& p_log_record_extents,
+    std::string&& p_log_messages) -> status_code
+{
+    log_level highest_log_level = log_level::info;
+
+    for (const log_record_extent& extent : p_log_record_extents)
+    {
+        highest_log_level = std::max(highest_log_level, extent.m_metadata.m_log_level);
+    }
+
+    return enqueue_records(
+        get_priority_lane(highest_log_level),
+        queued_records{
+            std::move(p_log_messages),
+            std::move(p_log_record_extents)});
+}
+
+auto
+disk_flush_manager::flush() -> status_code
+{
+    std::scoped_lock<std::mutex> lock {m_flush_lock};
+
+    const status_code status = flush_lanes();
+
+    if (status::failed(m_filesystem_writer->flush()))
+    {
+        return status::file_write_failed;
+    }
+
+    return status;
+}
+
+auto
+disk_flush_manager::wait_for_durability() -> status_code
+{
+    {
+        std::scoped_lock<std::mutex> lock {m_flush_lock};
+
+        flush_lanes();
+    }
+
+    return m_filesystem_writer->wait_for_durability();
+}
+
+auto
+disk_flush_manager::get_lane_statistics() const -> std::array<priority_lane_statistics, c_priority_lanes_count>
+{
+    std::array<priority_lane_statistics, c_priority_lanes_count> lane_statistics;
+    std::scoped_lock<std::mutex> lock {m_queue_lock};
+
+    for (std::size_t lane_index = 0u; lane_index < c_priority_lanes_count; ++lane_index)
+    {
+        lane_statistics[lane_index] = m_lanes[lane_index].m_statistics;
+    }
+
+    return lane_statistics;
+}
+
+auto
+disk_flush_manager::enqueue_records(
+    const priority_lane p_priority_lane,
+    queued_records&& p_queued_records) -> status_code
+{
+    lane& target_lane = m_lanes[static_cast<std::size_t>(p_priority_lane)];
+    const std::size_t records_size_bytes = p_queued_records.m_log_messages.size();
+    bool flush_required = false;
+    bool records_shed = false;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_queue_lock};
+
+        records_shed = p_priority_lane == priority_lane::info &&
+            target_lane.m_queued_size_bytes + records_size_bytes > m_max_info_lane_size_bytes;
+
+        if (records_shed)
+        {
+            //
+            // The flusher is falling behind; give up info traffic rather than memory or the higher lanes.
+            //
+            target_lane.m_statistics.m_shed_records_count += p_queued_records.m_extents.size();
+
+            //
+            // Shed on purpose; the numbers of the records are not losses. The flusher retires them.
+            //
+            for (const log_record_extent& extent : p_queued_records.m_extents)
+            {
+                if (extent.m_metadata.m_sequence_number.has_value())
+                {
+                    record_shed_sequence_number(
+                        target_lane,
+                        extent.m_metadata.m_sequence_number.value());
+                }
+            }
+        }
+        else
+        {
+            target_lane.m_queued_records.push_back(std::move(p_queued_records));
+            target_lane.m_queued_size_bytes += records_size_bytes;
+            m_queued_size_bytes += records_size_bytes;
+
+            flush_required = p_priority_lane == priority_lane::urgent ||
+                m_queued_size_bytes >= c_chunk_size_bytes;
+        }
+    }
+
+    if (records_shed)
+    {
+        return status::info_lane_full;
+    }
+
+    if (flush_required)
+    {
+        m_flush_condition.notify_one();
+    }
+
+    return status::success;
+}
+
+auto
+disk_flush_manager::take_next_chunk(
+    std::vector<queued_records>& p_chunk,
+    priority_lane& p_priority_lane) -> bool
+{
+    for (std::size_t lane_index = 0u; lane_index < c_priority_lanes_count; ++lane_index)
+    {
+        lane& current_lane = m_lanes[lane_index];
+        std::size_t chunk_size_bytes = 0u;
+
+        while (!current_lane.m_queued_records.empty() &&
+            chunk_size_bytes < c_chunk_size_bytes)
+        {
+            const std::size_t records_size_bytes = current_lane.m_queued_records.front().m_log_messages.size();
+
+            chunk_size_bytes += records_size_bytes;
+            current_lane.m_queued_size_bytes -= records_size_bytes;
+            m_queued_size_bytes -= records_size_bytes;
+
+            p_chunk.push_back(std::move(current_lane.m_queued_records.front()));
+            current_lane.m_queued_records.pop_front();
+        }
+
+        if (!p_chunk.empty())
+        {
+            p_priority_lane = static_cast<priority_lane>(lane_index);
+
+            return true;
+        }
+    }
+
+    return false;
+}
+
+auto
+disk_flush_manager::record_shed_sequence_number(
+    lane& p_lane,
+    const std::uint64_t p_sequence_number) -> void
+{
+    const auto open_ranges_begin = p_lane.m_shed_ranges.end() - std::min(p_lane.m_shed_ranges.size(), c_open_shed_ranges_count);
+
+    const auto open_range = std::find_if(
+        open_ranges_begin,
+        p_lane.m_shed_ranges.end(),
+        [p_sequence_number](const retired_sequence_range& p_shed_range)
+        {
+            return p_shed_range.m_first_sequence_number + p_shed_range.m_records_count == p_sequence_number;
+        });
+
+    if (open_range != p_lane.m_shed_ranges.end())
+    {
+        ++open_range->m_records_count;
+
+        return;
+    }
+
+    p_lane.m_shed_ranges.push_back(retired_sequence_range{
+        p_sequence_number,
+        1u,
+        sequence_retirement_reason::shed,
+        0u});
+}
+
+auto
+disk_flush_manager::retire_shed_ranges() -> void
+{
+    std::vector<retired_sequence_range> shed_ranges;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_queue_lock};
+
+        for (lane& current_lane : m_lanes)
+        {
+            shed_ranges.insert(shed_ranges.end(), current_lane.m_shed_ranges.begin(), current_lane.m_shed_ranges.end());
+            current_lane.m_shed_ranges.clear();
+        }
+    }
+
+    //
+    // In order, so that the ledger merges contiguous ranges of different producers.
+    //
+    std::sort(
+        shed_ranges.begin(),
+        shed_ranges.end(),
+        [](const retired_sequence_range& p_left, const retired_sequence_range& p_right)
+        {
+            return p_left.m_first_sequence_number < p_right.m_first_sequence_number;
+        });
+
+    for (const retired_sequence_range& shed_range : shed_ranges)
+    {
+        m_sequence_filesystem_writer->retire_sequence_numbers(
+            shed_range.m_first_sequence_number,
+            shed_range.m_records_count,
+            shed_range.m_reason);
+    }
+}
+
+auto
+disk_flush_manager::flush_lanes() -> status_code
+{
+    retire_shed_ranges();
+
+    status_code status = status::success;
+    std::vector<queued_records> chunk;
+    std::string batch;
+    std::vector<log_record_extent> extents;
+    priority_lane chunk_priority_lane = priority_lane::urgent;
+
+    while (true)
+    {
+        chunk.clear();
+
+        {
+            std::scoped_lock<std::mutex> lock {m_queue_lock};
+
+            if (!take_next_chunk(chunk, chunk_priority_lane))
+            {
+                break;
+            }
+        }
+
+        batch.clear();
+        extents.clear();
+
+        for (const queued_records& records : chunk)
+        {
+            batch += records.m_log_messages;
+            extents.insert(extents.end(), records.m_extents.begin(), records.m_extents.end());
+        }
+
+        const status_code write_status = m_filesystem_writer->write_log_messages_to_disk(batch, extents);
+
+        if (status::failed(write_status))
+        {
+            status = write_status;
+        }
+
+        //
+        // End-to-end delay of every record, from the log call to the write that carried it.
+        //
+        const std::uint64_t written_timestamp_ns = get_current_timestamp_ns();
+        std::uint64_t total_latency_ns = 0u;
+        std::uint64_t max_latency_ns = 0u;
+
+        for (const log_record_extent& extent : extents)
+        {
+            const std::uint64_t latency_ns = written_timestamp_ns > extent.m_metadata.m_timestamp_ns ?
+                written_timestamp_ns - extent.m_metadata.m_timestamp_ns :
+                0u;
+
+            total_latency_ns += latency_ns;
+            max_latency_ns = std::max(max_latency_ns, latency_ns);
+        }
+
+        std::scoped_lock<std::mutex> lock {m_queue_lock};
+
+        priority_lane_statistics& statistics = m_lanes[static_cast<std::size_t>(chunk_priority_lane)].m_statistics;
+
+        statistics.m_written_records_count += extents.size();
+        statistics.m_total_latency_ns += total_latency_ns;
+        statistics.m_max_latency_ns = std::max(statistics.m_max_latency_ns, max_latency_ns);
+    }
+
+    return status;
+}
+
+auto
+disk_flush_manager::flusher_loop() -> void
+{
+    std::unique_lock<std::mutex> lock {m_queue_lock};
+
+    while (!m_stop_requested)
+    {
+        m_flush_condition.wait_for(
+            lock,
+            std::chrono::milliseconds(m_flush_frequency_ms),
+            [this]()
+            {
+                return m_stop_requested ||
+                    !m_lanes[static_cast<std::size_t>(priority_lane::urgent)].m_queued_records.empty() ||
+                    m_queued_size_bytes >= c_chunk_size_bytes;
+            });
+
+        lock.unlock();
+
+        {
+            std::scoped_lock<std::mutex> flush_lock {m_flush_lock};
+
+            flush_lanes();
+        }
+
+        lock.lock();
+    }
+}
+
+} // namespace echo.
@@ -0,0 +1,322 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'disk_flush_manager.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <array>
+#include <deque>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <condition_variable>
+#include "log_level.hh"
+#include "filesystem_writer.hh"
+#include "../status/status.hh"
+
+namespace echo
+{
+
+//
+// Queue of the records of a severity band in async mode. Lanes are drained in order.
+//
+enum class priority_lane : std::uint8_t
+{
+
+    //
+    // Error and critical records. Never shed.
+    //
+    urgent = 0,
+
+    //
+    // Warning records. Never shed.
+    //
+    warning = 1,
+
+    //
+    // Information records. Shed once the lane is full.
+    //
+    info = 2
+
+};
+
+//
+// Count of priority lanes.
+//
+constexpr std::size_t c_priority_lanes_count = 3u;
+
+//
+// Gets the lane of the records of a level.
+//
+inline
+auto
+get_priority_lane(
+    const log_level p_log_level) -> priority_lane
+{
+    switch (p_log_level)
+    {
+        case log_level::critical:
+        case log_level::error:
+            return priority_lane::urgent;
+        case log_level::warning:
+            return priority_lane::warning;
+        default:
+            return priority_lane::info;
+    }
+}
+
+//
+// Counters of a priority lane since the logging session started.
+//
+struct priority_lane_statistics
+{
+
+    //
+    // Count of records handed over to the filesystem.
+    //
+    std::uint64_t m_written_records_count;
+
+    //
+    // Count of records dropped because the lane was full.
+    //
+    std::uint64_t m_shed_records_count;
+
+    //
+    // Sum and max of the delays in nanoseconds between the timestamp of
+    // a record and the completion of the write that carried it.
+    //
+    std::uint64_t m_total_latency_ns;
+
+    std::uint64_t m_max_latency_ns;
+
+};
+
+//
+// Buffer of async mode. Records are queued in the lane of their severity band and written out
+// by a flusher thread every flush period, or as soon as an urgent record or a full write comes
+// in. The flusher always drains the higher priority lanes first and writes the info lane in
+// bounded chunks, checking the higher lanes again before each one, so an error record never
+// waits behind more than a chunk of info traffic. Under pressure only the info lane sheds.
+// Records of different lanes are not in timestamp order on disk.
+// Thread-safe class.
+//
+class disk_flush_manager
+{
+
+public:
+
+    //
+    // Constructor. Starts the flusher thread. Shed records are accounted for by the flusher in
+    // the sequence ledger of the writer that handed out their numbers, the stream writer unless given.
+    //
+    disk_flush_manager(
+        std::shared_ptr<filesystem_writer> p_filesystem_writer,
+        const std::uint32_t p_flush_frequency_ms,
+        const std::uint32_t p_info_lane_size_mib,
+        std::shared_ptr<filesystem_writer> p_sequence_filesystem_writer = nullptr);
+
+    //
+    // Destructor. Stops the flusher thread and writes out all queued records.
+    //
+    ~disk_flush_manager();
+
+    disk_flush_manager(const disk_flush_manager&) = delete;
+
+    disk_flush_manager&
+    operator=(const disk_flush_manager&) = delete;
+
+    //
+    // Queues a formatted log message in the lane of its level.
+    // Fails with info_lane_full if the record was shed.
+    //
+    auto
+    enqueue(
+        const log_record_metadata& p_log_record_metadata,
+        std::string&& p_log_message) -> status_code;
+
+    //
+    // Queues the formatted log messages of a batch as a unit, in the lane of its highest level.
+    // Fails with info_lane_full if the batch was shed.
+    //
+    auto
+    enqueue(
+        std::vector<log_record_extent>&& p_log_record_extents,
+        std::string&& p_log_messages) -> status_code;
+
+    //
+    // Writes out every queued record, higher priority lanes first.
+    //
+    auto
+    flush() -> status_code;
+
+    //
+    // Writes out every queued record and waits until they are on stable storage.
+    //
+    auto
+    wait_for_durability() -> status_code;
+
+    //
+    // Gets the counters of every lane, indexed by lane.
+    //
+    auto
+    get_lane_statistics() const -> std::array<priority_lane_statistics, c_priority_lanes_count>;
+
+private:
+
+    //
+    // Single record or batch queued in a lane.
+    //
+    struct queued_records
+    {
+
+        //
+        // Formatted log messages.
+        //
+        std::string m_log_messages;
+
+        //
+        // Extents of the records, covering the log messages.
+        //
+        std::vector<log_record_extent> m_extents;
+
+    };
+
+    //
+    // Queue and counters of a lane.
+    //
+    struct lane
+    {
+
+        std::deque<queued_records> m_queued_records;
+
+        std::size_t m_queued_size_bytes {0u};
+
+        priority_lane_statistics m_statistics {};
+
+        //
+        // Sequence numbers of the records shed since the last flush, as ranges extended while contiguous.
+        //
+        std::vector<retired_sequence_range> m_shed_ranges;
+
+    };
+
+    //
+    // Queues records in a lane, shedding them if it is the info lane and it is full.
+    //
+    auto
+    enqueue_records(
+        const priority_lane p_priority_lane,
+        queued_records&& p_queued_records) -> status_code;
+
+    //
+    // Takes the next chunk to be written out, from the highest priority lane with queued records.
+    // Returns false when every lane is empty. Caller must hold the queue lock.
+    //
+    auto
+    take_next_chunk(
+        std::vector<queued_records>& p_chunk,
+        priority_lane& p_priority_lane) -> bool;
+
+    //
+    // Accounts for a shed record in the shed ranges of its lane. Caller must hold the queue lock.
+    //
+    static
+    auto
+    record_shed_sequence_number(
+        lane& p_lane,
+        const std::uint64_t p_sequence_number) -> void;
+
+    //
+    // Hands the shed ranges of every lane over to the sequence ledger in bulk.
+    //
+    auto
+    retire_shed_ranges() -> void;
+
+    //
+    // Writes out the queued records, chunk by chunk, and retires the shed ones. Caller must hold the flush lock.
+    //
+    auto
+    flush_lanes() -> status_code;
+
+    //
+    // Flusher loop run by the flusher thread.
+    //
+    auto
+    flusher_loop() -> void;
+
+    //
+    // Size in bytes of the writes of the flusher, and of the queued records that wakes it up before its period ends.
+    //
+    static constexpr std::size_t c_chunk_size_bytes = 1024u * 1024u;
+
+    //
+    // Count of the most recent shed ranges of a lane that a shed record can extend; producers
+    // shed from their own sequence blocks, so ranges stay whole with this many of them at once.
+    //
+    static constexpr std::size_t c_open_shed_ranges_count = 8u;
+
+    //
+    // Writer of the segment stream.
+    //
+    const std::shared_ptr<filesystem_writer> m_filesystem_writer;
+
+    //
+    // Writer that handed out the sequence numbers of the queued records.
+    //
+    const std::shared_ptr<filesystem_writer> m_sequence_filesystem_writer;
+
+    //
+    // Flush frequency in milliseconds of the flusher thread.
+    //
+    const std::uint32_t m_flush_frequency_ms;
+
+    //
+    // Max size in bytes of the records queued in the info lane.
+    //
+    const std::size_t m_max_info_lane_size_bytes;
+
+    //
+    // Lanes, indexed by lane.
+    //
+    std::array<lane, c_priority_lanes_count> m_lanes;
+
+    //
+    // Size in bytes of the records queued in every lane.
+    //
+    std::size_t m_queued_size_bytes;
+
+    //
+    // Lock for the lanes and their counters.
+    //
+    mutable std::mutex m_queue_lock;
+
+    //
+    // Condition variable for waking up the flusher on urgent records, full writes or stop.
+    //
+    std::condition_variable m_flush_condition;
+
+    //
+    // Lock for serializing the writes of the queued records.
+    //
+    std::mutex m_flush_lock;
+
+    //
+    // Flag for signaling the flusher thread to exit.
+    //
+    bool m_stop_requested;
+
+    //
+    // Flusher thread.
+    //
+    std::thread m_flusher_thread;
+
+};
+
+} // namespace echo.
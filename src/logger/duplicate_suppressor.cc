@@ -0,0 +1,145 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'duplicate_suppressor.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <algorithm>
+#include "duplicate_suppressor.hh"
+
+namespace echo
+{
+
+duplicate_suppressor::duplicate_suppressor(
+    const std::uint32_t p_window_ms,
+    const std::uint32_t p_slots_count)
+    : m_window_ns{static_cast<std::uint64_t>(p_window_ms) * 1'000'000u},
+      m_slots{std::make_unique<slot[]>(std::max(p_slots_count, 1u))},
+      m_slots_count{std::max(p_slots_count, 1u)},
+      m_next_sweep_timestamp_ns{0u}
+{}
+
+auto
+duplicate_suppressor::is_suppressed(
+    const log_level p_log_level,
+    const std::source_location& p_source_location,
+    const char* p_title,
+    const std::string_view p_message,
+    const std::uint64_t p_timestamp_ns,
+    std::optional<suppressed_message_summary>& p_closed_summary) -> bool
+{
+    const std::uint64_t hash = hash_message(p_source_location, p_message);
+    slot& target_slot = m_slots[hash % m_slots_count];
+
+    std::scoped_lock<std::mutex> lock {target_slot.m_lock};
+
+    if (target_slot.m_hash == hash &&
+        p_timestamp_ns - target_slot.m_window_start_timestamp_ns < m_window_ns)
+    {
+        ++target_slot.m_summary.m_repeated_count;
+
+        return true;
+    }
+
+    //
+    // A new window starts; the previous one of the slot, for this or another pair, is closed.
+    //
+    p_closed_summary = take_summary(target_slot);
+
+    target_slot.m_hash = hash;
+    target_slot.m_window_start_timestamp_ns = p_timestamp_ns;
+    target_slot.m_summary.m_log_level = p_log_level;
+    target_slot.m_summary.m_title = p_title;
+    target_slot.m_summary.m_source_location = p_source_location;
+    target_slot.m_summary.m_repeated_count = 0u;
+    target_slot.m_summary.m_message_prefix.assign(p_message.substr(0u, c_max_message_prefix_size_bytes));
+
+    return false;
+}
+
+auto
+duplicate_suppressor::collect_closed_summaries(
+    const std::optional<std::uint64_t> p_timestamp_ns) -> std::vector<suppressed_message_summary>
+{
+    std::vector<suppressed_message_summary> summaries;
+
+    if (p_timestamp_ns.has_value())
+    {
+        //
+        // A single caller sweeps per window length.
+        //
+        std::uint64_t next_sweep_timestamp_ns = m_next_sweep_timestamp_ns.load(std::memory_order_relaxed);
+
+        if (p_timestamp_ns.value() < next_sweep_timestamp_ns ||
+            !m_next_sweep_timestamp_ns.compare_exchange_strong(
+                next_sweep_timestamp_ns,
+                p_timestamp_ns.value() + m_window_ns,
+                std::memory_order_relaxed))
+        {
+            return summaries;
+        }
+    }
+
+    for (std::uint32_t slot_index = 0u; slot_index < m_slots_count; ++slot_index)
+    {
+        slot& current_slot = m_slots[slot_index];
+        std::scoped_lock<std::mutex> lock {current_slot.m_lock};
+
+        if (current_slot.m_summary.m_repeated_count == 0u ||
+            (p_timestamp_ns.has_value() &&
+                p_timestamp_ns.value() - current_slot.m_window_start_timestamp_ns < m_window_ns))
+        {
+            continue;
+        }
+
+        std::optional<suppressed_message_summary> summary = take_summary(current_slot);
+        summaries.push_back(std::move(summary.value()));
+    }
+
+    return summaries;
+}
+
+auto
+duplicate_suppressor::hash_message(
+    const std::source_location& p_source_location,
+    const std::string_view p_message) -> std::uint64_t
+{
+    //
+    // FNV-1a over the message, seeded with the call site; zero is reserved for empty slots.
+    //
+    std::uint64_t hash = 14695981039346656037ull ^
+        reinterpret_cast<std::uintptr_t>(p_source_location.file_name()) ^
+        (static_cast<std::uint64_t>(p_source_location.line()) << 32u);
+
+    for (const char character : p_message)
+    {
+        hash ^= static_cast<std::uint8_t>(character);
+        hash *= 1099511628211ull;
+    }
+
+    return hash != 0u ? hash : 1u;
+}
+
+auto
+duplicate_suppressor::take_summary(
+    slot& p_slot) -> std::optional<suppressed_message_summary>
+{
+    if (p_slot.m_summary.m_repeated_count == 0u)
+    {
+        return std::nullopt;
+    }
+
+    suppressed_message_summary summary = p_slot.m_summary;
+    p_slot.m_summary.m_repeated_count = 0u;
+
+    //
+    // The next occurrence of the pair starts a new window and is logged.
+    //
+    p_slot.m_hash = 0u;
+
+    return summary;
+}
+
+} // namespace echo.
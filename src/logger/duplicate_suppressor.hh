@@ -0,0 +1,175 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'duplicate_suppressor.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <source_location>
+#include "log_level.hh"
+
+namespace echo
+{
+
+//
+// Summary of the repeats of a message suppressed during a window.
+//
+struct suppressed_message_summary
+{
+
+    //
+    // Level of the repeated message.
+    //
+    log_level m_log_level;
+
+    //
+    // Title of the repeated message.
+    //
+    const char* m_title;
+
+    //
+    // Call site of the repeated message.
+    //
+    std::source_location m_source_location;
+
+    //
+    // Count of suppressed repeats.
+    //
+    std::uint64_t m_repeated_count;
+
+    //
+    // Leading part of the repeated message.
+    //
+    std::string m_message_prefix;
+
+};
+
+//
+// Detects identical (call site, message) pairs logged within a time window and suppresses
+// the repeats after the first one; the count of repeats is handed back as a summary once
+// the window closes. Pairs are tracked in a fixed-size, direct-mapped table keyed by a
+// cheap hash, so memory stays flat under high-cardinality messages: a pair that evicts
+// another one closes the window of the evicted pair early.
+// Thread-safe class.
+//
+class duplicate_suppressor
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    duplicate_suppressor(
+        const std::uint32_t p_window_ms,
+        const std::uint32_t p_slots_count);
+
+    //
+    // Determines whether a message is a repeat to be suppressed. When the message closes the
+    // window of a previous pair, the summary of that window is returned through the output.
+    //
+    auto
+    is_suppressed(
+        const log_level p_log_level,
+        const std::source_location& p_source_location,
+        const char* p_title,
+        const std::string_view p_message,
+        const std::uint64_t p_timestamp_ns,
+        std::optional<suppressed_message_summary>& p_closed_summary) -> bool;
+
+    //
+    // Collects the summaries of the windows closed by the given time, or of every window
+    // with suppressed repeats if no time is given. Returns immediately when called before
+    // the next sweep is due, unless no time is given.
+    //
+    auto
+    collect_closed_summaries(
+        const std::optional<std::uint64_t> p_timestamp_ns) -> std::vector<suppressed_message_summary>;
+
+private:
+
+    //
+    // Pair tracked by the table.
+    //
+    struct alignas(64) slot
+    {
+
+        //
+        // Lock for the slot.
+        //
+        std::mutex m_lock;
+
+        //
+        // Hash of the pair. Zero if the slot is empty.
+        //
+        std::uint64_t m_hash {0u};
+
+        //
+        // Start of the suppression window.
+        //
+        std::uint64_t m_window_start_timestamp_ns {0u};
+
+        //
+        // Summary of the repeats suppressed so far in the window.
+        //
+        suppressed_message_summary m_summary {};
+
+    };
+
+    //
+    // Hashes a (call site, message) pair.
+    //
+    static
+    auto
+    hash_message(
+        const std::source_location& p_source_location,
+        const std::string_view p_message) -> std::uint64_t;
+
+    //
+    // Takes the summary out of a slot if repeats were suppressed in its window.
+    // Caller must hold the slot lock.
+    //
+    static
+    auto
+    take_summary(
+        slot& p_slot) -> std::optional<suppressed_message_summary>;
+
+    //
+    // Max size in bytes of the message prefix kept for the summaries.
+    //
+    static constexpr std::size_t c_max_message_prefix_size_bytes = 128u;
+
+    //
+    // Length of the suppression window in nanoseconds.
+    //
+    const std::uint64_t m_window_ns;
+
+    //
+    // Slots of the table.
+    //
+    const std::unique_ptr<slot[]> m_slots;
+
+    //
+    // Count of slots of the table.
+    //
+    const std::uint32_t m_slots_count;
+
+    //
+    // Time at which the next sweep for closed windows is due.
+    //
+    std::atomic<std::uint64_t> m_next_sweep_timestamp_ns;
+
+};
+
+} // namespace echo.
@@ -7,7 +7,11 @@
 // ****************************************************
 
 #include <format>
-#include <fstream>
+#include <cerrno>
+#include <fcntl.h>
+#include <unistd.h>
+#include <syslog.h>
+#include <algorithm>
 #include "filesystem_writer.hh"
 
 namespace echo
@@ -15,12 +19,107 @@ namespace echo
 
 filesystem_writer::filesystem_writer(
     const std::string& p_session_id,
-    const std::filesystem::path& p_logging_session_directory_path)
+    const std::filesystem::path& p_logging_session_directory_path,
+    const bool p_segment_index_enabled,
+    const std::uint32_t p_segment_index_block_record_count,
+    const bool p_direct_io_enabled,
+    const std::uint32_t p_memory_spill_size_mib,
+    const bool p_log_to_syslog_on_failure)
     : m_logs_files_count{0},
       m_session_id{p_session_id},
       m_logging_session_directory_path{p_logging_session_directory_path},
-      m_pointed_logs_file_path{get_pointed_logs_file_path()}
-{}
+      m_pointed_logs_file_path{get_pointed_logs_file_path()},
+      m_segment_index_enabled{p_segment_index_enabled},
+      m_segment_index_block_record_count{p_segment_index_block_record_count},
+      m_segment_index{nullptr},
+      m_direct_io_enabled{p_direct_io_enabled},
+      m_direct_io_file{nullptr},
+      m_durability_requests_count{0u},
+      m_synced_durability_requests_count{0u},
+      m_sync_in_progress{false},
+      m_last_sync_status{status::success},
+      m_writer_id{allocate_writer_id()},
+      m_next_sequence_number{0u},
+      m_sequence_ledger{sequence_ledger::get_ledger_path(p_logging_session_directory_path, p_session_id)},
+      m_log_to_syslog_on_failure{p_log_to_syslog_on_failure},
+      m_circuit_open{false},
+      m_consecutive_failures_count{0u},
+      m_memory_spill_size_bytes{0u},
+      m_max_memory_spill_size_bytes{static_cast<std::uint64_t>(p_memory_spill_size_mib) * 1024u * 1024u},
+      m_spilled_records_count{0u},
+      m_dropped_records_count{0u},
+      m_stop_requested{false},
+      m_combined_write_in_progress{false}
+{
+    std::scoped_lock<std::mutex> lock {get_sequence_blocks_lock()};
+
+    get_live_writers().push_back(this);
+}
+
+filesystem_writer::~filesystem_writer()
+{
+    {
+        std::scoped_lock<std::mutex> lock {get_sequence_blocks_lock()};
+
+        //
+        // No thread allocates from the writer anymore; the blocks still held by threads end here.
+        //
+        for (thread_sequence_blocks* registered_thread_sequence_blocks : get_registered_thread_sequence_blocks())
+        {
+            for (sequence_block& block : registered_thread_sequence_blocks->m_sequence_blocks)
+            {
+                if (block.m_writer_id.load(std::memory_order_relaxed) == m_writer_id)
+                {
+                    release_sequence_block(block);
+                }
+            }
+        }
+
+        std::erase(get_live_writers(), this);
+    }
+
+    const std::uint64_t next_sequence_number = m_next_sequence_number.load(std::memory_order_relaxed);
+
+    if (next_sequence_number != 0u)
+    {
+        m_sequence_ledger.retire(next_sequence_number, 0u, sequence_retirement_reason::writer_closed);
+    }
+
+    m_sequence_ledger.flush();
+
+    std::unique_lock<std::mutex> lock {m_circuit_lock};
+
+    m_stop_requested = true;
+    m_circuit_condition.notify_all();
+
+    if (m_recovery_thread.joinable())
+    {
+        //
+        // The recovery thread only needs the lock to observe the stop request.
+        //
+        lock.unlock();
+        m_recovery_thread.join();
+        lock.lock();
+    }
+
+    if (!m_memory_spill.empty() &&
+        !replay_memory_spill(lock))
+    {
+        std::uint64_t lost_records_count = m_dropped_records_count;
+
+        for (const spilled_log_messages& spilled_batch : m_memory_spill)
+        {
+            lost_records_count += get_records_count(spilled_batch.m_log_messages, spilled_batch.m_log_record_extents);
+        }
+
+        report_circuit_transition(
+            LOG_ERR,
+            std::format(
+                "Logs writes to '{}' did not recover before shutdown; {} records were lost.",
+                m_logging_session_directory_path.string(),
+                lost_records_count));
+    }
+}
 
 /*
 The Lord Speaks.
@@ -37,8 +136,177 @@ Do you know the laws of the heavens?"
 
 auto
 filesystem_writer::write_log_message_to_disk(
-    const char* p_log_message) -> status_code
+    const char* p_log_message,
+    const log_record_metadata* p_log_record_metadata) -> status_code
 {
+    const std::string_view log_message {p_log_message};
+
+    if (p_log_record_metadata == nullptr)
+    {
+        return write_log_messages_to_disk(log_message, {});
+    }
+
+    const log_record_extent log_record_extent {*p_log_record_metadata, log_message.size()};
+
+    return write_log_messages_to_disk(
+        log_message,
+        std::span<const echo::log_record_extent>(&log_record_extent, 1u));
+}
+
+auto
+filesystem_writer::write_log_messages_to_disk(
+    const std::string_view p_log_messages,
+    const std::span<const log_record_extent> p_log_record_extents) -> status_code
+{
+    const iovec log_messages {const_cast<char*>(p_log_messages.data()), p_log_messages.size()};
+
+    return write_gathered_log_messages_to_disk(
+        std::span<const iovec>(&log_messages, 1u),
+        p_log_record_extents);
+}
+
+auto
+filesystem_writer::write_log_message_combined(
+    const std::string_view p_log_message,
+    const log_record_metadata& p_log_record_metadata) -> status_code
+{
+    combined_write_request write_request {p_log_message, p_log_record_metadata, status::success, false};
+    std::vector<combined_write_request*> write_requests;
+
+    std::unique_lock<std::mutex> lock {m_combining_lock};
+
+    m_pending_write_requests.push_back(&write_request);
+
+    while (!write_request.m_completed)
+    {
+        if (m_combined_write_in_progress)
+        {
+            //
+            // Another caller is writing; it or the next combiner will carry this message.
+            //
+            m_combining_condition.wait(lock);
+
+            continue;
+        }
+
+        //
+        // Combine every published message, this one included unless a previous combiner took it.
+        //
+        m_combined_write_in_progress = true;
+
+        const std::size_t taken_write_requests_count = std::min(
+            m_pending_write_requests.size(),
+            c_max_combined_write_requests_count);
+
+        write_requests.assign(
+            m_pending_write_requests.begin(),
+            m_pending_write_requests.begin() + taken_write_requests_count);
+
+        m_pending_write_requests.erase(
+            m_pending_write_requests.begin(),
+            m_pending_write_requests.begin() + taken_write_requests_count);
+
+        lock.unlock();
+
+        std::vector<iovec> log_messages;
+        std::vector<log_record_extent> extents;
+        log_messages.reserve(write_requests.size());
+        extents.reserve(write_requests.size());
+
+        for (const combined_write_request* request : write_requests)
+        {
+            log_messages.push_back(iovec{const_cast<char*>(request->m_log_message.data()), request->m_log_message.size()});
+            extents.push_back(log_record_extent{request->m_metadata, request->m_log_message.size()});
+        }
+
+        const status_code status = write_gathered_log_messages_to_disk(
+            log_messages,
+            extents);
+
+        lock.lock();
+
+        for (combined_write_request* request : write_requests)
+        {
+            request->m_status = status;
+            request->m_completed = true;
+        }
+
+        m_combined_write_in_progress = false;
+
+        m_combining_condition.notify_all();
+    }
+
+    return write_request.m_status;
+}
+
+auto
+filesystem_writer::write_gathered_log_messages_to_disk(
+    const std::span<const iovec> p_log_messages,
+    const std::span<const log_record_extent> p_log_record_extents) -> status_code
+{
+    const bool circuit_open = m_circuit_open.load(std::memory_order_acquire);
+    status_code status = status::success;
+
+    if (!circuit_open)
+    {
+        status = write_log_messages_to_pointed_logs_file(
+            p_log_messages,
+            p_log_record_extents,
+            true /* p_circuit_breaker_enabled */);
+
+        if (status::succeeded(status))
+        {
+            m_consecutive_failures_count.store(0u, std::memory_order_relaxed);
+
+            return status;
+        }
+
+        //
+        // The failed attempt series of the write were already counted.
+        //
+        if (m_consecutive_failures_count.load(std::memory_order_relaxed) < c_circuit_failure_threshold)
+        {
+            return status;
+        }
+    }
+
+    //
+    // The disk is failing; do not pay for the retries until the recovery thread closes the circuit.
+    //
+    std::string spilled_log_messages;
+
+    for (const iovec& log_messages : p_log_messages)
+    {
+        spilled_log_messages.append(static_cast<const char*>(log_messages.iov_base), log_messages.iov_len);
+    }
+
+    return spill_log_messages(
+        spilled_log_messages,
+        p_log_record_extents,
+        !circuit_open /* p_circuit_open_requested */);
+}
+
+auto
+filesystem_writer::write_log_messages_to_pointed_logs_file(
+    const std::span<const iovec> p_log_messages,
+    const std::span<const log_record_extent> p_log_record_extents,
+    const bool p_circuit_breaker_enabled) -> status_code
+{
+    const bool index_enabled = m_segment_index_enabled && !p_log_record_extents.empty();
+
+    //
+    // Indexed writes are serialized so that the size observed right before a write is the
+    // exact offset of the record, and so are direct I/O writes, which go through a single
+    // buffer; otherwise concurrent appends are left to the filesystem.
+    //
+    std::unique_lock<std::mutex> write_lock {m_write_lock, std::defer_lock};
+
+    if (index_enabled ||
+        m_direct_io_enabled)
+    {
+        write_lock.lock();
+    }
+
     //
     // Idemponent logging even if the directory is not present.
     //
@@ -53,6 +321,11 @@ filesystem_writer::write_log_message_to_disk(
             //
             // No exceptions allowed in the logging hotpath; handle the error gracefully.
             //
+            if (p_circuit_breaker_enabled)
+            {
+                m_consecutive_failures_count.fetch_add(1u, std::memory_order_relaxed);
+            }
+
             return status::directory_creation_failed;
         }
     }
@@ -64,7 +337,17 @@ filesystem_writer::write_log_message_to_disk(
     //
     for (std::uint16_t incremental_search_retry_count {1}; incremental_search_retry_count <= c_max_incremental_search_retry_count; ++incremental_search_retry_count)
     {
+        //
+        // Once the circuit is open, the writes go to the memory spill without any further attempt.
+        //
+        if (p_circuit_breaker_enabled &&
+            m_circuit_open.load(std::memory_order_acquire))
+        {
+            return status::file_write_failed;
+        }
+
         status_code creation_status = status::success;
+        bool attempts_series_failed = true;
 
         if (!std::filesystem::exists(m_pointed_logs_file_path))
         {
@@ -74,7 +357,7 @@ filesystem_writer::write_log_message_to_disk(
             //
             creation_status = write_to_file(
                 m_pointed_logs_file_path,
-                nullptr /* p_data_buffer */);
+                {} /* p_data_buffers */);
         }
 
         //
@@ -83,16 +366,31 @@ filesystem_writer::write_log_message_to_disk(
         //
         if (status::succeeded(creation_status))
         {
-            const std::optional<std::uint32_t> file_size_mib = get_file_size_in_mib(m_pointed_logs_file_path);
+            //
+            // In direct I/O mode the file on disk lags behind the buffered data.
+            //
+            const std::optional<std::uint64_t> file_size_bytes =
+                m_direct_io_enabled && m_direct_io_file != nullptr && m_direct_io_file->get_path() == m_pointed_logs_file_path ?
+                    m_direct_io_file->get_size_bytes() :
+                    get_file_size_in_bytes(m_pointed_logs_file_path);
+
+            //
+            // A full file is a plain rotation rather than a failure.
+            //
+            attempts_series_failed =
+                !file_size_bytes.has_value() ||
+                file_size_bytes.value() < c_max_logs_file_size_bytes;
 
-            if (file_size_mib.has_value() &&
-                file_size_mib.value() < c_max_logs_file_size_mib)
+            if (file_size_bytes.has_value() &&
+                file_size_bytes.value() < c_max_logs_file_size_bytes)
             {
                 for (std::uint16_t logs_writing_attempts_retry_count {1}; logs_writing_attempts_retry_count <= c_max_logs_writing_attempts_retry_count; ++logs_writing_attempts_retry_count)
                 {
-                    const status_code status = write_to_file(
-                        m_pointed_logs_file_path,
-                        p_log_message);
+                    const status_code status = m_direct_io_enabled ?
+                        write_to_direct_io_file(p_log_messages) :
+                        write_to_file(
+                            m_pointed_logs_file_path,
+                            p_log_messages);
 
                     if (status::failed(status))
                     {
@@ -102,6 +400,21 @@ filesystem_writer::write_log_message_to_disk(
                         continue;
                     }
 
+                    if (index_enabled)
+                    {
+                        std::uint64_t record_offset_bytes = file_size_bytes.value();
+
+                        for (const log_record_extent& extent : p_log_record_extents)
+                        {
+                            index_log_message(
+                                extent.m_metadata,
+                                record_offset_bytes,
+                                extent.m_size_bytes);
+
+                            record_offset_bytes += extent.m_size_bytes;
+                        }
+                    }
+
                     //
                     // Filesystem write succeeded. Exit.
                     //
@@ -110,6 +423,17 @@ filesystem_writer::write_log_message_to_disk(
             }
         }
 
+        //
+        // Each failed attempt series counts against the circuit breaker, so that a failing
+        // disk opens the circuit without waiting for the whole search of every write.
+        //
+        if (p_circuit_breaker_enabled &&
+            attempts_series_failed &&
+            m_consecutive_failures_count.fetch_add(1u, std::memory_order_relaxed) + 1u >= c_circuit_failure_threshold)
+        {
+            return status::file_write_failed;
+        }
+
         if (incremental_search_retry_count == c_max_incremental_search_retry_count)
         {
             return status::logging_incremental_search_failed;
@@ -122,6 +446,7 @@ filesystem_writer::write_log_message_to_disk(
             //
             std::scoped_lock<std::mutex> lock {m_pointed_logs_file_lock};
 
+            m_unsynced_logs_file_paths.push_back(m_pointed_logs_file_path);
             ++m_logs_files_count;
             m_pointed_logs_file_path = get_pointed_logs_file_path();
         }
@@ -133,6 +458,262 @@ filesystem_writer::write_log_message_to_disk(
     return status::fail;
 }
 
+auto
+filesystem_writer::wait_for_durability() -> status_code
+{
+    if (m_circuit_open.load(std::memory_order_acquire))
+    {
+        return status::file_sync_failed;
+    }
+
+    std::unique_lock<std::mutex> lock {m_durability_lock};
+
+    const std::uint64_t durability_request = ++m_durability_requests_count;
+
+    while (m_synced_durability_requests_count < durability_request)
+    {
+        if (m_sync_in_progress)
+        {
+            //
+            // A sync that started before this request is running; the next one will cover it.
+            //
+            m_durability_condition.wait(lock);
+
+            continue;
+        }
+
+        //
+        // Lead a group sync covering every request made so far. Their writes completed
+        // before they were counted, so they are all covered by a sync started afterwards.
+        //
+        m_sync_in_progress = true;
+        const std::uint64_t covered_durability_requests_count = m_durability_requests_count;
+
+        lock.unlock();
+
+        const status_code sync_status = sync_logs_files();
+
+        lock.lock();
+
+        m_synced_durability_requests_count = covered_durability_requests_count;
+        m_last_sync_status = sync_status;
+        m_sync_in_progress = false;
+
+        m_durability_condition.notify_all();
+    }
+
+    return m_last_sync_status;
+}
+
+auto
+filesystem_writer::prepare() -> status_code
+{
+    std::error_code error_code;
+
+    std::filesystem::create_directories(m_logging_session_directory_path, error_code);
+
+    if (error_code)
+    {
+        return status::directory_creation_failed;
+    }
+
+    std::filesystem::path pointed_logs_file_path;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_pointed_logs_file_lock};
+
+        pointed_logs_file_path = m_pointed_logs_file_path;
+    }
+
+    return write_to_file(
+        pointed_logs_file_path,
+        {} /* p_data_buffers */);
+}
+
+auto
+filesystem_writer::flush() -> status_code
+{
+    if (!m_direct_io_enabled)
+    {
+        return status::success;
+    }
+
+    std::scoped_lock<std::mutex> lock {m_write_lock};
+
+    return m_direct_io_file != nullptr ? m_direct_io_file->flush() : status::success;
+}
+
+auto
+filesystem_writer::spill_log_messages(
+    const std::string_view p_log_messages,
+    const std::span<const log_record_extent> p_log_record_extents,
+    const bool p_circuit_open_requested) -> status_code
+{
+    std::unique_lock<std::mutex> lock {m_circuit_lock};
+
+    if (!m_circuit_open.load(std::memory_order_relaxed))
+    {
+        if (!p_circuit_open_requested)
+        {
+            //
+            // The disk recovered while waiting for the lock.
+            //
+            lock.unlock();
+
+            return write_log_messages_to_disk(
+                p_log_messages,
+                p_log_record_extents);
+        }
+
+        if (m_recovery_thread.joinable())
+        {
+            //
+            // The previous recovery thread released the lock for the last time when it closed the circuit.
+            //
+            m_recovery_thread.join();
+        }
+
+        m_circuit_open.store(true, std::memory_order_release);
+        m_recovery_thread = std::thread(&filesystem_writer::recovery_loop, this);
+
+        report_circuit_transition(
+            LOG_ERR,
+            std::format(
+                "Logs writes to '{}' failed {} times in a row; keeping records in memory until the disk recovers.",
+                m_logging_session_directory_path.string(),
+                c_circuit_failure_threshold));
+    }
+
+    const std::uint64_t records_count = get_records_count(
+        p_log_messages,
+        p_log_record_extents);
+
+    if (m_memory_spill_size_bytes + p_log_messages.size() > m_max_memory_spill_size_bytes)
+    {
+        m_dropped_records_count += records_count;
+
+        return status::memory_spill_full;
+    }
+
+    m_memory_spill.push_back(spilled_log_messages{
+        std::string(p_log_messages),
+        std::vector<log_record_extent>(p_log_record_extents.begin(), p_log_record_extents.end())});
+
+    m_memory_spill_size_bytes += p_log_messages.size();
+    m_spilled_records_count += records_count;
+
+    return status::logs_spilled_to_memory;
+}
+
+auto
+filesystem_writer::recovery_loop() -> void
+{
+    std::unique_lock<std::mutex> lock {m_circuit_lock};
+    std::chrono::milliseconds recovery_backoff = c_min_recovery_backoff;
+
+    while (true)
+    {
+        if (m_circuit_condition.wait_for(lock, recovery_backoff, [this]() { return m_stop_requested; }))
+        {
+            //
+            // The destructor makes the last replay attempt.
+            //
+            return;
+        }
+
+        if (!replay_memory_spill(lock))
+        {
+            recovery_backoff = std::min(recovery_backoff * 2, c_max_recovery_backoff);
+
+            continue;
+        }
+
+        //
+        // The spill is empty and the lock is held, so no record can be spilled after this.
+        // A single failure opens the circuit again until a write succeeds.
+        //
+        m_consecutive_failures_count.store(c_circuit_failure_threshold - 1u, std::memory_order_relaxed);
+        m_circuit_open.store(false, std::memory_order_release);
+
+        report_circuit_transition(
+            LOG_NOTICE,
+            std::format(
+                "Logs writes to '{}' recovered; {} records were replayed from memory and {} records were dropped.",
+                m_logging_session_directory_path.string(),
+                m_spilled_records_count,
+                m_dropped_records_count));
+
+        m_spilled_records_count = 0u;
+        m_dropped_records_count = 0u;
+
+        return;
+    }
+}
+
+auto
+filesystem_writer::replay_memory_spill(
+    std::unique_lock<std::mutex>& p_circuit_lock) -> bool
+{
+    while (!m_memory_spill.empty())
+    {
+        //
+        // New batches are only appended, so the front batch stays first while the lock is released.
+        //
+        spilled_log_messages spilled_batch = std::move(m_memory_spill.front());
+        m_memory_spill.pop_front();
+
+        p_circuit_lock.unlock();
+
+        const iovec spilled_log_messages {spilled_batch.m_log_messages.data(), spilled_batch.m_log_messages.size()};
+
+        const status_code status = write_log_messages_to_pointed_logs_file(
+            std::span<const iovec>(&spilled_log_messages, 1u),
+            spilled_batch.m_log_record_extents,
+            false /* p_circuit_breaker_enabled */);
+
+        p_circuit_lock.lock();
+
+        if (status::failed(status))
+        {
+            m_memory_spill.push_front(std::move(spilled_batch));
+
+            return false;
+        }
+
+        m_memory_spill_size_bytes -= spilled_batch.m_log_messages.size();
+    }
+
+    return true;
+}
+
+auto
+filesystem_writer::report_circuit_transition(
+    const int p_priority,
+    const std::string& p_message) const -> void
+{
+    if (!m_log_to_syslog_on_failure)
+    {
+        return;
+    }
+
+    openlog(m_session_id.c_str(), LOG_PID | LOG_CONS, LOG_USER);
+    syslog(p_priority, "%s", p_message.c_str());
+    closelog();
+}
+
+auto
+filesystem_writer::get_records_count(
+    const std::string_view p_log_messages,
+    const std::span<const log_record_extent> p_log_record_extents) -> std::uint64_t
+{
+    if (!p_log_record_extents.empty())
+    {
+        return p_log_record_extents.size();
+    }
+
+    return static_cast<std::uint64_t>(std::count(p_log_messages.begin(), p_log_messages.end(), '\n'));
+}
+
 auto
 filesystem_writer::get_pointed_logs_file_path() const -> std::filesystem::path
 {
@@ -148,29 +729,169 @@ filesystem_writer::get_pointed_logs_file_path() const -> std::filesystem::path
 auto
 filesystem_writer::write_to_file(
     const std::filesystem::path& p_file_path,
-    const char* p_data_buffer) -> status_code
+    const std::span<const iovec> p_data_buffers) -> status_code
 {
-    std::ofstream file;
-    file.open(p_file_path, std::ios_base::app);
+    const int file_descriptor = open(p_file_path.c_str(), O_WRONLY | O_CREAT | O_APPEND | O_CLOEXEC, 0666);
 
-    if (!file)
+    if (file_descriptor == -1)
     {
         return status::file_write_failed;
     }
 
-    file << p_data_buffer;
+    //
+    // A gathered write is normally complete; resume from where a short one stopped otherwise.
+    //
+    std::vector<iovec> data_buffers(p_data_buffers.begin(), p_data_buffers.end());
+    std::size_t data_buffer_index = 0u;
+    status_code status = status::success;
+
+    while (data_buffer_index < data_buffers.size())
+    {
+        const ssize_t written_size = writev(
+            file_descriptor,
+            data_buffers.data() + data_buffer_index,
+            static_cast<int>(data_buffers.size() - data_buffer_index));
+
+        if (written_size == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            status = status::file_write_failed;
+
+            break;
+        }
+
+        std::size_t remaining_size = static_cast<std::size_t>(written_size);
+
+        while (data_buffer_index < data_buffers.size() &&
+            remaining_size >= data_buffers[data_buffer_index].iov_len)
+        {
+            remaining_size -= data_buffers[data_buffer_index].iov_len;
+            ++data_buffer_index;
+        }
+
+        if (remaining_size != 0u)
+        {
+            data_buffers[data_buffer_index].iov_base = static_cast<char*>(data_buffers[data_buffer_index].iov_base) + remaining_size;
+            data_buffers[data_buffer_index].iov_len -= remaining_size;
+        }
+    }
+
+    if (close(file_descriptor) == -1)
+    {
+        status = status::file_write_failed;
+    }
+
+    return status;
+}
+
+auto
+filesystem_writer::write_to_direct_io_file(
+    const std::span<const iovec> p_data_buffers) -> status_code
+{
+    if (m_direct_io_file == nullptr ||
+        m_direct_io_file->get_path() != m_pointed_logs_file_path)
+    {
+        //
+        // The pointed logs file was rotated; replacing the file writes out and trims the last block of the previous one.
+        //
+        m_direct_io_file.reset();
+
+        std::unique_ptr<direct_io_file> pointed_direct_io_file = std::make_unique<direct_io_file>();
+
+        if (status::failed(pointed_direct_io_file->open(m_pointed_logs_file_path)))
+        {
+            return status::file_write_failed;
+        }
+
+        m_direct_io_file = std::move(pointed_direct_io_file);
+    }
+
+    for (const iovec& data_buffer : p_data_buffers)
+    {
+        const status_code status = m_direct_io_file->append(
+            static_cast<const char*>(data_buffer.iov_base),
+            data_buffer.iov_len);
+
+        if (status::failed(status))
+        {
+            return status;
+        }
+    }
 
     return status::success;
 }
 
 auto
-filesystem_writer::get_file_size_in_mib(
-    const std::filesystem::path& p_file_path) -> std::optional<std::uint32_t>
+filesystem_writer::sync_logs_files() -> status_code
+{
+    std::vector<std::filesystem::path> logs_file_paths;
+
+    //
+    // In direct I/O mode the buffered data has to reach the file before it can be synced.
+    //
+    status_code status = status::failed(flush()) ? status::file_sync_failed : status::success;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_pointed_logs_file_lock};
+
+        logs_file_paths.swap(m_unsynced_logs_file_paths);
+        logs_file_paths.push_back(m_pointed_logs_file_path);
+    }
+
+    for (const std::filesystem::path& logs_file_path : logs_file_paths)
+    {
+        if (status::failed(sync_file(logs_file_path, false /* p_metadata_sync_required */)))
+        {
+            status = status::file_sync_failed;
+        }
+    }
+
+    if (logs_file_paths.back() != m_synced_logs_file_path)
+    {
+        //
+        // A logs file was created since the previous sync; persist its directory entry too.
+        //
+        if (status::failed(sync_file(m_logging_session_directory_path, true /* p_metadata_sync_required */)))
+        {
+            status = status::file_sync_failed;
+        }
+
+        m_synced_logs_file_path = logs_file_paths.back();
+    }
+
+    return status;
+}
+
+auto
+filesystem_writer::sync_file(
+    const std::filesystem::path& p_file_path,
+    const bool p_metadata_sync_required) -> status_code
+{
+    const int file_descriptor = open(p_file_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (file_descriptor == -1)
+    {
+        return status::file_sync_failed;
+    }
+
+    const int result = p_metadata_sync_required ? fsync(file_descriptor) : fdatasync(file_descriptor);
+
+    close(file_descriptor);
+
+    return result == 0 ? status::success : status::file_sync_failed;
+}
+
+auto
+filesystem_writer::get_file_size_in_bytes(
+    const std::filesystem::path& p_file_path) -> std::optional<std::uint64_t>
 {
     try
     {
-        const std::uint32_t file_size_bytes = static_cast<std::uint32_t>(std::filesystem::file_size(p_file_path));
-        return file_size_bytes / (1024u * 1024u);
+        return static_cast<std::uint64_t>(std::filesystem::file_size(p_file_path));
     }
     catch (const std::filesystem::filesystem_error& exception)
     {
@@ -182,4 +903,184 @@ filesystem_writer::get_file_size_in_mib(
     }
 }
 
+auto
+filesystem_writer::index_log_message(
+    const log_record_metadata& p_log_record_metadata,
+    const std::uint64_t p_offset_bytes,
+    const std::uint64_t p_size_bytes) -> void
+{
+    if (m_segment_index == nullptr ||
+        m_segment_index->get_segment_path() != m_pointed_logs_file_path)
+    {
+        //
+        // The pointed logs file was rotated; replacing the index writes out the last block of the previous one.
+        //
+        m_segment_index = std::make_unique<segment_index>(
+            m_pointed_logs_file_path,
+            m_segment_index_block_record_count);
+    }
+
+    m_segment_index->add_record(
+        p_log_record_metadata,
+        p_offset_bytes,
+        p_size_bytes);
+}
+
+auto
+filesystem_writer::allocate_writer_id() -> std::uint64_t
+{
+    static std::atomic<std::uint64_t> next_writer_id {1u};
+
+    return next_writer_id.fetch_add(1u, std::memory_order_relaxed);
+}
+
+auto
+filesystem_writer::retire_sequence_numbers(
+    const std::uint64_t p_first_sequence_number,
+    const std::uint64_t p_records_count,
+    const sequence_retirement_reason p_reason) -> void
+{
+    m_sequence_ledger.retire(
+        p_first_sequence_number,
+        p_records_count,
+        p_reason);
+}
+
+auto
+filesystem_writer::prepare_fork() -> void
+{
+    get_sequence_blocks_lock().lock();
+}
+
+auto
+filesystem_writer::complete_fork_in_parent() -> void
+{
+    get_sequence_blocks_lock().unlock();
+}
+
+auto
+filesystem_writer::complete_fork_in_child() -> void
+{
+    get_sequence_blocks_lock().unlock();
+}
+
+auto
+filesystem_writer::refill_sequence_block(
+    thread_sequence_blocks& p_thread_sequence_blocks,
+    sequence_block& p_sequence_block,
+    const std::uint64_t p_records_count) -> void
+{
+    if (p_sequence_block.m_writer_id.load(std::memory_order_relaxed) == m_writer_id)
+    {
+        //
+        // The thread moves on from a block too short for the requested numbers.
+        //
+        if (p_sequence_block.m_next_sequence_number < p_sequence_block.m_end_sequence_number)
+        {
+            m_sequence_ledger.retire(
+                p_sequence_block.m_next_sequence_number,
+                p_sequence_block.m_end_sequence_number - p_sequence_block.m_next_sequence_number,
+                sequence_retirement_reason::unused_block_tail);
+        }
+    }
+    else
+    {
+        //
+        // First block of the thread for this writer, possibly taking the cache entry of another writer.
+        //
+        std::scoped_lock<std::mutex> lock {get_sequence_blocks_lock()};
+
+        if (!p_thread_sequence_blocks.m_registered)
+        {
+            get_registered_thread_sequence_blocks().push_back(&p_thread_sequence_blocks);
+            p_thread_sequence_blocks.m_registered = true;
+        }
+
+        release_sequence_block(p_sequence_block);
+        p_sequence_block.m_writer_id.store(m_writer_id, std::memory_order_relaxed);
+    }
+
+    //
+    // Whole blocks only, so that every block stays aligned to the block size.
+    //
+    const std::uint64_t allocated_records_count =
+        (p_records_count + c_sequence_block_records_count - 1u) / c_sequence_block_records_count * c_sequence_block_records_count;
+
+    p_sequence_block.m_next_sequence_number = m_next_sequence_number.fetch_add(allocated_records_count, std::memory_order_relaxed);
+    p_sequence_block.m_end_sequence_number = p_sequence_block.m_next_sequence_number + allocated_records_count;
+}
+
+auto
+filesystem_writer::release_sequence_block(
+    sequence_block& p_sequence_block) -> void
+{
+    const std::uint64_t writer_id = p_sequence_block.m_writer_id.load(std::memory_order_relaxed);
+
+    if (writer_id == 0u)
+    {
+        return;
+    }
+
+    if (p_sequence_block.m_next_sequence_number < p_sequence_block.m_end_sequence_number)
+    {
+        const std::vector<filesystem_writer*>& live_writers = get_live_writers();
+
+        const auto writer = std::find_if(live_writers.begin(), live_writers.end(), [writer_id](const filesystem_writer* p_filesystem_writer)
+        {
+            return p_filesystem_writer->m_writer_id == writer_id;
+        });
+
+        if (writer != live_writers.end())
+        {
+            (*writer)->m_sequence_ledger.retire(
+                p_sequence_block.m_next_sequence_number,
+                p_sequence_block.m_end_sequence_number - p_sequence_block.m_next_sequence_number,
+                sequence_retirement_reason::unused_block_tail);
+        }
+    }
+
+    p_sequence_block.m_writer_id.store(0u, std::memory_order_relaxed);
+}
+
+auto
+filesystem_writer::get_live_writers() -> std::vector<filesystem_writer*>&
+{
+    static std::vector<filesystem_writer*> live_writers;
+
+    return live_writers;
+}
+
+auto
+filesystem_writer::get_registered_thread_sequence_blocks() -> std::vector<thread_sequence_blocks*>&
+{
+    static std::vector<thread_sequence_blocks*> registered_thread_sequence_blocks;
+
+    return registered_thread_sequence_blocks;
+}
+
+auto
+filesystem_writer::get_sequence_blocks_lock() -> std::mutex&
+{
+    static std::mutex sequence_blocks_lock;
+
+    return sequence_blocks_lock;
+}
+
+filesystem_writer::thread_sequence_blocks::~thread_sequence_blocks()
+{
+    if (!m_registered)
+    {
+        return;
+    }
+
+    std::scoped_lock<std::mutex> lock {get_sequence_blocks_lock()};
+
+    for (sequence_block& block : m_sequence_blocks)
+    {
+        release_sequence_block(block);
+    }
+
+    std::erase(get_registered_thread_sequence_blocks(), this);
+}
+
 } // namespace echo.
\ No newline at end of file
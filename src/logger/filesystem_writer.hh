@@ -8,17 +8,53 @@
 
 #pragma once
 
+#include <array>
 #include <mutex>
+#include <deque>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
 #include <cstdint>
+#include <span>
+#include <chrono>
 #include <optional>
 #include <filesystem>
+#include <string_view>
+#include <condition_variable>
+#include <sys/uio.h>
+#include <climits>
+#include "segment_index.hh"
+#include "direct_io_file.hh"
+#include "sequence_ledger.hh"
 #include "../status/status.hh"
 
 namespace echo
 {
 
+//
+// Extent of a log record inside a batch of log messages written at once.
+//
+struct log_record_extent
+{
+
+    //
+    // Metadata used for indexing the record.
+    //
+    log_record_metadata m_metadata;
+
+    //
+    // Size in bytes of the record inside the batch.
+    //
+    std::uint64_t m_size_bytes;
+
+};
+
 //
 // Filesystem writer class for handling logs dispatching to disk.
+// Writes go through a circuit breaker: after repeated failures the writer stops touching
+// the disk and keeps records in a bounded memory spill, while a recovery thread probes the
+// disk with backoff and replays the spill once writes succeed again.
 //
 class filesystem_writer
 {
@@ -30,17 +66,324 @@ public:
     //
     filesystem_writer(
         const std::string& p_session_id,
-        const std::filesystem::path& p_logging_session_directory_path);
+        const std::filesystem::path& p_logging_session_directory_path,
+        const bool p_segment_index_enabled = false,
+        const std::uint32_t p_segment_index_block_record_count = 0u,
+        const bool p_direct_io_enabled = false,
+        const std::uint32_t p_memory_spill_size_mib = 0u,
+        const bool p_log_to_syslog_on_failure = false);
+
+    //
+    // Destructor. Stops the recovery thread, makes a last attempt at replaying the memory spill
+    // and closes the sequence ledger.
+    //
+    ~filesystem_writer();
+
+    filesystem_writer(const filesystem_writer&) = delete;
+
+    filesystem_writer&
+    operator=(const filesystem_writer&) = delete;
 
     //
     // Provides a direct API for writing a single log message to disk.
+    // The record is added to the segment sidecar index when its metadata is provided
+    // and indexing is enabled; unindexed writes are still found by full scans.
     //
     auto
     write_log_message_to_disk(
-        const char* p_log_message) -> status_code;
+        const char* p_log_message,
+        const log_record_metadata* p_log_record_metadata = nullptr) -> status_code;
+
+    //
+    // Writes a batch of contiguous log messages to disk with a single write, so the batch is
+    // never split across logs files. The extents, if provided, must cover the whole batch in
+    // order and are used for indexing each record of the batch. While the circuit is open the
+    // batch is kept in the memory spill instead.
+    //
+    auto
+    write_log_messages_to_disk(
+        const std::string_view p_log_messages,
+        const std::span<const log_record_extent> p_log_record_extents) -> status_code;
+
+    //
+    // Writes a single log message to disk through flat combining, for concurrent sync mode
+    // callers: each caller publishes its message, and whichever caller finds no combined write
+    // in progress writes every published message with a single gathered write on behalf of
+    // the others, then releases them. Returns once the message was handed over to the kernel,
+    // or kept in the memory spill, with the status of the write that carried it.
+    //
+    auto
+    write_log_message_combined(
+        const std::string_view p_log_message,
+        const log_record_metadata& p_log_record_metadata) -> status_code;
+
+    //
+    // Blocks until every log message written before the call is on stable storage.
+    // Concurrent callers are grouped so that a single fdatasync covers all of them:
+    // one caller syncs on behalf of the group while the others wait for its result.
+    // Fails right away while the circuit is open.
+    //
+    auto
+    wait_for_durability() -> status_code;
+
+    //
+    // Creates the logging session directory and the first logs file ahead of the first write,
+    // so that it does not pay for them. Writes still create both on their own when missing.
+    //
+    auto
+    prepare() -> status_code;
+
+    //
+    // Writes out the data buffered by the writer. Only applies for direct I/O mode.
+    //
+    auto
+    flush() -> status_code;
+
+    //
+    // Allocates the next sequence numbers of the records written by this writer,
+    // consecutive when several are requested, and returns the first of them. Numbers are
+    // unique across the writer and increase within a thread, but are handed out to threads
+    // in blocks so that the shared counter is only touched once per block: a block starts
+    // at a multiple of the block size and the numbers left unused at its end when the
+    // thread exits or moves on, or when the writer is destroyed, are never written. Those
+    // are accounted for in the sequence ledger of the writer.
+    //
+    inline
+    auto
+    allocate_sequence_number(
+        const std::uint64_t p_records_count = 1u) -> std::uint64_t
+    {
+        thread_local thread_sequence_blocks sequence_blocks;
+
+        sequence_block& block = sequence_blocks.m_sequence_blocks[m_writer_id % c_sequence_block_cache_size];
+
+        if (block.m_writer_id.load(std::memory_order_relaxed) != m_writer_id ||
+            block.m_end_sequence_number - block.m_next_sequence_number < p_records_count)
+        {
+            refill_sequence_block(
+                sequence_blocks,
+                block,
+                p_records_count);
+        }
+
+        const std::uint64_t sequence_number = block.m_next_sequence_number;
+        block.m_next_sequence_number += p_records_count;
+
+        return sequence_number;
+    }
+
+    //
+    // Count of sequence numbers in a block handed out to a thread.
+    //
+    static constexpr std::uint64_t c_sequence_block_records_count = 64u;
+
+    //
+    // Accounts in the sequence ledger for numbers handed out by this writer that will never be
+    // written, such as those of the records evicted or shed on purpose.
+    //
+    auto
+    retire_sequence_numbers(
+        const std::uint64_t p_first_sequence_number,
+        const std::uint64_t p_records_count,
+        const sequence_retirement_reason p_reason) -> void;
+
+    //
+    // Takes the sequence blocks lock right before a fork so that the child inherits consistent blocks.
+    //
+    static
+    auto
+    prepare_fork() -> void;
+
+    //
+    // Releases the sequence blocks lock in the parent process after a fork.
+    //
+    static
+    auto
+    complete_fork_in_parent() -> void;
+
+    //
+    // Releases the sequence blocks lock in the child process after a fork. The blocks of the
+    // threads of the parent stay registered; their storage is never released in the child.
+    //
+    static
+    auto
+    complete_fork_in_child() -> void;
 
 private:
 
+    //
+    // Sequence numbers of a writer held by a thread. The writer identifier is only changed
+    // under the sequence blocks lock, so that a destroyed writer can take back its blocks.
+    //
+    struct sequence_block
+    {
+
+        std::atomic<std::uint64_t> m_writer_id {0u};
+
+        std::uint64_t m_next_sequence_number {0u};
+
+        std::uint64_t m_end_sequence_number {0u};
+
+    };
+
+    //
+    // Count of writers whose blocks a thread holds at once, e.g. for the default and a named instance.
+    //
+    static constexpr std::size_t c_sequence_block_cache_size = 4u;
+
+    //
+    // Blocks held by a thread. Registered on the first block of the thread, and accounts for
+    // the unused tails of its blocks when the thread exits.
+    //
+    struct thread_sequence_blocks
+    {
+
+        ~thread_sequence_blocks();
+
+        std::array<sequence_block, c_sequence_block_cache_size> m_sequence_blocks;
+
+        bool m_registered {false};
+
+    };
+
+    //
+    // Hands a new block of this writer to the calling thread, accounting for the unused
+    // tail of the block it replaces.
+    //
+    auto
+    refill_sequence_block(
+        thread_sequence_blocks& p_thread_sequence_blocks,
+        sequence_block& p_sequence_block,
+        const std::uint64_t p_records_count) -> void;
+
+    //
+    // Accounts for the unused tail of a block in the ledger of its writer, if still alive,
+    // and releases the block. Caller must hold the sequence blocks lock.
+    //
+    static
+    auto
+    release_sequence_block(
+        sequence_block& p_sequence_block) -> void;
+
+    //
+    // Gets a unique identifier for a new writer; never zero, never reused.
+    //
+    static
+    auto
+    allocate_writer_id() -> std::uint64_t;
+
+    //
+    // Gets the writers alive in the process, for accounting for the blocks released by threads.
+    //
+    static
+    auto
+    get_live_writers() -> std::vector<filesystem_writer*>&;
+
+    //
+    // Gets the blocks of every thread that took one, for a destroyed writer to take back its own.
+    //
+    static
+    auto
+    get_registered_thread_sequence_blocks() -> std::vector<thread_sequence_blocks*>&;
+
+    //
+    // Gets the lock for synchronizing the live writers, the registered blocks and the writers of the blocks.
+    //
+    static
+    auto
+    get_sequence_blocks_lock() -> std::mutex&;
+
+    //
+    // Batch of log messages kept in memory while the circuit is open.
+    //
+    struct spilled_log_messages
+    {
+
+        std::string m_log_messages;
+
+        std::vector<log_record_extent> m_log_record_extents;
+
+    };
+
+    //
+    // Log message published for a combined write. Lives on the stack of its caller.
+    // The completion flag and status are guarded by the combining lock.
+    //
+    struct combined_write_request
+    {
+
+        const std::string_view m_log_message;
+
+        const log_record_metadata m_metadata;
+
+        status_code m_status;
+
+        bool m_completed;
+
+    };
+
+    //
+    // Writes a batch of log messages, given as the pieces to gather, with a single write,
+    // keeping it in the memory spill instead while the circuit is open.
+    //
+    auto
+    write_gathered_log_messages_to_disk(
+        const std::span<const iovec> p_log_messages,
+        const std::span<const log_record_extent> p_log_record_extents) -> status_code;
+
+    //
+    // Writes a batch of log messages to the pointed logs file, rotating it and retrying on failures.
+    // With the circuit breaker enabled, every failed attempt series is counted as a failure and
+    // the write gives up as soon as the circuit is open or the failures reach the threshold.
+    //
+    auto
+    write_log_messages_to_pointed_logs_file(
+        const std::span<const iovec> p_log_messages,
+        const std::span<const log_record_extent> p_log_record_extents,
+        const bool p_circuit_breaker_enabled) -> status_code;
+
+    //
+    // Keeps a batch of log messages in the memory spill, opening the circuit first when requested.
+    // Writes the batch to disk instead if the circuit was closed in the meantime.
+    //
+    auto
+    spill_log_messages(
+        const std::string_view p_log_messages,
+        const std::span<const log_record_extent> p_log_record_extents,
+        const bool p_circuit_open_requested) -> status_code;
+
+    //
+    // Recovery loop run by the recovery thread while the circuit is open. Replays the memory
+    // spill with exponential backoff between attempts and closes the circuit once it is empty.
+    //
+    auto
+    recovery_loop() -> void;
+
+    //
+    // Writes the memory spill to disk in order, stopping at the first failure.
+    // Caller must hold the circuit lock, which is released during the writes.
+    //
+    auto
+    replay_memory_spill(
+        std::unique_lock<std::mutex>& p_circuit_lock) -> bool;
+
+    //
+    // Reports a circuit transition through syslog, when enabled.
+    //
+    auto
+    report_circuit_transition(
+        const int p_priority,
+        const std::string& p_message) const -> void;
+
+    //
+    // Counts the records of a batch of log messages.
+    //
+    static
+    auto
+    get_records_count(
+        const std::string_view p_log_messages,
+        const std::span<const log_record_extent> p_log_record_extents) -> std::uint64_t;
+
     //
     // Generates the curently pointed logs file path.
     //
@@ -48,21 +391,54 @@ private:
     get_pointed_logs_file_path() const -> std::filesystem::path;
 
     //
-    // Creates and/or appends data to the specified file.
+    // Creates and/or appends data to the specified file, gathered from the given pieces.
     //
     static
     auto
     write_to_file(
         const std::filesystem::path& p_file_path,
-        const char* p_data_buffer) -> status_code;
+        const std::span<const iovec> p_data_buffers) -> status_code;
 
     //
-    // Gets the size of a file in MiB.
+    // Syncs the data of every logs file written since the previous sync.
+    //
+    auto
+    sync_logs_files() -> status_code;
+
+    //
+    // Syncs the data of a file, or the metadata too when requested.
     //
     static
     auto
-    get_file_size_in_mib(
-        const std::filesystem::path& p_file_path) -> std::optional<std::uint32_t>;
+    sync_file(
+        const std::filesystem::path& p_file_path,
+        const bool p_metadata_sync_required) -> status_code;
+
+    //
+    // Gets the size of a file in bytes.
+    //
+    static
+    auto
+    get_file_size_in_bytes(
+        const std::filesystem::path& p_file_path) -> std::optional<std::uint64_t>;
+
+    //
+    // Appends data to the pointed logs file through its direct I/O file, replacing it
+    // when the pointed logs file was rotated. Caller must hold the write lock.
+    //
+    auto
+    write_to_direct_io_file(
+        const std::span<const iovec> p_data_buffers) -> status_code;
+
+    //
+    // Adds a record written to the pointed logs file to its sidecar index.
+    // Caller must hold the write lock.
+    //
+    auto
+    index_log_message(
+        const log_record_metadata& p_log_record_metadata,
+        const std::uint64_t p_offset_bytes,
+        const std::uint64_t p_size_bytes) -> void;
 
     //
     // Logs files extension.
@@ -74,6 +450,11 @@ private:
     //
     static constexpr std::uint8_t c_max_logs_file_size_mib = 10u;
 
+    //
+    // Max size in bytes for individual logs files.
+    //
+    static constexpr std::uint64_t c_max_logs_file_size_bytes = c_max_logs_file_size_mib * 1024u * 1024u;
+
     //
     // Max retries count for incremental search for logging.
     //
@@ -84,6 +465,18 @@ private:
     //
     static constexpr std::uint8_t c_max_logs_writing_attempts_retry_count = 10u;
 
+    //
+    // Count of consecutive failed write attempt series that opens the circuit.
+    //
+    static constexpr std::uint32_t c_circuit_failure_threshold = 3u;
+
+    //
+    // Bounds of the backoff between recovery probes while the circuit is open.
+    //
+    static constexpr std::chrono::milliseconds c_min_recovery_backoff {100};
+
+    static constexpr std::chrono::milliseconds c_max_recovery_backoff {10'000};
+
     //
     // Logging session identifier.
     //
@@ -109,6 +502,165 @@ private:
     //
     mutable std::mutex m_pointed_logs_file_lock;
 
+    //
+    // Flag for determining if segments get a sidecar index.
+    //
+    const bool m_segment_index_enabled;
+
+    //
+    // Records per sidecar index block.
+    //
+    const std::uint32_t m_segment_index_block_record_count;
+
+    //
+    // Sidecar index of the pointed logs file. Only used when indexing is enabled.
+    //
+    std::unique_ptr<segment_index> m_segment_index;
+
+    //
+    // Flag for determining if logs files are written through O_DIRECT.
+    //
+    const bool m_direct_io_enabled;
+
+    //
+    // Direct I/O file of the pointed logs file. Only used in direct I/O mode.
+    //
+    std::unique_ptr<direct_io_file> m_direct_io_file;
+
+    //
+    // Lock for serializing writes so that record offsets are exact and the direct I/O
+    // buffers have a single writer. Only taken when indexing or direct I/O is enabled.
+    //
+    std::mutex m_write_lock;
+
+    //
+    // Logs files rotated away from since the previous sync.
+    // Synchronized through the pointed logs file lock.
+    //
+    std::vector<std::filesystem::path> m_unsynced_logs_file_paths;
+
+    //
+    // Path to the pointed logs file on the previous sync. Only accessed by the sync leader.
+    //
+    std::filesystem::path m_synced_logs_file_path;
+
+    //
+    // Count of durability requests made so far.
+    //
+    std::uint64_t m_durability_requests_count;
+
+    //
+    // Count of durability requests covered by a completed sync.
+    //
+    std::uint64_t m_synced_durability_requests_count;
+
+    //
+    // Flag for determining whether a group sync is running.
+    //
+    bool m_sync_in_progress;
+
+    //
+    // Status of the last completed group sync.
+    //
+    status_code m_last_sync_status;
+
+    //
+    // Lock and condition variable for grouping durability requests.
+    //
+    std::mutex m_durability_lock;
+
+    std::condition_variable m_durability_condition;
+
+    //
+    // Identifier of the writer, tying the per-thread sequence blocks to it.
+    //
+    const std::uint64_t m_writer_id;
+
+    //
+    // Next record sequence number not yet handed out in a block.
+    //
+    std::atomic<std::uint64_t> m_next_sequence_number;
+
+    //
+    // Ledger of the sequence numbers handed out and never written.
+    //
+    sequence_ledger m_sequence_ledger;
+
+    //
+    // Flag for determining if failures are reported through syslog.
+    //
+    const bool m_log_to_syslog_on_failure;
+
+    //
+    // Flag for determining whether the circuit is open, in which case the disk is not touched.
+    // Only set under the circuit lock.
+    //
+    std::atomic<bool> m_circuit_open;
+
+    //
+    // Count of consecutive failed writes while the circuit is closed.
+    //
+    std::atomic<std::uint32_t> m_consecutive_failures_count;
+
+    //
+    // Batches of log messages waiting for the disk to recover, in write order.
+    //
+    std::deque<spilled_log_messages> m_memory_spill;
+
+    //
+    // Size in bytes of the memory spill and its bound.
+    //
+    std::uint64_t m_memory_spill_size_bytes;
+
+    const std::uint64_t m_max_memory_spill_size_bytes;
+
+    //
+    // Counts of records spilled to memory and dropped since the circuit opened.
+    //
+    std::uint64_t m_spilled_records_count;
+
+    std::uint64_t m_dropped_records_count;
+
+    //
+    // Lock and condition variable for the circuit state, the memory spill and the recovery thread.
+    //
+    std::mutex m_circuit_lock;
+
+    std::condition_variable m_circuit_condition;
+
+    //
+    // Flag for signaling the recovery thread to exit.
+    //
+    bool m_stop_requested;
+
+    //
+    // Recovery thread. Only runs while the circuit is open.
+    //
+    std::thread m_recovery_thread;
+
+    //
+    // Max count of log messages carried by a combined write; the limit of a gathered write.
+    //
+    static constexpr std::size_t c_max_combined_write_requests_count = IOV_MAX;
+
+    //
+    // Lock and condition variable for publishing log messages to be combined and for
+    // releasing their callers once written.
+    //
+    std::mutex m_combining_lock;
+
+    std::condition_variable m_combining_condition;
+
+    //
+    // Log messages published and not yet taken by a combined write, in publishing order.
+    //
+    std::vector<combined_write_request*> m_pending_write_requests;
+
+    //
+    // Flag for determining whether a caller is writing a combined write.
+    //
+    bool m_combined_write_in_progress;
+
 };
 
 } // namespace echo.
\ No newline at end of file
@@ -0,0 +1,397 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'flight_recorder.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <array>
+#include <iterator>
+#include <algorithm>
+#include "flight_recorder.hh"
+
+namespace echo
+{
+
+flight_recorder::flight_recorder(
+    const std::uint64_t p_ring_capacity_bytes,
+    const bool p_per_thread_rings_enabled,
+    eviction_callback p_eviction_callback)
+    : m_recorder_id{allocate_recorder_id()},
+      m_ring_capacity_bytes{p_ring_capacity_bytes},
+      m_per_thread_rings_enabled{p_per_thread_rings_enabled},
+      m_eviction_callback{std::move(p_eviction_callback)},
+      m_shared_ring{p_ring_capacity_bytes}
+{}
+
+flight_recorder::~flight_recorder()
+{
+    std::vector<flight_record> held_records;
+
+    drain(held_records);
+
+    std::vector<evicted_sequence_range> held_ranges;
+    held_ranges.reserve(held_records.size());
+
+    for (const flight_record& held_record : held_records)
+    {
+        held_ranges.push_back(evicted_sequence_range{held_record.m_sequence_number, 1u});
+    }
+
+    coalesce_evicted_ranges(held_ranges);
+
+    for (const evicted_sequence_range& held_range : held_ranges)
+    {
+        m_eviction_callback(held_range.m_first_sequence_number, held_range.m_records_count);
+    }
+}
+
+auto
+flight_recorder::record(
+    flight_record&& p_flight_record) -> void
+{
+    flight_ring& ring = m_per_thread_rings_enabled ? get_thread_ring() : m_shared_ring;
+
+    if (ring.record(std::move(p_flight_record)))
+    {
+        collect_evicted_ranges(ring);
+    }
+}
+
+auto
+flight_recorder::drain(
+    std::vector<flight_record>& p_flight_records) -> void
+{
+    const std::size_t first_record_index = p_flight_records.size();
+    std::vector<evicted_sequence_range> evicted_ranges;
+
+    if (!m_per_thread_rings_enabled)
+    {
+        m_shared_ring.drain(p_flight_records, evicted_ranges);
+    }
+    else
+    {
+        std::scoped_lock<std::mutex> lock {m_thread_rings_lock};
+
+        for (const std::shared_ptr<flight_ring>& thread_ring : m_thread_rings)
+        {
+            thread_ring->drain(p_flight_records, evicted_ranges);
+        }
+
+        //
+        // The rings of exited threads are empty now and no longer needed.
+        //
+        std::erase_if(m_thread_rings, [](const std::shared_ptr<flight_ring>& p_flight_ring)
+        {
+            return p_flight_ring->is_thread_exited();
+        });
+    }
+
+    {
+        std::scoped_lock<std::mutex> lock {m_evicted_ranges_lock};
+
+        evicted_ranges.insert(evicted_ranges.end(), m_evicted_ranges.begin(), m_evicted_ranges.end());
+        m_evicted_ranges.clear();
+    }
+
+    coalesce_evicted_ranges(evicted_ranges);
+
+    for (const evicted_sequence_range& evicted_range : evicted_ranges)
+    {
+        m_eviction_callback(evicted_range.m_first_sequence_number, evicted_range.m_records_count);
+    }
+
+    //
+    // Threads can hold a sequence number for a while before recording, so even a single ring is not always in order.
+    //
+    std::stable_sort(
+        p_flight_records.begin() + first_record_index,
+        p_flight_records.end(),
+        [](const flight_record& p_left, const flight_record& p_right)
+        {
+            return p_left.m_sequence_number < p_right.m_sequence_number;
+        });
+}
+
+auto
+flight_recorder::get_dump_lock() -> std::mutex&
+{
+    return m_dump_lock;
+}
+
+auto
+flight_recorder::get_ring_capacity_bytes() const -> std::uint64_t
+{
+    return m_ring_capacity_bytes;
+}
+
+auto
+flight_recorder::are_per_thread_rings_enabled() const -> bool
+{
+    return m_per_thread_rings_enabled;
+}
+
+flight_recorder::flight_ring::flight_ring(
+    const std::uint64_t p_capacity_bytes)
+    : m_capacity_bytes{p_capacity_bytes},
+      m_size_bytes{0u},
+      m_thread_exited{false}
+{}
+
+auto
+flight_recorder::flight_ring::record(
+    flight_record&& p_flight_record) -> bool
+{
+    std::scoped_lock<std::mutex> lock {m_lock};
+
+    m_size_bytes += p_flight_record.m_log_message.size();
+    m_records.push_back(std::move(p_flight_record));
+
+    //
+    // The newest record is always kept, even if larger than the whole ring.
+    //
+    while (m_size_bytes > m_capacity_bytes &&
+        m_records.size() > 1u)
+    {
+        const std::uint64_t sequence_number = m_records.front().m_sequence_number;
+
+        m_size_bytes -= m_records.front().m_log_message.size();
+        m_records.pop_front();
+
+        //
+        // Numbers come in blocks per thread, so evictions mostly extend one of the latest ranges.
+        //
+        const auto open_ranges_begin = m_evicted_ranges.end() - std::min(m_evicted_ranges.size(), c_open_evicted_ranges_count);
+
+        const auto open_range = std::find_if(
+            std::make_reverse_iterator(m_evicted_ranges.end()),
+            std::make_reverse_iterator(open_ranges_begin),
+            [sequence_number](const evicted_sequence_range& p_evicted_range)
+            {
+                return p_evicted_range.m_first_sequence_number + p_evicted_range.m_records_count == sequence_number;
+            });
+
+        if (open_range != std::make_reverse_iterator(open_ranges_begin))
+        {
+            ++open_range->m_records_count;
+        }
+        else
+        {
+            m_evicted_ranges.push_back(evicted_sequence_range{sequence_number, 1u});
+        }
+    }
+
+    return m_evicted_ranges.size() >= c_max_ring_evicted_ranges_count;
+}
+
+auto
+flight_recorder::flight_ring::drain(
+    std::vector<flight_record>& p_flight_records,
+    std::vector<evicted_sequence_range>& p_evicted_ranges) -> void
+{
+    std::deque<flight_record> records;
+    std::vector<evicted_sequence_range> evicted_ranges;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_lock};
+
+        records.swap(m_records);
+        evicted_ranges.swap(m_evicted_ranges);
+        m_size_bytes = 0u;
+    }
+
+    std::move(records.begin(), records.end(), std::back_inserter(p_flight_records));
+    p_evicted_ranges.insert(p_evicted_ranges.end(), evicted_ranges.begin(), evicted_ranges.end());
+}
+
+auto
+flight_recorder::flight_ring::take_evicted_ranges(
+    std::vector<evicted_sequence_range>& p_evicted_ranges) -> void
+{
+    std::scoped_lock<std::mutex> lock {m_lock};
+
+    p_evicted_ranges.swap(m_evicted_ranges);
+}
+
+auto
+flight_recorder::flight_ring::mark_thread_exited() -> void
+{
+    m_thread_exited.store(true, std::memory_order_release);
+}
+
+auto
+flight_recorder::flight_ring::is_thread_exited() const -> bool
+{
+    return m_thread_exited.load(std::memory_order_acquire);
+}
+
+flight_recorder::thread_rings_owner::~thread_rings_owner()
+{
+    for (const std::shared_ptr<flight_ring>& thread_ring : m_flight_rings)
+    {
+        thread_ring->mark_thread_exited();
+    }
+}
+
+auto
+flight_recorder::get_thread_ring() -> flight_ring&
+{
+    thread_local std::array<thread_ring_entry, c_thread_ring_cache_size> thread_ring_cache {};
+
+    thread_ring_entry& entry = thread_ring_cache[m_recorder_id % c_thread_ring_cache_size];
+
+    if (entry.m_recorder_id != m_recorder_id)
+    {
+        entry = thread_ring_entry{m_recorder_id, &register_thread_ring()};
+    }
+
+    return *entry.m_flight_ring;
+}
+
+auto
+flight_recorder::register_thread_ring() -> flight_ring&
+{
+    thread_local thread_rings_owner owner;
+
+    //
+    // Rings only referenced by their owner thread belong to recorders that are gone.
+    //
+    std::erase_if(owner.m_flight_rings, [](const std::shared_ptr<flight_ring>& p_flight_ring)
+    {
+        return p_flight_ring.use_count() == 1;
+    });
+
+    //
+    // A recorder whose cached entry was evicted by another one finds its ring again here.
+    //
+    std::scoped_lock<std::mutex> lock {m_thread_rings_lock};
+
+    for (const std::shared_ptr<flight_ring>& owned_ring : owner.m_flight_rings)
+    {
+        if (std::find(m_thread_rings.begin(), m_thread_rings.end(), owned_ring) != m_thread_rings.end())
+        {
+            return *owned_ring;
+        }
+    }
+
+    const std::size_t exited_thread_rings_count = std::count_if(
+        m_thread_rings.begin(),
+        m_thread_rings.end(),
+        [](const std::shared_ptr<flight_ring>& p_flight_ring)
+        {
+            return p_flight_ring->is_thread_exited();
+        });
+
+    if (exited_thread_rings_count > c_max_exited_thread_rings_count)
+    {
+        //
+        // Under thread churn without dumps, the context of the oldest exited threads goes first.
+        //
+        std::size_t dropped_rings_count = exited_thread_rings_count - c_max_exited_thread_rings_count;
+        std::vector<flight_record> dropped_records;
+        std::vector<evicted_sequence_range> dropped_ranges;
+
+        std::erase_if(m_thread_rings, [&dropped_rings_count, &dropped_records, &dropped_ranges](const std::shared_ptr<flight_ring>& p_flight_ring)
+        {
+            if (dropped_rings_count == 0u ||
+                !p_flight_ring->is_thread_exited())
+            {
+                return false;
+            }
+
+            --dropped_rings_count;
+            p_flight_ring->drain(dropped_records, dropped_ranges);
+
+            return true;
+        });
+
+        //
+        // Their records are never written; they are accounted for as evicted on the next drain.
+        //
+        for (const flight_record& dropped_record : dropped_records)
+        {
+            dropped_ranges.push_back(evicted_sequence_range{dropped_record.m_sequence_number, 1u});
+        }
+
+        std::scoped_lock<std::mutex> evicted_ranges_lock {m_evicted_ranges_lock};
+
+        merge_evicted_ranges(dropped_ranges);
+    }
+
+    const std::shared_ptr<flight_ring> thread_ring = std::make_shared<flight_ring>(m_ring_capacity_bytes);
+
+    m_thread_rings.push_back(thread_ring);
+    owner.m_flight_rings.push_back(thread_ring);
+
+    return *thread_ring;
+}
+
+auto
+flight_recorder::collect_evicted_ranges(
+    flight_ring& p_flight_ring) -> void
+{
+    std::vector<evicted_sequence_range> evicted_ranges;
+
+    p_flight_ring.take_evicted_ranges(evicted_ranges);
+
+    std::scoped_lock<std::mutex> lock {m_evicted_ranges_lock};
+
+    merge_evicted_ranges(evicted_ranges);
+}
+
+auto
+flight_recorder::merge_evicted_ranges(
+    std::vector<evicted_sequence_range>& p_evicted_ranges) -> void
+{
+    //
+    // The rings evict the interleaved blocks of every thread, so together they mostly form long ranges.
+    //
+    m_evicted_ranges.insert(m_evicted_ranges.end(), p_evicted_ranges.begin(), p_evicted_ranges.end());
+
+    coalesce_evicted_ranges(m_evicted_ranges);
+}
+
+auto
+flight_recorder::coalesce_evicted_ranges(
+    std::vector<evicted_sequence_range>& p_evicted_ranges) -> void
+{
+    std::sort(
+        p_evicted_ranges.begin(),
+        p_evicted_ranges.end(),
+        [](const evicted_sequence_range& p_left, const evicted_sequence_range& p_right)
+        {
+            return p_left.m_first_sequence_number < p_right.m_first_sequence_number;
+        });
+
+    std::size_t coalesced_ranges_count = 0u;
+
+    for (const evicted_sequence_range& evicted_range : p_evicted_ranges)
+    {
+        if (coalesced_ranges_count != 0u)
+        {
+            evicted_sequence_range& last_range = p_evicted_ranges[coalesced_ranges_count - 1u];
+
+            if (last_range.m_first_sequence_number + last_range.m_records_count == evicted_range.m_first_sequence_number)
+            {
+                last_range.m_records_count += evicted_range.m_records_count;
+
+                continue;
+            }
+        }
+
+        p_evicted_ranges[coalesced_ranges_count++] = evicted_range;
+    }
+
+    p_evicted_ranges.resize(coalesced_ranges_count);
+}
+
+auto
+flight_recorder::allocate_recorder_id() -> std::uint64_t
+{
+    static std::atomic<std::uint64_t> next_recorder_id {1u};
+
+    return next_recorder_id.fetch_add(1u, std::memory_order_relaxed);
+}
+
+} // namespace echo.
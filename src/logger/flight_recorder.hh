@@ -0,0 +1,308 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'flight_recorder.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include "segment_index.hh"
+
+namespace echo
+{
+
+//
+// Formatted record held by a flight recorder until it is dumped.
+//
+struct flight_record
+{
+
+    std::uint64_t m_sequence_number;
+
+    log_record_metadata m_metadata;
+
+    std::string m_log_message;
+
+};
+
+//
+// Range of sequence numbers of records evicted from a flight recorder.
+//
+struct evicted_sequence_range
+{
+
+    std::uint64_t m_first_sequence_number;
+
+    std::uint64_t m_records_count;
+
+};
+
+//
+// Bounded in-memory holder of the most recent records, for writing them out only around failures.
+// Records go into a single ring shared by every thread, or into a ring per thread so that a chatty
+// thread can not evict the context of the others; once a ring is over its capacity, its oldest
+// records are evicted. Ring locks are only contended while the rings are drained. Every ring
+// keeps the sequence numbers of its evicted records as ranges in memory; they are handed to the
+// eviction callback when the rings are drained, along with the records still held when the
+// recorder is destroyed, so that recording never does more than touching its own ring.
+// Thread-safe class.
+//
+class flight_recorder
+{
+
+public:
+
+    //
+    // Callback taking a range of sequence numbers of records that are never drained.
+    // Called on drains and on destruction, outside of the ring locks; must not use the recorder.
+    //
+    using eviction_callback = std::function<void(const std::uint64_t, const std::uint64_t)>;
+
+    //
+    // Constructor.
+    //
+    flight_recorder(
+        const std::uint64_t p_ring_capacity_bytes,
+        const bool p_per_thread_rings_enabled,
+        eviction_callback p_eviction_callback);
+
+    //
+    // Destructor. Accounts for the records still held as evicted.
+    //
+    ~flight_recorder();
+
+    flight_recorder(const flight_recorder&) = delete;
+
+    flight_recorder&
+    operator=(const flight_recorder&) = delete;
+
+    //
+    // Holds a record in the ring of the calling thread, or in the shared ring.
+    //
+    auto
+    record(
+        flight_record&& p_flight_record) -> void;
+
+    //
+    // Takes the records held by every ring and empties them. Records are appended to
+    // the output vector in sequence number order. The ranges evicted since the previous
+    // drain are handed to the eviction callback.
+    //
+    auto
+    drain(
+        std::vector<flight_record>& p_flight_records) -> void;
+
+    //
+    // Gets the lock serializing the dumps, so that the records of consecutive dumps reach the writers in order.
+    //
+    auto
+    get_dump_lock() -> std::mutex&;
+
+    //
+    // Gets the capacity in bytes of each ring.
+    //
+    auto
+    get_ring_capacity_bytes() const -> std::uint64_t;
+
+    //
+    // Determines whether every thread records into a ring of its own.
+    //
+    auto
+    are_per_thread_rings_enabled() const -> bool;
+
+private:
+
+    //
+    // Ring of records bounded by the size of their messages.
+    //
+    class flight_ring
+    {
+
+    public:
+
+        explicit flight_ring(
+            const std::uint64_t p_capacity_bytes);
+
+        //
+        // Holds a record, evicting the oldest ones if over capacity.
+        // Returns true once the evicted ranges of the ring should be collected.
+        //
+        auto
+        record(
+            flight_record&& p_flight_record) -> bool;
+
+        auto
+        drain(
+            std::vector<flight_record>& p_flight_records,
+            std::vector<evicted_sequence_range>& p_evicted_ranges) -> void;
+
+        //
+        // Takes the evicted ranges of the ring.
+        //
+        auto
+        take_evicted_ranges(
+            std::vector<evicted_sequence_range>& p_evicted_ranges) -> void;
+
+        //
+        // Flags the owner thread as exited.
+        //
+        auto
+        mark_thread_exited() -> void;
+
+        auto
+        is_thread_exited() const -> bool;
+
+    private:
+
+        const std::uint64_t m_capacity_bytes;
+
+        //
+        // Records from oldest to newest, and the size of their messages.
+        //
+        std::deque<flight_record> m_records;
+
+        std::uint64_t m_size_bytes;
+
+        //
+        // Sequence numbers of the evicted records, as ranges extended while contiguous.
+        //
+        std::vector<evicted_sequence_range> m_evicted_ranges;
+
+        std::mutex m_lock;
+
+        std::atomic<bool> m_thread_exited;
+
+    };
+
+    //
+    // Ring of the calling thread cached for a recorder.
+    //
+    struct thread_ring_entry
+    {
+
+        std::uint64_t m_recorder_id;
+
+        flight_ring* m_flight_ring;
+
+    };
+
+    //
+    // Per-thread owner of the rings of a thread; flags them when the thread exits so
+    // that they can be dropped once drained.
+    //
+    struct thread_rings_owner
+    {
+
+        ~thread_rings_owner();
+
+        std::vector<std::shared_ptr<flight_ring>> m_flight_rings;
+
+    };
+
+    //
+    // Gets the ring of the calling thread, creating it on its first record.
+    //
+    auto
+    get_thread_ring() -> flight_ring&;
+
+    //
+    // Creates and registers the ring of the calling thread.
+    //
+    auto
+    register_thread_ring() -> flight_ring&;
+
+    //
+    // Moves the evicted ranges of a ring to the ones of the recorder, merging them.
+    //
+    auto
+    collect_evicted_ranges(
+        flight_ring& p_flight_ring) -> void;
+
+    //
+    // Merges ranges into the evicted ranges of the recorder. Caller must hold the evicted ranges lock.
+    //
+    auto
+    merge_evicted_ranges(
+        std::vector<evicted_sequence_range>& p_evicted_ranges) -> void;
+
+    //
+    // Sorts and coalesces ranges of sequence numbers.
+    //
+    static
+    auto
+    coalesce_evicted_ranges(
+        std::vector<evicted_sequence_range>& p_evicted_ranges) -> void;
+
+    //
+    // Gets a process-wide unique identifier for a recorder, for validating the cached rings.
+    //
+    static
+    auto
+    allocate_recorder_id() -> std::uint64_t;
+
+    //
+    // Count of recorders whose ring a thread keeps cached.
+    //
+    static constexpr std::size_t c_thread_ring_cache_size = 4u;
+
+    //
+    // Max count of rings of exited threads kept until the next drain. The oldest ones are dropped beyond.
+    //
+    static constexpr std::size_t c_max_exited_thread_rings_count = 64u;
+
+    //
+    // Count of the most recent evicted ranges of a ring that an eviction can extend; a shared
+    // ring interleaves the sequence blocks of this many threads without breaking up its ranges.
+    //
+    static constexpr std::size_t c_open_evicted_ranges_count = 8u;
+
+    //
+    // Count of evicted ranges of a ring that has them collected by the recorder.
+    //
+    static constexpr std::size_t c_max_ring_evicted_ranges_count = 1024u;
+
+    const std::uint64_t m_recorder_id;
+
+    const std::uint64_t m_ring_capacity_bytes;
+
+    const bool m_per_thread_rings_enabled;
+
+    const eviction_callback m_eviction_callback;
+
+    //
+    // Ring shared by every thread. Unused with per-thread rings.
+    //
+    flight_ring m_shared_ring;
+
+    //
+    // Rings of the threads, by registration order, and their lock.
+    //
+    std::vector<std::shared_ptr<flight_ring>> m_thread_rings;
+
+    std::mutex m_thread_rings_lock;
+
+    //
+    // Evicted ranges collected from the rings since the previous drain, sorted and coalesced, and their lock.
+    //
+    std::vector<evicted_sequence_range> m_evicted_ranges;
+
+    std::mutex m_evicted_ranges_lock;
+
+    //
+    // Lock serializing the dumps.
+    //
+    std::mutex m_dump_lock;
+
+};
+
+} // namespace echo.
@@ -0,0 +1,61 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'log_batch.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include "log_batch.hh"
+
+namespace echo
+{
+
+log_batch::log_batch()
+    : m_logger{logger::get_logger()}
+{}
+
+log_batch::log_batch(
+    const named_logger& p_named_logger)
+    : m_logger{*p_named_logger.m_logger}
+{}
+
+log_batch::~log_batch()
+{
+    commit();
+}
+
+auto
+log_batch::commit() -> void
+{
+    if (m_records.empty())
+    {
+        return;
+    }
+
+    std::vector<log_batch_record> records;
+    std::vector<std::size_t> message_offsets;
+    std::string messages;
+
+    records.swap(m_records);
+    message_offsets.swap(m_message_offsets);
+    messages.swap(m_messages);
+
+    //
+    // The messages buffer no longer grows; point the records at their messages.
+    //
+    for (std::size_t record_index = 0u; record_index < records.size(); ++record_index)
+    {
+        records[record_index].m_message = messages.data() + message_offsets[record_index];
+    }
+
+    m_logger.log_batch_implementation(records);
+}
+
+auto
+log_batch::get_records_count() const -> std::size_t
+{
+    return m_records.size();
+}
+
+} // namespace echo.
@@ -0,0 +1,143 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'log_batch.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <format>
+#include <iterator>
+#include <source_location>
+#include "logger.hh"
+#include "named_logger.hh"
+#include "log_level.hh"
+#include "title_and_source_location.hh"
+
+namespace echo
+{
+
+//
+// Record collected by a log batch.
+//
+struct log_batch_record
+{
+
+    log_level m_log_level;
+
+    std::source_location m_source_location;
+
+    const char* m_title;
+
+    const char* m_message;
+
+};
+
+//
+// Scope collecting several records on the calling thread and committing them as a unit:
+// the records get consecutive sequence numbers, share the commit timestamp and reach the
+// sinks in a single operation, so they are contiguous in the segment even while other
+// threads are logging. Committed when the scope ends, or earlier through commit.
+// Duplicate suppression does not apply to batched records.
+// Not thread-safe; meant to be used by a single thread.
+//
+class log_batch
+{
+
+public:
+
+    //
+    // Constructor. Commits to the default logger instance.
+    //
+    log_batch();
+
+    //
+    // Constructor. Commits to the given named logger instance.
+    //
+    explicit log_batch(
+        const named_logger& p_named_logger);
+
+    //
+    // Destructor. Commits the pending records.
+    //
+    ~log_batch();
+
+    log_batch(const log_batch&) = delete;
+
+    log_batch&
+    operator=(const log_batch&) = delete;
+
+    //
+    // Adds a record to the batch. The message is formatted right away.
+    // Expects that the title is valid for the lifetime of the program.
+    // Generates a compile-time error on failed format validations.
+    //
+    template<typename... Args>
+    auto
+    log(
+        const log_level& p_log_level,
+        title_and_source_location p_title_and_source_location,
+        std::format_string<Args...> p_format,
+        Args&&... p_args) -> void
+    {
+        if (!m_logger.is_log_level_enabled(p_log_level))
+        {
+            //
+            // Filtered records do not pay for formatting.
+            //
+            return;
+        }
+
+        m_message_offsets.push_back(m_messages.size());
+        m_records.push_back(log_batch_record{
+            p_log_level,
+            p_title_and_source_location.m_source_location,
+            p_title_and_source_location.m_title,
+            nullptr});
+
+        std::format_to(std::back_inserter(m_messages), p_format, std::forward<Args>(p_args)...);
+        m_messages.push_back('\0');
+    }
+
+    //
+    // Commits the pending records as a unit and starts a new, empty batch.
+    // Before initialization the records are captured one by one, like with logger::log.
+    //
+    auto
+    commit() -> void;
+
+    //
+    // Gets the count of records pending in the batch.
+    //
+    auto
+    get_records_count() const -> std::size_t;
+
+private:
+
+    //
+    // Logger instance the batch commits to.
+    //
+    logger& m_logger;
+
+    //
+    // Records pending in the batch. Their messages are pointed at on commit.
+    //
+    std::vector<log_batch_record> m_records;
+
+    //
+    // Offset of the message of each pending record.
+    //
+    std::vector<std::size_t> m_message_offsets;
+
+    //
+    // NUL-terminated messages of the pending records, back to back.
+    //
+    std::string m_messages;
+
+};
+
+} // namespace echo.
@@ -0,0 +1,319 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'log_broadcaster.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <chrono>
+#include <cstring>
+#include <algorithm>
+#include "log_broadcaster.hh"
+
+namespace echo
+{
+
+log_subscription::log_subscription(
+    log_broadcaster& p_log_broadcaster,
+    const log_subscription_filter& p_filter,
+    std::function<void(const log_record&)> p_callback)
+    : m_log_broadcaster{p_log_broadcaster},
+      m_filter{p_filter},
+      m_callback{std::move(p_callback)},
+      m_fork_generation{p_log_broadcaster.register_subscriber()},
+      m_next_ticket{p_log_broadcaster.get_write_ticket()},
+      m_lagged_records_count{0u},
+      m_delivered_records_count{0u},
+      m_stop_requested{false},
+      m_delivery_thread{&log_subscription::delivery_loop, this}
+{}
+
+log_subscription::~log_subscription()
+{
+    m_stop_requested.store(true, std::memory_order_relaxed);
+
+    if (!m_log_broadcaster.unregister_subscriber(m_fork_generation, m_delivery_thread))
+    {
+        //
+        // Inherited from the parent; the broadcaster took over the handle of the delivery thread.
+        //
+        return;
+    }
+
+    m_delivery_thread.join();
+}
+
+auto
+log_subscription::get_lagged_records_count() const -> std::uint64_t
+{
+    return m_lagged_records_count.load(std::memory_order_relaxed);
+}
+
+auto
+log_subscription::get_delivered_records_count() const -> std::uint64_t
+{
+    return m_delivered_records_count.load(std::memory_order_relaxed);
+}
+
+auto
+log_subscription::delivery_loop() -> void
+{
+    char message_buffer[log_broadcaster::c_max_message_size_bytes];
+    log_record record {};
+
+    while (!m_stop_requested.load(std::memory_order_relaxed))
+    {
+        const std::uint64_t write_ticket = m_log_broadcaster.get_write_ticket();
+
+        if (write_ticket - m_next_ticket > log_broadcaster::c_slots_count)
+        {
+            //
+            // More than a full ring lap behind; everything older has been overwritten.
+            //
+            const std::uint64_t oldest_available_ticket = write_ticket - log_broadcaster::c_slots_count;
+            m_lagged_records_count.fetch_add(oldest_available_ticket - m_next_ticket, std::memory_order_relaxed);
+            m_next_ticket = oldest_available_ticket;
+        }
+
+        switch (m_log_broadcaster.read(m_next_ticket, record, message_buffer))
+        {
+            case log_broadcaster::read_result::ready:
+            {
+                ++m_next_ticket;
+
+                if (record.m_log_level < m_filter.m_minimum_log_level ||
+                    (m_filter.m_title.has_value() && m_filter.m_title.value() != record.m_title))
+                {
+                    break;
+                }
+
+                try
+                {
+                    m_callback(record);
+                }
+                catch (const std::exception& p_exception)
+                {
+                    //
+                    // Subscriber failures must not stop the delivery.
+                    //
+                }
+
+                m_delivered_records_count.fetch_add(1u, std::memory_order_relaxed);
+
+                break;
+            }
+            case log_broadcaster::read_result::lost:
+            {
+                ++m_next_ticket;
+                m_lagged_records_count.fetch_add(1u, std::memory_order_relaxed);
+
+                break;
+            }
+            case log_broadcaster::read_result::pending:
+            {
+                std::this_thread::sleep_for(std::chrono::microseconds(c_idle_polling_interval_us));
+
+                break;
+            }
+        }
+    }
+}
+
+log_broadcaster::log_broadcaster()
+    : m_slots{nullptr},
+      m_slots_storage{nullptr},
+      m_write_ticket{0u},
+      m_subscribers_count{0u},
+      m_fork_generation{0u}
+{}
+
+log_broadcaster::~log_broadcaster()
+{
+    for (std::thread& inherited_delivery_thread : m_inherited_delivery_threads)
+    {
+        //
+        // The thread only ran in an ancestor process and never exits in this one, so
+        // detaching just marks its handle; nothing is waited for nor released.
+        //
+        inherited_delivery_thread.detach();
+    }
+}
+
+auto
+log_broadcaster::publish(
+    const std::uint64_t p_timestamp_ns,
+    const log_level p_log_level,
+    const char* p_title,
+    const std::string_view p_log_message) -> void
+{
+    slot* slots = m_slots.load(std::memory_order_acquire);
+
+    if (slots == nullptr)
+    {
+        return;
+    }
+
+    const std::uint64_t ticket = m_write_ticket.fetch_add(1u, std::memory_order_relaxed);
+    slot& target_slot = slots[ticket & (c_slots_count - 1u)];
+    std::uint64_t sequence = target_slot.m_sequence.load(std::memory_order_relaxed);
+
+    do
+    {
+        if ((sequence & 1u) != 0u ||
+            sequence >= 2u * (ticket + 1u))
+        {
+            //
+            // Another producer is still writing this slot a lap behind, or a newer ticket already
+            // took it. Never wait; subscribers account for the missing ticket as lag.
+            //
+            return;
+        }
+    }
+    while (!target_slot.m_sequence.compare_exchange_weak(
+        sequence,
+        2u * ticket + 1u,
+        std::memory_order_relaxed));
+
+    std::atomic_thread_fence(std::memory_order_release);
+
+    const std::size_t message_size = std::min<std::size_t>(p_log_message.size(), c_max_message_size_bytes);
+
+    target_slot.m_timestamp_ns = p_timestamp_ns;
+    target_slot.m_title = p_title;
+    target_slot.m_log_level = p_log_level;
+    target_slot.m_message_size_bytes = static_cast<std::uint32_t>(message_size);
+    std::memcpy(target_slot.m_message, p_log_message.data(), message_size);
+
+    target_slot.m_sequence.store(2u * (ticket + 1u), std::memory_order_release);
+}
+
+auto
+log_broadcaster::subscribe(
+    const log_subscription_filter& p_filter,
+    std::function<void(const log_record&)> p_callback) -> std::unique_ptr<log_subscription>
+{
+    {
+        std::scoped_lock<std::mutex> lock {m_allocation_lock};
+
+        if (m_slots_storage == nullptr)
+        {
+            //
+            // Producers may observe the ring as soon as it is published; the slots
+            // start zeroed, which no published ticket sequence can match.
+            //
+            m_slots_storage = std::make_unique<slot[]>(c_slots_count);
+            m_slots.store(m_slots_storage.get(), std::memory_order_release);
+        }
+    }
+
+    return std::make_unique<log_subscription>(
+        *this,
+        p_filter,
+        std::move(p_callback));
+}
+
+auto
+log_broadcaster::read(
+    const std::uint64_t p_ticket,
+    log_record& p_log_record,
+    char* p_message_buffer) const -> read_result
+{
+    const slot& source_slot = m_slots.load(std::memory_order_acquire)[p_ticket & (c_slots_count - 1u)];
+    const std::uint64_t published_sequence = 2u * (p_ticket + 1u);
+    const std::uint64_t sequence = source_slot.m_sequence.load(std::memory_order_acquire);
+
+    if (sequence > published_sequence)
+    {
+        return read_result::lost;
+    }
+
+    if (sequence < published_sequence)
+    {
+        //
+        // A producer that could not take the slot drops its ticket; stop waiting for
+        // it once the producers are far enough ahead that it cannot be in flight anymore.
+        //
+        return get_write_ticket() - p_ticket > c_slots_count / 2u ?
+            read_result::lost :
+            read_result::pending;
+    }
+
+    p_log_record.m_timestamp_ns = source_slot.m_timestamp_ns;
+    p_log_record.m_title = source_slot.m_title;
+    p_log_record.m_log_level = source_slot.m_log_level;
+
+    const std::uint32_t message_size = std::min(source_slot.m_message_size_bytes, c_max_message_size_bytes);
+    std::memcpy(p_message_buffer, source_slot.m_message, message_size);
+    p_log_record.m_log_message = std::string_view(p_message_buffer, message_size);
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (source_slot.m_sequence.load(std::memory_order_relaxed) != published_sequence)
+    {
+        //
+        // A producer lapped the subscriber while it was copying the slot.
+        //
+        return read_result::lost;
+    }
+
+    return read_result::ready;
+}
+
+auto
+log_broadcaster::get_write_ticket() const -> std::uint64_t
+{
+    return m_write_ticket.load(std::memory_order_acquire);
+}
+
+auto
+log_broadcaster::prepare_fork() -> void
+{
+    m_allocation_lock.lock();
+}
+
+auto
+log_broadcaster::complete_fork_in_parent() -> void
+{
+    m_allocation_lock.unlock();
+}
+
+auto
+log_broadcaster::complete_fork_in_child() -> void
+{
+    m_subscribers_count.store(0u, std::memory_order_relaxed);
+    ++m_fork_generation;
+
+    m_allocation_lock.unlock();
+}
+
+auto
+log_broadcaster::register_subscriber() -> std::uint64_t
+{
+    std::scoped_lock<std::mutex> lock {m_allocation_lock};
+
+    m_subscribers_count.fetch_add(1u, std::memory_order_relaxed);
+
+    return m_fork_generation;
+}
+
+auto
+log_broadcaster::unregister_subscriber(
+    const std::uint64_t p_fork_generation,
+    std::thread& p_delivery_thread) -> bool
+{
+    std::scoped_lock<std::mutex> lock {m_allocation_lock};
+
+    if (p_fork_generation != m_fork_generation)
+    {
+        m_inherited_delivery_threads.push_back(std::move(p_delivery_thread));
+
+        return false;
+    }
+
+    m_subscribers_count.fetch_sub(1u, std::memory_order_relaxed);
+
+    return true;
+}
+
+} // namespace echo.
@@ -0,0 +1,374 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'log_broadcaster.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <functional>
+#include <string_view>
+#include "log_level.hh"
+
+namespace echo
+{
+
+class log_broadcaster;
+
+//
+// Log record delivered to live subscribers.
+// The views are only valid for the duration of the callback.
+//
+struct log_record
+{
+
+    //
+    // Wall-clock timestamp in nanoseconds of the record.
+    //
+    std::uint64_t m_timestamp_ns;
+
+    //
+    // Level of the record.
+    //
+    log_level m_log_level;
+
+    //
+    // Title of the record.
+    //
+    const char* m_title;
+
+    //
+    // Fully formatted log message. Truncated if longer than the broadcast slot capacity.
+    //
+    std::string_view m_log_message;
+
+};
+
+//
+// Filter applied to the records delivered to a subscriber.
+//
+struct log_subscription_filter
+{
+
+    //
+    // Lowest level delivered to the subscriber.
+    //
+    log_level m_minimum_log_level = log_level::info;
+
+    //
+    // Title delivered to the subscriber. Every title is delivered if not set.
+    //
+    std::optional<std::string> m_title;
+
+};
+
+//
+// Live subscription to the records produced by the logger.
+// Records are delivered on a dedicated thread owned by the subscription.
+// Destroying the subscription stops the delivery.
+//
+class log_subscription
+{
+
+public:
+
+    //
+    // Constructor. Delivery starts with the records produced after this point.
+    //
+    log_subscription(
+        log_broadcaster& p_log_broadcaster,
+        const log_subscription_filter& p_filter,
+        std::function<void(const log_record&)> p_callback);
+
+    //
+    // Destructor. Stops the delivery thread. A subscription inherited by a child process
+    // after a fork has no delivery thread there; its handle is handed over to the broadcaster.
+    //
+    ~log_subscription();
+
+    log_subscription(const log_subscription&) = delete;
+
+    log_subscription&
+    operator=(const log_subscription&) = delete;
+
+    //
+    // Gets the count of records the subscriber missed because it fell behind the producers.
+    //
+    auto
+    get_lagged_records_count() const -> std::uint64_t;
+
+    //
+    // Gets the count of records delivered to the callback.
+    //
+    auto
+    get_delivered_records_count() const -> std::uint64_t;
+
+private:
+
+    //
+    // Delivery loop run by the subscription thread.
+    //
+    auto
+    delivery_loop() -> void;
+
+    //
+    // Polling interval in microseconds when no new records are available.
+    //
+    static constexpr std::uint32_t c_idle_polling_interval_us = 1'000u;
+
+    //
+    // Broadcaster the subscription reads from.
+    //
+    log_broadcaster& m_log_broadcaster;
+
+    //
+    // Filter for the delivered records.
+    //
+    const log_subscription_filter m_filter;
+
+    //
+    // Callback invoked for every delivered record.
+    //
+    const std::function<void(const log_record&)> m_callback;
+
+    //
+    // Fork generation of the broadcaster when the subscription was registered.
+    //
+    const std::uint64_t m_fork_generation;
+
+    //
+    // Next ticket to be read from the ring.
+    //
+    std::uint64_t m_next_ticket;
+
+    //
+    // Count of missed records.
+    //
+    std::atomic<std::uint64_t> m_lagged_records_count;
+
+    //
+    // Count of delivered records.
+    //
+    std::atomic<std::uint64_t> m_delivered_records_count;
+
+    //
+    // Flag for signaling the delivery thread to exit.
+    //
+    std::atomic<bool> m_stop_requested;
+
+    //
+    // Delivery thread.
+    //
+    std::thread m_delivery_thread;
+
+};
+
+//
+// Lock-free, fixed-capacity broadcast ring fanning out log records to live subscribers.
+// Producers never wait for subscribers; a subscriber that falls more than a ring lap behind
+// skips the overwritten records and accounts for them in its lag counter. The ring is only
+// allocated on the first subscription, and producers only pay for a relaxed load while
+// there are no subscribers.
+//
+class log_broadcaster
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    log_broadcaster();
+
+    //
+    // Destructor. Releases the delivery thread handles inherited from the parent process.
+    //
+    ~log_broadcaster();
+
+    //
+    // Determines whether there is at least one live subscriber.
+    //
+    inline
+    auto
+    has_subscribers() const -> bool
+    {
+        return m_subscribers_count.load(std::memory_order_relaxed) != 0u;
+    }
+
+    //
+    // Publishes a record to the live subscribers. Lock-free and wait-free for producers.
+    //
+    auto
+    publish(
+        const std::uint64_t p_timestamp_ns,
+        const log_level p_log_level,
+        const char* p_title,
+        const std::string_view p_log_message) -> void;
+
+    //
+    // Registers a new live subscriber.
+    //
+    auto
+    subscribe(
+        const log_subscription_filter& p_filter,
+        std::function<void(const log_record&)> p_callback) -> std::unique_ptr<log_subscription>;
+
+    //
+    // Takes the allocation lock right before a fork so that the child inherits a consistent ring.
+    //
+    auto
+    prepare_fork() -> void;
+
+    //
+    // Releases the allocation lock in the parent process after a fork.
+    //
+    auto
+    complete_fork_in_parent() -> void;
+
+    //
+    // Drops the subscribers in the child process after a fork: their delivery threads do not
+    // exist in the child. The subscriptions inherited from the parent are told apart by the
+    // fork generation, which the child starts anew.
+    //
+    auto
+    complete_fork_in_child() -> void;
+
+private:
+
+    friend class log_subscription;
+
+    //
+    // Result of reading a ring slot for a given ticket.
+    //
+    enum class read_result : std::uint8_t
+    {
+
+        //
+        // The record was copied out of the slot.
+        //
+        ready,
+
+        //
+        // The record is not yet published.
+        //
+        pending,
+
+        //
+        // The record was overwritten or dropped before being read.
+        //
+        lost
+
+    };
+
+    //
+    // Max size in bytes of a broadcast record message.
+    //
+    static constexpr std::uint32_t c_max_message_size_bytes = 480u;
+
+    //
+    // Count of slots in the ring. Must be a power of two.
+    //
+    static constexpr std::uint64_t c_slots_count = 4096u;
+
+    //
+    // Ring slot guarded by a sequence lock. The sequence is odd while a producer writes
+    // the slot and becomes 2 * (ticket + 1) once the record for the ticket is published.
+    //
+    struct alignas(64) slot
+    {
+
+        std::atomic<std::uint64_t> m_sequence;
+
+        std::uint64_t m_timestamp_ns;
+
+        const char* m_title;
+
+        std::uint32_t m_message_size_bytes;
+
+        log_level m_log_level;
+
+        char m_message[c_max_message_size_bytes];
+
+    };
+
+    //
+    // Copies the record for a ticket into the output buffer.
+    //
+    auto
+    read(
+        const std::uint64_t p_ticket,
+        log_record& p_log_record,
+        char* p_message_buffer) const -> read_result;
+
+    //
+    // Gets the ticket that the next published record will take.
+    //
+    auto
+    get_write_ticket() const -> std::uint64_t;
+
+    //
+    // Registers a subscriber in the subscribers count and gets the current fork generation.
+    //
+    auto
+    register_subscriber() -> std::uint64_t;
+
+    //
+    // Unregisters a subscriber registered in a fork generation. Fails for subscribers of an
+    // older generation, which were already dropped from the count; the handle of their
+    // delivery thread, which does not exist in this process, is kept by the broadcaster.
+    //
+    auto
+    unregister_subscriber(
+        const std::uint64_t p_fork_generation,
+        std::thread& p_delivery_thread) -> bool;
+
+    //
+    // Ring slots. Published once on the first subscription and never released.
+    //
+    std::atomic<slot*> m_slots;
+
+    //
+    // Owner of the ring slots.
+    //
+    std::unique_ptr<slot[]> m_slots_storage;
+
+    //
+    // Next ticket to be taken by a producer.
+    //
+    alignas(64) std::atomic<std::uint64_t> m_write_ticket;
+
+    //
+    // Count of live subscribers.
+    //
+    alignas(64) std::atomic<std::uint32_t> m_subscribers_count;
+
+    //
+    // Count of forks the process of the broadcaster went through since it was constructed.
+    // Only accessed under the allocation lock.
+    //
+    std::uint64_t m_fork_generation;
+
+    //
+    // Handles of the delivery threads of subscriptions inherited from older fork generations.
+    // They can neither be joined nor destroyed while joinable. Only accessed under the allocation lock.
+    //
+    std::vector<std::thread> m_inherited_delivery_threads;
+
+    //
+    // Lock for synchronizing the ring allocation and the subscribers registration.
+    //
+    std::mutex m_allocation_lock;
+
+};
+
+} // namespace echo.
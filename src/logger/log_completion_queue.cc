@@ -0,0 +1,177 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'log_completion_queue.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <new>
+#include <optional>
+#include "log_completion_queue.hh"
+
+namespace echo
+{
+
+log_completion_queue::log_completion_queue(
+    std::function<status_code(completion_operation)> p_operation_runner)
+    : m_operation_runner{std::move(p_operation_runner)},
+      m_stop_requested{false}
+{}
+
+log_completion_queue::~log_completion_queue()
+{
+    {
+        std::scoped_lock<std::mutex> lock {m_lock};
+
+        m_stop_requested = true;
+    }
+
+    m_condition.notify_all();
+
+    if (m_completion_thread.joinable())
+    {
+        m_completion_thread.join();
+    }
+}
+
+auto
+log_completion_queue::submit(
+    const completion_operation p_operation,
+    std::coroutine_handle<> p_coroutine_handle,
+    status_code* p_status) -> void
+{
+    {
+        std::scoped_lock<std::mutex> lock {m_lock};
+
+        if (!m_completion_thread.joinable())
+        {
+            m_completion_thread = std::thread(&log_completion_queue::completion_loop, this);
+        }
+
+        m_pending_requests.push_back(completion_request{
+            p_operation,
+            p_coroutine_handle,
+            p_status});
+    }
+
+    m_condition.notify_one();
+}
+
+auto
+log_completion_queue::set_resume_callback(
+    resume_callback p_resume_callback) -> void
+{
+    std::scoped_lock<std::mutex> lock {m_lock};
+
+    m_resume_callback = std::move(p_resume_callback);
+}
+
+auto
+log_completion_queue::prepare_fork() -> void
+{
+    m_lock.lock();
+}
+
+auto
+log_completion_queue::complete_fork_in_parent() -> void
+{
+    m_lock.unlock();
+}
+
+auto
+log_completion_queue::complete_fork_in_child() -> void
+{
+    m_pending_requests.clear();
+
+    if (m_completion_thread.joinable())
+    {
+        //
+        // Joining or detaching the handle of a thread of the parent is not possible; leak it instead.
+        //
+        static_cast<void>(new std::thread(std::move(m_completion_thread)));
+
+        //
+        // The condition variable can still count the waiting completion thread of the parent.
+        //
+        new (&m_condition) std::condition_variable();
+    }
+
+    m_lock.unlock();
+}
+
+auto
+log_completion_queue::completion_loop() -> void
+{
+    std::unique_lock<std::mutex> lock {m_lock};
+
+    while (true)
+    {
+        m_condition.wait(lock, [this]()
+        {
+            return m_stop_requested || !m_pending_requests.empty();
+        });
+
+        if (m_pending_requests.empty())
+        {
+            return;
+        }
+
+        std::deque<completion_request> requests;
+        requests.swap(m_pending_requests);
+
+        lock.unlock();
+
+        complete_requests(requests);
+
+        lock.lock();
+    }
+}
+
+auto
+log_completion_queue::complete_requests(
+    std::deque<completion_request>& p_requests) -> void
+{
+    //
+    // Every request was queued after its records were logged, so a single run of each
+    // operation started now covers the whole batch.
+    //
+    std::optional<status_code> flush_status;
+    std::optional<status_code> durability_status;
+
+    for (const completion_request& request : p_requests)
+    {
+        std::optional<status_code>& operation_status = request.m_operation == completion_operation::flush ?
+            flush_status :
+            durability_status;
+
+        if (!operation_status.has_value())
+        {
+            operation_status = m_operation_runner(request.m_operation);
+        }
+
+        *request.m_status = operation_status.value();
+    }
+
+    resume_callback resume_hook;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_lock};
+
+        resume_hook = m_resume_callback;
+    }
+
+    for (const completion_request& request : p_requests)
+    {
+        if (resume_hook)
+        {
+            resume_hook(request.m_coroutine_handle);
+        }
+        else
+        {
+            request.m_coroutine_handle.resume();
+        }
+    }
+}
+
+} // namespace echo.
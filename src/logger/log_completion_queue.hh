@@ -0,0 +1,226 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'log_completion_queue.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <deque>
+#include <thread>
+#include <cstdint>
+#include <coroutine>
+#include <functional>
+#include <condition_variable>
+#include "../status/status.hh"
+
+namespace echo
+{
+
+//
+// Hook for handing a suspended coroutine back to its executor once its operation completes.
+// Without a hook, coroutines are resumed inline on the completion thread.
+//
+using resume_callback = std::function<void(std::coroutine_handle<>)>;
+
+//
+// Blocking logger operation run on behalf of a suspended coroutine.
+//
+enum class completion_operation : std::uint8_t
+{
+
+    //
+    // Writes out the buffered records.
+    //
+    flush,
+
+    //
+    // Waits until every record logged so far is on stable storage.
+    //
+    durability
+
+};
+
+//
+// Queue running blocking logger operations on a dedicated completion thread, so that
+// coroutines can await them without holding an executor thread. Requests queued while
+// an operation runs are served together by a single run of each operation, which keeps
+// group commit effective for concurrent durable writes.
+// Thread-safe class.
+//
+class log_completion_queue
+{
+
+public:
+
+    //
+    // Constructor. The completion thread starts on the first request.
+    //
+    explicit log_completion_queue(
+        std::function<status_code(completion_operation)> p_operation_runner);
+
+    //
+    // Destructor. Completes the pending requests and stops the completion thread.
+    //
+    ~log_completion_queue();
+
+    log_completion_queue(const log_completion_queue&) = delete;
+
+    log_completion_queue&
+    operator=(const log_completion_queue&) = delete;
+
+    //
+    // Queues an operation; the coroutine is resumed with the operation status once it completes.
+    //
+    auto
+    submit(
+        const completion_operation p_operation,
+        std::coroutine_handle<> p_coroutine_handle,
+        status_code* p_status) -> void;
+
+    //
+    // Sets the hook used for resuming coroutines. Applies to the operations completed afterwards.
+    //
+    auto
+    set_resume_callback(
+        resume_callback p_resume_callback) -> void;
+
+    //
+    // Takes the queue lock right before a fork so that the child inherits a consistent queue.
+    //
+    auto
+    prepare_fork() -> void;
+
+    //
+    // Releases the queue lock in the parent process after a fork.
+    //
+    auto
+    complete_fork_in_parent() -> void;
+
+    //
+    // Resets the queue in the child process after a fork. The pending requests belong to
+    // coroutines of the parent and are dropped, and the completion thread, which does not
+    // exist in the child, is forgotten; a new one starts on the next request.
+    //
+    auto
+    complete_fork_in_child() -> void;
+
+private:
+
+    //
+    // Operation awaited by a suspended coroutine.
+    //
+    struct completion_request
+    {
+
+        completion_operation m_operation;
+
+        std::coroutine_handle<> m_coroutine_handle;
+
+        status_code* m_status;
+
+    };
+
+    //
+    // Completion loop run by the completion thread.
+    //
+    auto
+    completion_loop() -> void;
+
+    //
+    // Runs the operations requested by a batch of requests and resumes their coroutines.
+    //
+    auto
+    complete_requests(
+        std::deque<completion_request>& p_requests) -> void;
+
+    //
+    // Runner for the blocking operations.
+    //
+    const std::function<status_code(completion_operation)> m_operation_runner;
+
+    //
+    // Hook used for resuming coroutines.
+    //
+    resume_callback m_resume_callback;
+
+    //
+    // Requests waiting for the completion thread.
+    //
+    std::deque<completion_request> m_pending_requests;
+
+    //
+    // Lock and condition variable for the pending requests, the hook and the thread state.
+    //
+    std::mutex m_lock;
+
+    std::condition_variable m_condition;
+
+    //
+    // Flag for signaling the completion thread to exit.
+    //
+    bool m_stop_requested;
+
+    //
+    // Completion thread.
+    //
+    std::thread m_completion_thread;
+
+};
+
+//
+// Awaitable for a logger operation. Suspends the awaiting coroutine until the operation
+// completes on the completion thread and resumes it with the status of the operation.
+//
+class log_completion_awaitable
+{
+
+public:
+
+    log_completion_awaitable(
+        log_completion_queue& p_log_completion_queue,
+        const completion_operation p_operation)
+        : m_log_completion_queue{p_log_completion_queue},
+          m_operation{p_operation},
+          m_status{status::success}
+    {}
+
+    auto
+    await_ready() const noexcept -> bool
+    {
+        return false;
+    }
+
+    //
+    // The coroutine may be resumed before this returns; the awaitable is not touched after submitting.
+    //
+    auto
+    await_suspend(
+        std::coroutine_handle<> p_coroutine_handle) -> void
+    {
+        m_log_completion_queue.submit(
+            m_operation,
+            p_coroutine_handle,
+            &m_status);
+    }
+
+    auto
+    await_resume() const noexcept -> status_code
+    {
+        return m_status;
+    }
+
+private:
+
+    log_completion_queue& m_log_completion_queue;
+
+    const completion_operation m_operation;
+
+    status_code m_status;
+
+};
+
+} // namespace echo.
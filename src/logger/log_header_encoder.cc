@@ -0,0 +1,331 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'log_header_encoder.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <ctime>
+#include <cstring>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include "log_header_encoder.hh"
+
+namespace echo
+{
+
+namespace
+{
+
+//
+// Two-digit renderings of 0 through 99, back to back.
+//
+constexpr char c_digit_pairs[] =
+    "00010203040506070809"
+    "10111213141516171819"
+    "20212223242526272829"
+    "30313233343536373839"
+    "40414243444546474849"
+    "50515253545556575859"
+    "60616263646566676869"
+    "70717273747576777879"
+    "80818283848586878889"
+    "90919293949596979899";
+
+//
+// Writes the two-digit rendering of a value below 100 and advances the cursor.
+//
+inline
+auto
+write_digit_pair(
+    char*& p_cursor,
+    const std::uint32_t p_value) -> void
+{
+    std::memcpy(p_cursor, &c_digit_pairs[p_value * 2u], 2u);
+    p_cursor += 2u;
+}
+
+} // namespace.
+
+log_header_encoder::log_header_encoder(
+    const std::string& p_session_id,
+    const pid_t p_process_id,
+    const bool p_utc_enabled,
+    const bool p_source_location_enabled)
+    : m_session_and_process_text{"] (" + p_session_id + ") PID=" + std::to_string(p_process_id) + ", TID="},
+      m_utc_enabled{p_utc_enabled},
+      m_source_location_enabled{p_source_location_enabled}
+{}
+
+auto
+log_header_encoder::encode(
+    std::string& p_output,
+    const std::uint64_t p_timestamp_ns,
+    const std::uint64_t p_sequence_number,
+    const log_level p_log_level,
+    const std::source_location& p_source_location,
+    const char* p_title,
+    const char* p_message) const -> void
+{
+    if (m_source_location_enabled)
+    {
+        encode_with_layout<true, true, true>(
+            p_output,
+            p_timestamp_ns,
+            p_sequence_number,
+            p_log_level,
+            p_source_location,
+            p_title,
+            p_message);
+
+        return;
+    }
+
+    encode_with_layout<false, true, true>(
+        p_output,
+        p_timestamp_ns,
+        p_sequence_number,
+        p_log_level,
+        p_source_location,
+        p_title,
+        p_message);
+}
+
+template<bool SourceLocationEnabled, bool TimestampEnabled, bool ActivityIdEnabled>
+auto
+log_header_encoder::encode_with_layout(
+    std::string& p_output,
+    const std::uint64_t p_timestamp_ns,
+    const std::uint64_t p_sequence_number,
+    const log_level p_log_level,
+    const std::source_location& p_source_location,
+    const char* p_title,
+    const char* p_message) const -> void
+{
+    const std::string_view level = get_log_level_text(p_log_level);
+    const std::string_view title {p_title};
+    const std::string_view message {p_message};
+    std::size_t file_name_size = 0u;
+    std::size_t function_name_size = 0u;
+
+    if constexpr (SourceLocationEnabled)
+    {
+        const source_location_lengths& lengths = get_source_location_lengths(p_source_location);
+
+        file_name_size = lengths.m_file_name_size;
+        function_name_size = lengths.m_function_name_size;
+    }
+
+    //
+    // Size the buffer once for the longest possible rendering and trim it at the end.
+    //
+    p_output.resize(
+        1u + c_timestamp_size_bytes + m_session_and_process_text.size() +
+        c_max_unsigned_size_bytes + 6u + c_max_unsigned_size_bytes +
+        13u + c_activity_id.size() +
+        7u + file_name_size +
+        11u + function_name_size +
+        7u + c_max_unsigned_size_bytes +
+        3u + level.size() +
+        3u + title.size() +
+        2u + message.size() + 1u);
+
+    char* cursor = p_output.data();
+
+    *cursor++ = '[';
+
+    if constexpr (TimestampEnabled)
+    {
+        write_timestamp(cursor, p_timestamp_ns);
+    }
+
+    write_string(cursor, m_session_and_process_text);
+    write_unsigned(cursor, static_cast<std::uint64_t>(syscall(SYS_gettid)));
+    write_string(cursor, ", Seq=");
+    write_unsigned(cursor, p_sequence_number);
+
+    if constexpr (ActivityIdEnabled)
+    {
+        write_string(cursor, ", ActivityID=");
+        write_string(cursor, c_activity_id);
+    }
+
+    if constexpr (SourceLocationEnabled)
+    {
+        write_string(cursor, ", File=");
+        write_string(cursor, std::string_view(p_source_location.file_name(), file_name_size));
+        write_string(cursor, ", Function=");
+        write_string(cursor, std::string_view(p_source_location.function_name(), function_name_size));
+        write_string(cursor, ", Line=");
+        write_unsigned(cursor, p_source_location.line());
+    }
+
+    write_string(cursor, ". <");
+    write_string(cursor, level);
+    write_string(cursor, "> [");
+    write_string(cursor, title);
+    write_string(cursor, "] ");
+    write_string(cursor, message);
+    *cursor++ = '\n';
+
+    p_output.resize(static_cast<std::size_t>(cursor - p_output.data()));
+}
+
+auto
+log_header_encoder::get_source_location_lengths(
+    const std::source_location& p_source_location) -> const source_location_lengths&
+{
+    thread_local std::array<source_location_lengths, c_source_location_cache_slots_count> cache {};
+
+    //
+    // The names of a call site are string literals, so their addresses identify it. Both are
+    // compared: identical function names of different files can be merged into a single literal.
+    //
+    const char* file_name = p_source_location.file_name();
+    const char* function_name = p_source_location.function_name();
+    source_location_lengths& lengths = cache[(reinterpret_cast<std::uintptr_t>(function_name) >> 4u) & (c_source_location_cache_slots_count - 1u)];
+
+    if (lengths.m_function_name != function_name ||
+        lengths.m_file_name != file_name)
+    {
+        lengths.m_file_name = file_name;
+        lengths.m_function_name = function_name;
+        lengths.m_file_name_size = std::strlen(file_name);
+        lengths.m_function_name_size = std::strlen(function_name);
+    }
+
+    return lengths;
+}
+
+auto
+log_header_encoder::write_timestamp(
+    char*& p_cursor,
+    const std::uint64_t p_timestamp_ns) const -> void
+{
+    //
+    // The calendar part only changes once per second; render it again only then.
+    //
+    thread_local std::time_t cached_seconds = -1;
+    thread_local bool cached_utc_enabled = false;
+    thread_local char cached_calendar[c_calendar_size_bytes];
+
+    const std::time_t seconds = static_cast<std::time_t>(p_timestamp_ns / 1'000'000'000u);
+
+    if (seconds != cached_seconds ||
+        m_utc_enabled != cached_utc_enabled)
+    {
+        std::tm calendar_time {};
+
+        if (m_utc_enabled)
+        {
+            gmtime_r(&seconds, &calendar_time);
+        }
+        else
+        {
+            localtime_r(&seconds, &calendar_time);
+        }
+
+        const std::uint32_t year = static_cast<std::uint32_t>(calendar_time.tm_year + 1900);
+        char* calendar_cursor = cached_calendar;
+
+        write_digit_pair(calendar_cursor, year / 100u % 100u);
+        write_digit_pair(calendar_cursor, year % 100u);
+        *calendar_cursor++ = '-';
+        write_digit_pair(calendar_cursor, static_cast<std::uint32_t>(calendar_time.tm_mon + 1));
+        *calendar_cursor++ = '-';
+        write_digit_pair(calendar_cursor, static_cast<std::uint32_t>(calendar_time.tm_mday));
+        *calendar_cursor++ = ' ';
+        write_digit_pair(calendar_cursor, static_cast<std::uint32_t>(calendar_time.tm_hour));
+        *calendar_cursor++ = ':';
+        write_digit_pair(calendar_cursor, static_cast<std::uint32_t>(calendar_time.tm_min));
+        *calendar_cursor++ = ':';
+        write_digit_pair(calendar_cursor, static_cast<std::uint32_t>(calendar_time.tm_sec));
+        *calendar_cursor++ = '.';
+
+        cached_seconds = seconds;
+        cached_utc_enabled = m_utc_enabled;
+    }
+
+    std::memcpy(p_cursor, cached_calendar, c_calendar_size_bytes);
+    p_cursor += c_calendar_size_bytes;
+
+    const std::uint32_t microseconds = static_cast<std::uint32_t>((p_timestamp_ns % 1'000'000'000u) / 1'000u);
+
+    write_digit_pair(p_cursor, microseconds / 10'000u);
+    write_digit_pair(p_cursor, microseconds / 100u % 100u);
+    write_digit_pair(p_cursor, microseconds % 100u);
+}
+
+auto
+log_header_encoder::write_unsigned(
+    char*& p_cursor,
+    std::uint64_t p_value) -> void
+{
+    //
+    // Render from the least significant digits backwards, two digits at a time.
+    //
+    char digits[c_max_unsigned_size_bytes];
+    char* digits_end = digits + c_max_unsigned_size_bytes;
+    char* digits_begin = digits_end;
+
+    while (p_value >= 100u)
+    {
+        digits_begin -= 2;
+        std::memcpy(digits_begin, &c_digit_pairs[(p_value % 100u) * 2u], 2u);
+        p_value /= 100u;
+    }
+
+    if (p_value >= 10u)
+    {
+        digits_begin -= 2;
+        std::memcpy(digits_begin, &c_digit_pairs[p_value * 2u], 2u);
+    }
+    else
+    {
+        *--digits_begin = static_cast<char>('0' + p_value);
+    }
+
+    const std::size_t digits_size = static_cast<std::size_t>(digits_end - digits_begin);
+
+    std::memcpy(p_cursor, digits_begin, digits_size);
+    p_cursor += digits_size;
+}
+
+auto
+log_header_encoder::write_string(
+    char*& p_cursor,
+    const std::string_view p_string) -> void
+{
+    std::memcpy(p_cursor, p_string.data(), p_string.size());
+    p_cursor += p_string.size();
+}
+
+auto
+log_header_encoder::get_log_level_text(
+    const log_level p_log_level) -> std::string_view
+{
+    const std::size_t level_index = static_cast<std::size_t>(p_log_level);
+
+    return level_index < c_log_level_texts.size() ? c_log_level_texts[level_index] : c_default_log_level_text;
+}
+
+//
+// Every record shape; the encoding itself stays in this translation unit.
+//
+#define ECHO_INSTANTIATE_ENCODE_WITH_LAYOUT(p_source_location_enabled, p_timestamp_enabled, p_activity_id_enabled) \
+    template auto log_header_encoder::encode_with_layout<p_source_location_enabled, p_timestamp_enabled, p_activity_id_enabled>( \
+        std::string&, const std::uint64_t, const std::uint64_t, const log_level, const std::source_location&, const char*, const char*) const -> void;
+
+ECHO_INSTANTIATE_ENCODE_WITH_LAYOUT(false, false, false)
+ECHO_INSTANTIATE_ENCODE_WITH_LAYOUT(false, false, true)
+ECHO_INSTANTIATE_ENCODE_WITH_LAYOUT(false, true, false)
+ECHO_INSTANTIATE_ENCODE_WITH_LAYOUT(false, true, true)
+ECHO_INSTANTIATE_ENCODE_WITH_LAYOUT(true, false, false)
+ECHO_INSTANTIATE_ENCODE_WITH_LAYOUT(true, false, true)
+ECHO_INSTANTIATE_ENCODE_WITH_LAYOUT(true, true, false)
+ECHO_INSTANTIATE_ENCODE_WITH_LAYOUT(true, true, true)
+
+#undef ECHO_INSTANTIATE_ENCODE_WITH_LAYOUT
+
+} // namespace echo.
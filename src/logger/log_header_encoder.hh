@@ -0,0 +1,187 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'log_header_encoder.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <array>
+#include <string>
+#include <cstdint>
+#include <unistd.h>
+#include <string_view>
+#include <source_location>
+#include "log_level.hh"
+
+namespace echo
+{
+
+//
+// Encoder for formatted log records. Renders the fixed record shape
+//
+//   [<timestamp>] (<session>) PID=<pid>, TID=<tid>, Seq=<seq>, ActivityID=<activity>, File=<file>,
+//   Function=<function>, Line=<line>. <<level>> [<title>] <message>
+//
+// straight into the output buffer, byte for byte as the equivalent std::format call would:
+// the session and PID part is rendered once, integers go through a digit-pair table, the
+// calendar part of the timestamp is cached per thread for the current second and the
+// lengths of the source location strings are cached per thread by call site.
+// The activity and source location fields can be left out of the shape, as can the
+// timestamp, whose brackets are kept empty so that readers still parse the record.
+//
+class log_header_encoder
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    log_header_encoder(
+        const std::string& p_session_id,
+        const pid_t p_process_id,
+        const bool p_utc_enabled,
+        const bool p_source_location_enabled = true);
+
+    //
+    // Renders a whole record, header and message, replacing the contents of the output buffer.
+    // The source location fields are only rendered if enabled on construction.
+    //
+    auto
+    encode(
+        std::string& p_output,
+        const std::uint64_t p_timestamp_ns,
+        const std::uint64_t p_sequence_number,
+        const log_level p_log_level,
+        const std::source_location& p_source_location,
+        const char* p_title,
+        const char* p_message) const -> void;
+
+    //
+    // Renders a whole record with a shape fixed at compile time, replacing the contents
+    // of the output buffer. Fields left out of the shape are not rendered nor looked at.
+    //
+    template<bool SourceLocationEnabled, bool TimestampEnabled, bool ActivityIdEnabled>
+    auto
+    encode_with_layout(
+        std::string& p_output,
+        const std::uint64_t p_timestamp_ns,
+        const std::uint64_t p_sequence_number,
+        const log_level p_log_level,
+        const std::source_location& p_source_location,
+        const char* p_title,
+        const char* p_message) const -> void;
+
+private:
+
+    //
+    // Lengths of the strings of a call site, along with the strings they were taken from.
+    //
+    struct source_location_lengths
+    {
+
+        const char* m_file_name;
+
+        const char* m_function_name;
+
+        std::size_t m_file_name_size;
+
+        std::size_t m_function_name_size;
+
+    };
+
+    //
+    // Gets the lengths of the strings of a call site, from the per-thread cache if possible.
+    //
+    static
+    auto
+    get_source_location_lengths(
+        const std::source_location& p_source_location) -> const source_location_lengths&;
+
+    //
+    // Writes the 'YYYY-MM-DD HH:MM:SS.ffffff' rendering of a timestamp and advances the cursor.
+    //
+    auto
+    write_timestamp(
+        char*& p_cursor,
+        const std::uint64_t p_timestamp_ns) const -> void;
+
+    //
+    // Writes the decimal rendering of an unsigned integer and advances the cursor.
+    //
+    static
+    auto
+    write_unsigned(
+        char*& p_cursor,
+        std::uint64_t p_value) -> void;
+
+    //
+    // Writes a string and advances the cursor.
+    //
+    static
+    auto
+    write_string(
+        char*& p_cursor,
+        const std::string_view p_string) -> void;
+
+    //
+    // Gets the text of a level.
+    //
+    static
+    auto
+    get_log_level_text(
+        const log_level p_log_level) -> std::string_view;
+
+    //
+    // Max size in bytes of the decimal rendering of a 64-bit unsigned integer.
+    //
+    static constexpr std::size_t c_max_unsigned_size_bytes = 20u;
+
+    //
+    // Size in bytes of the rendering of a timestamp.
+    //
+    static constexpr std::size_t c_timestamp_size_bytes = 26u;
+
+    //
+    // Size in bytes of the calendar part of the rendering of a timestamp, up to the fraction.
+    //
+    static constexpr std::size_t c_calendar_size_bytes = 20u;
+
+    //
+    // Count of call sites in the per-thread cache of source location lengths. Must be a power of two.
+    //
+    static constexpr std::size_t c_source_location_cache_slots_count = 256u;
+
+    //
+    // Activity identifier of every record.
+    //
+    static constexpr std::string_view c_activity_id = "123";
+
+    //
+    // Text of each level.
+    //
+    static constexpr std::array<std::string_view, 4u> c_log_level_texts = {"Info", "Warning", "Error", "Critical"};
+
+    static constexpr std::string_view c_default_log_level_text = "Unknown";
+
+    //
+    // Rendering of '] (<session>) PID=<pid>, TID='.
+    //
+    const std::string m_session_and_process_text;
+
+    //
+    // Flag for determining if timestamps are rendered in UTC or local time.
+    //
+    const bool m_utc_enabled;
+
+    //
+    // Flag for determining if the source location fields are rendered by encode.
+    //
+    const bool m_source_location_enabled;
+
+};
+
+} // namespace echo.
@@ -0,0 +1,260 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'log_shipping_protocol.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <string>
+#include <cstdint>
+#include <cstring>
+#include <optional>
+#include <string_view>
+#include "log_level.hh"
+
+#ifdef ECHO_LOGGER_LZ4_ENABLED
+#include <lz4.h>
+#endif
+
+namespace echo
+{
+
+//
+// Wire format between a socket log shipper and a socket log collector on the same host.
+// Values are in host byte order. A connection starts with a hello frame naming the
+// logging session, followed by any number of batch frames:
+//
+//   hello: magic, version, component name size (u16), session id size (u16), component name, session id.
+//   batch: magic, flags, records count, uncompressed payload size, payload size (u32 each), payload.
+//
+// The uncompressed payload of a batch is a sequence of records:
+//
+//   record: message size (u32), timestamp in nanoseconds (u64), level (u8), title size (u8),
+//           title followed by a terminating null character, formatted log message.
+//
+namespace log_shipping_protocol
+{
+
+//
+// Magic value opening every frame.
+//
+static constexpr std::uint32_t c_frame_magic = 0x53484345u; // 'ECHS'.
+
+//
+// Version sent in the hello frame.
+//
+static constexpr std::uint32_t c_protocol_version = 1u;
+
+//
+// Batch flag marking an LZ4-compressed payload.
+//
+static constexpr std::uint32_t c_lz4_compressed_batch_flag = 0x1u;
+
+//
+// Max size in bytes of an uncompressed batch payload.
+//
+static constexpr std::uint32_t c_max_batch_payload_size_bytes = 4u * 1024u * 1024u;
+
+//
+// Size in bytes of the hello frame header.
+//
+static constexpr std::size_t c_hello_header_size_bytes = 3u * sizeof(std::uint32_t);
+
+//
+// Size in bytes of the batch frame header.
+//
+static constexpr std::size_t c_batch_header_size_bytes = 5u * sizeof(std::uint32_t);
+
+//
+// Size in bytes of the fixed part of a record.
+//
+static constexpr std::size_t c_record_header_size_bytes = sizeof(std::uint32_t) + sizeof(std::uint64_t) + 2u * sizeof(std::uint8_t);
+
+//
+// Max size in bytes of a record title, excluding its terminating null character.
+//
+static constexpr std::size_t c_max_title_size_bytes = 254u;
+
+//
+// Record decoded from a batch payload. The views point into the payload.
+//
+struct shipped_record
+{
+
+    std::uint64_t m_timestamp_ns;
+
+    log_level m_log_level;
+
+    //
+    // Null-terminated title.
+    //
+    const char* m_title;
+
+    std::string_view m_log_message;
+
+};
+
+//
+// Appends a value to a frame buffer.
+//
+template<typename T>
+inline
+auto
+append_value(
+    std::string& p_buffer,
+    const T p_value) -> void
+{
+    p_buffer.append(reinterpret_cast<const char*>(&p_value), sizeof(T));
+}
+
+//
+// Reads a value from a frame buffer at the given offset.
+//
+template<typename T>
+inline
+auto
+read_value(
+    const char* p_buffer,
+    const std::size_t p_offset) -> T
+{
+    T value;
+    std::memcpy(&value, p_buffer + p_offset, sizeof(T));
+
+    return value;
+}
+
+//
+// Appends a record to a batch payload. Titles longer than the max size are truncated.
+//
+inline
+auto
+append_record(
+    std::string& p_payload,
+    const std::uint64_t p_timestamp_ns,
+    const log_level p_log_level,
+    const char* p_title,
+    const std::string_view p_log_message) -> void
+{
+    const std::string_view title = std::string_view(p_title).substr(0u, c_max_title_size_bytes);
+
+    append_value<std::uint32_t>(p_payload, static_cast<std::uint32_t>(p_log_message.size()));
+    append_value<std::uint64_t>(p_payload, p_timestamp_ns);
+    append_value<std::uint8_t>(p_payload, static_cast<std::uint8_t>(p_log_level));
+    append_value<std::uint8_t>(p_payload, static_cast<std::uint8_t>(title.size() + 1u));
+    p_payload.append(title);
+    p_payload.push_back('\0');
+    p_payload.append(p_log_message);
+}
+
+//
+// Decodes the record at the given offset of a batch payload and advances the offset past it.
+// Returns nothing if the record is malformed or overruns the payload.
+//
+inline
+auto
+read_record(
+    const std::string_view p_payload,
+    std::size_t& p_offset) -> std::optional<shipped_record>
+{
+    if (p_payload.size() - p_offset < c_record_header_size_bytes)
+    {
+        return std::nullopt;
+    }
+
+    const std::uint32_t message_size_bytes = read_value<std::uint32_t>(p_payload.data(), p_offset);
+    const std::uint64_t timestamp_ns = read_value<std::uint64_t>(p_payload.data(), p_offset + 4u);
+    const std::uint8_t level = read_value<std::uint8_t>(p_payload.data(), p_offset + 12u);
+    const std::uint8_t title_size_bytes = read_value<std::uint8_t>(p_payload.data(), p_offset + 13u);
+    const std::size_t record_begin = p_offset + c_record_header_size_bytes;
+
+    if (title_size_bytes == 0u ||
+        p_payload.size() - record_begin < static_cast<std::size_t>(title_size_bytes) + message_size_bytes ||
+        p_payload[record_begin + title_size_bytes - 1u] != '\0')
+    {
+        return std::nullopt;
+    }
+
+    p_offset = record_begin + title_size_bytes + message_size_bytes;
+
+    return shipped_record{
+        timestamp_ns,
+        static_cast<log_level>(level),
+        p_payload.data() + record_begin,
+        p_payload.substr(record_begin + title_size_bytes, message_size_bytes)};
+}
+
+//
+// Determines whether the library was built with LZ4 support (ECHO_LOGGER_LZ4 CMake option).
+//
+inline
+auto
+is_compression_supported() -> bool
+{
+#ifdef ECHO_LOGGER_LZ4_ENABLED
+    return true;
+#else
+    return false;
+#endif
+}
+
+//
+// Compresses a batch payload with LZ4. Returns false if compression is not supported or failed.
+//
+inline
+auto
+compress_payload(
+    [[maybe_unused]] const std::string_view p_payload,
+    [[maybe_unused]] std::string& p_compressed_payload) -> bool
+{
+#ifdef ECHO_LOGGER_LZ4_ENABLED
+    p_compressed_payload.resize(static_cast<std::size_t>(LZ4_compressBound(static_cast<int>(p_payload.size()))));
+
+    const int compressed_size_bytes = LZ4_compress_default(
+        p_payload.data(),
+        p_compressed_payload.data(),
+        static_cast<int>(p_payload.size()),
+        static_cast<int>(p_compressed_payload.size()));
+
+    if (compressed_size_bytes <= 0)
+    {
+        return false;
+    }
+
+    p_compressed_payload.resize(static_cast<std::size_t>(compressed_size_bytes));
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+//
+// Decompresses an LZ4 batch payload. Returns false if compression is not supported or the payload is malformed.
+//
+inline
+auto
+decompress_payload(
+    [[maybe_unused]] const std::string_view p_compressed_payload,
+    [[maybe_unused]] const std::uint32_t p_payload_size_bytes,
+    [[maybe_unused]] std::string& p_payload) -> bool
+{
+#ifdef ECHO_LOGGER_LZ4_ENABLED
+    p_payload.resize(p_payload_size_bytes);
+
+    const int payload_size_bytes = LZ4_decompress_safe(
+        p_compressed_payload.data(),
+        p_payload.data(),
+        static_cast<int>(p_compressed_payload.size()),
+        static_cast<int>(p_payload.size()));
+
+    return payload_size_bytes == static_cast<int>(p_payload_size_bytes);
+#else
+    return false;
+#endif
+}
+
+} // namespace log_shipping_protocol.
+} // namespace echo.
@@ -7,11 +7,20 @@
 // ****************************************************
 
 #include <mutex>
+#include <chrono>
+#include <algorithm>
 #include <string>
 #include <iostream>
 #include <syslog.h>
+#include <thread>
+#include <unistd.h>
+#include <pthread.h>
 #include "logger.hh"
+#include "log_batch.hh"
 #include "logging_engine.hh"
+#include "trace_recorder.hh"
+#include "../utils/time_utilities.hh"
+#include "../utils/hazard_pointer_domain.hh"
 
 namespace echo
 {
@@ -40,31 +49,108 @@ logger::initialize(
         *p_logger_configuration);
 }
 
+auto
+logger::reconfigure(
+    const logger_configuration& p_logger_configuration) -> void
+{
+    get_logger().reconfigure_implementation(
+        p_logger_configuration);
+}
+
+auto
+logger::shutdown() -> void
+{
+    get_logger().shutdown_implementation();
+}
+
 auto
 logger::flush() -> void
 {
-    // Pending implementation.
+    get_logger().flush_implementation();
+}
+
+auto
+logger::get_priority_lane_statistics() -> std::array<priority_lane_statistics, c_priority_lanes_count>
+{
+    return get_logger().get_priority_lane_statistics_implementation();
+}
+
+auto
+logger::write_call_site_report() -> status_code
+{
+    return get_logger().write_call_site_report_implementation();
+}
+
+auto
+logger::flush_async() -> log_completion_awaitable
+{
+    return log_completion_awaitable(
+        get_logger().m_log_completion_queue,
+        completion_operation::flush);
+}
+
+auto
+logger::set_resume_callback(
+    resume_callback p_resume_callback) -> void
+{
+    get_logger().m_log_completion_queue.set_resume_callback(
+        std::move(p_resume_callback));
+}
+
+auto
+logger::subscribe(
+    const log_subscription_filter& p_filter,
+    std::function<void(const log_record&)> p_callback) -> std::unique_ptr<log_subscription>
+{
+    return get_logger().m_log_broadcaster.subscribe(
+        p_filter,
+        std::move(p_callback));
 }
 
 logger::logger()
-    : m_logging_engine{nullptr}
+    : m_logging_engine{nullptr},
+      m_minimum_log_level{static_cast<std::uint8_t>(log_level::info)},
+      m_call_site_profiling_enabled{false},
+      m_rebuild_after_fork_pending{false},
+      m_parent_logging_engine{nullptr},
+      m_log_completion_queue{[this](const completion_operation p_operation)
+      {
+          return p_operation == completion_operation::flush ?
+              flush_implementation() :
+              wait_for_durability_implementation();
+      }}
 {}
 
+logger::~logger()
+{
+    //
+    // Static destruction; no other thread can be logging through the instance anymore.
+    //
+    delete m_logging_engine.load(std::memory_order_acquire);
+}
+
 auto
 logger::is_logger_initialized_implementation() -> bool
 {
-    std::shared_lock lock {m_lock};
+    complete_pending_fork_rebuild();
 
-    return m_logging_engine != nullptr;
+    return m_logging_engine.load(std::memory_order_acquire) != nullptr;
 }  
 
 auto
 logger::initialize_implementation(
     const logger_configuration& p_logger_configuration) -> void
 {
-    std::unique_lock lock {m_lock};
+    register_fork_handlers();
+
+    //
+    // An instance initialized before a fork is initialized in the child too.
+    //
+    complete_pending_fork_rebuild();
+
+    std::scoped_lock<std::mutex> lock {m_lock};
 
-    if (m_logging_engine != nullptr)
+    if (m_logging_engine.load(std::memory_order_relaxed) != nullptr)
     {
         //
         // The logging engine has already been initialized; nothing to do here.
@@ -72,8 +158,196 @@ logger::initialize_implementation(
         throw std::logic_error("The echo logger has already been initialized.");
     }
 
-    m_logging_engine = std::make_unique<logging_engine>(
-        p_logger_configuration);
+    auto engine = std::make_unique<logging_engine>(
+        p_logger_configuration,
+        &m_log_broadcaster);
+
+    replay_pre_initialization_records(*engine);
+
+    m_logger_configuration = p_logger_configuration;
+    m_minimum_log_level.store(static_cast<std::uint8_t>(p_logger_configuration.minimum_log_level), std::memory_order_relaxed);
+    m_call_site_profiling_enabled.store(p_logger_configuration.call_site_profiling_enabled, std::memory_order_relaxed);
+    m_logging_engine.store(engine.release(), std::memory_order_release);
+}
+
+auto
+logger::reconfigure_implementation(
+    const logger_configuration& p_logger_configuration) -> void
+{
+    register_fork_handlers();
+
+    //
+    // An instance initialized before a fork is initialized in the child too.
+    //
+    complete_pending_fork_rebuild();
+
+    std::scoped_lock<std::mutex> lock {m_lock};
+
+    logging_engine* previous_engine = m_logging_engine.load(std::memory_order_relaxed);
+
+    //
+    // Build the new snapshot completely before publishing it. Can throw,
+    // in which case the current engine remains in place.
+    //
+    auto engine = std::make_unique<logging_engine>(
+        p_logger_configuration,
+        &m_log_broadcaster,
+        previous_engine);
+
+    if (previous_engine == nullptr)
+    {
+        replay_pre_initialization_records(*engine);
+    }
+
+    m_logger_configuration = p_logger_configuration;
+    m_minimum_log_level.store(static_cast<std::uint8_t>(p_logger_configuration.minimum_log_level), std::memory_order_relaxed);
+    m_call_site_profiling_enabled.store(p_logger_configuration.call_site_profiling_enabled, std::memory_order_relaxed);
+    m_logging_engine.store(engine.release(), std::memory_order_release);
+
+    if (previous_engine != nullptr)
+    {
+        //
+        // Deleted now if no log call is using it, or on a later reconfiguration or shutdown.
+        //
+        retire_logging_engine(previous_engine);
+    }
+}
+
+auto
+logger::shutdown_implementation() -> void
+{
+    std::scoped_lock<std::mutex> lock {m_lock};
+
+    //
+    // An engine still pending after a fork is no longer needed.
+    //
+    m_rebuild_after_fork_pending.store(false, std::memory_order_relaxed);
+    m_parent_logging_engine = nullptr;
+
+    logging_engine* previous_engine = m_logging_engine.exchange(nullptr, std::memory_order_acq_rel);
+
+    if (previous_engine != nullptr)
+    {
+        retire_logging_engine(previous_engine);
+    }
+
+    //
+    // Wait for in-flight log calls on the engines of the instance to drain so that
+    // every record has been handed over when the call returns.
+    //
+    wait_for_retired_logging_engines();
+
+    //
+    // Records logged from now on are captured until the next initialization.
+    //
+    m_pre_initialization_buffer.reset();
+
+    m_logger_configuration.reset();
+    m_minimum_log_level.store(static_cast<std::uint8_t>(log_level::info), std::memory_order_relaxed);
+    m_call_site_profiling_enabled.store(false, std::memory_order_relaxed);
+}
+
+auto
+logger::retire_logging_engine(
+    logging_engine* p_logging_engine) -> void
+{
+    std::erase_if(m_retired_logging_engine_tickets, [](const std::uint64_t p_ticket)
+    {
+        return hazard_pointer_domain<logging_engine>::is_reclaimed(p_ticket);
+    });
+
+    m_retired_logging_engine_tickets.push_back(hazard_pointer_domain<logging_engine>::retire(p_logging_engine));
+}
+
+auto
+logger::wait_for_retired_logging_engines() -> void
+{
+    constexpr std::chrono::microseconds c_initial_backoff {50};
+    constexpr std::chrono::microseconds c_max_backoff {10'000};
+
+    std::chrono::microseconds backoff = c_initial_backoff;
+
+    while (true)
+    {
+        std::erase_if(m_retired_logging_engine_tickets, [](const std::uint64_t p_ticket)
+        {
+            return hazard_pointer_domain<logging_engine>::is_reclaimed(p_ticket);
+        });
+
+        if (m_retired_logging_engine_tickets.empty())
+        {
+            return;
+        }
+
+        //
+        // Log calls protect an engine for the span of a single record; back off instead of
+        // paying a process-wide barrier per pass while they finish.
+        //
+        std::this_thread::sleep_for(backoff);
+        backoff = std::min(backoff * 2, c_max_backoff);
+
+        hazard_pointer_domain<logging_engine>::reclaim();
+    }
+}
+
+auto
+logger::flush_implementation() -> status_code
+{
+    complete_pending_fork_rebuild();
+
+    const auto engine = hazard_pointer_domain<logging_engine>::protect(m_logging_engine);
+
+    if (engine.get() == nullptr)
+    {
+        return status::logger_not_initialized;
+    }
+
+    return engine->flush();
+}
+
+auto
+logger::get_priority_lane_statistics_implementation() -> std::array<priority_lane_statistics, c_priority_lanes_count>
+{
+    complete_pending_fork_rebuild();
+
+    const auto engine = hazard_pointer_domain<logging_engine>::protect(m_logging_engine);
+
+    if (engine.get() == nullptr)
+    {
+        return {};
+    }
+
+    return engine->get_priority_lane_statistics();
+}
+
+auto
+logger::write_call_site_report_implementation() -> status_code
+{
+    complete_pending_fork_rebuild();
+
+    const auto engine = hazard_pointer_domain<logging_engine>::protect(m_logging_engine);
+
+    if (engine.get() == nullptr)
+    {
+        return status::logger_not_initialized;
+    }
+
+    return engine->write_call_site_report();
+}
+
+auto
+logger::wait_for_durability_implementation() -> status_code
+{
+    complete_pending_fork_rebuild();
+
+    const auto engine = hazard_pointer_domain<logging_engine>::protect(m_logging_engine);
+
+    if (engine.get() == nullptr)
+    {
+        return status::logger_not_initialized;
+    }
+
+    return engine->wait_for_durability();
 }
 
 auto
@@ -81,23 +355,295 @@ logger::log_implementation(
     const log_level& p_log_level,
     const std::source_location& p_source_location,
     const char* p_title,
-    const char* p_message) -> void
+    const char* p_message,
+    const bool p_durability_wait_enabled,
+    const std::uint64_t p_formatting_start_tick) -> void
 {
-    std::shared_lock lock {m_lock};
+    while (true)
+    {
+        const auto engine = hazard_pointer_domain<logging_engine>::protect(m_logging_engine);
+
+        if (engine.get() != nullptr)
+        {
+            engine->log(
+                p_log_level,
+                p_source_location,
+                p_title,
+                p_message,
+                p_durability_wait_enabled,
+                p_formatting_start_tick);
+
+            return;
+        }
+
+        if (m_rebuild_after_fork_pending.load(std::memory_order_acquire))
+        {
+            //
+            // First record of a child process after a fork.
+            //
+            rebuild_logging_engine_after_fork();
+
+            continue;
+        }
+
+        //
+        // The logging engine is not yet initialized; keep the record for when it is.
+        //
+        const status_code status = m_pre_initialization_buffer.capture(
+            get_current_timestamp_ns(),
+            p_log_level,
+            p_source_location,
+            p_title,
+            p_message);
+
+        if (status != status::pre_initialization_buffer_sealed)
+        {
+            return;
+        }
+
+        //
+        // The captured records are being replayed; the engine is about to be published.
+        //
+        std::this_thread::yield();
+    }
+}
 
-    if (m_logging_engine == nullptr)
+auto
+logger::log_batch_implementation(
+    const std::span<const log_batch_record> p_log_batch_records) -> void
+{
+    //
+    // The first batch of a child process after a fork goes to its own engine too.
+    //
+    complete_pending_fork_rebuild();
+
+    {
+        const auto engine = hazard_pointer_domain<logging_engine>::protect(m_logging_engine);
+
+        if (engine.get() != nullptr)
+        {
+            engine->log_batch(p_log_batch_records);
+
+            return;
+        }
+    }
+
+    //
+    // The logging engine is not yet initialized; the records are captured one by one.
+    //
+    for (const log_batch_record& record : p_log_batch_records)
+    {
+        log_implementation(
+            record.m_log_level,
+            record.m_source_location,
+            record.m_title,
+            record.m_message);
+    }
+}
+
+auto
+logger::replay_pre_initialization_records(
+    logging_engine& p_logging_engine) -> void
+{
+    std::string message;
+
+    const std::uint32_t dropped_records_count = m_pre_initialization_buffer.replay(
+        [&p_logging_engine, &message](const pre_initialization_buffer::captured_record& p_captured_record)
+        {
+            message.assign(p_captured_record.m_message, p_captured_record.m_message_size_bytes);
+
+            p_logging_engine.replay(
+                p_captured_record.m_timestamp_ns,
+                p_captured_record.m_log_level,
+                p_captured_record.m_source_location,
+                p_captured_record.m_title,
+                message.c_str());
+        });
+
+    if (dropped_records_count != 0u)
+    {
+        const std::string summary_message = std::format(
+            "{} records logged before initialization were dropped; the capture buffer was full.",
+            dropped_records_count);
+
+        p_logging_engine.log(
+            log_level::warning,
+            std::source_location::current(),
+            "EchoLogger",
+            summary_message.c_str(),
+            false /* p_durability_wait_enabled */);
+    }
+}
+
+auto
+logger::prepare_fork_implementation() -> void
+{
+    m_lock.lock();
+    m_log_completion_queue.prepare_fork();
+    m_log_broadcaster.prepare_fork();
+}
+
+auto
+logger::complete_fork_in_parent_implementation() -> void
+{
+    m_log_broadcaster.complete_fork_in_parent();
+    m_log_completion_queue.complete_fork_in_parent();
+    m_lock.unlock();
+}
+
+auto
+logger::complete_fork_in_child_implementation() -> void
+{
+    m_log_completion_queue.complete_fork_in_child();
+    m_log_broadcaster.complete_fork_in_child();
+    m_pre_initialization_buffer.discard_after_fork();
+
+    const logging_engine* parent_engine = m_logging_engine.load(std::memory_order_relaxed);
+
+    if (parent_engine != nullptr)
     {
         //
-        // The logging engine is not yet initialized; nothing to do here.
+        // The engine of the parent is left behind untouched: its background threads do not
+        // exist in the child, so it can be neither used nor destroyed. The child continues
+        // in a logging session of its own, linked back to the one of the parent, once the
+        // engine is rebuilt outside of the fork handler.
         //
-        throw std::logic_error("The echo logger is not yet initialized.");
+        m_parent_logging_engine = parent_engine;
+        m_logging_engine.store(nullptr, std::memory_order_release);
+        m_rebuild_after_fork_pending.store(true, std::memory_order_release);
+    }
+
+    m_lock.unlock();
+}
+
+auto
+logger::rebuild_logging_engine_after_fork() -> void
+{
+    std::scoped_lock<std::mutex> lock {m_lock};
+
+    if (!m_rebuild_after_fork_pending.load(std::memory_order_relaxed))
+    {
+        //
+        // Rebuilt by another thread, or shut down, in the meantime.
+        //
+        return;
+    }
+
+    //
+    // Cleared first so that records logged while the engine is built are captured for the replay.
+    //
+    m_rebuild_after_fork_pending.store(false, std::memory_order_release);
+
+    std::unique_ptr<logging_engine> child_engine;
+
+    try
+    {
+        child_engine = std::make_unique<logging_engine>(
+            *m_logger_configuration,
+            &m_log_broadcaster);
+
+        replay_pre_initialization_records(*child_engine);
+    }
+    catch (const std::exception& p_exception)
+    {
+        const std::string error_message = std::format(
+            "Restarting the echo logger in forked process {} failed; records are captured until it is initialized again. {}",
+            getpid(),
+            p_exception.what());
+
+        log_error_fallback("EchoLogger", error_message.c_str());
+
+        m_parent_logging_engine = nullptr;
+        m_logger_configuration.reset();
+        m_minimum_log_level.store(static_cast<std::uint8_t>(log_level::info), std::memory_order_relaxed);
+        m_call_site_profiling_enabled.store(false, std::memory_order_relaxed);
+
+        return;
     }
 
-    m_logging_engine->log(
-        p_log_level,
-        p_source_location,
-        p_title,
-        p_message);
+    const std::string fork_message = std::format(
+        "Process forked from process {}, logging session {}.",
+        getppid(),
+        m_parent_logging_engine->get_session_id());
+
+    child_engine->log(
+        log_level::info,
+        std::source_location::current(),
+        "EchoLogger",
+        fork_message.c_str(),
+        false /* p_durability_wait_enabled */);
+
+    m_parent_logging_engine = nullptr;
+    m_logging_engine.store(child_engine.release(), std::memory_order_release);
+}
+
+auto
+logger::register_fork_handlers() -> void
+{
+    //
+    // Best effort; without the handlers a child keeps writing to the session of its parent.
+    //
+    static const bool fork_handlers_registered = pthread_atfork(
+        &logger::prepare_fork,
+        &logger::complete_fork_in_parent,
+        &logger::complete_fork_in_child) == 0;
+
+    static_cast<void>(fork_handlers_registered);
+}
+
+auto
+logger::prepare_fork() -> void
+{
+    //
+    // Named instances are never destroyed, and none can be created while their lock is held.
+    //
+    get_named_instances_lock().lock();
+    get_logger().prepare_fork_implementation();
+
+    for (const auto& [name, named_instance] : get_named_instances())
+    {
+        named_instance->prepare_fork_implementation();
+    }
+
+    trace_recorder::prepare_fork();
+    filesystem_writer::prepare_fork();
+}
+
+auto
+logger::complete_fork_in_parent() -> void
+{
+    filesystem_writer::complete_fork_in_parent();
+    trace_recorder::complete_fork_in_parent();
+
+    for (const auto& [name, named_instance] : get_named_instances())
+    {
+        named_instance->complete_fork_in_parent_implementation();
+    }
+
+    get_logger().complete_fork_in_parent_implementation();
+    get_named_instances_lock().unlock();
+}
+
+auto
+logger::complete_fork_in_child() -> void
+{
+    //
+    // The calling thread is the only one left. Every lock of the logger is held by it, so no
+    // engine was being retired, no span buffer was being registered and no sequence block was
+    // being handed out when the process forked.
+    //
+    hazard_pointer_domain<logging_engine>::reset_after_fork();
+    filesystem_writer::complete_fork_in_child();
+    trace_recorder::complete_fork_in_child();
+
+    get_logger().complete_fork_in_child_implementation();
+
+    for (const auto& [name, named_instance] : get_named_instances())
+    {
+        named_instance->complete_fork_in_child_implementation();
+    }
+
+    get_named_instances_lock().unlock();
 }
 
 auto
@@ -108,6 +654,41 @@ logger::get_logger() -> logger&
     return singleton_logger_instance;
 }
 
+auto
+logger::get_named_instance(
+    const std::string_view p_name) -> logger&
+{
+    std::scoped_lock<std::mutex> lock {get_named_instances_lock()};
+
+    std::map<std::string, std::unique_ptr<logger, named_instance_deleter>, std::less<>>& named_instances = get_named_instances();
+    auto named_instance = named_instances.find(p_name);
+
+    if (named_instance == named_instances.end())
+    {
+        named_instance = named_instances.emplace(
+            std::string(p_name),
+            std::unique_ptr<logger, named_instance_deleter>(new logger())).first;
+    }
+
+    return *named_instance->second;
+}
+
+auto
+logger::get_named_instances_lock() -> std::mutex&
+{
+    static std::mutex named_instances_lock;
+
+    return named_instances_lock;
+}
+
+auto
+logger::get_named_instances() -> std::map<std::string, std::unique_ptr<logger, named_instance_deleter>, std::less<>>&
+{
+    static std::map<std::string, std::unique_ptr<logger, named_instance_deleter>, std::less<>> named_instances;
+
+    return named_instances;
+}
+
 auto
 logger::log_error_fallback(
     const char* p_title,
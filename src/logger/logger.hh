@@ -8,22 +8,45 @@
 
 #pragma once
 
+#include <map>
+#include <array>
+#include <mutex>
+#include <atomic>
 #include <format>
+#include <span>
 #include <memory>
+#include <string>
 #include <cassert>
-#include <shared_mutex>
+#include <vector>
+#include <optional>
+#include <string_view>
 #include "log_level.hh"
+#include "log_broadcaster.hh"
+#include "disk_flush_manager.hh"
+#include "log_completion_queue.hh"
 #include "../status/status.hh"
 #include "logger_configuration.hh"
+#include "pre_initialization_buffer.hh"
 #include "title_and_source_location.hh"
+#include "../utils/time_utilities.hh"
 
 namespace echo
 {
 
 class logging_engine;
 
+struct log_batch_record;
+
 //
-// Logger singleton class for managing logging in the system.
+// Logger class for managing logging in the system. The static functions go through the
+// default instance; see named_logger for independent instances with their own configuration.
+// Fork-aware: once an instance has been initialized, a child process created by fork gets a
+// new engine for every initialized instance, with a logging session of its own under its own
+// PID and its own background threads, so that pre-fork workers never share a segment stream
+// with their parent. The fork handler only resets the instance; the engine of the child is
+// built on the first call going through the instance in the child. The records and awaitable
+// operations still in flight in the parent stay there, and subscriptions are not inherited:
+// the child has to subscribe again.
 //
 class logger
 {
@@ -38,7 +61,9 @@ public:
     is_logger_initialized() -> bool;  
 
     //
-    // Initializes the singleton logger instance.
+    // Initializes the default logger instance and replays the records captured before
+    // initialization into the logging session. The session directory and the first segment
+    // are created in the background; failures to create them surface on the first writes.
     // Throws if the initialization process fails.
     //
     static
@@ -47,7 +72,32 @@ public:
         logger_configuration* p_logger_configuration = nullptr) -> void;
 
     //
-    // Logs a message.
+    // Replaces the configuration of the default logger instance at runtime.
+    // Publishes a new engine snapshot; in-flight log calls finish on the previous one,
+    // which is reclaimed once no thread uses it. The logging session is continued if the
+    // component name, logs directory, logging mode and the settings fixed by the writers, such
+    // as the flush frequency, shards, segment index, direct I/O and buffer sizes, are unchanged;
+    // otherwise a new session starts with the new settings. Initializes
+    // the logger if it was not initialized. Throws if the new engine cannot be created,
+    // in which case the current configuration is kept.
+    //
+    static
+    auto
+    reconfigure(
+        const logger_configuration& p_logger_configuration) -> void;
+
+    //
+    // Shuts down the default logger instance, waiting for in-flight log calls to drain.
+    // The logger can be initialized again afterwards.
+    //
+    static
+    auto
+    shutdown() -> void;
+
+    //
+    // Logs a message. Records logged before initialization, e.g. from static initializers,
+    // are captured in a fixed-size buffer and logged with their original timestamps once
+    // the logger is initialized; beyond its capacity they are dropped and accounted for.
     // Expects that the title is valid for the lifetime of the program.
     // Generates a compile-time error on failed format validations.
     //
@@ -60,30 +110,172 @@ public:
         std::format_string<Args...> p_format,
         Args&&... p_args) -> void
     {
+        logger& instance = get_logger();
+
+        if (!instance.is_log_level_enabled(p_log_level))
+        {
+            //
+            // Filtered records do not pay for formatting.
+            //
+            return;
+        }
+
+        const std::uint64_t formatting_start_tick = instance.read_formatting_start_tick();
         const std::string formatted_message = std::format(p_format, std::forward<Args>(p_args)...);
 
-        get_logger().log_implementation(
+        instance.log_implementation(
             p_log_level,
             p_title_and_source_location.m_source_location,
             p_title_and_source_location.m_title,
-            formatted_message.c_str());
+            formatted_message.c_str(),
+            true /* p_durability_wait_enabled */,
+            formatting_start_tick);
     }
 
     //
     // Flushes the current contents of the memory buffer to the filesystem.
-    // Only applies for async mode logging.
+    // Only applies for buffered logging modes.
     //
     static
     auto
     flush() -> void;
 
+    //
+    // Gets the counters of the priority lanes of async mode, indexed by lane: records written,
+    // records shed and their end-to-end delays. All zeros if the logger is not initialized or
+    // does not run in async mode.
+    //
+    static
+    auto
+    get_priority_lane_statistics() -> std::array<priority_lane_statistics, c_priority_lanes_count>;
+
+    //
+    // Writes the report of the call sites producing the most bytes so far to the session
+    // directory, replacing the previous one. Fails with call_site_profiling_disabled if
+    // call site profiling is not enabled.
+    //
+    static
+    auto
+    write_call_site_report() -> status_code;
+
+    //
+    // Awaitable flush. Suspends the awaiting coroutine while the buffers are written out on
+    // the logger completion thread and resumes it with the status of the flush, through the
+    // resume callback if one is set. Does not block the awaiting thread.
+    //
+    static
+    auto
+    flush_async() -> log_completion_awaitable;
+
+    //
+    // Awaitable durable write. Logs the message right away, regardless of the configured
+    // durable level, then suspends the awaiting coroutine until the record is on stable
+    // storage and resumes it with the status of the sync. Before initialization the record
+    // is captured like with log and the sync completes with logger_not_initialized.
+    //
+    template<typename... Args>
+    static
+    auto
+    log_durable_async(
+        const log_level& p_log_level,
+        title_and_source_location p_title_and_source_location,
+        std::format_string<Args...> p_format,
+        Args&&... p_args) -> log_completion_awaitable
+    {
+        logger& instance = get_logger();
+        const std::uint64_t formatting_start_tick = instance.read_formatting_start_tick();
+        const std::string formatted_message = std::format(p_format, std::forward<Args>(p_args)...);
+
+        //
+        // The durability wait moves to the completion thread.
+        //
+        instance.log_implementation(
+            p_log_level,
+            p_title_and_source_location.m_source_location,
+            p_title_and_source_location.m_title,
+            formatted_message.c_str(),
+            false /* p_durability_wait_enabled */,
+            formatting_start_tick);
+
+        return log_completion_awaitable(
+            instance.m_log_completion_queue,
+            completion_operation::durability);
+    }
+
+    //
+    // Sets the hook used for handing coroutines suspended on the awaitable operations back to
+    // their executor, e.g. by posting the handle to its run queue. An empty hook, the default,
+    // resumes them inline on the logger completion thread.
+    //
+    static
+    auto
+    set_resume_callback(
+        resume_callback p_resume_callback) -> void;
+
+    //
+    // Subscribes an in-process consumer to the records as they are produced.
+    // The callback runs on a thread owned by the returned subscription; a consumer that
+    // falls behind loses records, reported by its lag counter, instead of slowing the
+    // producers. Destroying the subscription unsubscribes. Does not require initialization.
+    //
+    static
+    auto
+    subscribe(
+        const log_subscription_filter& p_filter,
+        std::function<void(const log_record&)> p_callback) -> std::unique_ptr<log_subscription>;
+
 private:
 
+    friend class log_batch;
+
+    friend class named_logger;
+
+    //
+    // Deleter of the named instances, which can reach the private destructor.
     //
-    // Constructor for the singleton logger instance.
+    struct named_instance_deleter
+    {
+
+        auto
+        operator()(
+            logger* p_logger) const -> void
+        {
+            delete p_logger;
+        }
+
+    };
+
+    //
+    // Constructor for a logger instance.
     //
     logger();
 
+    //
+    // Destructor.
+    //
+    ~logger();
+
+    //
+    // Determines whether records of the given level pass the configured minimum level.
+    //
+    inline
+    auto
+    is_log_level_enabled(
+        const log_level p_log_level) const -> bool
+    {
+        return static_cast<std::uint8_t>(p_log_level) >= m_minimum_log_level.load(std::memory_order_relaxed);
+    }
+
+    //
+    // Reads the timestamp counter before formatting a record while call sites are profiled; zero otherwise.
+    //
+    inline
+    auto
+    read_formatting_start_tick() const -> std::uint64_t
+    {
+        return m_call_site_profiling_enabled.load(std::memory_order_relaxed) ? read_timestamp_counter() : 0u;
+    }
+
     //
     // Gets the logger initialization status.
     //
@@ -91,29 +283,174 @@ private:
     is_logger_initialized_implementation() -> bool;  
 
     //
-    // Initializes the singleton logger instance.
+    // Initializes the logger instance.
     //
     auto
     initialize_implementation(
         const logger_configuration& p_logger_configuration) -> void;
 
     //
-    // Logs a message through the singleton logger instance.
+    // Replaces the configuration of the logger instance.
+    //
+    auto
+    reconfigure_implementation(
+        const logger_configuration& p_logger_configuration) -> void;
+
+    //
+    // Shuts down the logger instance.
+    //
+    auto
+    shutdown_implementation() -> void;
+
+    //
+    // Flushes the buffers of the logger instance.
+    //
+    auto
+    flush_implementation() -> status_code;
+
+    //
+    // Gets the counters of the priority lanes of the logger instance.
+    //
+    auto
+    get_priority_lane_statistics_implementation() -> std::array<priority_lane_statistics, c_priority_lanes_count>;
+
+    //
+    // Writes the call site report of the logger instance.
+    //
+    auto
+    write_call_site_report_implementation() -> status_code;
+
+    //
+    // Waits until the records of the logger instance are on stable storage.
+    //
+    auto
+    wait_for_durability_implementation() -> status_code;
+
+    //
+    // Logs a message through the logger instance.
     //
     auto
     log_implementation(
         const log_level& p_log_level,
         const std::source_location& p_source_location,
         const char* p_title,
-        const char* p_message) -> void;
+        const char* p_message,
+        const bool p_durability_wait_enabled = true,
+        const std::uint64_t p_formatting_start_tick = 0u) -> void;
+
+    //
+    // Logs the records of a batch as a unit through the logger instance.
+    //
+    auto
+    log_batch_implementation(
+        const std::span<const log_batch_record> p_log_batch_records) -> void;
+
+    //
+    // Retires a replaced engine and keeps the ticket of its retirement. Called under the lock.
+    //
+    auto
+    retire_logging_engine(
+        logging_engine* p_logging_engine) -> void;
+
+    //
+    // Waits until every engine retired by the instance is deleted, backing off between checks.
+    // Engines retired by other instances are not waited for. Called under the lock.
+    //
+    auto
+    wait_for_retired_logging_engines() -> void;
+
+    //
+    // Replays the records captured before initialization into a new engine, before it is published.
+    //
+    auto
+    replay_pre_initialization_records(
+        logging_engine& p_logging_engine) -> void;
+
+    //
+    // Takes the locks of the logger instance right before a fork.
+    //
+    auto
+    prepare_fork_implementation() -> void;
+
+    //
+    // Releases the locks of the logger instance in the parent process after a fork.
+    //
+    auto
+    complete_fork_in_parent_implementation() -> void;
+
+    //
+    // Resets the logger instance in the child process after a fork and releases its locks.
+    // The engine of the parent is dropped and flagged for a rebuild; nothing is allocated
+    // and no thread is started here.
+    //
+    auto
+    complete_fork_in_child_implementation() -> void;
+
+    //
+    // Builds the engine of the instance in a child process on its first call after a fork,
+    // if still pending.
+    //
+    auto
+    rebuild_logging_engine_after_fork() -> void;
+
+    //
+    // Rebuilds the engine of the instance if a fork left it pending.
+    //
+    inline
+    auto
+    complete_pending_fork_rebuild() -> void
+    {
+        if (m_rebuild_after_fork_pending.load(std::memory_order_acquire))
+        {
+            rebuild_logging_engine_after_fork();
+        }
+    }
+
+    //
+    // Registers the fork handlers of the process, once.
+    //
+    static
+    auto
+    register_fork_handlers() -> void;
 
     //
-    // Gets and constructs the singleton logger instance by lazy initialization.
+    // Fork handlers covering the default instance and every named instance.
+    //
+    static
+    auto
+    prepare_fork() -> void;
+
+    static
+    auto
+    complete_fork_in_parent() -> void;
+
+    static
+    auto
+    complete_fork_in_child() -> void;
+
+    //
+    // Gets and constructs the default logger instance by lazy initialization.
     //
     static
     auto
     get_logger() -> logger&;
 
+    //
+    // Gets the named instance of the given name, constructing it on first use.
+    //
+    static
+    auto
+    get_named_instance(
+        const std::string_view p_name) -> logger&;
+
+    static
+    auto
+    get_named_instances_lock() -> std::mutex&;
+
+    static
+    auto
+    get_named_instances() -> std::map<std::string, std::unique_ptr<logger, named_instance_deleter>, std::less<>>&;
+
     //
     // Logs a message to the standard error stream and syslog.
     // Not thread-safe; caller responsible for synchronization.
@@ -144,14 +481,65 @@ private:
         const char* p_message) -> void;
 
     //
-    // Logging engine used to handle logs dispatching.
+    // Current logging engine snapshot used to handle logs dispatching.
+    // Readers protect it through hazard pointers; it is replaced as a whole on reconfiguration.
+    //
+    std::atomic<logging_engine*> m_logging_engine;
+
+    //
+    // Mirror of the minimum log level of the current engine, used to skip formatting.
+    //
+    std::atomic<std::uint8_t> m_minimum_log_level;
+
+    //
+    // Mirror of the call site profiling flag of the current engine, used to time formatting.
+    //
+    std::atomic<bool> m_call_site_profiling_enabled;
+
+    //
+    // Lock for serializing initialization, reconfiguration and shutdown.
+    // Never taken on the logging hotpath.
+    //
+    std::mutex m_lock;
+
+    //
+    // Configuration of the current engine, for restarting it in a child process after a fork.
+    // Only accessed under the lock.
+    //
+    std::optional<logger_configuration> m_logger_configuration;
+
+    //
+    // Whether a fork left the instance without the engine it was initialized with, to be rebuilt
+    // in the child on its first call.
+    //
+    std::atomic<bool> m_rebuild_after_fork_pending;
+
+    //
+    // Engine of the parent process left behind in a child, for linking the session of the child
+    // back to it. Only accessed under the lock.
+    //
+    const logging_engine* m_parent_logging_engine;
+
+    //
+    // Retirement tickets of the engines replaced by the instance and not known to be deleted yet.
+    // Only accessed under the lock.
+    //
+    std::vector<std::uint64_t> m_retired_logging_engine_tickets;
+
+    //
+    // Broadcaster for fanning out records to live subscribers.
+    //
+    log_broadcaster m_log_broadcaster;
+
+    //
+    // Queue for running the awaitable operations off the awaiting threads.
     //
-    std::unique_ptr<logging_engine> m_logging_engine;
+    log_completion_queue m_log_completion_queue;
 
     //
-    // Lock for handling access synchronization to the object.
+    // Buffer capturing the records logged while no engine is published.
     //
-    mutable std::shared_mutex m_lock;
+    pre_initialization_buffer m_pre_initialization_buffer;
 
 };
 
@@ -8,12 +8,39 @@
 
 #pragma once
 
+#include <string>
+#include <vector>
 #include <cstdint>
+#include <optional>
 #include <filesystem>
+#include "log_level.hh"
 
 namespace echo
 {
 
+//
+// Rule sending the records of the titles that start with a prefix to a segment stream of
+// their own, 'log_<session>_<stream>_<count>.log', next to the main stream of the session.
+//
+struct title_route
+{
+
+    //
+    // Prefix of the routed titles. An exact title is a prefix of itself.
+    //
+    std::string title_prefix;
+
+    //
+    // Name of the segment stream. Made of letters, digits, dashes and underscores.
+    // Several routes can share a stream.
+    //
+    std::string stream_name;
+
+    auto
+    operator==(const title_route&) const -> bool = default;
+
+};
+
 //
 // Logger configuration container for specifying logger startup options.
 //
@@ -32,7 +59,33 @@ struct logger_configuration
           utc_enabled{true},
           component_name{"EchoLogger"},
           flush_frequency_ms{1'000u},
-          include_source_location{true}
+          include_source_location{true},
+          shared_memory_mode_enabled{false},
+          shared_memory_ring_size_mib{8u},
+          segment_index_enabled{true},
+          segment_index_block_record_count{256u},
+          minimum_log_level{log_level::info},
+          durable_log_level{log_level::critical},
+          sharded_mode_enabled{false},
+          shards_count{0u},
+          shard_per_numa_node{false},
+          direct_io_enabled{false},
+          duplicate_suppression_window_ms{0u},
+          duplicate_suppression_slots_count{1024u},
+          memory_spill_size_mib{16u},
+          shipping_socket_path{std::nullopt},
+          shipping_buffer_size_mib{8u},
+          shipping_compression_enabled{false},
+          disk_logging_enabled{true},
+          trace_enabled{false},
+          info_lane_size_mib{16u},
+          call_site_profiling_enabled{false},
+          call_site_report_interval_ms{0u},
+          call_site_report_call_sites_count{50u},
+          title_routes{},
+          flight_recorder_mode_enabled{false},
+          flight_recorder_ring_size_kib{1024u},
+          flight_recorder_per_thread_rings_enabled{false}
     {}
 
     //
@@ -50,7 +103,9 @@ struct logger_configuration
     bool log_to_syslog_on_failure;
 
     //
-    // Flag for determining if the loggger will work on sync or async mode.
+    // Flag for determining if the loggger will work on sync or async mode. In async mode records
+    // are queued in memory and written out by a background thread every flush period; error and
+    // critical records are written out right away, ahead of the queued lower level records.
     //
     bool async_mode_enabled;
 
@@ -76,9 +131,186 @@ struct logger_configuration
 
     //
     // Flag for determining if source location details should be included in the log message.
+    // Records without them leave the File, Function and Line fields out of their header.
     //
     bool include_source_location;
 
+    //
+    // Flag for determining if logs should be placed into a shared memory ring instead of
+    // being written to disk by this process. An echo collector running for the same component
+    // name drains the rings of all processes into a single ordered set of segments. Records
+    // committed to the ring are still collected if the process crashes.
+    //
+    bool shared_memory_mode_enabled;
+
+    //
+    // Size in MiB of the shared memory ring. Only applies for shared memory mode logging.
+    // Records are dropped when the ring is full rather than blocking the caller.
+    //
+    std::uint32_t shared_memory_ring_size_mib;
+
+    //
+    // Flag for determining if a sidecar index is maintained next to each logs file.
+    // The index lets echo_query read only the blocks that can match a query. Indexed
+    // writes are serialized within the process so that record offsets are exact.
+    //
+    bool segment_index_enabled;
+
+    //
+    // Count of records covered by each sidecar index entry.
+    //
+    std::uint32_t segment_index_block_record_count;
+
+    //
+    // Lowest level of the records to be logged. Lower level records are discarded before formatting.
+    //
+    log_level minimum_log_level;
+
+    //
+    // Lowest level of the records that must be on stable storage before the log call returns.
+    // Such calls wait for an fdatasync shared with every concurrent durable call (group commit);
+    // lower level records stay buffered by the operating system. Durability is disabled if not set.
+    // Only applies for sync mode logging written by this process.
+    //
+    std::optional<log_level> durable_log_level;
+
+    //
+    // Flag for determining if the logging session is split into one segment stream per shard.
+    // Callers buffer records in the shard of the CPU they run on and a flusher thread pinned to
+    // that shard writes them every flush period, so there is no process-wide write lock. Records
+    // are time-ordered within each shard stream; use echo_merge to read the session as one stream.
+    //
+    bool sharded_mode_enabled;
+
+    //
+    // Count of shards. Zero creates one shard per CPU core. Only applies for sharded mode logging.
+    //
+    std::uint32_t shards_count;
+
+    //
+    // Flag for creating one shard per NUMA node instead. Only applies for sharded mode logging.
+    //
+    bool shard_per_numa_node;
+
+    //
+    // Flag for determining if logs files are written through O_DIRECT from page-aligned
+    // buffers, keeping logs out of the page cache. Data reaches the file in 1 MiB blocks,
+    // and the final partial block on flush, durable writes, file rotation and shutdown.
+    // Does not apply for shared memory mode logging.
+    //
+    bool direct_io_enabled;
+
+    //
+    // Length in milliseconds of the duplicate suppression window. Repeats of an identical
+    // message from the same call site inside the window are dropped and replaced by a single
+    // "repeated N times" record once the window closes. Zero disables the suppression.
+    //
+    std::uint32_t duplicate_suppression_window_ms;
+
+    //
+    // Count of (call site, message) pairs tracked at once for duplicate suppression.
+    // Bounds the memory of the suppression table.
+    //
+    std::uint32_t duplicate_suppression_slots_count;
+
+    //
+    // Max size in MiB of the records kept in memory while the logs volume is failing.
+    // After repeated write failures the writer stops touching the disk, spills records to
+    // memory and probes for recovery in the background, replaying the spill once the disk
+    // is back. Records beyond this bound are dropped and accounted for on recovery.
+    // The bound applies to each segment stream, that is, to each shard in sharded mode.
+    //
+    std::uint32_t memory_spill_size_mib;
+
+    //
+    // Path to the Unix domain socket of a socket log collector. When set, records are also
+    // streamed in batches to the collector every flush period, which writes them into the
+    // standard segment layout on its side; see the echo_socket_collector binary.
+    //
+    std::optional<std::filesystem::path> shipping_socket_path;
+
+    //
+    // Max size in MiB of the records buffered for shipping while the collector is slow or
+    // unreachable. Records beyond this bound are dropped. Only applies when shipping.
+    //
+    std::uint32_t shipping_buffer_size_mib;
+
+    //
+    // Flag for LZ4-compressing the shipped batches. Requires a library built with the
+    // ECHO_LOGGER_LZ4 CMake option; ignored otherwise. Only applies when shipping.
+    //
+    bool shipping_compression_enabled;
+
+    //
+    // Flag for determining if records are written to disk on this host. When disabled, records
+    // only reach the console, the live subscribers and the shipping collector.
+    //
+    bool disk_logging_enabled;
+
+    //
+    // Flag for recording the spans of echo::trace_span scopes. Spans are written as Chrome
+    // trace event JSON files, 'trace_<session>_<count>.json', next to the logs of the session,
+    // and can be opened in Perfetto. Spans cost a single relaxed load while disabled.
+    //
+    bool trace_enabled;
+
+    //
+    // Max size in MiB of the information records queued in async mode. Records are queued in
+    // one lane per severity band and the higher lanes are always written out first; past this
+    // bound information records are shed, while warning, error and critical records never are.
+    // Only applies for async mode logging.
+    //
+    std::uint32_t info_lane_size_mib;
+
+    //
+    // Flag for counting the records, bytes and formatting time of every call site. The top
+    // call sites by bytes are reported to 'call_sites_<session>.txt' in the session directory
+    // on demand with logger::write_call_site_report, periodically if an interval is set, and
+    // when the session ends. Costs two timestamp counter reads and an uncontended lock per record.
+    //
+    bool call_site_profiling_enabled;
+
+    //
+    // Interval in milliseconds between call site reports. Reports are only written on demand
+    // and at the end of the session if not set. Only applies for call site profiling.
+    //
+    std::uint32_t call_site_report_interval_ms;
+
+    //
+    // Count of call sites listed by a call site report. Only applies for call site profiling.
+    //
+    std::uint32_t call_site_report_call_sites_count;
+
+    //
+    // Routes of titles to segment streams of their own, each written and rotated on its own,
+    // so that per-component readers only read their own files. A title goes to the stream of
+    // the longest matching prefix, and to the main stream if none matches. Routing is resolved
+    // once per title and cached, which expects titles to be valid for the lifetime of the
+    // program like the logger does. Only applies for sync and async mode logging to disk.
+    //
+    std::vector<title_route> title_routes;
+
+    //
+    // Flag for holding the records in bounded in-memory rings instead of writing them. The rings
+    // are only written out, in order and followed by the triggering record, when an error or
+    // critical record is logged or the logger is flushed, so disk I/O stays proportional to the
+    // error rate; records still held at shutdown are discarded. Evicted records leave gaps in the
+    // sequence numbers. Only applies for sync and async mode logging to disk.
+    //
+    bool flight_recorder_mode_enabled;
+
+    //
+    // Capacity in KiB of the formatted records held by a flight recorder ring. Once full, the
+    // oldest records are evicted. Only applies for flight recorder mode.
+    //
+    std::uint32_t flight_recorder_ring_size_kib;
+
+    //
+    // Flag for giving every thread a ring of its own, of the full capacity, so that the context
+    // of a thread is not evicted by the others. Only applies for flight recorder mode.
+    //
+    bool flight_recorder_per_thread_rings_enabled;
+
 };
 
 } // namespace echo.
\ No newline at end of file
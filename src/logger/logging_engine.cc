@@ -7,30 +7,291 @@
 // ****************************************************
 
 #include <format>
+#include <iterator>
+#include <algorithm>
+#include <thread>
 #include <iostream>
+#include "log_batch.hh"
 #include "logging_engine.hh"
+#include "../utils/time_utilities.hh"
 #include "../utils/uuid_utilities.hh"
 
 namespace echo
 {
 
 logging_engine::logging_engine(
-    const logger_configuration& p_logger_configuration)
+    const logger_configuration& p_logger_configuration,
+    log_broadcaster* p_log_broadcaster,
+    const logging_engine* p_predecessor)
+    : logging_engine(
+        p_logger_configuration,
+        p_log_broadcaster,
+        session_continuation{can_continue_session(p_logger_configuration, p_predecessor) ? p_predecessor : nullptr})
+{}
+
+logging_engine::logging_engine(
+    const logger_configuration& p_logger_configuration,
+    log_broadcaster* p_log_broadcaster,
+    const session_continuation& p_session_continuation)
     : m_component_name{p_logger_configuration.component_name},
-      m_session_id{uuid_to_string(generate_uuid())},
+      m_minimum_log_level{p_logger_configuration.minimum_log_level},
+      m_durable_log_level{p_logger_configuration.durable_log_level},
+      m_logs_directory_path{std::filesystem::absolute(p_logger_configuration.logs_directory_path)},
+      m_session_id{
+        p_session_continuation.m_predecessor != nullptr ?
+            p_session_continuation.m_predecessor->m_session_id :
+            uuid_to_string(generate_uuid())},
       m_logging_session_directory_path{
-        std::filesystem::absolute(p_logger_configuration.logs_directory_path) /
+        m_logs_directory_path /
         std::string(m_component_name + "-logs-" + m_session_id)},
-      m_filesystem_writer{m_session_id, m_logging_session_directory_path},
+      m_filesystem_writer{
+        p_session_continuation.m_predecessor != nullptr ?
+            p_session_continuation.m_predecessor->m_filesystem_writer :
+            std::make_shared<filesystem_writer>(
+                m_session_id,
+                m_logging_session_directory_path,
+                p_logger_configuration.segment_index_enabled,
+                p_logger_configuration.segment_index_block_record_count,
+                p_logger_configuration.direct_io_enabled,
+                p_logger_configuration.memory_spill_size_mib,
+                p_logger_configuration.log_to_syslog_on_failure)},
       m_process_id{getpid()},
       m_debug_mode_enabled{p_logger_configuration.debug_mode_enabled},
       m_log_to_syslog_on_failure{p_logger_configuration.log_to_syslog_on_failure},
-      m_async_mode_enabled{p_logger_configuration.async_mode_enabled}
+      m_async_mode_enabled{p_logger_configuration.async_mode_enabled},
+      m_utc_enabled{p_logger_configuration.utc_enabled},
+      m_title_routes{p_logger_configuration.title_routes},
+      m_disk_logging_enabled{p_logger_configuration.disk_logging_enabled},
+      m_log_broadcaster{p_log_broadcaster},
+      m_duplicate_suppressor{
+        p_logger_configuration.duplicate_suppression_window_ms != 0u ?
+            std::make_unique<duplicate_suppressor>(
+                p_logger_configuration.duplicate_suppression_window_ms,
+                p_logger_configuration.duplicate_suppression_slots_count) :
+            nullptr},
+      m_log_header_encoder{m_session_id, m_process_id, m_utc_enabled, p_logger_configuration.include_source_location},
+      m_logger_configuration{p_logger_configuration}
 {
+    if (p_logger_configuration.shipping_socket_path.has_value())
+    {
+        const logging_engine* predecessor = p_session_continuation.m_predecessor;
+
+        //
+        // A continued session keeps its connection to the collector unless the shipping settings changed.
+        //
+        m_socket_log_shipper =
+            predecessor != nullptr &&
+            predecessor->m_socket_log_shipper != nullptr &&
+            predecessor->m_logger_configuration.shipping_socket_path == p_logger_configuration.shipping_socket_path &&
+            predecessor->m_logger_configuration.shipping_buffer_size_mib == p_logger_configuration.shipping_buffer_size_mib &&
+            predecessor->m_logger_configuration.shipping_compression_enabled == p_logger_configuration.shipping_compression_enabled ?
+                predecessor->m_socket_log_shipper :
+                std::make_shared<socket_log_shipper>(
+                    p_logger_configuration.shipping_socket_path.value(),
+                    m_component_name,
+                    m_session_id,
+                    p_logger_configuration.shipping_buffer_size_mib,
+                    p_logger_configuration.shipping_compression_enabled,
+                    p_logger_configuration.flush_frequency_ms);
+    }
+
+    if (p_logger_configuration.trace_enabled)
+    {
+        //
+        // A continued session keeps its trace exporter, and with it its trace file.
+        // Can throw if the session directory could not be created.
+        //
+        m_trace_exporter =
+            p_session_continuation.m_predecessor != nullptr &&
+            p_session_continuation.m_predecessor->m_trace_exporter != nullptr ?
+                p_session_continuation.m_predecessor->m_trace_exporter :
+                std::make_shared<trace_exporter>(
+                    m_session_id,
+                    m_logging_session_directory_path,
+                    m_process_id);
+    }
+
+    if (p_logger_configuration.call_site_profiling_enabled)
+    {
+        //
+        // A continued session keeps its profiler, and with it the counts so far, unless the report settings changed.
+        //
+        m_call_site_profiler =
+            p_session_continuation.m_predecessor != nullptr &&
+            p_session_continuation.m_predecessor->m_call_site_profiler != nullptr &&
+            p_session_continuation.m_predecessor->m_logger_configuration.call_site_report_interval_ms == p_logger_configuration.call_site_report_interval_ms &&
+            p_session_continuation.m_predecessor->m_logger_configuration.call_site_report_call_sites_count == p_logger_configuration.call_site_report_call_sites_count ?
+                p_session_continuation.m_predecessor->m_call_site_profiler :
+                std::make_shared<call_site_profiler>(
+                    m_session_id,
+                    m_logging_session_directory_path,
+                    p_logger_configuration.call_site_report_interval_ms,
+                    p_logger_configuration.call_site_report_call_sites_count);
+    }
+
+    if (p_session_continuation.m_predecessor != nullptr)
+    {
+        //
+        // The session directory and, in shared memory mode, the ring already exist.
+        //
+        m_shared_memory_ring = p_session_continuation.m_predecessor->m_shared_memory_ring;
+        m_sharded_writer = p_session_continuation.m_predecessor->m_sharded_writer;
+        m_disk_flush_manager = p_session_continuation.m_predecessor->m_disk_flush_manager;
+        m_title_router = p_session_continuation.m_predecessor->m_title_router;
+        m_routed_streams = p_session_continuation.m_predecessor->m_routed_streams;
+        m_flight_recorder = p_session_continuation.m_predecessor->m_flight_recorder;
+
+        return;
+    }
+
+    if (p_logger_configuration.shared_memory_mode_enabled)
+    {
+        //
+        // Logs are handed over to the collector; this process does not touch the disk.
+        // Can throw if the shared memory ring could not be created.
+        //
+        m_shared_memory_ring = std::make_shared<shared_memory_ring>(
+            std::format(
+                "{}{}-{}-{}",
+                shared_memory_ring::c_ring_name_prefix,
+                m_component_name,
+                m_process_id,
+                m_session_id),
+            p_logger_configuration.shared_memory_ring_size_mib * 1024u * 1024u);
+
+        return;
+    }
+
+    if (!m_disk_logging_enabled)
+    {
+        return;
+    }
+
+    if (p_logger_configuration.sharded_mode_enabled)
+    {
+        m_sharded_writer = std::make_shared<sharded_writer>(
+            m_session_id,
+            m_logging_session_directory_path,
+            p_logger_configuration.shards_count,
+            p_logger_configuration.shard_per_numa_node,
+            p_logger_configuration.flush_frequency_ms,
+            p_logger_configuration.segment_index_enabled,
+            p_logger_configuration.segment_index_block_record_count,
+            p_logger_configuration.direct_io_enabled,
+            p_logger_configuration.memory_spill_size_mib,
+            p_logger_configuration.log_to_syslog_on_failure);
+    }
+    else
+    {
+        if (m_async_mode_enabled)
+        {
+            m_disk_flush_manager = std::make_shared<disk_flush_manager>(
+                m_filesystem_writer,
+                p_logger_configuration.flush_frequency_ms,
+                p_logger_configuration.info_lane_size_mib);
+        }
+
+        if (!m_title_routes.empty())
+        {
+            //
+            // Every routed stream is written and rotated on its own: 'log_<session>_<stream>_<count>.log'.
+            // Can throw if a stream name is invalid.
+            //
+            m_title_router = std::make_shared<title_router>(m_title_routes);
+
+            for (const std::string& stream_name : m_title_router->get_stream_names())
+            {
+                routed_stream stream;
+
+                stream.m_filesystem_writer = std::make_shared<filesystem_writer>(
+                    std::format("{}_{}", m_session_id, stream_name),
+                    m_logging_session_directory_path,
+                    p_logger_configuration.segment_index_enabled,
+                    p_logger_configuration.segment_index_block_record_count,
+                    p_logger_configuration.direct_io_enabled,
+                    p_logger_configuration.memory_spill_size_mib,
+                    p_logger_configuration.log_to_syslog_on_failure);
+
+                if (m_async_mode_enabled)
+                {
+                    //
+                    // Sequence numbers come from the writer of the session; so do the ledger entries of shed records.
+                    //
+                    stream.m_disk_flush_manager = std::make_shared<disk_flush_manager>(
+                        stream.m_filesystem_writer,
+                        p_logger_configuration.flush_frequency_ms,
+                        p_logger_configuration.info_lane_size_mib,
+                        m_filesystem_writer);
+                }
+
+                m_routed_streams.push_back(std::move(stream));
+            }
+        }
+
+        if (p_logger_configuration.flight_recorder_mode_enabled)
+        {
+            //
+            // Evicted records are accounted for in the ledger of the writer that numbered them,
+            // in bulk on dumps, flushes and shutdown.
+            //
+            m_flight_recorder = std::make_shared<flight_recorder>(
+                static_cast<std::uint64_t>(p_logger_configuration.flight_recorder_ring_size_kib) * 1024u,
+                p_logger_configuration.flight_recorder_per_thread_rings_enabled,
+                [filesystem_writer = m_filesystem_writer](
+                    const std::uint64_t p_first_sequence_number,
+                    const std::uint64_t p_records_count)
+                {
+                    filesystem_writer->retire_sequence_numbers(
+                        p_first_sequence_number,
+                        p_records_count,
+                        sequence_retirement_reason::evicted);
+                });
+        }
+    }
+
     //
-    // Can throw if the directory creation was not possible.
+    // Creating the session directory and the first logs file takes longer than the rest of the
+    // startup; it is moved off the initialization path. Records logged meanwhile do not wait
+    // for it: writes create both on their own when still missing.
     //
-    std::filesystem::create_directories(m_logging_session_directory_path);
+    m_startup_thread = std::thread(
+        [filesystem_writer = m_filesystem_writer,
+            logging_session_directory_path = m_logging_session_directory_path,
+            sharded_mode_enabled = p_logger_configuration.sharded_mode_enabled]()
+        {
+            if (sharded_mode_enabled)
+            {
+                //
+                // Shards create their own logs files.
+                //
+                std::error_code error_code;
+
+                std::filesystem::create_directories(logging_session_directory_path, error_code);
+
+                return;
+            }
+
+            filesystem_writer->prepare();
+        });
+}
+
+logging_engine::~logging_engine()
+{
+    if (m_startup_thread.joinable())
+    {
+        m_startup_thread.join();
+    }
+
+    if (m_duplicate_suppressor != nullptr)
+    {
+        //
+        // Account for the repeats of the windows still open; the writers outlive this call.
+        //
+        for (const suppressed_message_summary& summary : m_duplicate_suppressor->collect_closed_summaries(std::nullopt))
+        {
+            log_suppressed_message_summary(summary);
+        }
+    }
 }
 
 auto
@@ -38,14 +299,444 @@ logging_engine::log(
     const log_level& p_log_level,
     const std::source_location& p_source_location,
     const char* p_title,
-    const char* p_message) -> void
+    const char* p_message,
+    const bool p_durability_wait_enabled,
+    const std::uint64_t p_formatting_start_tick) -> status_code
 {
-    const std::string log_message = create_formatted_log_message(
+    if (!is_log_level_enabled(p_log_level))
+    {
+        return status::success;
+    }
+
+    if (m_duplicate_suppressor != nullptr)
+    {
+        const std::uint64_t timestamp_ns = get_current_timestamp_ns();
+        std::optional<suppressed_message_summary> closed_summary;
+
+        const bool suppressed = m_duplicate_suppressor->is_suppressed(
+            p_log_level,
+            p_source_location,
+            p_title,
+            p_message,
+            timestamp_ns,
+            closed_summary);
+
+        if (closed_summary.has_value())
+        {
+            log_suppressed_message_summary(closed_summary.value());
+        }
+
+        for (const suppressed_message_summary& summary : m_duplicate_suppressor->collect_closed_summaries(timestamp_ns))
+        {
+            log_suppressed_message_summary(summary);
+        }
+
+        if (suppressed)
+        {
+            return status::success;
+        }
+    }
+
+    return dispatch_log_message(
+        p_log_level,
+        p_source_location,
+        p_title,
+        p_message,
+        p_durability_wait_enabled,
+        std::nullopt,
+        p_formatting_start_tick);
+}
+
+auto
+logging_engine::log_batch(
+    const std::span<const log_batch_record> p_log_batch_records) -> void
+{
+    std::vector<const log_batch_record*> records;
+    records.reserve(p_log_batch_records.size());
+
+    bool durability_wait_required = false;
+
+    for (const log_batch_record& record : p_log_batch_records)
+    {
+        if (is_log_level_enabled(record.m_log_level))
+        {
+            records.push_back(&record);
+
+            durability_wait_required = durability_wait_required ||
+                (m_durable_log_level.has_value() && record.m_log_level >= m_durable_log_level.value());
+        }
+    }
+
+    if (records.empty())
+    {
+        return;
+    }
+
+    //
+    // A single reservation covers the whole batch so that no other record can land in between.
+    //
+    const std::uint32_t shard_index = m_sharded_writer != nullptr ? m_sharded_writer->get_current_shard_index() : 0u;
+
+    const record_reservation reservation = m_sharded_writer != nullptr ?
+        m_sharded_writer->reserve_record(shard_index, records.size()) :
+        record_reservation{m_filesystem_writer->allocate_sequence_number(records.size()), get_current_timestamp_ns()};
+
+    record_reservation_guard reservation_guard {
+        m_sharded_writer.get(),
+        shard_index,
+        reservation.m_sequence_number,
+        records.size()};
+
+    std::string log_messages;
+    std::string log_message;
+    std::vector<log_record_extent> extents;
+    extents.reserve(records.size());
+
+    for (std::size_t record_index = 0u; record_index < records.size(); ++record_index)
+    {
+        const log_batch_record& record = *records[record_index];
+        const std::uint64_t formatting_start_tick = m_call_site_profiler != nullptr ? read_timestamp_counter() : 0u;
+
+        m_log_header_encoder.encode(
+            log_message,
+            reservation.m_timestamp_ns,
+            reservation.m_sequence_number + record_index,
+            record.m_log_level,
+            record.m_source_location,
+            record.m_title,
+            record.m_message);
+
+        if (m_call_site_profiler != nullptr)
+        {
+            //
+            // Batch messages are formatted as they are added; only their headers are timed.
+            //
+            m_call_site_profiler->record(
+                record.m_log_level,
+                record.m_source_location,
+                record.m_title,
+                log_message.size(),
+                formatting_start_tick);
+        }
+
+        if (m_log_broadcaster != nullptr &&
+            m_log_broadcaster->has_subscribers())
+        {
+            m_log_broadcaster->publish(
+                reservation.m_timestamp_ns,
+                record.m_log_level,
+                record.m_title,
+                log_message);
+        }
+
+        log_messages += log_message;
+        extents.push_back(log_record_extent{
+            log_record_metadata{reservation.m_timestamp_ns, record.m_log_level, record.m_title, reservation.m_sequence_number + record_index},
+            log_message.size()});
+    }
+
+    if (m_debug_mode_enabled)
+    {
+        std::scoped_lock<std::mutex> lock {m_std_output_lock};
+
+        log_message_to_console(log_messages.c_str());
+    }
+
+    if (m_socket_log_shipper != nullptr)
+    {
+        m_socket_log_shipper->ship(
+            extents,
+            log_messages);
+    }
+
+    if (!m_disk_logging_enabled)
+    {
+        return;
+    }
+
+    if (m_shared_memory_ring != nullptr)
+    {
+        //
+        // The whole batch travels as a single ring record; the collector writes it as is.
+        //
+        m_shared_memory_ring->append(
+            reservation.m_timestamp_ns,
+            log_messages.c_str(),
+            static_cast<std::uint32_t>(log_messages.size()));
+
+        return;
+    }
+
+    if (m_sharded_writer != nullptr)
+    {
+        m_sharded_writer->append(
+            shard_index,
+            reservation.m_sequence_number,
+            std::move(extents),
+            std::move(log_messages));
+
+        reservation_guard.release();
+
+        if (durability_wait_required)
+        {
+            m_sharded_writer->wait_for_durability(shard_index, reservation.m_sequence_number + records.size() - 1u);
+        }
+
+        return;
+    }
+
+    if (m_flight_recorder != nullptr)
+    {
+        std::vector<flight_record> flight_records;
+        std::size_t offset_bytes = 0u;
+        bool dump_required = false;
+
+        flight_records.reserve(extents.size());
+
+        for (std::size_t record_index = 0u; record_index < extents.size(); ++record_index)
+        {
+            flight_records.push_back(flight_record{
+                reservation.m_sequence_number + record_index,
+                extents[record_index].m_metadata,
+                log_messages.substr(offset_bytes, extents[record_index].m_size_bytes)});
+
+            offset_bytes += extents[record_index].m_size_bytes;
+            dump_required = dump_required || extents[record_index].m_metadata.m_log_level >= log_level::error;
+        }
+
+        if (dump_required)
+        {
+            dump_flight_recorder(
+                std::move(flight_records),
+                durability_wait_required);
+
+            return;
+        }
+
+        for (flight_record& record : flight_records)
+        {
+            m_flight_recorder->record(std::move(record));
+        }
+
+        return;
+    }
+
+    write_batch_to_streams(
+        std::move(log_messages),
+        std::move(extents),
+        durability_wait_required);
+}
+
+auto
+logging_engine::write_batch_to_streams(
+    std::string&& p_log_messages,
+    std::vector<log_record_extent>&& p_log_record_extents,
+    const bool p_durability_wait_enabled) -> void
+{
+    if (m_title_router == nullptr)
+    {
+        write_batch_to_stream(
+            title_router::c_main_stream_index,
+            std::move(p_log_messages),
+            std::move(p_log_record_extents),
+            p_durability_wait_enabled);
+
+        return;
+    }
+
+    //
+    // The batch is split into one batch per stream; each one is written as a unit, in order.
+    //
+    std::vector<std::pair<std::string, std::vector<log_record_extent>>> stream_batches(m_routed_streams.size() + 1u);
+    std::size_t offset_bytes = 0u;
+
+    for (const log_record_extent& extent : p_log_record_extents)
+    {
+        auto& [stream_log_messages, stream_extents] = stream_batches[route_title(extent.m_metadata.m_title)];
+
+        stream_log_messages.append(p_log_messages, offset_bytes, extent.m_size_bytes);
+        stream_extents.push_back(extent);
+        offset_bytes += extent.m_size_bytes;
+    }
+
+    for (std::uint32_t stream_index = 0u; stream_index < stream_batches.size(); ++stream_index)
+    {
+        auto& [stream_log_messages, stream_extents] = stream_batches[stream_index];
+
+        if (!stream_extents.empty())
+        {
+            write_batch_to_stream(
+                stream_index,
+                std::move(stream_log_messages),
+                std::move(stream_extents),
+                p_durability_wait_enabled);
+        }
+    }
+}
+
+auto
+logging_engine::dump_flight_recorder(
+    std::vector<flight_record>&& p_triggering_flight_records,
+    const bool p_durability_wait_enabled) -> void
+{
+    std::scoped_lock<std::mutex> lock {m_flight_recorder->get_dump_lock()};
+
+    std::vector<flight_record> flight_records;
+
+    m_flight_recorder->drain(flight_records);
+
+    const std::size_t held_records_count = flight_records.size();
+
+    std::move(p_triggering_flight_records.begin(), p_triggering_flight_records.end(), std::back_inserter(flight_records));
+
+    //
+    // Records held by other threads can be newer than the triggering ones.
+    //
+    std::inplace_merge(
+        flight_records.begin(),
+        flight_records.begin() + held_records_count,
+        flight_records.end(),
+        [](const flight_record& p_left, const flight_record& p_right)
+        {
+            return p_left.m_sequence_number < p_right.m_sequence_number;
+        });
+
+    if (flight_records.empty())
+    {
+        return;
+    }
+
+    std::string log_messages;
+    std::vector<log_record_extent> extents;
+    extents.reserve(flight_records.size());
+
+    for (const flight_record& record : flight_records)
+    {
+        log_messages += record.m_log_message;
+        extents.push_back(log_record_extent{
+            record.m_metadata,
+            record.m_log_message.size()});
+    }
+
+    write_batch_to_streams(
+        std::move(log_messages),
+        std::move(extents),
+        p_durability_wait_enabled);
+}
+
+auto
+logging_engine::write_batch_to_stream(
+    const std::uint32_t p_stream_index,
+    std::string&& p_log_messages,
+    std::vector<log_record_extent>&& p_log_record_extents,
+    const bool p_durability_wait_enabled) -> void
+{
+    if (!m_async_mode_enabled)
+    {
+        filesystem_writer& stream_filesystem_writer = get_stream_filesystem_writer(p_stream_index);
+
+        const status_code status = stream_filesystem_writer.write_log_messages_to_disk(
+            p_log_messages,
+            p_log_record_extents);
+
+        if (status::succeeded(status) &&
+            p_durability_wait_enabled)
+        {
+            stream_filesystem_writer.wait_for_durability();
+        }
+
+        return;
+    }
+
+    //
+    // The batch is queued as a unit in the lane of its highest level.
+    //
+    disk_flush_manager& stream_disk_flush_manager = get_stream_disk_flush_manager(p_stream_index);
+
+    const status_code status = stream_disk_flush_manager.enqueue(
+        std::move(p_log_record_extents),
+        std::move(p_log_messages));
+
+    if (status::succeeded(status) &&
+        p_durability_wait_enabled)
+    {
+        stream_disk_flush_manager.wait_for_durability();
+    }
+}
+
+auto
+logging_engine::replay(
+    const std::uint64_t p_timestamp_ns,
+    const log_level& p_log_level,
+    const std::source_location& p_source_location,
+    const char* p_title,
+    const char* p_message) -> status_code
+{
+    if (!is_log_level_enabled(p_log_level))
+    {
+        return status::success;
+    }
+
+    return dispatch_log_message(
+        p_log_level,
+        p_source_location,
+        p_title,
+        p_message,
+        false /* p_durability_wait_enabled */,
+        p_timestamp_ns);
+}
+
+auto
+logging_engine::dispatch_log_message(
+    const log_level& p_log_level,
+    const std::source_location& p_source_location,
+    const char* p_title,
+    const char* p_message,
+    const bool p_durability_wait_enabled,
+    const std::optional<std::uint64_t> p_timestamp_ns,
+    const std::uint64_t p_formatting_start_tick) -> status_code
+{
+    const std::uint32_t shard_index = m_sharded_writer != nullptr ? m_sharded_writer->get_current_shard_index() : 0u;
+
+    const record_reservation reservation = m_sharded_writer != nullptr ?
+        m_sharded_writer->reserve_record(shard_index) :
+        record_reservation{m_filesystem_writer->allocate_sequence_number(), get_current_timestamp_ns()};
+
+    const std::uint64_t sequence_number = reservation.m_sequence_number;
+    const std::uint64_t timestamp_ns = p_timestamp_ns.value_or(reservation.m_timestamp_ns);
+
+    //
+    // A reserved shard record that never makes it to the append is abandoned, not waited for.
+    //
+    record_reservation_guard reservation_guard {
+        m_sharded_writer.get(),
+        shard_index,
+        sequence_number,
+        1u};
+
+    const std::uint64_t formatting_start_tick =
+        m_call_site_profiler != nullptr && p_formatting_start_tick == 0u ?
+            read_timestamp_counter() :
+            p_formatting_start_tick;
+
+    std::string log_message = create_formatted_log_message(
+        timestamp_ns,
+        sequence_number,
         p_log_level,
         p_source_location,
         p_title,
         p_message);
 
+    if (m_call_site_profiler != nullptr)
+    {
+        m_call_site_profiler->record(
+            p_log_level,
+            p_source_location,
+            p_title,
+            log_message.size(),
+            formatting_start_tick);
+    }
+
     if (m_debug_mode_enabled)
     {
         //
@@ -58,78 +749,394 @@ logging_engine::log(
         log_message_to_console(log_message.c_str());
     }
 
+    if (m_log_broadcaster != nullptr &&
+        m_log_broadcaster->has_subscribers())
+    {
+        //
+        // Only pay for the fan-out while someone is listening.
+        //
+        m_log_broadcaster->publish(
+            timestamp_ns,
+            p_log_level,
+            p_title,
+            log_message);
+    }
+
+    if (m_socket_log_shipper != nullptr)
+    {
+        //
+        // Records beyond the shipping buffer bound are dropped and counted by the shipper.
+        //
+        m_socket_log_shipper->ship(
+            timestamp_ns,
+            p_log_level,
+            p_title,
+            log_message);
+    }
+
+    if (!m_disk_logging_enabled)
+    {
+        return status::success;
+    }
+
+    if (m_shared_memory_ring != nullptr)
+    {
+        //
+        // Shared memory mode is specified. The collector owns the disk writes.
+        //
+        return m_shared_memory_ring->append(
+            timestamp_ns,
+            log_message.c_str(),
+            static_cast<std::uint32_t>(log_message.size()));
+    }
+
+    if (m_sharded_writer != nullptr)
+    {
+        //
+        // Sharded mode is specified. Buffer the record in the shard of the current CPU.
+        //
+        m_sharded_writer->append(
+            shard_index,
+            sequence_number,
+            log_record_metadata{timestamp_ns, p_log_level, p_title, sequence_number},
+            std::move(log_message));
+
+        reservation_guard.release();
+
+        if (p_durability_wait_enabled &&
+            m_durable_log_level.has_value() &&
+            p_log_level >= m_durable_log_level.value())
+        {
+            return m_sharded_writer->wait_for_durability(shard_index, sequence_number);
+        }
+
+        return status::success;
+    }
+
+    if (m_flight_recorder != nullptr)
+    {
+        //
+        // Flight recorder mode is specified. Hold the record in memory; an error
+        // or critical record writes out the held context along with itself.
+        //
+        flight_record record {
+            sequence_number,
+            log_record_metadata{timestamp_ns, p_log_level, p_title, sequence_number},
+            std::move(log_message)};
+
+        if (p_log_level < log_level::error)
+        {
+            m_flight_recorder->record(std::move(record));
+
+            return status::success;
+        }
+
+        std::vector<flight_record> triggering_records;
+        triggering_records.push_back(std::move(record));
+
+        dump_flight_recorder(
+            std::move(triggering_records),
+            p_durability_wait_enabled &&
+                m_durable_log_level.has_value() &&
+                p_log_level >= m_durable_log_level.value());
+
+        return status::success;
+    }
+
     if (!m_async_mode_enabled)
     {
         //
         // Sync mode is specified. Write the log
         // message directly to disk and cut the operation.
+        // Concurrent callers share their writes through flat combining.
         // Performance of async mode logging is much greater.
         // Consider switching to async mode for production workloads.
         //
-        m_filesystem_writer.write_log_message_to_disk(log_message.c_str());
+        const log_record_metadata metadata {timestamp_ns, p_log_level, p_title, sequence_number};
+        filesystem_writer& stream_filesystem_writer = get_stream_filesystem_writer(route_title(p_title));
 
-        return;
+        const status_code status = stream_filesystem_writer.write_log_message_combined(
+            log_message,
+            metadata);
+
+        if (status::succeeded(status) &&
+            p_durability_wait_enabled &&
+            m_durable_log_level.has_value() &&
+            p_log_level >= m_durable_log_level.value())
+        {
+            //
+            // Durable record; wait until a group sync covers it.
+            //
+            return stream_filesystem_writer.wait_for_durability();
+        }
+
+        //
+        // Spilled and failed writes are reported to the caller.
+        //
+        return status;
     }
 
+    //
+    // Async mode is specified. Queue the record in the lane of its level; the flusher
+    // writes out error and critical records right away, ahead of the queued ones.
+    // Information records are shed while their lane is full.
+    //
+    disk_flush_manager& stream_disk_flush_manager = get_stream_disk_flush_manager(route_title(p_title));
 
+    const status_code status = stream_disk_flush_manager.enqueue(
+        log_record_metadata{timestamp_ns, p_log_level, p_title, sequence_number},
+        std::move(log_message));
+
+    if (status::succeeded(status) &&
+        p_durability_wait_enabled &&
+        m_durable_log_level.has_value() &&
+        p_log_level >= m_durable_log_level.value())
+    {
+        return stream_disk_flush_manager.wait_for_durability();
+    }
+
+    return status;
 }
 
 auto
-logging_engine::create_formatted_log_message(
-    const log_level& p_log_level,
-    const std::source_location& p_source_location,
-    const char* p_title,
-    const char* p_message) -> std::string
+logging_engine::log_suppressed_message_summary(
+    const suppressed_message_summary& p_summary) -> void
 {
-    const char* level = nullptr;
+    const std::string summary_message = std::format(
+        "Previous message repeated {} times: {}",
+        p_summary.m_repeated_count,
+        p_summary.m_message_prefix);
+
+    dispatch_log_message(
+        p_summary.m_log_level,
+        p_summary.m_source_location,
+        p_summary.m_title,
+        summary_message.c_str(),
+        false /* p_durability_wait_enabled */);
+}
 
-    switch (static_cast<std::uint8_t>(p_log_level))
+auto
+logging_engine::flush() -> status_code
+{
+    if (m_duplicate_suppressor != nullptr)
     {
-        case static_cast<std::uint8_t>(log_level::info):
+        //
+        // Windows still open are closed early so that their repeats are accounted for.
+        //
+        for (const suppressed_message_summary& summary : m_duplicate_suppressor->collect_closed_summaries(std::nullopt))
         {
-            level = c_info_log_level;
-
-            break;
+            log_suppressed_message_summary(summary);
         }
-        case static_cast<std::uint8_t>(log_level::warning):
-        {
-            level = c_warning_log_level;
+    }
 
-            break;
-        }
-        case static_cast<std::uint8_t>(log_level::error):
-        {
-            level = c_error_log_level;
+    if (m_trace_exporter != nullptr)
+    {
+        //
+        // Trace files are best effort; they do not fail the flush of the records.
+        //
+        m_trace_exporter->flush();
+    }
 
-            break;
-        }
-        case static_cast<std::uint8_t>(log_level::critical):
-        {
-            level = c_critical_log_level;
+    status_code status = status::success;
+
+    if (m_socket_log_shipper != nullptr)
+    {
+        status = m_socket_log_shipper->flush();
+    }
+
+    if (!m_disk_logging_enabled)
+    {
+        return status;
+    }
+
+    if (m_sharded_writer != nullptr)
+    {
+        return m_sharded_writer->flush();
+    }
+
+    if (m_flight_recorder != nullptr)
+    {
+        dump_flight_recorder(
+            {},
+            false /* p_durability_wait_enabled */);
+    }
 
-            break;
+    for (std::uint32_t stream_index = 0u; stream_index <= m_routed_streams.size(); ++stream_index)
+    {
+        const status_code stream_status = m_disk_flush_manager != nullptr ?
+            get_stream_disk_flush_manager(stream_index).flush() :
+            get_stream_filesystem_writer(stream_index).flush();
+
+        if (status::failed(stream_status))
+        {
+            status = stream_status;
         }
-        default:
+    }
+
+    return status;
+}
+
+auto
+logging_engine::wait_for_durability() -> status_code
+{
+    if (!m_disk_logging_enabled)
+    {
+        //
+        // Durability is owned by the collector; hand the records over to it at least.
+        //
+        return m_socket_log_shipper != nullptr ? m_socket_log_shipper->flush() : status::success;
+    }
+
+    if (m_shared_memory_ring != nullptr)
+    {
+        return status::success;
+    }
+
+    if (m_sharded_writer != nullptr)
+    {
+        return m_sharded_writer->wait_for_durability();
+    }
+
+    status_code status = status::success;
+
+    for (std::uint32_t stream_index = 0u; stream_index <= m_routed_streams.size(); ++stream_index)
+    {
+        const status_code stream_status = m_disk_flush_manager != nullptr ?
+            get_stream_disk_flush_manager(stream_index).wait_for_durability() :
+            get_stream_filesystem_writer(stream_index).wait_for_durability();
+
+        if (status::failed(stream_status))
         {
-            level = c_default_log_level;
+            status = stream_status;
+        }
+    }
+
+    return status;
+}
+
+auto
+logging_engine::write_call_site_report() -> status_code
+{
+    if (m_call_site_profiler == nullptr)
+    {
+        return status::call_site_profiling_disabled;
+    }
+
+    return m_call_site_profiler->write_report();
+}
 
-            break;
+auto
+logging_engine::get_session_id() const -> const std::string&
+{
+    return m_session_id;
+}
+
+auto
+logging_engine::get_priority_lane_statistics() const -> std::array<priority_lane_statistics, c_priority_lanes_count>
+{
+    if (m_disk_flush_manager == nullptr)
+    {
+        return {};
+    }
+
+    std::array<priority_lane_statistics, c_priority_lanes_count> lane_statistics = m_disk_flush_manager->get_lane_statistics();
+
+    for (const routed_stream& stream : m_routed_streams)
+    {
+        const std::array<priority_lane_statistics, c_priority_lanes_count> stream_lane_statistics = stream.m_disk_flush_manager->get_lane_statistics();
+
+        for (std::size_t lane_index = 0u; lane_index < c_priority_lanes_count; ++lane_index)
+        {
+            lane_statistics[lane_index].m_written_records_count += stream_lane_statistics[lane_index].m_written_records_count;
+            lane_statistics[lane_index].m_shed_records_count += stream_lane_statistics[lane_index].m_shed_records_count;
+            lane_statistics[lane_index].m_total_latency_ns += stream_lane_statistics[lane_index].m_total_latency_ns;
+            lane_statistics[lane_index].m_max_latency_ns = std::max(lane_statistics[lane_index].m_max_latency_ns, stream_lane_statistics[lane_index].m_max_latency_ns);
         }
     }
 
-    return std::format(
-        "[{}] ({}) PID={}, TID={}, ActivityID={}, File={}, Function={}, Line={}. <{}> [{}] {}\n",
-        "Now", // Update.
-        m_session_id.c_str(),
-        m_process_id,
-        syscall(SYS_gettid),
-        "123", // Update.
-        p_source_location.file_name(),
-        p_source_location.function_name(),
-        p_source_location.line(),
-        level,
+    return lane_statistics;
+}
+
+auto
+logging_engine::get_stream_filesystem_writer(
+    const std::uint32_t p_stream_index) const -> filesystem_writer&
+{
+    return p_stream_index == title_router::c_main_stream_index ?
+        *m_filesystem_writer :
+        *m_routed_streams[p_stream_index - 1u].m_filesystem_writer;
+}
+
+auto
+logging_engine::get_stream_disk_flush_manager(
+    const std::uint32_t p_stream_index) const -> disk_flush_manager&
+{
+    return p_stream_index == title_router::c_main_stream_index ?
+        *m_disk_flush_manager :
+        *m_routed_streams[p_stream_index - 1u].m_disk_flush_manager;
+}
+
+auto
+logging_engine::can_continue_session(
+    const logger_configuration& p_logger_configuration,
+    const logging_engine* p_predecessor) -> bool
+{
+    if (p_predecessor == nullptr)
+    {
+        return false;
+    }
+
+    const logger_configuration& predecessor_configuration = p_predecessor->m_logger_configuration;
+
+    //
+    // Settings of the shared writers, flush managers, shards and rings.
+    //
+    const bool same_writer_settings =
+        predecessor_configuration.flush_frequency_ms == p_logger_configuration.flush_frequency_ms &&
+        predecessor_configuration.shared_memory_ring_size_mib == p_logger_configuration.shared_memory_ring_size_mib &&
+        predecessor_configuration.segment_index_enabled == p_logger_configuration.segment_index_enabled &&
+        predecessor_configuration.segment_index_block_record_count == p_logger_configuration.segment_index_block_record_count &&
+        predecessor_configuration.shards_count == p_logger_configuration.shards_count &&
+        predecessor_configuration.shard_per_numa_node == p_logger_configuration.shard_per_numa_node &&
+        predecessor_configuration.direct_io_enabled == p_logger_configuration.direct_io_enabled &&
+        predecessor_configuration.memory_spill_size_mib == p_logger_configuration.memory_spill_size_mib &&
+        predecessor_configuration.log_to_syslog_on_failure == p_logger_configuration.log_to_syslog_on_failure &&
+        predecessor_configuration.info_lane_size_mib == p_logger_configuration.info_lane_size_mib;
+
+    return same_writer_settings &&
+        p_predecessor->m_component_name == p_logger_configuration.component_name &&
+        p_predecessor->m_logs_directory_path == std::filesystem::absolute(p_logger_configuration.logs_directory_path) &&
+        (p_predecessor->m_shared_memory_ring != nullptr) == p_logger_configuration.shared_memory_mode_enabled &&
+        p_predecessor->m_disk_logging_enabled == p_logger_configuration.disk_logging_enabled &&
+        p_predecessor->m_title_routes == p_logger_configuration.title_routes &&
+        (p_predecessor->m_flight_recorder != nullptr) == (p_logger_configuration.flight_recorder_mode_enabled && !p_logger_configuration.sharded_mode_enabled && !p_logger_configuration.shared_memory_mode_enabled && p_logger_configuration.disk_logging_enabled) &&
+        (p_predecessor->m_flight_recorder == nullptr ||
+            (p_predecessor->m_flight_recorder->get_ring_capacity_bytes() == static_cast<std::uint64_t>(p_logger_configuration.flight_recorder_ring_size_kib) * 1024u &&
+                p_predecessor->m_flight_recorder->are_per_thread_rings_enabled() == p_logger_configuration.flight_recorder_per_thread_rings_enabled)) &&
+        (p_predecessor->m_sharded_writer != nullptr) == (p_logger_configuration.sharded_mode_enabled && !p_logger_configuration.shared_memory_mode_enabled && p_logger_configuration.disk_logging_enabled) &&
+        (p_predecessor->m_disk_flush_manager != nullptr) == (p_logger_configuration.async_mode_enabled && !p_logger_configuration.sharded_mode_enabled && !p_logger_configuration.shared_memory_mode_enabled && p_logger_configuration.disk_logging_enabled);
+}
+
+auto
+logging_engine::create_formatted_log_message(
+    const std::uint64_t p_timestamp_ns,
+    const std::uint64_t p_sequence_number,
+    const log_level& p_log_level,
+    const std::source_location& p_source_location,
+    const char* p_title,
+    const char* p_message) -> std::string
+{
+    std::string log_message;
+
+    m_log_header_encoder.encode(
+        log_message,
+        p_timestamp_ns,
+        p_sequence_number,
+        p_log_level,
+        p_source_location,
         p_title,
         p_message);
+
+    return log_message;
 }
 
 } // namespace echo.
\ No newline at end of file
@@ -8,17 +8,34 @@
 
 #pragma once
 
+#include <span>
 #include <mutex>
+#include <memory>
+#include <thread>
+#include <optional>
 #include <unistd.h>
 #include "log_level.hh"
 #include <source_location>
 #include "../status/status.hh"
+#include "log_broadcaster.hh"
+#include "sharded_writer.hh"
+#include "disk_flush_manager.hh"
+#include "duplicate_suppressor.hh"
 #include "filesystem_writer.hh"
+#include "shared_memory_ring.hh"
+#include "trace_exporter.hh"
+#include "call_site_profiler.hh"
+#include "log_header_encoder.hh"
+#include "socket_log_shipper.hh"
+#include "title_router.hh"
+#include "flight_recorder.hh"
 #include "logger_configuration.hh"
 
 namespace echo
 {
 
+struct log_batch_record;
+
 //
 // Logging engine used for logs memory placement and filesystem flushing.
 //
@@ -27,28 +44,237 @@ class logging_engine
 
 public:
 
+    //
+    // Constructor. When a predecessor engine is provided and the configuration keeps its
+    // component name, logs directory, mode and writer settings, the logging session is continued:
+    // the session identifier, directory and writer are shared instead of starting a new session.
+    //
     logging_engine(
-        const logger_configuration& p_logger_configuration);
+        const logger_configuration& p_logger_configuration,
+        log_broadcaster* p_log_broadcaster = nullptr,
+        const logging_engine* p_predecessor = nullptr);
+
+    //
+    // Destructor. Logs the summaries of the suppression windows still open.
+    //
+    ~logging_engine();
 
     auto
     initialize(
         const char* p_component_name,
         const logger_configuration& p_logger_configuration) -> status_code;
 
+    //
+    // Logs a message. Records at or above the durable level are synced to stable storage
+    // before returning unless the durability wait is disabled, in which case the caller
+    // is expected to wait for durability separately. The formatting start tick, if provided,
+    // is the timestamp counter reading taken before the message was formatted.
+    // Returns the status of the hand-over to the writer, such as a spill to memory.
+    //
     auto
     log(
         const log_level& p_log_level,
         const std::source_location& p_source_location,
         const char* p_title,
-        const char* p_message) -> void;
+        const char* p_message,
+        const bool p_durability_wait_enabled = true,
+        const std::uint64_t p_formatting_start_tick = 0u) -> status_code;
+
+    //
+    // Logs the records of a batch as a unit: they get consecutive sequence numbers and the
+    // same timestamp, and are handed over to each writer in a single operation so that they
+    // are contiguous on disk. Waits for durability once if any record is at or above the
+    // durable level. Records are not subject to duplicate suppression.
+    //
+    auto
+    log_batch(
+        const std::span<const log_batch_record> p_log_batch_records) -> void;
+
+    //
+    // Logs a record captured before the logger was initialized, with its original timestamp.
+    // Records are not subject to duplicate suppression.
+    //
+    auto
+    replay(
+        const std::uint64_t p_timestamp_ns,
+        const log_level& p_log_level,
+        const std::source_location& p_source_location,
+        const char* p_title,
+        const char* p_message) -> status_code;
+
+    //
+    // Writes out every record buffered by the engine.
+    //
+    auto
+    flush() -> status_code;
+
+    //
+    // Blocks until every record logged through the engine so far is on stable storage.
+    // Records handed over to a shared memory ring are owned by the collector.
+    //
+    auto
+    wait_for_durability() -> status_code;
+
+    //
+    // Gets the counters of the priority lanes of async mode, indexed by lane.
+    // All zeros when the engine does not queue records in lanes.
+    //
+    auto
+    get_priority_lane_statistics() const -> std::array<priority_lane_statistics, c_priority_lanes_count>;
+
+    //
+    // Writes the report of the top call sites of the session so far.
+    // Fails with call_site_profiling_disabled when the engine does not profile call sites.
+    //
+    auto
+    write_call_site_report() -> status_code;
+
+    //
+    // Gets the identifier of the logging session of the engine.
+    //
+    auto
+    get_session_id() const -> const std::string&;
+
+    //
+    // Determines whether records of the given level are logged by this engine.
+    //
+    inline
+    auto
+    is_log_level_enabled(
+        const log_level p_log_level) const -> bool
+    {
+        return p_log_level >= m_minimum_log_level;
+    }
 
 private:
 
+    //
+    // Logging session continued from a predecessor engine, if any.
+    //
+    struct session_continuation
+    {
+
+        const logging_engine* m_predecessor;
+
+    };
+
+    //
+    // Constructor for a resolved session continuation.
+    //
+    logging_engine(
+        const logger_configuration& p_logger_configuration,
+        log_broadcaster* p_log_broadcaster,
+        const session_continuation& p_session_continuation);
+
+    //
+    // Determines whether an engine for the given configuration can continue the session of a predecessor.
+    // Sessions are only continued if the writers and buffers they share keep their settings, since
+    // those are fixed when they are built.
+    //
+    static
+    auto
+    can_continue_session(
+        const logger_configuration& p_logger_configuration,
+        const logging_engine* p_predecessor) -> bool;
+
+    //
+    // Segment stream of the titles of a route.
+    //
+    struct routed_stream
+    {
+
+        std::shared_ptr<filesystem_writer> m_filesystem_writer;
+
+        //
+        // Buffer of async mode. Null in sync mode.
+        //
+        std::shared_ptr<disk_flush_manager> m_disk_flush_manager;
+
+    };
+
+    //
+    // Gets the index of the segment stream of a title.
+    //
+    inline
+    auto
+    route_title(
+        const char* p_title) const -> std::uint32_t
+    {
+        return m_title_router != nullptr ? m_title_router->route(p_title) : title_router::c_main_stream_index;
+    }
+
+    //
+    // Gets the writer of a segment stream.
+    //
+    auto
+    get_stream_filesystem_writer(
+        const std::uint32_t p_stream_index) const -> filesystem_writer&;
+
+    //
+    // Gets the buffer of a segment stream. Only applies for async mode.
+    //
+    auto
+    get_stream_disk_flush_manager(
+        const std::uint32_t p_stream_index) const -> disk_flush_manager&;
+
+    //
+    // Writes a batch of records in sync or async mode, split by the segment streams of their titles.
+    //
+    auto
+    write_batch_to_streams(
+        std::string&& p_log_messages,
+        std::vector<log_record_extent>&& p_log_record_extents,
+        const bool p_durability_wait_enabled) -> void;
+
+    //
+    // Writes out the records held by the flight recorder followed by the triggering records,
+    // which must be in sequence number order, as a single batch.
+    //
+    auto
+    dump_flight_recorder(
+        std::vector<flight_record>&& p_triggering_flight_records,
+        const bool p_durability_wait_enabled) -> void;
+
+    //
+    // Writes a batch of records to a segment stream in sync or async mode, as a unit.
+    //
+    auto
+    write_batch_to_stream(
+        const std::uint32_t p_stream_index,
+        std::string&& p_log_messages,
+        std::vector<log_record_extent>&& p_log_record_extents,
+        const bool p_durability_wait_enabled) -> void;
+
+    //
+    // Formats a log message and hands it over to the console, subscribers and writers.
+    // The timestamp, if provided, replaces the one taken when reserving the record.
+    // Without a formatting start tick only the rendering of the header is profiled.
+    // Returns the status of the sync write or of the enqueue, and of the durability wait.
+    //
+    auto
+    dispatch_log_message(
+        const log_level& p_log_level,
+        const std::source_location& p_source_location,
+        const char* p_title,
+        const char* p_message,
+        const bool p_durability_wait_enabled,
+        const std::optional<std::uint64_t> p_timestamp_ns = std::nullopt,
+        const std::uint64_t p_formatting_start_tick = 0u) -> status_code;
+
+    //
+    // Logs the summary of the repeats suppressed during a window, at the level and call site of the message.
+    //
+    auto
+    log_suppressed_message_summary(
+        const suppressed_message_summary& p_summary) -> void;
+
     //
     // Constructs the log message with formatting.
     //
     auto
     create_formatted_log_message(
+        const std::uint64_t p_timestamp_ns,
+        const std::uint64_t p_sequence_number,
         const log_level& p_log_level,
         const std::source_location& p_source_location,
         const char* p_title,
@@ -73,49 +299,44 @@ private:
     }
 
     //
-    // Text representation for info level logs.
-    //
-    static constexpr const char* c_info_log_level = "Info";
-
-    //
-    // Text representation for warning level logs.
+    // Flag for determining whether debug mode is enabled for the logger instance.
     //
-    static constexpr const char* c_warning_log_level = "Warning";
+    const bool m_debug_mode_enabled;
 
     //
-    // Text representation for error level logs.
+    // Flag for determining if logs should be flushed to syslog in case of failure.
     //
-    static constexpr const char* c_error_log_level = "Error";
+    const bool m_log_to_syslog_on_failure;
 
     //
-    // Text representation for critical level logs.
+    // Component name.
     //
-    static constexpr const char* c_critical_log_level = "Critical";
+    const std::string m_component_name;
 
     //
-    // Text representation for default level logs.
+    // Flag for determining if the loggger will work on sync or async mode.
     //
-    static constexpr const char* c_default_log_level = "Unknown";
+    const bool m_async_mode_enabled;
 
     //
-    // Flag for determining whether debug mode is enabled for the logger instance.
+    // Flag for determining if the loggger will use UTC or local time for logs.
     //
-    const bool m_debug_mode_enabled;
+    const bool m_utc_enabled;
 
     //
-    // Flag for determining if logs should be flushed to syslog in case of failure.
+    // Lowest level of the records logged by the engine.
     //
-    const bool m_log_to_syslog_on_failure;
+    const log_level m_minimum_log_level;
 
     //
-    // Component name.
+    // Lowest level of the records that are synced to stable storage before returning.
     //
-    const std::string m_component_name;
+    const std::optional<log_level> m_durable_log_level;
 
     //
-    // Flag for determining if the loggger will work on sync or async mode.
+    // Absolute path to the directory where the logging session directory is created.
     //
-    const bool m_async_mode_enabled;
+    const std::filesystem::path m_logs_directory_path;
 
     //
     // Logging session identifier.
@@ -140,8 +361,94 @@ private:
 
     //
     // Filesystem writer class for handling log writes to disk.
+    // Shared with the successor engines that continue the logging session.
+    //
+    const std::shared_ptr<filesystem_writer> m_filesystem_writer;
+
+    //
+    // Shared memory ring for handing logs over to an echo collector.
+    // Only set when shared memory mode is enabled.
+    //
+    std::shared_ptr<shared_memory_ring> m_shared_memory_ring;
+
+    //
+    // Sharded writer for splitting the session into per-shard segment streams.
+    // Only set when sharded mode is enabled.
+    //
+    std::shared_ptr<sharded_writer> m_sharded_writer;
+
+    //
+    // Buffer of the priority lanes of async mode.
+    // Only set when async mode is enabled and sharded mode is not.
+    //
+    std::shared_ptr<disk_flush_manager> m_disk_flush_manager;
+
+    //
+    // Routes of titles to segment streams of their own, as configured.
+    //
+    const std::vector<title_route> m_title_routes;
+
+    //
+    // Router of titles to the routed streams, and the routed streams by stream index minus one.
+    // Only set when title routes are configured and records are written in sync or async mode.
+    //
+    std::shared_ptr<title_router> m_title_router;
+
+    std::vector<routed_stream> m_routed_streams;
+
+    //
+    // Holder of the records until an error or a flush in flight recorder mode. Null otherwise.
+    //
+    std::shared_ptr<flight_recorder> m_flight_recorder;
+
+    //
+    // Sink streaming records to a socket log collector.
+    // Only set when a shipping socket is configured.
+    //
+    std::shared_ptr<socket_log_shipper> m_socket_log_shipper;
+
+    //
+    // Exporter writing the spans of the session to its trace files.
+    // Only set when tracing is enabled.
+    //
+    std::shared_ptr<trace_exporter> m_trace_exporter;
+
+    //
+    // Profiler of the log volume of every call site of the session.
+    // Only set when call site profiling is enabled.
+    //
+    std::shared_ptr<call_site_profiler> m_call_site_profiler;
+
+    //
+    // Flag for determining if records are written to disk on this host.
+    //
+    const bool m_disk_logging_enabled;
+
+    //
+    // Broadcaster for live subscribers. Not owned; can be null.
+    //
+    log_broadcaster* const m_log_broadcaster;
+
+    //
+    // Suppressor for repeated messages. Only set when duplicate suppression is enabled.
+    //
+    const std::unique_ptr<duplicate_suppressor> m_duplicate_suppressor;
+
+    //
+    // Encoder rendering the formatted log messages.
+    //
+    const log_header_encoder m_log_header_encoder;
+
+    //
+    // Configuration the engine was built with, for telling what a successor can keep.
+    //
+    const logger_configuration m_logger_configuration;
+
+    //
+    // Thread creating the session directory and the first logs file.
+    // Only started for new logging sessions that write to disk on this host.
     //
-    filesystem_writer m_filesystem_writer;
+    std::thread m_startup_thread;
 
 };
 
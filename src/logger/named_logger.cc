@@ -0,0 +1,98 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'named_logger.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include "named_logger.hh"
+
+namespace echo
+{
+
+named_logger::named_logger(
+    const std::string_view p_name)
+    : m_name{p_name},
+      m_logger{&logger::get_named_instance(p_name)}
+{}
+
+auto
+named_logger::get_name() const -> const std::string&
+{
+    return m_name;
+}
+
+auto
+named_logger::is_initialized() const -> bool
+{
+    return m_logger->is_logger_initialized_implementation();
+}
+
+auto
+named_logger::initialize(
+    const logger_configuration& p_logger_configuration) const -> void
+{
+    m_logger->initialize_implementation(
+        p_logger_configuration);
+}
+
+auto
+named_logger::reconfigure(
+    const logger_configuration& p_logger_configuration) const -> void
+{
+    m_logger->reconfigure_implementation(
+        p_logger_configuration);
+}
+
+auto
+named_logger::shutdown() const -> void
+{
+    m_logger->shutdown_implementation();
+}
+
+auto
+named_logger::flush() const -> status_code
+{
+    return m_logger->flush_implementation();
+}
+
+auto
+named_logger::flush_async() const -> log_completion_awaitable
+{
+    return log_completion_awaitable(
+        m_logger->m_log_completion_queue,
+        completion_operation::flush);
+}
+
+auto
+named_logger::get_priority_lane_statistics() const -> std::array<priority_lane_statistics, c_priority_lanes_count>
+{
+    return m_logger->get_priority_lane_statistics_implementation();
+}
+
+auto
+named_logger::write_call_site_report() const -> status_code
+{
+    return m_logger->write_call_site_report_implementation();
+}
+
+auto
+named_logger::set_resume_callback(
+    resume_callback p_resume_callback) const -> void
+{
+    m_logger->m_log_completion_queue.set_resume_callback(
+        std::move(p_resume_callback));
+}
+
+auto
+named_logger::subscribe(
+    const log_subscription_filter& p_filter,
+    std::function<void(const log_record&)> p_callback) const -> std::unique_ptr<log_subscription>
+{
+    return m_logger->m_log_broadcaster.subscribe(
+        p_filter,
+        std::move(p_callback));
+}
+
+} // namespace echo.
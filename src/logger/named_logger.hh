@@ -0,0 +1,194 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'named_logger.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <array>
+#include <format>
+#include <memory>
+#include <string>
+#include <functional>
+#include <string_view>
+#include "logger.hh"
+#include "log_level.hh"
+#include "../status/status.hh"
+#include "logger_configuration.hh"
+#include "title_and_source_location.hh"
+
+namespace echo
+{
+
+//
+// Handle to a named logger instance. Every name maps to an instance of its own, independent
+// from the default instance behind the static logger functions and from every other name:
+// it has its own configuration, engine, session directory, writer, subscribers and
+// pre-initialization buffer, so a high-volume subsystem logging through it does not contend
+// with the others. Instances live until the end of the program; handles can be copied freely.
+// Span tracing is process-wide and should only be enabled on a single instance.
+// Thread-safe class.
+//
+class named_logger
+{
+
+public:
+
+    //
+    // Constructor. Creates the instance of the name on first use.
+    //
+    explicit named_logger(
+        const std::string_view p_name);
+
+    //
+    // Gets the name of the instance.
+    //
+    auto
+    get_name() const -> const std::string&;
+
+    //
+    // Gets the initialization status of the instance.
+    //
+    auto
+    is_initialized() const -> bool;
+
+    //
+    // Initializes the instance. Works like logger::initialize.
+    // Throws if the instance is already initialized or the initialization process fails.
+    //
+    auto
+    initialize(
+        const logger_configuration& p_logger_configuration) const -> void;
+
+    //
+    // Replaces the configuration of the instance at runtime. Works like logger::reconfigure.
+    //
+    auto
+    reconfigure(
+        const logger_configuration& p_logger_configuration) const -> void;
+
+    //
+    // Shuts down the instance. Works like logger::shutdown.
+    //
+    auto
+    shutdown() const -> void;
+
+    //
+    // Logs a message through the instance. Works like logger::log.
+    // Expects that the title is valid for the lifetime of the program.
+    // Generates a compile-time error on failed format validations.
+    //
+    template<typename... Args>
+    auto
+    log(
+        const log_level& p_log_level,
+        title_and_source_location p_title_and_source_location,
+        std::format_string<Args...> p_format,
+        Args&&... p_args) const -> void
+    {
+        if (!m_logger->is_log_level_enabled(p_log_level))
+        {
+            //
+            // Filtered records do not pay for formatting.
+            //
+            return;
+        }
+
+        const std::uint64_t formatting_start_tick = m_logger->read_formatting_start_tick();
+        const std::string formatted_message = std::format(p_format, std::forward<Args>(p_args)...);
+
+        m_logger->log_implementation(
+            p_log_level,
+            p_title_and_source_location.m_source_location,
+            p_title_and_source_location.m_title,
+            formatted_message.c_str(),
+            true /* p_durability_wait_enabled */,
+            formatting_start_tick);
+    }
+
+    //
+    // Awaitable durable write through the instance. Works like logger::log_durable_async.
+    //
+    template<typename... Args>
+    auto
+    log_durable_async(
+        const log_level& p_log_level,
+        title_and_source_location p_title_and_source_location,
+        std::format_string<Args...> p_format,
+        Args&&... p_args) const -> log_completion_awaitable
+    {
+        const std::uint64_t formatting_start_tick = m_logger->read_formatting_start_tick();
+        const std::string formatted_message = std::format(p_format, std::forward<Args>(p_args)...);
+
+        m_logger->log_implementation(
+            p_log_level,
+            p_title_and_source_location.m_source_location,
+            p_title_and_source_location.m_title,
+            formatted_message.c_str(),
+            false /* p_durability_wait_enabled */,
+            formatting_start_tick);
+
+        return log_completion_awaitable(
+            m_logger->m_log_completion_queue,
+            completion_operation::durability);
+    }
+
+    //
+    // Flushes the buffers of the instance.
+    //
+    auto
+    flush() const -> status_code;
+
+    //
+    // Awaitable flush of the instance. Works like logger::flush_async.
+    //
+    auto
+    flush_async() const -> log_completion_awaitable;
+
+    //
+    // Gets the counters of the priority lanes of the instance. Works like logger::get_priority_lane_statistics.
+    //
+    auto
+    get_priority_lane_statistics() const -> std::array<priority_lane_statistics, c_priority_lanes_count>;
+
+    //
+    // Writes the call site report of the instance. Works like logger::write_call_site_report.
+    //
+    auto
+    write_call_site_report() const -> status_code;
+
+    //
+    // Sets the hook used for resuming the coroutines awaiting operations of the instance.
+    //
+    auto
+    set_resume_callback(
+        resume_callback p_resume_callback) const -> void;
+
+    //
+    // Subscribes an in-process consumer to the records of the instance. Works like logger::subscribe.
+    //
+    auto
+    subscribe(
+        const log_subscription_filter& p_filter,
+        std::function<void(const log_record&)> p_callback) const -> std::unique_ptr<log_subscription>;
+
+private:
+
+    friend class log_batch;
+
+    //
+    // Name of the instance.
+    //
+    std::string m_name;
+
+    //
+    // Instance of the name. Never destroyed before the end of the program.
+    //
+    logger* m_logger;
+
+};
+
+} // namespace echo.
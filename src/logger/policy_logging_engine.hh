@@ -0,0 +1,285 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'policy_logging_engine.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <memory>
+#include <format>
+#include <string>
+#include <utility>
+#include <concepts>
+#include <iostream>
+#include <iterator>
+#include <filesystem>
+#include <unistd.h>
+#include "log_level.hh"
+#include "../status/status.hh"
+#include "filesystem_writer.hh"
+#include "disk_flush_manager.hh"
+#include "log_header_encoder.hh"
+#include "logger_configuration.hh"
+#include "../utils/time_utilities.hh"
+#include "../utils/uuid_utilities.hh"
+#include "title_and_source_location.hh"
+
+namespace echo
+{
+
+//
+// Set of features of a policy logging engine, fixed at compile time.
+//
+template<typename Policy>
+concept engine_policy = requires
+{
+    { Policy::c_source_location_enabled } -> std::convertible_to<bool>;
+    { Policy::c_console_mirroring_enabled } -> std::convertible_to<bool>;
+    { Policy::c_timestamps_enabled } -> std::convertible_to<bool>;
+    { Policy::c_activity_ids_enabled } -> std::convertible_to<bool>;
+};
+
+//
+// Policy with every feature of the runtime engine.
+//
+struct full_engine_policy
+{
+
+    static constexpr bool c_source_location_enabled = true;
+
+    static constexpr bool c_console_mirroring_enabled = true;
+
+    static constexpr bool c_timestamps_enabled = true;
+
+    static constexpr bool c_activity_ids_enabled = true;
+
+};
+
+//
+// Policy with no optional feature: records only carry the session, PID, TID,
+// sequence number, level, title and message, and nothing is mirrored to the console.
+//
+struct minimal_engine_policy
+{
+
+    static constexpr bool c_source_location_enabled = false;
+
+    static constexpr bool c_console_mirroring_enabled = false;
+
+    static constexpr bool c_timestamps_enabled = false;
+
+    static constexpr bool c_activity_ids_enabled = false;
+
+};
+
+//
+// Logging engine whose features are picked at compile time by its policy instead of being
+// checked on every record: disabled features are compiled out of the log path, and their
+// fields out of the record layout. The policy takes the place of the debug_mode_enabled and
+// include_source_location flags of the configuration. Records are written to their own
+// logging session in sync or async mode; the sharded, shared memory, shipping, tracing and
+// durability options of the configuration do not apply. Without timestamps records sort
+// as the epoch in the segment index and the lane latency counters are not meaningful.
+// Thread-safe class.
+//
+template<engine_policy Policy>
+class policy_logging_engine
+{
+
+public:
+
+    //
+    // Constructor. Throws if the logs directory path can not be made absolute or the async
+    // mode flusher could not be started.
+    //
+    explicit policy_logging_engine(
+        const logger_configuration& p_logger_configuration)
+        : m_minimum_log_level{p_logger_configuration.minimum_log_level},
+          m_session_id{uuid_to_string(generate_uuid())},
+          m_logging_session_directory_path{
+            std::filesystem::absolute(p_logger_configuration.logs_directory_path) /
+            std::string(p_logger_configuration.component_name + "-logs-" + m_session_id)},
+          m_filesystem_writer{
+            std::make_shared<filesystem_writer>(
+                m_session_id,
+                m_logging_session_directory_path,
+                p_logger_configuration.segment_index_enabled,
+                p_logger_configuration.segment_index_block_record_count,
+                p_logger_configuration.direct_io_enabled,
+                p_logger_configuration.memory_spill_size_mib,
+                p_logger_configuration.log_to_syslog_on_failure)},
+          m_log_header_encoder{
+            m_session_id,
+            getpid(),
+            p_logger_configuration.utc_enabled,
+            Policy::c_source_location_enabled}
+    {
+        if (p_logger_configuration.async_mode_enabled)
+        {
+            m_disk_flush_manager = std::make_unique<disk_flush_manager>(
+                m_filesystem_writer,
+                p_logger_configuration.flush_frequency_ms,
+                p_logger_configuration.info_lane_size_mib);
+        }
+    }
+
+    policy_logging_engine(const policy_logging_engine&) = delete;
+
+    policy_logging_engine&
+    operator=(const policy_logging_engine&) = delete;
+
+    //
+    // Logs a message. Records below the minimum log level are discarded before formatting.
+    // Expects that the title is valid for the lifetime of the program.
+    // Generates a compile-time error on failed format validations.
+    //
+    template<typename... Args>
+    auto
+    log(
+        const log_level p_log_level,
+        title_and_source_location p_title_and_source_location,
+        std::format_string<Args...> p_format,
+        Args&&... p_args) -> status_code
+    {
+        if (p_log_level < m_minimum_log_level)
+        {
+            return status::success;
+        }
+
+        //
+        // Both buffers keep their capacity across the records of the thread.
+        //
+        thread_local std::string formatted_message;
+        thread_local std::string log_message;
+
+        formatted_message.clear();
+        std::format_to(std::back_inserter(formatted_message), p_format, std::forward<Args>(p_args)...);
+
+        std::uint64_t timestamp_ns = 0u;
+
+        if constexpr (Policy::c_timestamps_enabled)
+        {
+            timestamp_ns = get_current_timestamp_ns();
+        }
+
+        const std::uint64_t sequence_number = m_filesystem_writer->allocate_sequence_number();
+
+        m_log_header_encoder.template encode_with_layout<
+            Policy::c_source_location_enabled,
+            Policy::c_timestamps_enabled,
+            Policy::c_activity_ids_enabled>(
+                log_message,
+                timestamp_ns,
+                sequence_number,
+                p_log_level,
+                p_title_and_source_location.m_source_location,
+                p_title_and_source_location.m_title,
+                formatted_message.c_str());
+
+        if constexpr (Policy::c_console_mirroring_enabled)
+        {
+            std::scoped_lock<std::mutex> lock {m_std_output_lock};
+
+            std::cout << log_message << "\n";
+        }
+
+        const log_record_metadata metadata {timestamp_ns, p_log_level, p_title_and_source_location.m_title, sequence_number};
+
+        if (m_disk_flush_manager != nullptr)
+        {
+            //
+            // Async mode. The queued record takes a copy so that the buffer keeps its capacity.
+            //
+            return m_disk_flush_manager->enqueue(metadata, std::string(log_message));
+        }
+
+        return m_filesystem_writer->write_log_message_combined(
+            log_message,
+            metadata);
+    }
+
+    //
+    // Writes out every queued record and flushes the buffers of the writer.
+    //
+    auto
+    flush() -> status_code
+    {
+        return m_disk_flush_manager != nullptr ?
+            m_disk_flush_manager->flush() :
+            m_filesystem_writer->flush();
+    }
+
+    //
+    // Writes out every queued record and waits until every record is on stable storage.
+    //
+    auto
+    wait_for_durability() -> status_code
+    {
+        return m_disk_flush_manager != nullptr ?
+            m_disk_flush_manager->wait_for_durability() :
+            m_filesystem_writer->wait_for_durability();
+    }
+
+    //
+    // Gets the identifier of the logging session of the engine.
+    //
+    auto
+    get_session_id() const -> const std::string&
+    {
+        return m_session_id;
+    }
+
+    //
+    // Gets the path of the logging session directory of the engine.
+    //
+    auto
+    get_logging_session_directory_path() const -> const std::filesystem::path&
+    {
+        return m_logging_session_directory_path;
+    }
+
+private:
+
+    //
+    // Lowest level of the records to be logged.
+    //
+    const log_level m_minimum_log_level;
+
+    //
+    // Identifier of the logging session.
+    //
+    const std::string m_session_id;
+
+    //
+    // Path of the logging session directory.
+    //
+    const std::filesystem::path m_logging_session_directory_path;
+
+    //
+    // Writer of the segment stream.
+    //
+    const std::shared_ptr<filesystem_writer> m_filesystem_writer;
+
+    //
+    // Encoder of the records, in the layout of the policy.
+    //
+    const log_header_encoder m_log_header_encoder;
+
+    //
+    // Buffer of async mode. Null in sync mode.
+    // Destroyed first so that the queued records are written out while the writer is alive.
+    //
+    std::unique_ptr<disk_flush_manager> m_disk_flush_manager;
+
+    //
+    // Lock for the standard output stream. Only used with console mirroring.
+    //
+    std::mutex m_std_output_lock;
+
+};
+
+} // namespace echo.
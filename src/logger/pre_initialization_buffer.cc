@@ -0,0 +1,108 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'pre_initialization_buffer.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <cstring>
+#include "pre_initialization_buffer.hh"
+
+namespace echo
+{
+
+pre_initialization_buffer::pre_initialization_buffer()
+    : m_records{},
+      m_reserved_records_count{0u}
+{}
+
+auto
+pre_initialization_buffer::capture(
+    const std::uint64_t p_timestamp_ns,
+    const log_level p_log_level,
+    const std::source_location& p_source_location,
+    const char* p_title,
+    const char* p_message) -> status_code
+{
+    const std::uint32_t record_index = m_reserved_records_count.fetch_add(1u, std::memory_order_acq_rel);
+
+    if (record_index >= c_sealed_records_count)
+    {
+        return status::pre_initialization_buffer_sealed;
+    }
+
+    if (record_index >= c_capacity_records_count)
+    {
+        return status::pre_initialization_buffer_full;
+    }
+
+    captured_record& record = m_records[record_index];
+    const std::size_t message_size_bytes = std::min(std::strlen(p_message), c_max_message_size_bytes);
+
+    record.m_log_level = p_log_level;
+    record.m_message_size_bytes = static_cast<std::uint16_t>(message_size_bytes);
+    record.m_timestamp_ns = p_timestamp_ns;
+    record.m_title = p_title;
+    record.m_source_location = p_source_location;
+    std::memcpy(record.m_message, p_message, message_size_bytes);
+
+    record.m_committed.store(true, std::memory_order_release);
+
+    return status::success;
+}
+
+auto
+pre_initialization_buffer::reset() -> void
+{
+    m_reserved_records_count.store(0u, std::memory_order_release);
+}
+
+auto
+pre_initialization_buffer::discard_after_fork() -> void
+{
+    const std::uint32_t reserved_records_count = m_reserved_records_count.load(std::memory_order_acquire);
+
+    //
+    // No producer is left in the middle of a slot in the child, so the slots are cleared without waiting.
+    //
+    for (std::uint32_t record_index = 0u; record_index < std::min(reserved_records_count, c_capacity_records_count); ++record_index)
+    {
+        m_records[record_index].m_committed.store(false, std::memory_order_relaxed);
+    }
+
+    m_reserved_records_count.store(0u, std::memory_order_release);
+}
+
+auto
+pre_initialization_buffer::wait_for_commit(
+    captured_record& p_captured_record) -> void
+{
+    while (!p_captured_record.m_committed.load(std::memory_order_acquire))
+    {
+        //
+        // The producer reserved the slot and is still filling it in.
+        //
+        std::this_thread::yield();
+    }
+}
+
+auto
+pre_initialization_buffer::discard_records(
+    const std::uint32_t p_first_record_index,
+    const std::uint32_t p_end_record_index) -> void
+{
+    for (std::uint32_t record_index = p_first_record_index; record_index < p_end_record_index; ++record_index)
+    {
+        captured_record& record = m_records[record_index];
+
+        //
+        // A slot reopened while its producer still writes it could be reserved twice.
+        //
+        wait_for_commit(record);
+
+        record.m_committed.store(false, std::memory_order_relaxed);
+    }
+}
+
+} // namespace echo.
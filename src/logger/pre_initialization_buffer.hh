@@ -0,0 +1,181 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'pre_initialization_buffer.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <array>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <cstdint>
+#include <source_location>
+#include "log_level.hh"
+#include "../status/status.hh"
+
+namespace echo
+{
+
+//
+// Fixed-size buffer capturing the records logged before the logger is initialized,
+// e.g. from static initializers, so that they can be replayed into the logging session
+// with their original timestamps once it starts. Lives in static storage and never
+// allocates. Records beyond its capacity are dropped and counted, and messages longer
+// than a slot are truncated.
+// Thread-safe class.
+//
+class pre_initialization_buffer
+{
+
+public:
+
+    //
+    // Max size in bytes of a captured message, sized for 512-byte slots.
+    //
+    static constexpr std::size_t c_max_message_size_bytes = 464u;
+
+    //
+    // Record captured before initialization.
+    //
+    struct captured_record
+    {
+
+        std::atomic<bool> m_committed;
+
+        log_level m_log_level;
+
+        std::uint16_t m_message_size_bytes;
+
+        std::uint64_t m_timestamp_ns;
+
+        const char* m_title;
+
+        std::source_location m_source_location;
+
+        char m_message[c_max_message_size_bytes];
+
+    };
+
+    //
+    // Constructor.
+    //
+    pre_initialization_buffer();
+
+    pre_initialization_buffer(const pre_initialization_buffer&) = delete;
+
+    pre_initialization_buffer&
+    operator=(const pre_initialization_buffer&) = delete;
+
+    //
+    // Captures a record. Fails with pre_initialization_buffer_sealed while the buffer is
+    // being replayed, in which case the logger is about to be initialized.
+    //
+    auto
+    capture(
+        const std::uint64_t p_timestamp_ns,
+        const log_level p_log_level,
+        const std::source_location& p_source_location,
+        const char* p_title,
+        const char* p_message) -> status_code;
+
+    //
+    // Seals the buffer and hands every captured record, in capture order, to the callback.
+    // Returns the count of records dropped because the buffer was full. The buffer stays
+    // sealed until reset. If the callback throws, the records not replayed yet are dropped
+    // and the buffer reopens for capturing before the exception is propagated.
+    //
+    template<typename Callback>
+    auto
+    replay(
+        Callback&& p_callback) -> std::uint32_t
+    {
+        const std::uint32_t reserved_records_count = m_reserved_records_count.exchange(
+            c_sealed_records_count,
+            std::memory_order_acq_rel);
+
+        const std::uint32_t captured_records_count = std::min<std::uint32_t>(reserved_records_count, c_capacity_records_count);
+
+        for (std::uint32_t record_index = 0u; record_index < captured_records_count; ++record_index)
+        {
+            captured_record& record = m_records[record_index];
+
+            wait_for_commit(record);
+
+            try
+            {
+                p_callback(static_cast<const captured_record&>(record));
+            }
+            catch (...)
+            {
+                discard_records(record_index, captured_records_count);
+                m_reserved_records_count.store(0u, std::memory_order_release);
+
+                throw;
+            }
+
+            record.m_committed.store(false, std::memory_order_relaxed);
+        }
+
+        return reserved_records_count - captured_records_count;
+    }
+
+    //
+    // Reopens the buffer for capturing. Only called while no replay is in progress.
+    //
+    auto
+    reset() -> void;
+
+    //
+    // Drops the captured records in a child process after a fork and reopens the buffer: the
+    // records belong to the parent, and slots can have been left reserved by parent threads that
+    // do not exist in the child. A buffer sealed by the engine of the parent is reopened too,
+    // since that engine is not published in the child.
+    //
+    auto
+    discard_after_fork() -> void;
+
+private:
+
+    //
+    // Waits for the producer that reserved a slot to finish filling it in.
+    //
+    static
+    auto
+    wait_for_commit(
+        captured_record& p_captured_record) -> void;
+
+    //
+    // Drops the records of a range of reserved slots once their producers are done with them.
+    //
+    auto
+    discard_records(
+        const std::uint32_t p_first_record_index,
+        const std::uint32_t p_end_record_index) -> void;
+
+    //
+    // Count of records held by the buffer.
+    //
+    static constexpr std::uint32_t c_capacity_records_count = 128u;
+
+    //
+    // Reservations count marking the buffer as sealed; far beyond any real count of reservations.
+    //
+    static constexpr std::uint32_t c_sealed_records_count = 1u << 30u;
+
+    //
+    // Slots of the captured records.
+    //
+    std::array<captured_record, c_capacity_records_count> m_records;
+
+    //
+    // Count of slots reserved so far, or at least the sealed count while sealed.
+    //
+    std::atomic<std::uint32_t> m_reserved_records_count;
+
+};
+
+} // namespace echo.
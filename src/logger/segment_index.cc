@@ -0,0 +1,150 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'segment_index.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <limits>
+#include <algorithm>
+#include <fstream>
+#include "segment_index.hh"
+
+namespace echo
+{
+
+segment_index::segment_index(
+    const std::filesystem::path& p_segment_path,
+    const std::uint32_t p_block_record_count)
+    : m_segment_path{p_segment_path},
+      m_index_path{get_index_path(p_segment_path)},
+      m_block_record_count{p_block_record_count == 0u ? 1u : p_block_record_count},
+      m_current_block{}
+{}
+
+segment_index::~segment_index()
+{
+    flush_block();
+}
+
+auto
+segment_index::add_record(
+    const log_record_metadata& p_log_record_metadata,
+    const std::uint64_t p_offset_bytes,
+    const std::uint64_t p_size_bytes) -> void
+{
+    if (m_current_block.m_record_count == 0u)
+    {
+        m_current_block.m_min_timestamp_ns = std::numeric_limits<std::uint64_t>::max();
+        m_current_block.m_max_timestamp_ns = 0u;
+        m_current_block.m_offset_bytes = p_offset_bytes;
+    }
+
+    m_current_block.m_min_timestamp_ns = std::min(m_current_block.m_min_timestamp_ns, p_log_record_metadata.m_timestamp_ns);
+    m_current_block.m_max_timestamp_ns = std::max(m_current_block.m_max_timestamp_ns, p_log_record_metadata.m_timestamp_ns);
+    m_current_block.m_size_bytes = p_offset_bytes + p_size_bytes - m_current_block.m_offset_bytes;
+    m_current_block.m_title_bitmap |= get_title_bitmap(p_log_record_metadata.m_title);
+    m_current_block.m_level_bitmap |= 1u << static_cast<std::uint8_t>(p_log_record_metadata.m_log_level);
+    ++m_current_block.m_record_count;
+
+    if (m_current_block.m_record_count >= m_block_record_count)
+    {
+        flush_block();
+    }
+}
+
+auto
+segment_index::flush_block() -> void
+{
+    if (m_current_block.m_record_count == 0u)
+    {
+        return;
+    }
+
+    const bool index_exists = std::filesystem::exists(m_index_path);
+
+    std::ofstream file;
+    file.open(m_index_path, std::ios_base::app | std::ios_base::binary);
+
+    if (file)
+    {
+        if (!index_exists)
+        {
+            const index_file_header header {c_index_magic, m_block_record_count, sizeof(segment_index_block)};
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+
+        file.write(reinterpret_cast<const char*>(&m_current_block), sizeof(m_current_block));
+    }
+
+    //
+    // A lost index entry is not fatal; queries scan segment ranges not covered by the index.
+    //
+    m_current_block = segment_index_block{};
+}
+
+auto
+segment_index::get_segment_path() const -> const std::filesystem::path&
+{
+    return m_segment_path;
+}
+
+auto
+segment_index::get_index_path(
+    const std::filesystem::path& p_segment_path) -> std::filesystem::path
+{
+    return std::filesystem::path(p_segment_path).replace_extension(c_index_files_extension);
+}
+
+auto
+segment_index::read_blocks(
+    const std::filesystem::path& p_segment_path) -> std::optional<std::vector<segment_index_block>>
+{
+    std::ifstream file;
+    file.open(get_index_path(p_segment_path), std::ios_base::binary);
+
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    index_file_header header {};
+
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.m_magic != c_index_magic ||
+        header.m_block_size_bytes != sizeof(segment_index_block))
+    {
+        return std::nullopt;
+    }
+
+    std::vector<segment_index_block> blocks;
+    segment_index_block block {};
+
+    while (file.read(reinterpret_cast<char*>(&block), sizeof(block)))
+    {
+        blocks.push_back(block);
+    }
+
+    return blocks;
+}
+
+auto
+segment_index::get_title_bitmap(
+    const char* p_title) -> std::uint64_t
+{
+    //
+    // FNV-1a hash; two bits per title keep the false positive rate low for typical title counts per block.
+    //
+    std::uint64_t hash = 0xCBF29CE4'84222325u;
+
+    for (const char* character = p_title; *character != '\0'; ++character)
+    {
+        hash ^= static_cast<std::uint8_t>(*character);
+        hash *= 0x00000100'000001B3u;
+    }
+
+    return (1ull << (hash & 63u)) | (1ull << ((hash >> 6u) & 63u));
+}
+
+} // namespace echo.
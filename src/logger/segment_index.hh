@@ -0,0 +1,222 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'segment_index.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+#include "log_level.hh"
+
+namespace echo
+{
+
+//
+// Metadata of a log record used for indexing it inside its segment.
+//
+struct log_record_metadata
+{
+
+    //
+    // Wall-clock timestamp in nanoseconds of the record.
+    //
+    std::uint64_t m_timestamp_ns;
+
+    //
+    // Level of the record.
+    //
+    log_level m_log_level;
+
+    //
+    // Title of the record.
+    //
+    const char* m_title;
+
+    //
+    // Sequence number of the record, for accounting for it in the sequence ledger if it is shed.
+    //
+    std::optional<std::uint64_t> m_sequence_number;
+
+};
+
+//
+// Sidecar index entry describing a contiguous block of records inside a segment.
+// The layout is written as-is to the index file.
+//
+struct segment_index_block
+{
+
+    //
+    // Lowest record timestamp in the block.
+    //
+    std::uint64_t m_min_timestamp_ns;
+
+    //
+    // Highest record timestamp in the block.
+    //
+    std::uint64_t m_max_timestamp_ns;
+
+    //
+    // Byte offset of the block inside the segment.
+    //
+    std::uint64_t m_offset_bytes;
+
+    //
+    // Size in bytes of the block.
+    //
+    std::uint64_t m_size_bytes;
+
+    //
+    // Bloom bitmap of the titles present in the block.
+    //
+    std::uint64_t m_title_bitmap;
+
+    //
+    // Count of records in the block.
+    //
+    std::uint32_t m_record_count;
+
+    //
+    // Bitmap of the levels present in the block; bit N is set for level value N.
+    //
+    std::uint32_t m_level_bitmap;
+
+};
+
+//
+// Sidecar index writer for a single segment. Not thread-safe; caller responsible for synchronization.
+// Records are grouped into blocks of a fixed record count and one entry is appended to
+// the index file per block, so a query only needs to read the blocks that may match.
+//
+class segment_index
+{
+
+public:
+
+    //
+    // Constructor. The index file is created on the first completed block.
+    //
+    segment_index(
+        const std::filesystem::path& p_segment_path,
+        const std::uint32_t p_block_record_count);
+
+    //
+    // Destructor. Writes out the last partial block.
+    //
+    ~segment_index();
+
+    segment_index(const segment_index&) = delete;
+
+    segment_index&
+    operator=(const segment_index&) = delete;
+
+    //
+    // Accounts for a record written at the given offset of the segment.
+    //
+    auto
+    add_record(
+        const log_record_metadata& p_log_record_metadata,
+        const std::uint64_t p_offset_bytes,
+        const std::uint64_t p_size_bytes) -> void;
+
+    //
+    // Appends the current partial block, if any, to the index file.
+    //
+    auto
+    flush_block() -> void;
+
+    //
+    // Gets the path to the indexed segment.
+    //
+    auto
+    get_segment_path() const -> const std::filesystem::path&;
+
+    //
+    // Gets the path to the sidecar index file of a segment.
+    //
+    static
+    auto
+    get_index_path(
+        const std::filesystem::path& p_segment_path) -> std::filesystem::path;
+
+    //
+    // Reads all the blocks from the sidecar index file of a segment.
+    // Returns no value if the index file is missing or invalid.
+    //
+    static
+    auto
+    read_blocks(
+        const std::filesystem::path& p_segment_path) -> std::optional<std::vector<segment_index_block>>;
+
+    //
+    // Gets the bloom bitmap bits for a title.
+    //
+    static
+    auto
+    get_title_bitmap(
+        const char* p_title) -> std::uint64_t;
+
+    //
+    // Index files extension.
+    //
+    static constexpr const char* c_index_files_extension = "idx";
+
+private:
+
+    //
+    // Index file header.
+    //
+    struct index_file_header
+    {
+
+        //
+        // Magic value used to validate index files.
+        //
+        std::uint64_t m_magic;
+
+        //
+        // Records per block used when writing the index.
+        //
+        std::uint32_t m_block_record_count;
+
+        //
+        // Size in bytes of each block entry.
+        //
+        std::uint32_t m_block_size_bytes;
+
+    };
+
+    //
+    // Magic value for identifying index files ("ECHOIDX1").
+    //
+    static constexpr std::uint64_t c_index_magic = 0x31584449'4F484345u;
+
+    //
+    // Path to the indexed segment.
+    //
+    const std::filesystem::path m_segment_path;
+
+    //
+    // Path to the sidecar index file.
+    //
+    const std::filesystem::path m_index_path;
+
+    //
+    // Records per block.
+    //
+    const std::uint32_t m_block_record_count;
+
+    //
+    // Block currently being accumulated.
+    //
+    segment_index_block m_current_block;
+
+};
+
+} // namespace echo.
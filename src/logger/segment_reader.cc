@@ -0,0 +1,183 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'segment_reader.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <string>
+#include <cstdint>
+#include <utility>
+#include <charconv>
+#include <algorithm>
+#include <system_error>
+#include "segment_reader.hh"
+
+namespace echo
+{
+
+//
+// Header fields carrying the record sequence number and thread identifier.
+//
+static constexpr std::string_view c_sequence_number_field = ", Seq=";
+
+static constexpr std::string_view c_thread_id_field = ", TID=";
+
+//
+// Parses the value of a numeric header field between the session and the level, if present.
+//
+static
+auto
+parse_header_number(
+    const std::string_view p_line,
+    const std::string_view p_field,
+    const std::size_t p_session_end,
+    const std::size_t p_level_begin) -> std::optional<std::uint64_t>
+{
+    const std::size_t field_begin = p_line.substr(0u, p_level_begin).find(p_field, p_session_end);
+
+    if (field_begin == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+
+    const char* value_first = p_line.data() + field_begin + p_field.size();
+    std::uint64_t value = 0u;
+
+    if (std::from_chars(value_first, p_line.data() + p_level_begin, value).ec != std::errc{})
+    {
+        return std::nullopt;
+    }
+
+    return value;
+}
+
+auto
+parse_log_record(
+    const std::string_view p_line) -> std::optional<log_record_view>
+{
+    std::string_view line = p_line;
+
+    if (!line.empty() && line.back() == '\n')
+    {
+        line.remove_suffix(1u);
+    }
+
+    if (!line.starts_with('['))
+    {
+        return std::nullopt;
+    }
+
+    const std::size_t timestamp_end = line.find("] (");
+    const std::size_t session_end = line.find(')', timestamp_end + 3u);
+    const std::size_t level_begin = line.find(". <", session_end);
+    const std::size_t level_end = line.find("> [", level_begin);
+    const std::size_t title_end = line.find("] ", level_end + 3u);
+
+    if (timestamp_end == std::string_view::npos ||
+        session_end == std::string_view::npos ||
+        level_begin == std::string_view::npos ||
+        level_end == std::string_view::npos ||
+        title_end == std::string_view::npos)
+    {
+        return std::nullopt;
+    }
+
+    const std::optional<log_level> level = string_to_log_level(
+        line.substr(level_begin + 3u, level_end - level_begin - 3u));
+
+    if (!level.has_value())
+    {
+        return std::nullopt;
+    }
+
+    return log_record_view{
+        line.substr(1u, timestamp_end - 1u),
+        line.substr(timestamp_end + 3u, session_end - timestamp_end - 3u),
+        parse_header_number(line, c_sequence_number_field, session_end, level_begin),
+        parse_header_number(line, c_thread_id_field, session_end, level_begin),
+        level.value(),
+        line.substr(level_end + 3u, title_end - level_end - 3u),
+        line.substr(title_end + 2u)};
+}
+
+auto
+string_to_log_level(
+    const std::string_view p_log_level) -> std::optional<log_level>
+{
+    if (p_log_level == "Info")
+    {
+        return log_level::info;
+    }
+
+    if (p_log_level == "Warning")
+    {
+        return log_level::warning;
+    }
+
+    if (p_log_level == "Error")
+    {
+        return log_level::error;
+    }
+
+    if (p_log_level == "Critical")
+    {
+        return log_level::critical;
+    }
+
+    return std::nullopt;
+}
+
+auto
+get_segment_paths(
+    const std::filesystem::path& p_logging_session_directory_path) -> std::vector<std::filesystem::path>
+{
+    //
+    // Logs files are named 'log_<session>_<count>.log'; order numerically by count within each session.
+    //
+    std::vector<std::pair<std::pair<std::string, std::uint64_t>, std::filesystem::path>> segments;
+    std::error_code error_code;
+
+    for (const std::filesystem::directory_entry& entry :
+        std::filesystem::directory_iterator(p_logging_session_directory_path, error_code))
+    {
+        const std::string stem = entry.path().stem().string();
+        const std::size_t count_begin = stem.rfind('_');
+
+        if (!entry.is_regular_file(error_code) ||
+            entry.path().extension() != ".log" ||
+            !stem.starts_with("log_") ||
+            count_begin == std::string::npos)
+        {
+            continue;
+        }
+
+        try
+        {
+            segments.emplace_back(
+                std::make_pair(stem.substr(0u, count_begin), std::stoull(stem.substr(count_begin + 1u))),
+                entry.path());
+        }
+        catch (const std::exception& p_exception)
+        {
+            //
+            // Not a logs file produced by the writer.
+            //
+        }
+    }
+
+    std::sort(segments.begin(), segments.end());
+
+    std::vector<std::filesystem::path> segment_paths;
+    segment_paths.reserve(segments.size());
+
+    for (auto& segment : segments)
+    {
+        segment_paths.push_back(std::move(segment.second));
+    }
+
+    return segment_paths;
+}
+
+} // namespace echo.
@@ -0,0 +1,88 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'segment_reader.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+#include <string_view>
+#include "log_level.hh"
+
+namespace echo
+{
+
+//
+// Non-owning view over the fields of a formatted log record.
+//
+struct log_record_view
+{
+
+    //
+    // Record timestamp as rendered in the header.
+    //
+    std::string_view m_timestamp;
+
+    //
+    // Logging session identifier.
+    //
+    std::string_view m_session_id;
+
+    //
+    // Sequence number of the record: unique within the session, or within the shard for
+    // sharded streams, and increasing within a thread.
+    // Not set for records written before sequence numbers were added to the header.
+    //
+    std::optional<std::uint64_t> m_sequence_number;
+
+    //
+    // Kernel identifier of the thread that logged the record.
+    //
+    std::optional<std::uint64_t> m_thread_id;
+
+    //
+    // Record level.
+    //
+    log_level m_log_level;
+
+    //
+    // Record title.
+    //
+    std::string_view m_title;
+
+    //
+    // Record message, without the trailing line break.
+    //
+    std::string_view m_message;
+
+};
+
+//
+// Parses a single formatted log record line as produced by the logging engine.
+// Returns no value if the line does not follow the record layout.
+//
+auto
+parse_log_record(
+    const std::string_view p_line) -> std::optional<log_record_view>;
+
+//
+// Parses the text representation of a log level.
+//
+auto
+string_to_log_level(
+    const std::string_view p_log_level) -> std::optional<log_level>;
+
+//
+// Gets the paths of all logs files in a session directory, ordered by session and file count.
+//
+auto
+get_segment_paths(
+    const std::filesystem::path& p_logging_session_directory_path) -> std::vector<std::filesystem::path>;
+
+} // namespace echo.
@@ -0,0 +1,135 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'sequence_ledger.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <format>
+#include <fstream>
+#include "sequence_ledger.hh"
+
+namespace echo
+{
+
+sequence_ledger::sequence_ledger(
+    const std::filesystem::path& p_ledger_path)
+    : m_ledger_path{p_ledger_path}
+{}
+
+sequence_ledger::~sequence_ledger()
+{
+    flush();
+}
+
+auto
+sequence_ledger::retire(
+    const std::uint64_t p_first_sequence_number,
+    const std::uint64_t p_records_count,
+    const sequence_retirement_reason p_reason) -> void
+{
+    std::scoped_lock<std::mutex> lock {m_lock};
+
+    if (!m_pending_ranges.empty())
+    {
+        retired_sequence_range& last_range = m_pending_ranges.back();
+
+        if (last_range.m_reason == p_reason &&
+            last_range.m_first_sequence_number + last_range.m_records_count == p_first_sequence_number)
+        {
+            last_range.m_records_count += p_records_count;
+
+            return;
+        }
+    }
+
+    m_pending_ranges.push_back(retired_sequence_range{p_first_sequence_number, p_records_count, p_reason, 0u});
+
+    if (m_pending_ranges.size() >= c_max_pending_ranges_count)
+    {
+        write_pending_ranges();
+    }
+}
+
+auto
+sequence_ledger::flush() -> void
+{
+    std::scoped_lock<std::mutex> lock {m_lock};
+
+    write_pending_ranges();
+}
+
+auto
+sequence_ledger::get_ledger_path(
+    const std::filesystem::path& p_logging_session_directory_path,
+    const std::string& p_session_id) -> std::filesystem::path
+{
+    return p_logging_session_directory_path / std::format("log_{}.{}", p_session_id, c_ledger_files_extension);
+}
+
+auto
+sequence_ledger::read_ranges(
+    const std::filesystem::path& p_ledger_path) -> std::optional<std::vector<retired_sequence_range>>
+{
+    std::ifstream file;
+    file.open(p_ledger_path, std::ios_base::binary);
+
+    if (!file)
+    {
+        return std::nullopt;
+    }
+
+    ledger_file_header header {};
+
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        header.m_magic != c_ledger_magic ||
+        header.m_range_size_bytes != sizeof(retired_sequence_range))
+    {
+        return std::nullopt;
+    }
+
+    std::vector<retired_sequence_range> ranges;
+    retired_sequence_range range {};
+
+    while (file.read(reinterpret_cast<char*>(&range), sizeof(range)))
+    {
+        ranges.push_back(range);
+    }
+
+    return ranges;
+}
+
+auto
+sequence_ledger::write_pending_ranges() -> void
+{
+    if (m_pending_ranges.empty())
+    {
+        return;
+    }
+
+    const bool ledger_exists = std::filesystem::exists(m_ledger_path);
+
+    std::ofstream file;
+    file.open(m_ledger_path, std::ios_base::app | std::ios_base::binary);
+
+    if (file)
+    {
+        if (!ledger_exists)
+        {
+            const ledger_file_header header {c_ledger_magic, sizeof(retired_sequence_range), 0u};
+            file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        }
+
+        file.write(
+            reinterpret_cast<const char*>(m_pending_ranges.data()),
+            static_cast<std::streamsize>(m_pending_ranges.size() * sizeof(retired_sequence_range)));
+    }
+
+    //
+    // A lost ledger entry is not fatal; the verifier reports its numbers as missing.
+    //
+    m_pending_ranges.clear();
+}
+
+} // namespace echo.
@@ -0,0 +1,202 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'sequence_ledger.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <optional>
+#include <filesystem>
+
+namespace echo
+{
+
+//
+// Reason for a range of sequence numbers handed out by a writer without ever being written.
+//
+enum class sequence_retirement_reason : std::uint32_t
+{
+
+    //
+    // Numbers left at the end of the block of a thread when it moved on, exited or the writer went away.
+    //
+    unused_block_tail = 0u,
+
+    //
+    // Written once when the writer closes; the range is empty and starts at the first number never handed out.
+    // A ledger without it belongs to a session that did not shut down cleanly.
+    //
+    writer_closed = 1u,
+
+    //
+    // Records evicted from a flight recorder ring, or still held by it when it went away.
+    //
+    evicted = 2u,
+
+    //
+    // Records shed by the info lane while it was full.
+    //
+    shed = 3u,
+
+    //
+    // Records reserved in a shard whose logging failed before they were appended.
+    //
+    abandoned = 4u
+
+};
+
+//
+// Range of sequence numbers retired for the same reason.
+// The layout is written as-is to the ledger file.
+//
+struct retired_sequence_range
+{
+
+    //
+    // First retired sequence number.
+    //
+    std::uint64_t m_first_sequence_number;
+
+    //
+    // Count of retired sequence numbers.
+    //
+    std::uint64_t m_records_count;
+
+    //
+    // Why the numbers were never written.
+    //
+    sequence_retirement_reason m_reason;
+
+    std::uint32_t m_reserved;
+
+};
+
+//
+// Sidecar ledger of the sequence numbers a writer handed out but deliberately never wrote,
+// so that a verifier can tell them apart from lost records instead of guessing. Ranges are
+// kept in memory, merged with the previous one when contiguous, and appended to the ledger
+// file in bulk. The ledger file is created on the first write.
+// Thread-safe class.
+//
+class sequence_ledger
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    explicit sequence_ledger(
+        const std::filesystem::path& p_ledger_path);
+
+    //
+    // Destructor. Writes out the pending ranges.
+    //
+    ~sequence_ledger();
+
+    sequence_ledger(const sequence_ledger&) = delete;
+
+    sequence_ledger&
+    operator=(const sequence_ledger&) = delete;
+
+    //
+    // Accounts for a range of sequence numbers that will never be written.
+    //
+    auto
+    retire(
+        const std::uint64_t p_first_sequence_number,
+        const std::uint64_t p_records_count,
+        const sequence_retirement_reason p_reason) -> void;
+
+    //
+    // Appends the pending ranges, if any, to the ledger file.
+    //
+    auto
+    flush() -> void;
+
+    //
+    // Gets the path to the ledger file of the writer of a session.
+    //
+    static
+    auto
+    get_ledger_path(
+        const std::filesystem::path& p_logging_session_directory_path,
+        const std::string& p_session_id) -> std::filesystem::path;
+
+    //
+    // Reads all the ranges from a ledger file.
+    // Returns no value if the ledger file is missing or invalid.
+    //
+    static
+    auto
+    read_ranges(
+        const std::filesystem::path& p_ledger_path) -> std::optional<std::vector<retired_sequence_range>>;
+
+    //
+    // Ledger files extension.
+    //
+    static constexpr const char* c_ledger_files_extension = "seq";
+
+private:
+
+    //
+    // Appends the pending ranges to the ledger file. Caller must hold the lock.
+    //
+    auto
+    write_pending_ranges() -> void;
+
+    //
+    // Ledger file header.
+    //
+    struct ledger_file_header
+    {
+
+        //
+        // Magic value used to validate ledger files.
+        //
+        std::uint64_t m_magic;
+
+        //
+        // Size in bytes of each range entry.
+        //
+        std::uint32_t m_range_size_bytes;
+
+        std::uint32_t m_reserved;
+
+    };
+
+    //
+    // Magic value for identifying ledger files ("ECHOSEQ1").
+    //
+    static constexpr std::uint64_t c_ledger_magic = 0x31514553'4F484345u;
+
+    //
+    // Count of pending ranges that triggers a write out.
+    //
+    static constexpr std::size_t c_max_pending_ranges_count = 256u;
+
+    //
+    // Path to the ledger file.
+    //
+    const std::filesystem::path m_ledger_path;
+
+    //
+    // Ranges not written out yet.
+    //
+    std::vector<retired_sequence_range> m_pending_ranges;
+
+    //
+    // Lock for synchronizing the pending ranges and the ledger file.
+    //
+    std::mutex m_lock;
+
+};
+
+} // namespace echo.
@@ -0,0 +1,536 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'sharded_writer.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <format>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <pthread.h>
+#include "sharded_writer.hh"
+#include "../utils/time_utilities.hh"
+
+namespace echo
+{
+
+sharded_writer::sharded_writer(
+    const std::string& p_session_id,
+    const std::filesystem::path& p_logging_session_directory_path,
+    const std::uint32_t p_shards_count,
+    const bool p_shard_per_numa_node,
+    const std::uint32_t p_flush_frequency_ms,
+    const bool p_segment_index_enabled,
+    const std::uint32_t p_segment_index_block_record_count,
+    const bool p_direct_io_enabled,
+    const std::uint32_t p_memory_spill_size_mib,
+    const bool p_log_to_syslog_on_failure)
+    : m_flush_frequency_ms{p_flush_frequency_ms},
+      m_stop_requested{false}
+{
+    const std::uint32_t shards_count = map_cpus_to_shards(
+        p_shards_count,
+        p_shard_per_numa_node);
+
+    for (std::uint32_t shard_index = 0u; shard_index < shards_count; ++shard_index)
+    {
+        shard& current_shard = *m_shards[shard_index];
+
+        //
+        // Every shard is an independent segment stream: 'log_<session>_shard<index>_<count>.log'.
+        //
+        current_shard.m_filesystem_writer = std::make_unique<filesystem_writer>(
+            std::format("{}_shard{}", p_session_id, shard_index),
+            p_logging_session_directory_path,
+            p_segment_index_enabled,
+            p_segment_index_block_record_count,
+            p_direct_io_enabled,
+            p_memory_spill_size_mib,
+            p_log_to_syslog_on_failure);
+
+        current_shard.m_flusher_thread = std::thread(&sharded_writer::flusher_loop, this, std::ref(current_shard));
+
+        //
+        // Best effort; an unpinned flusher is still correct.
+        //
+        pthread_setaffinity_np(
+            current_shard.m_flusher_thread.native_handle(),
+            sizeof(cpu_set_t),
+            &current_shard.m_cpu_set);
+    }
+}
+
+sharded_writer::~sharded_writer()
+{
+    m_stop_requested.store(true, std::memory_order_relaxed);
+
+    for (const std::unique_ptr<shard>& current_shard : m_shards)
+    {
+        {
+            std::scoped_lock<std::mutex> lock {current_shard->m_buffer_lock};
+        }
+
+        current_shard->m_flush_condition.notify_all();
+
+        if (current_shard->m_flusher_thread.joinable())
+        {
+            current_shard->m_flusher_thread.join();
+        }
+
+        flush_shard(*current_shard);
+    }
+}
+
+auto
+sharded_writer::get_current_shard_index() const -> std::uint32_t
+{
+    const int cpu_index = sched_getcpu();
+
+    if (cpu_index < 0 ||
+        static_cast<std::size_t>(cpu_index) >= m_cpu_to_shard.size())
+    {
+        return 0u;
+    }
+
+    return m_cpu_to_shard[cpu_index];
+}
+
+auto
+sharded_writer::reserve_record(
+    const std::uint32_t p_shard_index,
+    const std::uint64_t p_records_count) -> record_reservation
+{
+    shard& target_shard = *m_shards[p_shard_index];
+    std::scoped_lock<std::mutex> lock {target_shard.m_buffer_lock};
+
+    const std::uint64_t sequence_number = target_shard.m_next_sequence_number;
+    target_shard.m_next_sequence_number += p_records_count;
+
+    return record_reservation{
+        sequence_number,
+        get_current_timestamp_ns()};
+}
+
+auto
+sharded_writer::append(
+    const std::uint32_t p_shard_index,
+    const std::uint64_t p_sequence_number,
+    const log_record_metadata& p_log_record_metadata,
+    std::string&& p_log_message) -> void
+{
+    shard& target_shard = *m_shards[p_shard_index];
+    bool flush_required = false;
+
+    {
+        std::scoped_lock<std::mutex> lock {target_shard.m_buffer_lock};
+
+        target_shard.m_buffered_size_bytes += p_log_message.size();
+        target_shard.m_buffered_records.push_back(buffered_record{
+            p_sequence_number,
+            p_log_record_metadata,
+            std::move(p_log_message),
+            {},
+            0u});
+
+        //
+        // Error and critical records do not wait for the flush period.
+        //
+        target_shard.m_urgent_record_buffered |= get_priority_lane(p_log_record_metadata.m_log_level) == priority_lane::urgent;
+
+        flush_required = target_shard.m_urgent_record_buffered ||
+            target_shard.m_buffered_size_bytes >= c_flush_threshold_size_bytes;
+    }
+
+    if (flush_required)
+    {
+        target_shard.m_flush_condition.notify_one();
+    }
+}
+
+auto
+sharded_writer::append(
+    const std::uint32_t p_shard_index,
+    const std::uint64_t p_first_sequence_number,
+    std::vector<log_record_extent>&& p_log_record_extents,
+    std::string&& p_log_messages) -> void
+{
+    shard& target_shard = *m_shards[p_shard_index];
+    bool flush_required = false;
+
+    const bool urgent_record_buffered = std::any_of(p_log_record_extents.begin(), p_log_record_extents.end(), [](const log_record_extent& p_extent)
+    {
+        return get_priority_lane(p_extent.m_metadata.m_log_level) == priority_lane::urgent;
+    });
+
+    {
+        std::scoped_lock<std::mutex> lock {target_shard.m_buffer_lock};
+
+        target_shard.m_buffered_size_bytes += p_log_messages.size();
+        target_shard.m_buffered_records.push_back(buffered_record{
+            p_first_sequence_number,
+            p_log_record_extents.front().m_metadata,
+            std::move(p_log_messages),
+            std::move(p_log_record_extents),
+            0u});
+
+        target_shard.m_urgent_record_buffered |= urgent_record_buffered;
+
+        flush_required = target_shard.m_urgent_record_buffered ||
+            target_shard.m_buffered_size_bytes >= c_flush_threshold_size_bytes;
+    }
+
+    if (flush_required)
+    {
+        target_shard.m_flush_condition.notify_one();
+    }
+}
+
+auto
+sharded_writer::abandon(
+    const std::uint32_t p_shard_index,
+    const std::uint64_t p_first_sequence_number,
+    const std::uint64_t p_records_count) -> void
+{
+    shard& target_shard = *m_shards[p_shard_index];
+
+    {
+        std::scoped_lock<std::mutex> lock {target_shard.m_buffer_lock};
+
+        target_shard.m_buffered_records.push_back(buffered_record{
+            p_first_sequence_number,
+            log_record_metadata{},
+            std::string(),
+            {},
+            p_records_count});
+
+        //
+        // Later records, possibly urgent ones, may be held back behind the abandoned ones.
+        //
+        target_shard.m_urgent_record_buffered = true;
+    }
+
+    target_shard.m_flush_condition.notify_one();
+}
+
+auto
+sharded_writer::flush() -> status_code
+{
+    status_code status = status::success;
+
+    for (const std::unique_ptr<shard>& current_shard : m_shards)
+    {
+        flush_shard(*current_shard);
+
+        if (status::failed(current_shard->m_filesystem_writer->flush()))
+        {
+            status = status::file_write_failed;
+        }
+    }
+
+    return status;
+}
+
+auto
+sharded_writer::wait_for_durability(
+    const std::uint32_t p_shard_index,
+    const std::uint64_t p_sequence_number) -> status_code
+{
+    shard& target_shard = *m_shards[p_shard_index];
+
+    while (true)
+    {
+        flush_shard(target_shard);
+
+        std::scoped_lock<std::mutex> flush_lock {target_shard.m_flush_lock};
+
+        if (target_shard.m_next_flushed_sequence_number > p_sequence_number)
+        {
+            break;
+        }
+
+        //
+        // An older record of the shard is reserved but not yet appended.
+        //
+        std::this_thread::yield();
+    }
+
+    return target_shard.m_filesystem_writer->wait_for_durability();
+}
+
+auto
+sharded_writer::wait_for_durability() -> status_code
+{
+    status_code status = status::success;
+
+    for (std::uint32_t shard_index = 0u; shard_index < m_shards.size(); ++shard_index)
+    {
+        std::uint64_t reserved_records_count = 0u;
+
+        {
+            std::scoped_lock<std::mutex> lock {m_shards[shard_index]->m_buffer_lock};
+
+            reserved_records_count = m_shards[shard_index]->m_next_sequence_number;
+        }
+
+        if (reserved_records_count != 0u &&
+            status::failed(wait_for_durability(shard_index, reserved_records_count - 1u)))
+        {
+            status = status::file_sync_failed;
+        }
+    }
+
+    return status;
+}
+
+auto
+sharded_writer::get_shards_count() const -> std::uint32_t
+{
+    return static_cast<std::uint32_t>(m_shards.size());
+}
+
+auto
+sharded_writer::map_cpus_to_shards(
+    const std::uint32_t p_shards_count,
+    const bool p_shard_per_numa_node) -> std::uint32_t
+{
+    const long configured_cpus_count = sysconf(_SC_NPROCESSORS_CONF);
+    const std::uint32_t cpus_count = configured_cpus_count > 0 ? static_cast<std::uint32_t>(configured_cpus_count) : 1u;
+    std::uint32_t shards_count = 0u;
+
+    m_cpu_to_shard.assign(cpus_count, 0u);
+
+    if (p_shard_per_numa_node)
+    {
+        //
+        // One shard per NUMA node; each node lists its CPUs as ranges, e.g. '0-3,8-11'.
+        //
+        for (std::uint32_t node_index = 0u; ; ++node_index)
+        {
+            std::ifstream cpu_list_file {std::format("{}/node{}/cpulist", c_numa_nodes_directory_path, node_index)};
+            std::string cpu_list;
+
+            if (!cpu_list_file || !std::getline(cpu_list_file, cpu_list))
+            {
+                break;
+            }
+
+            std::stringstream cpu_ranges {cpu_list};
+            std::string cpu_range;
+
+            while (std::getline(cpu_ranges, cpu_range, ','))
+            {
+                const std::size_t separator = cpu_range.find('-');
+
+                try
+                {
+                    const std::uint32_t first_cpu = static_cast<std::uint32_t>(std::stoul(cpu_range.substr(0u, separator)));
+                    const std::uint32_t last_cpu = separator == std::string::npos ?
+                        first_cpu :
+                        static_cast<std::uint32_t>(std::stoul(cpu_range.substr(separator + 1u)));
+
+                    for (std::uint32_t cpu_index = first_cpu; cpu_index <= last_cpu && cpu_index < cpus_count; ++cpu_index)
+                    {
+                        m_cpu_to_shard[cpu_index] = node_index;
+                    }
+                }
+                catch (const std::exception& p_exception)
+                {
+                    //
+                    // Malformed range; its CPUs stay on the first shard.
+                    //
+                }
+            }
+
+            ++shards_count;
+        }
+    }
+
+    if (shards_count == 0u)
+    {
+        //
+        // Per-core sharding, also used when NUMA topology is not available.
+        //
+        shards_count = p_shards_count != 0u ? p_shards_count : cpus_count;
+
+        for (std::uint32_t cpu_index = 0u; cpu_index < cpus_count; ++cpu_index)
+        {
+            m_cpu_to_shard[cpu_index] = cpu_index % shards_count;
+        }
+    }
+
+    for (std::uint32_t shard_index = 0u; shard_index < shards_count; ++shard_index)
+    {
+        m_shards.push_back(std::make_unique<shard>());
+        CPU_ZERO(&m_shards.back()->m_cpu_set);
+    }
+
+    for (std::uint32_t cpu_index = 0u; cpu_index < cpus_count && cpu_index < CPU_SETSIZE; ++cpu_index)
+    {
+        CPU_SET(cpu_index, &m_shards[m_cpu_to_shard[cpu_index]]->m_cpu_set);
+    }
+
+    return shards_count;
+}
+
+auto
+sharded_writer::flush_shard(
+    shard& p_shard) -> void
+{
+    std::scoped_lock<std::mutex> flush_lock {p_shard.m_flush_lock};
+    std::vector<buffered_record> records;
+
+    {
+        std::scoped_lock<std::mutex> buffer_lock {p_shard.m_buffer_lock};
+
+        records.swap(p_shard.m_buffered_records);
+        p_shard.m_buffered_size_bytes = 0u;
+        p_shard.m_urgent_record_buffered = false;
+    }
+
+    //
+    // Appends race between reserving and taking the buffer lock; restore the order and
+    // hold back everything after a gap, since the missing record carries an older timestamp.
+    //
+    std::sort(records.begin(), records.end(), [](const buffered_record& p_left, const buffered_record& p_right)
+    {
+        return p_left.m_sequence_number < p_right.m_sequence_number;
+    });
+
+    std::size_t ready_records_count = 0u;
+
+    while (ready_records_count < records.size() &&
+        records[ready_records_count].m_sequence_number == p_shard.m_next_flushed_sequence_number)
+    {
+        const buffered_record& record = records[ready_records_count];
+
+        p_shard.m_next_flushed_sequence_number +=
+            record.m_abandoned_records_count != 0u ? record.m_abandoned_records_count :
+            record.m_batch_extents.empty() ? 1u :
+            record.m_batch_extents.size();
+        ++ready_records_count;
+    }
+
+    if (ready_records_count < records.size())
+    {
+        std::scoped_lock<std::mutex> buffer_lock {p_shard.m_buffer_lock};
+
+        for (std::size_t record_index = ready_records_count; record_index < records.size(); ++record_index)
+        {
+            p_shard.m_buffered_size_bytes += records[record_index].m_log_message.size();
+            p_shard.m_buffered_records.push_back(std::move(records[record_index]));
+        }
+
+        records.resize(ready_records_count);
+    }
+
+    //
+    // Abandoned records only close their gap; their numbers are not losses.
+    //
+    std::erase_if(records, [&p_shard](const buffered_record& p_record)
+    {
+        if (p_record.m_abandoned_records_count == 0u)
+        {
+            return false;
+        }
+
+        p_shard.m_filesystem_writer->retire_sequence_numbers(
+            p_record.m_sequence_number,
+            p_record.m_abandoned_records_count,
+            sequence_retirement_reason::abandoned);
+
+        return true;
+    });
+
+    if (records.empty())
+    {
+        return;
+    }
+
+    std::string batch;
+    std::vector<log_record_extent> extents;
+
+    for (std::size_t record_index = 0u; record_index < records.size(); ++record_index)
+    {
+        const buffered_record& record = records[record_index];
+
+        batch += record.m_log_message;
+
+        if (record.m_batch_extents.empty())
+        {
+            extents.push_back(log_record_extent{record.m_metadata, record.m_log_message.size()});
+        }
+        else
+        {
+            //
+            // A batch is never split; the write is cut after it at the earliest.
+            //
+            extents.insert(extents.end(), record.m_batch_extents.begin(), record.m_batch_extents.end());
+        }
+
+        if (batch.size() >= c_flush_threshold_size_bytes ||
+            record_index + 1u == records.size())
+        {
+            p_shard.m_filesystem_writer->write_log_messages_to_disk(batch, extents);
+
+            batch.clear();
+            extents.clear();
+        }
+    }
+}
+
+auto
+sharded_writer::flusher_loop(
+    shard& p_shard) -> void
+{
+    while (!m_stop_requested.load(std::memory_order_relaxed))
+    {
+        {
+            std::unique_lock<std::mutex> lock {p_shard.m_buffer_lock};
+
+            p_shard.m_flush_condition.wait_for(
+                lock,
+                std::chrono::milliseconds(m_flush_frequency_ms),
+                [this, &p_shard]()
+                {
+                    return m_stop_requested.load(std::memory_order_relaxed) ||
+                        p_shard.m_urgent_record_buffered ||
+                        p_shard.m_buffered_size_bytes >= c_flush_threshold_size_bytes;
+                });
+        }
+
+        flush_shard(p_shard);
+    }
+}
+
+record_reservation_guard::record_reservation_guard(
+    sharded_writer* p_sharded_writer,
+    const std::uint32_t p_shard_index,
+    const std::uint64_t p_first_sequence_number,
+    const std::uint64_t p_records_count)
+    : m_sharded_writer{p_sharded_writer},
+      m_shard_index{p_shard_index},
+      m_first_sequence_number{p_first_sequence_number},
+      m_records_count{p_records_count}
+{}
+
+record_reservation_guard::~record_reservation_guard()
+{
+    if (m_sharded_writer != nullptr)
+    {
+        m_sharded_writer->abandon(
+            m_shard_index,
+            m_first_sequence_number,
+            m_records_count);
+    }
+}
+
+auto
+record_reservation_guard::release() -> void
+{
+    m_sharded_writer = nullptr;
+}
+
+} // namespace echo.
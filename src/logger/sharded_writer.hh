@@ -0,0 +1,365 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'sharded_writer.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <sched.h>
+#include <filesystem>
+#include <condition_variable>
+#include "filesystem_writer.hh"
+#include "disk_flush_manager.hh"
+#include "../status/status.hh"
+
+namespace echo
+{
+
+//
+// Sequence number and timestamp reserved for a record of a shard.
+//
+struct record_reservation
+{
+
+    //
+    // Sequence number of the record inside its shard.
+    //
+    std::uint64_t m_sequence_number;
+
+    //
+    // Wall-clock timestamp in nanoseconds of the record.
+    //
+    std::uint64_t m_timestamp_ns;
+
+};
+
+//
+// Writer that splits the logging session into one independent segment stream per shard,
+// where a shard maps to a CPU core or to a NUMA node. Callers append to the buffer of the
+// shard they are running on, and a flusher thread pinned to the CPUs of that shard writes
+// it out, so no lock or file is shared across shards. Records carry their timestamp and a
+// per-shard sequence number, which lets echo_merge rebuild a single time-ordered stream.
+// Thread-safe class.
+//
+class sharded_writer
+{
+
+public:
+
+    //
+    // Constructor. Starts the flusher threads.
+    // A shards count of zero creates one shard per CPU core, or per NUMA node if requested.
+    //
+    sharded_writer(
+        const std::string& p_session_id,
+        const std::filesystem::path& p_logging_session_directory_path,
+        const std::uint32_t p_shards_count,
+        const bool p_shard_per_numa_node,
+        const std::uint32_t p_flush_frequency_ms,
+        const bool p_segment_index_enabled,
+        const std::uint32_t p_segment_index_block_record_count,
+        const bool p_direct_io_enabled,
+        const std::uint32_t p_memory_spill_size_mib,
+        const bool p_log_to_syslog_on_failure);
+
+    //
+    // Destructor. Stops the flusher threads and writes out all buffered records.
+    //
+    ~sharded_writer();
+
+    sharded_writer(const sharded_writer&) = delete;
+
+    sharded_writer&
+    operator=(const sharded_writer&) = delete;
+
+    //
+    // Gets the shard of the CPU the calling thread is running on.
+    //
+    auto
+    get_current_shard_index() const -> std::uint32_t;
+
+    //
+    // Reserves the next record of a shard: its sequence number and its timestamp, taken
+    // together so that both orders agree within the shard. Every reservation must be
+    // followed by an append or an abandon; the shard only writes out records up to the
+    // oldest one still reserved. Several records reserved at once get consecutive sequence
+    // numbers, starting at the reserved one, and share the timestamp.
+    //
+    auto
+    reserve_record(
+        const std::uint32_t p_shard_index,
+        const std::uint64_t p_records_count = 1u) -> record_reservation;
+
+    //
+    // Buffers a formatted log message in a shard.
+    //
+    auto
+    append(
+        const std::uint32_t p_shard_index,
+        const std::uint64_t p_sequence_number,
+        const log_record_metadata& p_log_record_metadata,
+        std::string&& p_log_message) -> void;
+
+    //
+    // Buffers the formatted log messages of a batch in a shard, reserved at once
+    // starting at the given sequence number. The batch is written out with a single write.
+    //
+    auto
+    append(
+        const std::uint32_t p_shard_index,
+        const std::uint64_t p_first_sequence_number,
+        std::vector<log_record_extent>&& p_log_record_extents,
+        std::string&& p_log_messages) -> void;
+
+    //
+    // Gives up reserved records that will never be appended, so that the shard writes out the
+    // records after them. Their sequence numbers are retired in the ledger of the shard.
+    //
+    auto
+    abandon(
+        const std::uint32_t p_shard_index,
+        const std::uint64_t p_first_sequence_number,
+        const std::uint64_t p_records_count) -> void;
+
+    //
+    // Writes out the buffered records of every shard.
+    //
+    auto
+    flush() -> status_code;
+
+    //
+    // Writes out the records of a shard up to the given sequence number and waits until
+    // they are on stable storage.
+    //
+    auto
+    wait_for_durability(
+        const std::uint32_t p_shard_index,
+        const std::uint64_t p_sequence_number) -> status_code;
+
+    //
+    // Writes out the records reserved so far in every shard and waits until they are on stable storage.
+    //
+    auto
+    wait_for_durability() -> status_code;
+
+    //
+    // Gets the count of shards.
+    //
+    auto
+    get_shards_count() const -> std::uint32_t;
+
+private:
+
+    //
+    // Record buffered in a shard.
+    //
+    struct buffered_record
+    {
+
+        //
+        // Sequence number of the record inside its shard.
+        //
+        std::uint64_t m_sequence_number;
+
+        //
+        // Metadata of the record.
+        //
+        log_record_metadata m_metadata;
+
+        //
+        // Formatted log message.
+        //
+        std::string m_log_message;
+
+        //
+        // Extents of the records of a batch buffered as a whole, covering the log message.
+        // Empty for single records.
+        //
+        std::vector<log_record_extent> m_batch_extents;
+
+        //
+        // Count of abandoned records this entry stands for, without a log message. Zero for appended records.
+        //
+        std::uint64_t m_abandoned_records_count;
+
+    };
+
+    //
+    // Independent segment stream with its own buffer, writer and flusher.
+    //
+    struct alignas(64) shard
+    {
+
+        //
+        // Lock for the reservations and the buffered records.
+        //
+        std::mutex m_buffer_lock;
+
+        //
+        // Next sequence number to be reserved in the shard.
+        //
+        std::uint64_t m_next_sequence_number {0u};
+
+        //
+        // Next sequence number to be written out. Only accessed by flushes.
+        //
+        std::uint64_t m_next_flushed_sequence_number {0u};
+
+        //
+        // Records appended since the last flush.
+        //
+        std::vector<buffered_record> m_buffered_records;
+
+        //
+        // Size in bytes of the buffered records.
+        //
+        std::size_t m_buffered_size_bytes {0u};
+
+        //
+        // Flag for determining whether an error or critical record was appended since the last flush.
+        //
+        bool m_urgent_record_buffered {false};
+
+        //
+        // Lock for serializing flushes of the shard.
+        //
+        std::mutex m_flush_lock;
+
+        //
+        // Condition variable for waking up the flusher when the buffer fills up or on stop.
+        //
+        std::condition_variable m_flush_condition;
+
+        //
+        // CPUs the flusher thread is pinned to.
+        //
+        cpu_set_t m_cpu_set;
+
+        //
+        // Writer for the segment stream of the shard.
+        //
+        std::unique_ptr<filesystem_writer> m_filesystem_writer;
+
+        //
+        // Flusher thread.
+        //
+        std::thread m_flusher_thread;
+
+    };
+
+    //
+    // Builds the CPU to shard mapping and returns the count of shards.
+    //
+    auto
+    map_cpus_to_shards(
+        const std::uint32_t p_shards_count,
+        const bool p_shard_per_numa_node) -> std::uint32_t;
+
+    //
+    // Writes out the buffered records of a shard in sequence order, stopping at the first
+    // record that is reserved but not yet appended or abandoned.
+    //
+    auto
+    flush_shard(
+        shard& p_shard) -> void;
+
+    //
+    // Flusher loop of a shard.
+    //
+    auto
+    flusher_loop(
+        shard& p_shard) -> void;
+
+    //
+    // Buffer size in bytes that wakes up the flusher before its period ends.
+    //
+    static constexpr std::size_t c_flush_threshold_size_bytes = 1024u * 1024u;
+
+    //
+    // Directory where the kernel exposes the NUMA nodes.
+    //
+    static constexpr const char* c_numa_nodes_directory_path = "/sys/devices/system/node";
+
+    //
+    // Flush frequency in milliseconds of the flusher threads.
+    //
+    const std::uint32_t m_flush_frequency_ms;
+
+    //
+    // Shard index for every CPU index.
+    //
+    std::vector<std::uint32_t> m_cpu_to_shard;
+
+    //
+    // Shards of the session.
+    //
+    std::vector<std::unique_ptr<shard>> m_shards;
+
+    //
+    // Flag for signaling the flusher threads to exit.
+    //
+    std::atomic<bool> m_stop_requested;
+
+};
+
+//
+// Guard of the records reserved in a shard. Abandons them unless released once they are
+// appended, e.g. when formatting them throws, so that the shard does not hold back its
+// later records forever. Does nothing without a sharded writer.
+//
+class record_reservation_guard
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    record_reservation_guard(
+        sharded_writer* p_sharded_writer,
+        const std::uint32_t p_shard_index,
+        const std::uint64_t p_first_sequence_number,
+        const std::uint64_t p_records_count);
+
+    //
+    // Destructor. Abandons the reserved records if not released.
+    //
+    ~record_reservation_guard();
+
+    record_reservation_guard(const record_reservation_guard&) = delete;
+
+    record_reservation_guard&
+    operator=(const record_reservation_guard&) = delete;
+
+    //
+    // Marks the reserved records as appended.
+    //
+    auto
+    release() -> void;
+
+private:
+
+    //
+    // Writer of the reservation; null once released.
+    //
+    sharded_writer* m_sharded_writer;
+
+    const std::uint32_t m_shard_index;
+
+    const std::uint64_t m_first_sequence_number;
+
+    const std::uint64_t m_records_count;
+
+};
+
+} // namespace echo.
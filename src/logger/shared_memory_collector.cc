@@ -0,0 +1,205 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'shared_memory_collector.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <algorithm>
+#include "shared_memory_collector.hh"
+#include "../utils/time_utilities.hh"
+#include "../utils/uuid_utilities.hh"
+
+namespace echo
+{
+
+shared_memory_collector::shared_memory_collector(
+    const std::string& p_component_name,
+    const std::filesystem::path& p_logs_directory_path,
+    const std::uint32_t p_collection_frequency_ms)
+    : m_ring_name_prefix{std::string(shared_memory_ring::c_ring_name_prefix) + p_component_name + "-"},
+      m_session_id{uuid_to_string(generate_uuid())},
+      m_logging_session_directory_path{
+        std::filesystem::absolute(p_logs_directory_path) /
+        std::string(p_component_name + "-logs-" + m_session_id)},
+      m_collection_frequency_ms{p_collection_frequency_ms},
+      m_filesystem_writer{m_session_id, m_logging_session_directory_path},
+      m_stop_requested{false}
+{}
+
+shared_memory_collector::~shared_memory_collector()
+{
+    stop();
+}
+
+auto
+shared_memory_collector::start() -> void
+{
+    {
+        std::scoped_lock<std::mutex> lock {m_stop_lock};
+
+        m_stop_requested = false;
+    }
+
+    m_collection_thread = std::thread(&shared_memory_collector::collection_loop, this);
+}
+
+auto
+shared_memory_collector::stop() -> void
+{
+    {
+        std::scoped_lock<std::mutex> lock {m_stop_lock};
+
+        m_stop_requested = true;
+    }
+
+    m_stop_condition.notify_all();
+
+    if (m_collection_thread.joinable())
+    {
+        m_collection_thread.join();
+    }
+
+    collect(true /* p_full_drain */);
+}
+
+auto
+shared_memory_collector::collect(
+    const bool p_full_drain) -> std::uint64_t
+{
+    std::scoped_lock<std::mutex> lock {m_collection_lock};
+
+    discover_rings();
+
+    const std::size_t previously_pending_count = m_pending_records.size();
+
+    for (auto iterator = m_rings.begin(); iterator != m_rings.end();)
+    {
+        shared_memory_ring& ring = *iterator->second;
+
+        //
+        // Sample liveness before collecting so that a producer exiting mid-pass
+        // keeps its ring around until a later pass sees it fully drained.
+        //
+        const bool producer_alive = ring.is_producer_alive();
+
+        ring.release(ring.collect(m_pending_records));
+
+        if (!producer_alive && ring.is_drained())
+        {
+            //
+            // Every record of a finished or crashed producer has been collected.
+            //
+            ring.unlink();
+            iterator = m_rings.erase(iterator);
+
+            continue;
+        }
+
+        ++iterator;
+    }
+
+    //
+    // Each ring is already ordered; only the newly collected tail needs sorting before the merge.
+    //
+    const auto by_timestamp = [](const shared_memory_record& p_left, const shared_memory_record& p_right)
+    {
+        return p_left.m_timestamp_ns < p_right.m_timestamp_ns;
+    };
+
+    const auto newly_collected = m_pending_records.begin() + static_cast<std::ptrdiff_t>(previously_pending_count);
+    std::stable_sort(newly_collected, m_pending_records.end(), by_timestamp);
+    std::inplace_merge(m_pending_records.begin(), newly_collected, m_pending_records.end(), by_timestamp);
+
+    const std::uint64_t watermark_ns = get_current_timestamp_ns() - c_reorder_window_ns;
+    std::size_t written_count = 0u;
+    std::string batch;
+
+    for (; written_count < m_pending_records.size(); ++written_count)
+    {
+        const shared_memory_record& record = m_pending_records[written_count];
+
+        if (!p_full_drain &&
+            record.m_timestamp_ns > watermark_ns)
+        {
+            break;
+        }
+
+        batch += record.m_log_message;
+
+        if (batch.size() >= c_max_write_batch_size_bytes)
+        {
+            m_filesystem_writer.write_log_message_to_disk(batch.c_str());
+            batch.clear();
+        }
+    }
+
+    if (!batch.empty())
+    {
+        m_filesystem_writer.write_log_message_to_disk(batch.c_str());
+    }
+
+    m_pending_records.erase(
+        m_pending_records.begin(),
+        m_pending_records.begin() + static_cast<std::ptrdiff_t>(written_count));
+
+    return written_count;
+}
+
+auto
+shared_memory_collector::get_logging_session_directory_path() const -> const std::filesystem::path&
+{
+    return m_logging_session_directory_path;
+}
+
+auto
+shared_memory_collector::discover_rings() -> void
+{
+    std::error_code error_code;
+
+    for (const std::filesystem::directory_entry& entry :
+        std::filesystem::directory_iterator(c_shared_memory_directory_path, error_code))
+    {
+        const std::string ring_name = entry.path().filename().string();
+
+        if (!ring_name.starts_with(m_ring_name_prefix) ||
+            m_rings.contains(ring_name))
+        {
+            continue;
+        }
+
+        try
+        {
+            m_rings.emplace(ring_name, std::make_unique<shared_memory_ring>(ring_name));
+        }
+        catch (const std::exception& p_exception)
+        {
+            //
+            // The producer may still be initializing the ring; retry on the next pass.
+            //
+        }
+    }
+}
+
+auto
+shared_memory_collector::collection_loop() -> void
+{
+    std::unique_lock<std::mutex> lock {m_stop_lock};
+
+    while (!m_stop_requested)
+    {
+        lock.unlock();
+
+        collect();
+
+        lock.lock();
+
+        m_stop_condition.wait_for(
+            lock,
+            std::chrono::milliseconds(m_collection_frequency_ms),
+            [this]() { return m_stop_requested; });
+    }
+}
+
+} // namespace echo.
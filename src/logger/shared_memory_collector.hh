@@ -0,0 +1,165 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'shared_memory_collector.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <map>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <filesystem>
+#include <condition_variable>
+#include "filesystem_writer.hh"
+#include "shared_memory_ring.hh"
+
+namespace echo
+{
+
+//
+// Collector that drains the shared memory rings of every process logging under
+// a given component name into a single, timestamp-ordered stream of segments.
+// Can be embedded as a background thread or driven from the echo_collector binary.
+//
+class shared_memory_collector
+{
+
+public:
+
+    //
+    // Constructor. No filesystem or shared memory access happens until the first collection.
+    //
+    shared_memory_collector(
+        const std::string& p_component_name,
+        const std::filesystem::path& p_logs_directory_path,
+        const std::uint32_t p_collection_frequency_ms);
+
+    //
+    // Destructor. Stops the background thread and drains all pending records.
+    //
+    ~shared_memory_collector();
+
+    //
+    // Starts collecting on a background thread.
+    //
+    auto
+    start() -> void;
+
+    //
+    // Stops the background thread, if any, and writes every pending record to disk.
+    //
+    auto
+    stop() -> void;
+
+    //
+    // Runs a single collection pass over all rings. Records newer than the reorder window
+    // are kept in memory so that late commits from other rings can still be ordered before
+    // them, unless a full drain is requested. Returns the count of records written to disk.
+    //
+    auto
+    collect(
+        const bool p_full_drain = false) -> std::uint64_t;
+
+    //
+    // Gets the path to the session directory where collected records are written.
+    //
+    auto
+    get_logging_session_directory_path() const -> const std::filesystem::path&;
+
+private:
+
+    //
+    // Attaches to rings created since the last pass.
+    //
+    auto
+    discover_rings() -> void;
+
+    //
+    // Background collection loop.
+    //
+    auto
+    collection_loop() -> void;
+
+    //
+    // Directory where POSIX shared memory objects are exposed.
+    //
+    static constexpr const char* c_shared_memory_directory_path = "/dev/shm";
+
+    //
+    // Window in nanoseconds during which collected records are held back for ordering.
+    //
+    static constexpr std::uint64_t c_reorder_window_ns = 50'000'000u;
+
+    //
+    // Max size in bytes of a single batched write to the filesystem writer.
+    //
+    static constexpr std::size_t c_max_write_batch_size_bytes = 1024u * 1024u;
+
+    //
+    // Name prefix shared by the rings of the collected component.
+    //
+    const std::string m_ring_name_prefix;
+
+    //
+    // Collector session identifier.
+    //
+    const std::string m_session_id;
+
+    //
+    // Path to the directory where the collected segments will be stored.
+    //
+    const std::filesystem::path m_logging_session_directory_path;
+
+    //
+    // Frequency in milliseconds of background collection passes.
+    //
+    const std::uint32_t m_collection_frequency_ms;
+
+    //
+    // Filesystem writer for the collected segments.
+    //
+    filesystem_writer m_filesystem_writer;
+
+    //
+    // Attached rings indexed by shared memory object name.
+    //
+    std::map<std::string, std::unique_ptr<shared_memory_ring>> m_rings;
+
+    //
+    // Records collected but not yet written, kept sorted by timestamp.
+    //
+    std::vector<shared_memory_record> m_pending_records;
+
+    //
+    // Lock for serializing collection passes.
+    //
+    std::mutex m_collection_lock;
+
+    //
+    // Lock and condition variable for waking up the background thread on stop.
+    //
+    std::mutex m_stop_lock;
+
+    std::condition_variable m_stop_condition;
+
+    //
+    // Flag for signaling the background thread to exit.
+    //
+    bool m_stop_requested;
+
+    //
+    // Background collection thread.
+    //
+    std::thread m_collection_thread;
+
+};
+
+} // namespace echo.
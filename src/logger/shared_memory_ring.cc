@@ -0,0 +1,307 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'shared_memory_ring.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <optional>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "shared_memory_ring.hh"
+
+namespace echo
+{
+
+shared_memory_ring::shared_memory_ring(
+    const std::string& p_ring_name,
+    const std::uint32_t p_capacity_bytes)
+    : m_ring_name{"/" + p_ring_name},
+      m_ring_header{nullptr},
+      m_data{nullptr},
+      m_mapping_size{0u}
+{
+    const std::uint64_t capacity_bytes = align_record_size(p_capacity_bytes);
+
+    if (capacity_bytes < 2u * c_record_alignment)
+    {
+        throw std::invalid_argument("The shared memory ring capacity is too small.");
+    }
+
+    const int file_descriptor = shm_open(m_ring_name.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+
+    if (file_descriptor == -1)
+    {
+        throw std::runtime_error("Failed to create the shared memory ring '" + m_ring_name + "'.");
+    }
+
+    const std::uint64_t mapping_size = sizeof(ring_header) + capacity_bytes;
+
+    if (ftruncate(file_descriptor, static_cast<off_t>(mapping_size)) == -1)
+    {
+        close(file_descriptor);
+        shm_unlink(m_ring_name.c_str());
+
+        throw std::runtime_error("Failed to size the shared memory ring '" + m_ring_name + "'.");
+    }
+
+    try
+    {
+        map(file_descriptor, mapping_size);
+    }
+    catch (const std::exception& p_exception)
+    {
+        shm_unlink(m_ring_name.c_str());
+
+        throw;
+    }
+
+    //
+    // The object was truncated from zero, so the data area is already zero-filled.
+    // Publish the magic value last so an attaching collector never sees a partial header.
+    //
+    m_ring_header->m_capacity_bytes = capacity_bytes;
+    m_ring_header->m_producer_process_id = getpid();
+    m_ring_header->m_write_position.store(0u, std::memory_order_relaxed);
+    m_ring_header->m_read_position.store(0u, std::memory_order_relaxed);
+    m_ring_header->m_dropped_records_count.store(0u, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    m_ring_header->m_magic = c_ring_magic;
+}
+
+shared_memory_ring::shared_memory_ring(
+    const std::string& p_ring_name)
+    : m_ring_name{"/" + p_ring_name},
+      m_ring_header{nullptr},
+      m_data{nullptr},
+      m_mapping_size{0u}
+{
+    const int file_descriptor = shm_open(m_ring_name.c_str(), O_RDWR, 0600);
+
+    if (file_descriptor == -1)
+    {
+        throw std::runtime_error("Failed to open the shared memory ring '" + m_ring_name + "'.");
+    }
+
+    struct stat file_status {};
+
+    if (fstat(file_descriptor, &file_status) == -1 ||
+        static_cast<std::uint64_t>(file_status.st_size) < sizeof(ring_header))
+    {
+        close(file_descriptor);
+
+        throw std::runtime_error("The shared memory ring '" + m_ring_name + "' is not initialized.");
+    }
+
+    map(file_descriptor, static_cast<std::uint64_t>(file_status.st_size));
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+
+    if (m_ring_header->m_magic != c_ring_magic ||
+        sizeof(ring_header) + m_ring_header->m_capacity_bytes != m_mapping_size)
+    {
+        munmap(m_ring_header, m_mapping_size);
+
+        throw std::runtime_error("The shared memory ring '" + m_ring_name + "' is invalid.");
+    }
+}
+
+shared_memory_ring::~shared_memory_ring()
+{
+    if (m_ring_header != nullptr)
+    {
+        munmap(m_ring_header, m_mapping_size);
+    }
+}
+
+auto
+shared_memory_ring::append(
+    const std::uint64_t p_timestamp_ns,
+    const char* p_data,
+    const std::uint32_t p_size) -> status_code
+{
+    const std::uint64_t capacity_bytes = m_ring_header->m_capacity_bytes;
+    const std::uint64_t record_size = align_record_size(sizeof(record_header) + p_size);
+    record_header* header = nullptr;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_reservation_lock};
+
+        const std::uint64_t write_position = m_ring_header->m_write_position.load(std::memory_order_relaxed);
+        const std::uint64_t read_position = m_ring_header->m_read_position.load(std::memory_order_acquire);
+
+        //
+        // Records never wrap around the end of the data area; the remaining
+        // tail is covered by a padding record when the new one does not fit.
+        //
+        const std::uint64_t tail_size = capacity_bytes - (write_position % capacity_bytes);
+        const std::uint64_t padding_size = record_size > tail_size ? tail_size : 0u;
+
+        if (record_size > capacity_bytes ||
+            write_position + padding_size + record_size - read_position > capacity_bytes)
+        {
+            //
+            // The collector is behind. Never stall the producer; account for the loss instead.
+            //
+            m_ring_header->m_dropped_records_count.fetch_add(1u, std::memory_order_relaxed);
+
+            return status::shared_memory_ring_full;
+        }
+
+        if (padding_size != 0u)
+        {
+            record_header* padding_header = get_record_header(write_position);
+            padding_header->m_size = static_cast<std::uint32_t>(padding_size - sizeof(record_header));
+            padding_header->m_timestamp_ns = 0u;
+            padding_header->m_state.store(c_record_state_padding, std::memory_order_relaxed);
+        }
+
+        header = get_record_header(write_position + padding_size);
+        header->m_size = p_size;
+        header->m_timestamp_ns = p_timestamp_ns;
+        header->m_state.store(c_record_state_reserved, std::memory_order_relaxed);
+
+        //
+        // Publishing the reservation makes the record headers visible to the collector.
+        // Its payload is only read after the commit below.
+        //
+        m_ring_header->m_write_position.store(
+            write_position + padding_size + record_size,
+            std::memory_order_release);
+    }
+
+    std::memcpy(reinterpret_cast<std::uint8_t*>(header) + sizeof(record_header), p_data, p_size);
+
+    header->m_state.store(c_record_state_committed, std::memory_order_release);
+
+    return status::success;
+}
+
+auto
+shared_memory_ring::collect(
+    std::vector<shared_memory_record>& p_records) -> std::uint64_t
+{
+    const std::uint64_t capacity_bytes = m_ring_header->m_capacity_bytes;
+    const std::uint64_t write_position = m_ring_header->m_write_position.load(std::memory_order_acquire);
+    std::uint64_t position = m_ring_header->m_read_position.load(std::memory_order_relaxed);
+    std::optional<bool> producer_alive;
+
+    while (position < write_position)
+    {
+        const record_header* header = get_record_header(position);
+        const std::uint32_t state = header->m_state.load(std::memory_order_acquire);
+
+        if (state == c_record_state_padding)
+        {
+            position += capacity_bytes - (position % capacity_bytes);
+
+            continue;
+        }
+
+        if (state == c_record_state_reserved)
+        {
+            if (!producer_alive.has_value())
+            {
+                producer_alive = is_producer_alive();
+            }
+
+            if (producer_alive.value())
+            {
+                //
+                // The record is still being written; preserve ordering and stop here.
+                //
+                break;
+            }
+
+            //
+            // The producer died while writing this record; it will never be committed.
+            //
+            position += align_record_size(sizeof(record_header) + header->m_size);
+
+            continue;
+        }
+
+        p_records.push_back(shared_memory_record{
+            header->m_timestamp_ns,
+            std::string(reinterpret_cast<const char*>(header + 1), header->m_size)});
+
+        position += align_record_size(sizeof(record_header) + header->m_size);
+    }
+
+    return position;
+}
+
+auto
+shared_memory_ring::release(
+    const std::uint64_t p_position) -> void
+{
+    m_ring_header->m_read_position.store(p_position, std::memory_order_release);
+}
+
+auto
+shared_memory_ring::is_producer_alive() const -> bool
+{
+    return kill(m_ring_header->m_producer_process_id, 0) == 0 || errno == EPERM;
+}
+
+auto
+shared_memory_ring::is_drained() const -> bool
+{
+    return m_ring_header->m_read_position.load(std::memory_order_acquire) ==
+        m_ring_header->m_write_position.load(std::memory_order_acquire);
+}
+
+auto
+shared_memory_ring::get_dropped_records_count() const -> std::uint64_t
+{
+    return m_ring_header->m_dropped_records_count.load(std::memory_order_relaxed);
+}
+
+auto
+shared_memory_ring::unlink() -> void
+{
+    shm_unlink(m_ring_name.c_str());
+}
+
+auto
+shared_memory_ring::map(
+    const int p_file_descriptor,
+    const std::uint64_t p_mapping_size) -> void
+{
+    void* mapping = mmap(
+        nullptr,
+        p_mapping_size,
+        PROT_READ | PROT_WRITE,
+        MAP_SHARED,
+        p_file_descriptor,
+        0);
+
+    //
+    // The mapping keeps the object referenced; the descriptor is no longer needed.
+    //
+    close(p_file_descriptor);
+
+    if (mapping == MAP_FAILED)
+    {
+        throw std::runtime_error("Failed to map the shared memory ring '" + m_ring_name + "'.");
+    }
+
+    m_ring_header = static_cast<ring_header*>(mapping);
+    m_data = static_cast<std::uint8_t*>(mapping) + sizeof(ring_header);
+    m_mapping_size = p_mapping_size;
+}
+
+auto
+shared_memory_ring::get_record_header(
+    const std::uint64_t p_position) const -> record_header*
+{
+    return reinterpret_cast<record_header*>(m_data + (p_position % m_ring_header->m_capacity_bytes));
+}
+
+} // namespace echo.
@@ -0,0 +1,276 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'shared_memory_ring.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <unistd.h>
+#include "../status/status.hh"
+
+namespace echo
+{
+
+//
+// Log record drained from a shared memory ring.
+//
+struct shared_memory_record
+{
+
+    //
+    // Wall-clock timestamp in nanoseconds taken by the producer.
+    //
+    std::uint64_t m_timestamp_ns;
+
+    //
+    // Fully formatted log message.
+    //
+    std::string m_log_message;
+
+};
+
+//
+// Single-process-producer, single-collector log ring placed in POSIX shared memory.
+// Records committed by the producer survive a producer crash since the memory
+// object outlives the process; the collector unlinks it once it is fully drained.
+//
+class shared_memory_ring
+{
+
+public:
+
+    //
+    // Creates a new ring owned by the calling process.
+    // Throws if the shared memory object cannot be created or mapped.
+    //
+    shared_memory_ring(
+        const std::string& p_ring_name,
+        const std::uint32_t p_capacity_bytes);
+
+    //
+    // Attaches to an existing ring from the collector side.
+    // Throws if the shared memory object cannot be opened, mapped or validated.
+    //
+    explicit
+    shared_memory_ring(
+        const std::string& p_ring_name);
+
+    //
+    // Destructor. Unmaps the ring; the shared memory object is kept.
+    //
+    ~shared_memory_ring();
+
+    shared_memory_ring(const shared_memory_ring&) = delete;
+
+    shared_memory_ring&
+    operator=(const shared_memory_ring&) = delete;
+
+    //
+    // Appends a record to the ring. Thread-safe among producer threads.
+    // Never blocks on the collector; fails if there is not enough free space.
+    //
+    auto
+    append(
+        const std::uint64_t p_timestamp_ns,
+        const char* p_data,
+        const std::uint32_t p_size) -> status_code;
+
+    //
+    // Copies every committed record that has not been released yet into the output vector
+    // and returns the ring position up to which records were collected. Records reserved by
+    // a producer that is no longer alive are skipped since they will never be committed.
+    // Only one collector may consume a given ring.
+    //
+    auto
+    collect(
+        std::vector<shared_memory_record>& p_records) -> std::uint64_t;
+
+    //
+    // Releases the ring space up to the position returned by collect.
+    //
+    auto
+    release(
+        const std::uint64_t p_position) -> void;
+
+    //
+    // Determines whether the producer process of the ring is still running.
+    //
+    auto
+    is_producer_alive() const -> bool;
+
+    //
+    // Determines whether every reserved record has been released by the collector.
+    //
+    auto
+    is_drained() const -> bool;
+
+    //
+    // Gets the number of records dropped by the producer because the ring was full.
+    //
+    auto
+    get_dropped_records_count() const -> std::uint64_t;
+
+    //
+    // Removes the shared memory object name. Existing mappings remain valid.
+    //
+    auto
+    unlink() -> void;
+
+    //
+    // Shared memory object name prefix used for all echo rings.
+    //
+    static constexpr const char* c_ring_name_prefix = "echo-ring-";
+
+private:
+
+    //
+    // Record header placed before every record payload.
+    //
+    struct record_header
+    {
+
+        //
+        // Record state; one of the c_record_state_* values.
+        //
+        std::atomic<std::uint32_t> m_state;
+
+        //
+        // Payload size in bytes.
+        //
+        std::uint32_t m_size;
+
+        //
+        // Producer timestamp in nanoseconds.
+        //
+        std::uint64_t m_timestamp_ns;
+
+    };
+
+    //
+    // Ring control block placed at the start of the shared memory object.
+    //
+    struct ring_header
+    {
+
+        //
+        // Magic value used to validate attached rings.
+        //
+        std::uint64_t m_magic;
+
+        //
+        // Data area capacity in bytes.
+        //
+        std::uint64_t m_capacity_bytes;
+
+        //
+        // Process ID of the producer.
+        //
+        pid_t m_producer_process_id;
+
+        //
+        // Monotonic position up to which space has been reserved by the producer.
+        //
+        alignas(64) std::atomic<std::uint64_t> m_write_position;
+
+        //
+        // Monotonic position up to which records have been released by the collector.
+        //
+        alignas(64) std::atomic<std::uint64_t> m_read_position;
+
+        //
+        // Count of records dropped because the ring was full.
+        //
+        alignas(64) std::atomic<std::uint64_t> m_dropped_records_count;
+
+    };
+
+    static_assert(std::atomic<std::uint32_t>::is_always_lock_free);
+    static_assert(std::atomic<std::uint64_t>::is_always_lock_free);
+
+    //
+    // Maps the shared memory object referenced by the file descriptor.
+    //
+    auto
+    map(
+        const int p_file_descriptor,
+        const std::uint64_t p_mapping_size) -> void;
+
+    //
+    // Gets the record header located at the given monotonic ring position.
+    //
+    auto
+    get_record_header(
+        const std::uint64_t p_position) const -> record_header*;
+
+    //
+    // Rounds up a size to the record alignment.
+    //
+    static
+    auto
+    align_record_size(
+        const std::uint64_t p_size) -> std::uint64_t
+    {
+        return (p_size + c_record_alignment - 1u) & ~(c_record_alignment - 1u);
+    }
+
+    //
+    // Magic value for identifying echo rings ("ECHORING").
+    //
+    static constexpr std::uint64_t c_ring_magic = 0x474E4952'4F484345u;
+
+    //
+    // Alignment for records inside the data area.
+    //
+    static constexpr std::uint64_t c_record_alignment = sizeof(record_header);
+
+    //
+    // Record reserved by the producer but not yet fully written.
+    //
+    static constexpr std::uint32_t c_record_state_reserved = 1u;
+
+    //
+    // Record fully written and visible to the collector.
+    //
+    static constexpr std::uint32_t c_record_state_committed = 2u;
+
+    //
+    // Filler record covering the tail of the data area before a wraparound.
+    //
+    static constexpr std::uint32_t c_record_state_padding = 3u;
+
+    //
+    // Shared memory object name, including the leading slash.
+    //
+    const std::string m_ring_name;
+
+    //
+    // Mapped control block.
+    //
+    ring_header* m_ring_header;
+
+    //
+    // Mapped data area.
+    //
+    std::uint8_t* m_data;
+
+    //
+    // Size of the whole mapping in bytes.
+    //
+    std::uint64_t m_mapping_size;
+
+    //
+    // Lock for serializing space reservation among producer threads.
+    //
+    std::mutex m_reservation_lock;
+
+};
+
+} // namespace echo.
@@ -0,0 +1,358 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'socket_log_collector.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <cerrno>
+#include <vector>
+#include <poll.h>
+#include <stdexcept>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/socket.h>
+#include "socket_log_collector.hh"
+#include "log_shipping_protocol.hh"
+
+namespace echo
+{
+
+socket_log_collector::socket_log_collector(
+    const std::filesystem::path& p_socket_path,
+    const std::filesystem::path& p_logs_directory_path,
+    const bool p_segment_index_enabled)
+    : m_socket_path{p_socket_path},
+      m_logs_directory_path{std::filesystem::absolute(p_logs_directory_path)},
+      m_segment_index_enabled{p_segment_index_enabled},
+      m_listening_socket_descriptor{-1},
+      m_stop_requested{false},
+      m_collected_records_count{0u}
+{
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    if (m_socket_path.native().size() >= sizeof(address.sun_path))
+    {
+        throw std::invalid_argument("The collector socket path '" + m_socket_path.string() + "' is too long.");
+    }
+
+    m_socket_path.native().copy(address.sun_path, sizeof(address.sun_path) - 1u);
+
+    //
+    // A socket file left behind by a previous collector would make the bind fail.
+    //
+    std::error_code error_code;
+    std::filesystem::remove(m_socket_path, error_code);
+
+    m_listening_socket_descriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    if (m_listening_socket_descriptor == -1 ||
+        bind(m_listening_socket_descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1 ||
+        listen(m_listening_socket_descriptor, SOMAXCONN) == -1)
+    {
+        if (m_listening_socket_descriptor != -1)
+        {
+            close(m_listening_socket_descriptor);
+        }
+
+        throw std::runtime_error("Failed to listen on the collector socket '" + m_socket_path.string() + "'.");
+    }
+}
+
+socket_log_collector::~socket_log_collector()
+{
+    stop();
+    reap_connections(true /* p_all_connections */);
+
+    close(m_listening_socket_descriptor);
+
+    std::error_code error_code;
+    std::filesystem::remove(m_socket_path, error_code);
+}
+
+auto
+socket_log_collector::run() -> void
+{
+    while (!m_stop_requested.load(std::memory_order_relaxed))
+    {
+        pollfd listening_socket {m_listening_socket_descriptor, POLLIN, 0};
+
+        //
+        // Wake up periodically to observe stop requests and reap finished connections.
+        //
+        if (poll(&listening_socket, 1u, c_polling_interval_ms) > 0)
+        {
+            const int socket_descriptor = accept4(m_listening_socket_descriptor, nullptr, nullptr, SOCK_CLOEXEC);
+
+            if (socket_descriptor != -1)
+            {
+                std::scoped_lock<std::mutex> lock {m_connections_lock};
+
+                connection& new_connection = m_connections.emplace_back();
+                new_connection.m_socket_descriptor = socket_descriptor;
+                new_connection.m_thread = std::thread(&socket_log_collector::serve_connection, this, std::ref(new_connection));
+            }
+        }
+
+        reap_connections(false /* p_all_connections */);
+    }
+
+    reap_connections(true /* p_all_connections */);
+}
+
+auto
+socket_log_collector::stop() -> void
+{
+    m_stop_requested.store(true, std::memory_order_relaxed);
+
+    std::scoped_lock<std::mutex> lock {m_connections_lock};
+
+    for (connection& current_connection : m_connections)
+    {
+        //
+        // Wakes up the connection thread; the descriptor is closed once the thread is joined.
+        //
+        shutdown(current_connection.m_socket_descriptor, SHUT_RDWR);
+    }
+}
+
+auto
+socket_log_collector::get_collected_records_count() const -> std::uint64_t
+{
+    return m_collected_records_count.load(std::memory_order_relaxed);
+}
+
+auto
+socket_log_collector::serve_connection(
+    connection& p_connection) -> void
+{
+    char hello_header[log_shipping_protocol::c_hello_header_size_bytes];
+
+    if (!receive_buffer(p_connection.m_socket_descriptor, hello_header, sizeof(hello_header)) ||
+        log_shipping_protocol::read_value<std::uint32_t>(hello_header, 0u) != log_shipping_protocol::c_frame_magic ||
+        log_shipping_protocol::read_value<std::uint32_t>(hello_header, 4u) != log_shipping_protocol::c_protocol_version)
+    {
+        p_connection.m_finished.store(true, std::memory_order_release);
+
+        return;
+    }
+
+    std::string component_name(log_shipping_protocol::read_value<std::uint16_t>(hello_header, 8u), '\0');
+    std::string session_id(log_shipping_protocol::read_value<std::uint16_t>(hello_header, 10u), '\0');
+
+    std::shared_ptr<filesystem_writer> session_filesystem_writer;
+
+    if (receive_buffer(p_connection.m_socket_descriptor, component_name.data(), component_name.size()) &&
+        receive_buffer(p_connection.m_socket_descriptor, session_id.data(), session_id.size()))
+    {
+        session_filesystem_writer = get_filesystem_writer(component_name, session_id);
+    }
+
+    std::string frame_payload;
+    std::string payload;
+
+    while (session_filesystem_writer != nullptr)
+    {
+        char batch_header[log_shipping_protocol::c_batch_header_size_bytes];
+
+        if (!receive_buffer(p_connection.m_socket_descriptor, batch_header, sizeof(batch_header)) ||
+            log_shipping_protocol::read_value<std::uint32_t>(batch_header, 0u) != log_shipping_protocol::c_frame_magic)
+        {
+            break;
+        }
+
+        const std::uint32_t flags = log_shipping_protocol::read_value<std::uint32_t>(batch_header, 4u);
+        const std::uint32_t records_count = log_shipping_protocol::read_value<std::uint32_t>(batch_header, 8u);
+        const std::uint32_t payload_size_bytes = log_shipping_protocol::read_value<std::uint32_t>(batch_header, 12u);
+        const std::uint32_t frame_payload_size_bytes = log_shipping_protocol::read_value<std::uint32_t>(batch_header, 16u);
+
+        if (payload_size_bytes > log_shipping_protocol::c_max_batch_payload_size_bytes ||
+            frame_payload_size_bytes > log_shipping_protocol::c_max_batch_payload_size_bytes)
+        {
+            break;
+        }
+
+        frame_payload.resize(frame_payload_size_bytes);
+
+        if (!receive_buffer(p_connection.m_socket_descriptor, frame_payload.data(), frame_payload.size()))
+        {
+            //
+            // The shipper resends a batch cut short on its next connection.
+            //
+            break;
+        }
+
+        if ((flags & log_shipping_protocol::c_lz4_compressed_batch_flag) != 0u)
+        {
+            if (!log_shipping_protocol::decompress_payload(frame_payload, payload_size_bytes, payload))
+            {
+                break;
+            }
+        }
+        else
+        {
+            payload.swap(frame_payload);
+        }
+
+        if (!write_batch(*session_filesystem_writer, payload, records_count))
+        {
+            break;
+        }
+    }
+
+    p_connection.m_finished.store(true, std::memory_order_release);
+}
+
+auto
+socket_log_collector::write_batch(
+    filesystem_writer& p_filesystem_writer,
+    const std::string_view p_payload,
+    const std::uint32_t p_records_count) -> bool
+{
+    std::string log_messages;
+    std::vector<log_record_extent> extents;
+    std::size_t offset = 0u;
+
+    log_messages.reserve(p_payload.size());
+    extents.reserve(p_records_count);
+
+    while (offset < p_payload.size())
+    {
+        const std::optional<log_shipping_protocol::shipped_record> record = log_shipping_protocol::read_record(p_payload, offset);
+
+        if (!record.has_value())
+        {
+            return false;
+        }
+
+        log_messages.append(record->m_log_message);
+        extents.push_back(log_record_extent{
+            log_record_metadata{record->m_timestamp_ns, record->m_log_level, record->m_title, std::nullopt},
+            record->m_log_message.size()});
+    }
+
+    if (extents.size() != p_records_count)
+    {
+        return false;
+    }
+
+    //
+    // Records the disk refuses are kept by the writer's memory spill; the stream goes on.
+    //
+    p_filesystem_writer.write_log_messages_to_disk(
+        log_messages,
+        m_segment_index_enabled ? std::span<const log_record_extent>(extents) : std::span<const log_record_extent>());
+
+    m_collected_records_count.fetch_add(extents.size(), std::memory_order_relaxed);
+
+    return true;
+}
+
+auto
+socket_log_collector::get_filesystem_writer(
+    const std::string& p_component_name,
+    const std::string& p_session_id) -> std::shared_ptr<filesystem_writer>
+{
+    //
+    // Names come from the wire; they must stay inside the logs directory.
+    //
+    for (const std::string* name : {&p_component_name, &p_session_id})
+    {
+        if (name->empty() ||
+            name->find('/') != std::string::npos ||
+            name->find("..") != std::string::npos)
+        {
+            return nullptr;
+        }
+    }
+
+    const std::string session_directory_name = p_component_name + "-logs-" + p_session_id;
+
+    std::scoped_lock<std::mutex> lock {m_filesystem_writers_lock};
+
+    std::shared_ptr<filesystem_writer>& session_filesystem_writer = m_filesystem_writers[session_directory_name];
+
+    if (session_filesystem_writer == nullptr)
+    {
+        session_filesystem_writer = std::make_shared<filesystem_writer>(
+            p_session_id,
+            m_logs_directory_path / session_directory_name,
+            m_segment_index_enabled,
+            c_segment_index_block_record_count);
+    }
+
+    return session_filesystem_writer;
+}
+
+auto
+socket_log_collector::reap_connections(
+    const bool p_all_connections) -> void
+{
+    std::list<connection> finished_connections;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_connections_lock};
+
+        for (auto connection_iterator = m_connections.begin(); connection_iterator != m_connections.end(); )
+        {
+            if (p_all_connections)
+            {
+                shutdown(connection_iterator->m_socket_descriptor, SHUT_RDWR);
+            }
+
+            if (p_all_connections ||
+                connection_iterator->m_finished.load(std::memory_order_acquire))
+            {
+                finished_connections.splice(finished_connections.end(), m_connections, connection_iterator++);
+
+                continue;
+            }
+
+            ++connection_iterator;
+        }
+    }
+
+    for (connection& finished_connection : finished_connections)
+    {
+        finished_connection.m_thread.join();
+
+        close(finished_connection.m_socket_descriptor);
+    }
+}
+
+auto
+socket_log_collector::receive_buffer(
+    const int p_socket_descriptor,
+    char* p_buffer,
+    const std::size_t p_size_bytes) -> bool
+{
+    std::size_t received_size_bytes = 0u;
+
+    while (received_size_bytes < p_size_bytes)
+    {
+        const ssize_t result = recv(
+            p_socket_descriptor,
+            p_buffer + received_size_bytes,
+            p_size_bytes - received_size_bytes,
+            0);
+
+        if (result == -1 &&
+            errno == EINTR)
+        {
+            continue;
+        }
+
+        if (result <= 0)
+        {
+            return false;
+        }
+
+        received_size_bytes += static_cast<std::size_t>(result);
+    }
+
+    return true;
+}
+
+} // namespace echo.
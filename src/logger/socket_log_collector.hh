@@ -0,0 +1,196 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'socket_log_collector.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <map>
+#include <list>
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <filesystem>
+#include "filesystem_writer.hh"
+
+namespace echo
+{
+
+//
+// Collector receiving the streams of socket log shippers on a Unix domain socket and writing
+// each logging session into the standard segment layout under the logs directory, as if the
+// session had been logged to disk locally: '<component>-logs-<session>/log_<session>_<count>.log'.
+// Every connection is served by its own thread; reconnections of a session append to its segments.
+// Thread-safe class.
+//
+class socket_log_collector
+{
+
+public:
+
+    //
+    // Constructor. Binds and listens on the socket, replacing a stale socket file.
+    // Throws if the socket cannot be created.
+    //
+    socket_log_collector(
+        const std::filesystem::path& p_socket_path,
+        const std::filesystem::path& p_logs_directory_path,
+        const bool p_segment_index_enabled = true);
+
+    //
+    // Destructor. Stops serving and removes the socket file.
+    //
+    ~socket_log_collector();
+
+    socket_log_collector(const socket_log_collector&) = delete;
+
+    socket_log_collector&
+    operator=(const socket_log_collector&) = delete;
+
+    //
+    // Accepts and serves connections until stopped.
+    //
+    auto
+    run() -> void;
+
+    //
+    // Stops accepting connections and closes the connections being served.
+    // Can be called from any thread.
+    //
+    auto
+    stop() -> void;
+
+    //
+    // Gets the count of records written to disk so far.
+    //
+    auto
+    get_collected_records_count() const -> std::uint64_t;
+
+private:
+
+    //
+    // Connection served by the collector.
+    //
+    struct connection
+    {
+
+        int m_socket_descriptor;
+
+        std::thread m_thread;
+
+        std::atomic<bool> m_finished {false};
+
+    };
+
+    //
+    // Receives the hello frame and the batches of a connection.
+    //
+    auto
+    serve_connection(
+        connection& p_connection) -> void;
+
+    //
+    // Decodes a batch payload and writes its records to the session segments.
+    // Returns false if the payload is malformed.
+    //
+    auto
+    write_batch(
+        filesystem_writer& p_filesystem_writer,
+        const std::string_view p_payload,
+        const std::uint32_t p_records_count) -> bool;
+
+    //
+    // Gets the writer of a logging session, creating it on the first connection of the session.
+    //
+    auto
+    get_filesystem_writer(
+        const std::string& p_component_name,
+        const std::string& p_session_id) -> std::shared_ptr<filesystem_writer>;
+
+    //
+    // Joins the threads of the connections that finished.
+    //
+    auto
+    reap_connections(
+        const bool p_all_connections) -> void;
+
+    //
+    // Reads exactly the size of the buffer from a connection. Returns false on disconnection.
+    //
+    static
+    auto
+    receive_buffer(
+        const int p_socket_descriptor,
+        char* p_buffer,
+        const std::size_t p_size_bytes) -> bool;
+
+    //
+    // Interval in milliseconds at which the accept loop observes stop requests.
+    //
+    static constexpr int c_polling_interval_ms = 200;
+
+    //
+    // Records per sidecar index block of the collected segments.
+    //
+    static constexpr std::uint32_t c_segment_index_block_record_count = 256u;
+
+    //
+    // Path to the socket the collector listens on.
+    //
+    const std::filesystem::path m_socket_path;
+
+    //
+    // Absolute path to the directory where the session directories are created.
+    //
+    const std::filesystem::path m_logs_directory_path;
+
+    //
+    // Flag for determining if segments get a sidecar index.
+    //
+    const bool m_segment_index_enabled;
+
+    //
+    // Listening socket.
+    //
+    int m_listening_socket_descriptor;
+
+    //
+    // Flag for signaling the collector to stop.
+    //
+    std::atomic<bool> m_stop_requested;
+
+    //
+    // Connections being served.
+    //
+    std::list<connection> m_connections;
+
+    //
+    // Lock for the connections.
+    //
+    std::mutex m_connections_lock;
+
+    //
+    // Writers of the logging sessions seen so far, keyed by session directory name.
+    // Kept for the lifetime of the collector so that reconnections continue the segment count.
+    //
+    std::map<std::string, std::shared_ptr<filesystem_writer>> m_filesystem_writers;
+
+    //
+    // Lock for the writers.
+    //
+    std::mutex m_filesystem_writers_lock;
+
+    //
+    // Count of records written to disk.
+    //
+    std::atomic<std::uint64_t> m_collected_records_count;
+
+};
+
+} // namespace echo.
@@ -0,0 +1,425 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'socket_log_shipper.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <cerrno>
+#include <algorithm>
+#include <unistd.h>
+#include <sys/un.h>
+#include <sys/time.h>
+#include <sys/socket.h>
+#include "socket_log_shipper.hh"
+#include "log_shipping_protocol.hh"
+
+namespace echo
+{
+
+socket_log_shipper::socket_log_shipper(
+    const std::filesystem::path& p_socket_path,
+    const std::string& p_component_name,
+    const std::string& p_session_id,
+    const std::uint32_t p_buffer_size_mib,
+    const bool p_compression_enabled,
+    const std::uint32_t p_flush_frequency_ms)
+    : m_socket_path{p_socket_path},
+      m_component_name{p_component_name},
+      m_session_id{p_session_id},
+      m_max_buffered_size_bytes{static_cast<std::uint64_t>(p_buffer_size_mib) * 1024u * 1024u},
+      m_compression_enabled{p_compression_enabled && log_shipping_protocol::is_compression_supported()},
+      m_flush_frequency_ms{std::max(p_flush_frequency_ms, 1u)},
+      m_batch_records_count{0u},
+      m_buffered_size_bytes{0u},
+      m_dropped_records_count{0u},
+      m_stop_requested{false},
+      m_socket_descriptor{-1},
+      m_reconnection_backoff{c_min_reconnection_backoff},
+      m_next_connection_attempt_time{std::chrono::steady_clock::now()}
+{
+    m_sender_thread = std::thread(&socket_log_shipper::sender_loop, this);
+}
+
+socket_log_shipper::~socket_log_shipper()
+{
+    {
+        std::scoped_lock<std::mutex> lock {m_buffer_lock};
+
+        m_stop_requested = true;
+    }
+
+    m_sender_condition.notify_all();
+
+    if (m_sender_thread.joinable())
+    {
+        m_sender_thread.join();
+    }
+
+    std::scoped_lock<std::mutex> send_lock {m_send_lock};
+
+    //
+    // Skip the backoff; this is the last chance for the buffered records.
+    //
+    m_next_connection_attempt_time = std::chrono::steady_clock::now();
+
+    send_batches();
+    disconnect_from_collector();
+}
+
+auto
+socket_log_shipper::ship(
+    const std::uint64_t p_timestamp_ns,
+    const log_level p_log_level,
+    const char* p_title,
+    const std::string_view p_log_message) -> status_code
+{
+    const std::size_t record_size_bytes =
+        log_shipping_protocol::c_record_header_size_bytes +
+        std::min(std::char_traits<char>::length(p_title), log_shipping_protocol::c_max_title_size_bytes) + 1u +
+        p_log_message.size();
+
+    bool sender_wake_up_required = false;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_buffer_lock};
+
+        if (m_buffered_size_bytes + record_size_bytes > m_max_buffered_size_bytes ||
+            m_batch_payload.size() + record_size_bytes > log_shipping_protocol::c_max_batch_payload_size_bytes)
+        {
+            ++m_dropped_records_count;
+
+            return status::shipping_buffer_full;
+        }
+
+        log_shipping_protocol::append_record(
+            m_batch_payload,
+            p_timestamp_ns,
+            p_log_level,
+            p_title,
+            p_log_message);
+
+        ++m_batch_records_count;
+        m_buffered_size_bytes += record_size_bytes;
+
+        //
+        // Only the record crossing the threshold pays for the notification.
+        //
+        sender_wake_up_required =
+            m_batch_payload.size() >= c_batch_threshold_size_bytes &&
+            m_batch_payload.size() - record_size_bytes < c_batch_threshold_size_bytes;
+    }
+
+    if (sender_wake_up_required)
+    {
+        m_sender_condition.notify_one();
+    }
+
+    return status::success;
+}
+
+auto
+socket_log_shipper::ship(
+    const std::span<const log_record_extent> p_log_record_extents,
+    const std::string_view p_log_messages) -> status_code
+{
+    std::size_t records_size_bytes = 0u;
+
+    for (const log_record_extent& extent : p_log_record_extents)
+    {
+        records_size_bytes +=
+            log_shipping_protocol::c_record_header_size_bytes +
+            std::min(std::char_traits<char>::length(extent.m_metadata.m_title), log_shipping_protocol::c_max_title_size_bytes) + 1u +
+            extent.m_size_bytes;
+    }
+
+    bool sender_wake_up_required = false;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_buffer_lock};
+
+        if (m_buffered_size_bytes + records_size_bytes > m_max_buffered_size_bytes ||
+            m_batch_payload.size() + records_size_bytes > log_shipping_protocol::c_max_batch_payload_size_bytes)
+        {
+            m_dropped_records_count += p_log_record_extents.size();
+
+            return status::shipping_buffer_full;
+        }
+
+        std::size_t offset = 0u;
+
+        for (const log_record_extent& extent : p_log_record_extents)
+        {
+            log_shipping_protocol::append_record(
+                m_batch_payload,
+                extent.m_metadata.m_timestamp_ns,
+                extent.m_metadata.m_log_level,
+                extent.m_metadata.m_title,
+                p_log_messages.substr(offset, extent.m_size_bytes));
+
+            offset += extent.m_size_bytes;
+        }
+
+        m_batch_records_count += static_cast<std::uint32_t>(p_log_record_extents.size());
+        m_buffered_size_bytes += records_size_bytes;
+
+        sender_wake_up_required =
+            m_batch_payload.size() >= c_batch_threshold_size_bytes &&
+            m_batch_payload.size() - records_size_bytes < c_batch_threshold_size_bytes;
+    }
+
+    if (sender_wake_up_required)
+    {
+        m_sender_condition.notify_one();
+    }
+
+    return status::success;
+}
+
+auto
+socket_log_shipper::flush() -> status_code
+{
+    std::scoped_lock<std::mutex> send_lock {m_send_lock};
+
+    return send_batches();
+}
+
+auto
+socket_log_shipper::get_socket_path() const -> const std::filesystem::path&
+{
+    return m_socket_path;
+}
+
+auto
+socket_log_shipper::get_dropped_records_count() const -> std::uint64_t
+{
+    std::scoped_lock<std::mutex> lock {m_buffer_lock};
+
+    return m_dropped_records_count;
+}
+
+auto
+socket_log_shipper::sender_loop() -> void
+{
+    while (true)
+    {
+        {
+            std::unique_lock<std::mutex> lock {m_buffer_lock};
+
+            m_sender_condition.wait_for(
+                lock,
+                std::chrono::milliseconds(m_flush_frequency_ms),
+                [this]()
+                {
+                    return m_stop_requested ||
+                        m_batch_payload.size() >= c_batch_threshold_size_bytes;
+                });
+
+            if (m_stop_requested)
+            {
+                return;
+            }
+        }
+
+        std::scoped_lock<std::mutex> send_lock {m_send_lock};
+
+        send_batches();
+    }
+}
+
+auto
+socket_log_shipper::send_batches() -> status_code
+{
+    seal_batch();
+
+    while (true)
+    {
+        const std::string* frame = nullptr;
+
+        {
+            std::scoped_lock<std::mutex> lock {m_buffer_lock};
+
+            if (m_sealed_frames.empty())
+            {
+                return status::success;
+            }
+
+            //
+            // Only the sender pops frames, and appending to the deque keeps references valid.
+            //
+            frame = &m_sealed_frames.front();
+        }
+
+        if (status::failed(connect_to_collector()) ||
+            status::failed(send_buffer(*frame)))
+        {
+            //
+            // A frame cut short is discarded by the collector; it is sent again whole on the next connection.
+            //
+            disconnect_from_collector();
+
+            return status::collector_connection_failed;
+        }
+
+        std::scoped_lock<std::mutex> lock {m_buffer_lock};
+
+        m_buffered_size_bytes -= frame->size();
+        m_sealed_frames.pop_front();
+    }
+}
+
+auto
+socket_log_shipper::seal_batch() -> void
+{
+    std::string payload;
+    std::uint32_t records_count = 0u;
+
+    {
+        std::scoped_lock<std::mutex> lock {m_buffer_lock};
+
+        if (m_batch_records_count == 0u)
+        {
+            return;
+        }
+
+        payload.swap(m_batch_payload);
+        records_count = m_batch_records_count;
+        m_batch_records_count = 0u;
+    }
+
+    //
+    // Compression runs outside of the buffer lock so that producers are not held back.
+    //
+    std::string compressed_payload;
+    const bool compressed =
+        m_compression_enabled &&
+        log_shipping_protocol::compress_payload(payload, compressed_payload) &&
+        compressed_payload.size() < payload.size();
+
+    const std::string& frame_payload = compressed ? compressed_payload : payload;
+    std::string frame;
+    frame.reserve(log_shipping_protocol::c_batch_header_size_bytes + frame_payload.size());
+
+    log_shipping_protocol::append_value<std::uint32_t>(frame, log_shipping_protocol::c_frame_magic);
+    log_shipping_protocol::append_value<std::uint32_t>(frame, compressed ? log_shipping_protocol::c_lz4_compressed_batch_flag : 0u);
+    log_shipping_protocol::append_value<std::uint32_t>(frame, records_count);
+    log_shipping_protocol::append_value<std::uint32_t>(frame, static_cast<std::uint32_t>(payload.size()));
+    log_shipping_protocol::append_value<std::uint32_t>(frame, static_cast<std::uint32_t>(frame_payload.size()));
+    frame.append(frame_payload);
+
+    std::scoped_lock<std::mutex> lock {m_buffer_lock};
+
+    m_buffered_size_bytes = m_buffered_size_bytes - payload.size() + frame.size();
+    m_sealed_frames.push_back(std::move(frame));
+}
+
+auto
+socket_log_shipper::connect_to_collector() -> status_code
+{
+    if (m_socket_descriptor != -1)
+    {
+        return status::success;
+    }
+
+    const std::chrono::steady_clock::time_point current_time = std::chrono::steady_clock::now();
+
+    if (current_time < m_next_connection_attempt_time)
+    {
+        return status::collector_connection_failed;
+    }
+
+    sockaddr_un address {};
+    address.sun_family = AF_UNIX;
+
+    if (m_socket_path.native().size() >= sizeof(address.sun_path))
+    {
+        return status::incorrect_parameters;
+    }
+
+    m_socket_path.native().copy(address.sun_path, sizeof(address.sun_path) - 1u);
+
+    m_socket_descriptor = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+
+    //
+    // A stalled collector fails the send instead of blocking the flushes indefinitely.
+    //
+    const timeval send_timeout {c_send_timeout_s, 0};
+
+    if (m_socket_descriptor == -1 ||
+        setsockopt(m_socket_descriptor, SOL_SOCKET, SO_SNDTIMEO, &send_timeout, sizeof(send_timeout)) == -1 ||
+        connect(m_socket_descriptor, reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == -1)
+    {
+        disconnect_from_collector();
+
+        m_next_connection_attempt_time = current_time + m_reconnection_backoff;
+        m_reconnection_backoff = std::min(m_reconnection_backoff * 2, c_max_reconnection_backoff);
+
+        return status::collector_connection_failed;
+    }
+
+    std::string hello;
+
+    log_shipping_protocol::append_value<std::uint32_t>(hello, log_shipping_protocol::c_frame_magic);
+    log_shipping_protocol::append_value<std::uint32_t>(hello, log_shipping_protocol::c_protocol_version);
+    log_shipping_protocol::append_value<std::uint16_t>(hello, static_cast<std::uint16_t>(m_component_name.size()));
+    log_shipping_protocol::append_value<std::uint16_t>(hello, static_cast<std::uint16_t>(m_session_id.size()));
+    hello.append(m_component_name);
+    hello.append(m_session_id);
+
+    if (status::failed(send_buffer(hello)))
+    {
+        disconnect_from_collector();
+
+        return status::collector_connection_failed;
+    }
+
+    m_reconnection_backoff = c_min_reconnection_backoff;
+
+    return status::success;
+}
+
+auto
+socket_log_shipper::disconnect_from_collector() -> void
+{
+    if (m_socket_descriptor != -1)
+    {
+        close(m_socket_descriptor);
+        m_socket_descriptor = -1;
+    }
+}
+
+auto
+socket_log_shipper::send_buffer(
+    const std::string_view p_buffer) -> status_code
+{
+    std::size_t sent_size_bytes = 0u;
+
+    while (sent_size_bytes < p_buffer.size())
+    {
+        //
+        // A collector going away must not raise SIGPIPE in the logging process.
+        //
+        const ssize_t result = send(
+            m_socket_descriptor,
+            p_buffer.data() + sent_size_bytes,
+            p_buffer.size() - sent_size_bytes,
+            MSG_NOSIGNAL);
+
+        if (result == -1)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+
+            return status::collector_connection_failed;
+        }
+
+        sent_size_bytes += static_cast<std::size_t>(result);
+    }
+
+    return status::success;
+}
+
+} // namespace echo.
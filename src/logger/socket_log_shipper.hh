@@ -0,0 +1,246 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'socket_log_shipper.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <span>
+#include <mutex>
+#include <deque>
+#include <chrono>
+#include <string>
+#include <thread>
+#include <cstdint>
+#include <filesystem>
+#include <string_view>
+#include <condition_variable>
+#include "log_level.hh"
+#include "filesystem_writer.hh"
+#include "../status/status.hh"
+
+namespace echo
+{
+
+//
+// Sink streaming log records over a Unix domain socket to a local socket log collector.
+// Records are appended to an in-memory batch that a sender thread seals every flush period,
+// or as soon as it grows past the batch threshold, and writes as a single length-framed frame,
+// optionally LZ4-compressed. Batches not yet sent are kept while the collector is unreachable,
+// up to the buffer bound, and the connection is retried with exponential backoff; records
+// beyond the bound are dropped and counted.
+// Thread-safe class.
+//
+class socket_log_shipper
+{
+
+public:
+
+    //
+    // Constructor. The connection is established by the sender thread.
+    //
+    socket_log_shipper(
+        const std::filesystem::path& p_socket_path,
+        const std::string& p_component_name,
+        const std::string& p_session_id,
+        const std::uint32_t p_buffer_size_mib,
+        const bool p_compression_enabled,
+        const std::uint32_t p_flush_frequency_ms);
+
+    //
+    // Destructor. Stops the sender thread and makes a last attempt at sending the buffered records.
+    //
+    ~socket_log_shipper();
+
+    socket_log_shipper(const socket_log_shipper&) = delete;
+
+    socket_log_shipper&
+    operator=(const socket_log_shipper&) = delete;
+
+    //
+    // Appends a record to the current batch.
+    //
+    auto
+    ship(
+        const std::uint64_t p_timestamp_ns,
+        const log_level p_log_level,
+        const char* p_title,
+        const std::string_view p_log_message) -> status_code;
+
+    //
+    // Appends the records of a batch of contiguous log messages to the current batch as a
+    // unit, so that the collector writes them contiguously. Dropped as a whole if they do not fit.
+    //
+    auto
+    ship(
+        const std::span<const log_record_extent> p_log_record_extents,
+        const std::string_view p_log_messages) -> status_code;
+
+    //
+    // Seals the current batch and sends every buffered batch on the calling thread.
+    //
+    auto
+    flush() -> status_code;
+
+    //
+    // Gets the path to the socket of the collector.
+    //
+    auto
+    get_socket_path() const -> const std::filesystem::path&;
+
+    //
+    // Gets the count of records dropped because the buffer was full.
+    //
+    auto
+    get_dropped_records_count() const -> std::uint64_t;
+
+private:
+
+    //
+    // Sender loop run by the sender thread.
+    //
+    auto
+    sender_loop() -> void;
+
+    //
+    // Seals the current batch into a frame and sends every sealed frame, in order,
+    // stopping at the first failure. Caller must hold the send lock.
+    //
+    auto
+    send_batches() -> status_code;
+
+    //
+    // Seals the current batch into a frame queued for sending. Caller must hold the send lock.
+    //
+    auto
+    seal_batch() -> void;
+
+    //
+    // Connects to the collector and sends the hello frame, unless connected already or
+    // the next connection attempt is not due yet. Caller must hold the send lock.
+    //
+    auto
+    connect_to_collector() -> status_code;
+
+    //
+    // Closes the connection to the collector. Caller must hold the send lock.
+    //
+    auto
+    disconnect_from_collector() -> void;
+
+    //
+    // Writes a whole buffer to the connection. Caller must hold the send lock.
+    //
+    auto
+    send_buffer(
+        const std::string_view p_buffer) -> status_code;
+
+    //
+    // Size in bytes of the current batch that wakes up the sender thread.
+    //
+    static constexpr std::size_t c_batch_threshold_size_bytes = 64u * 1024u;
+
+    //
+    // Bounds of the backoff between connection attempts.
+    //
+    static constexpr std::chrono::milliseconds c_min_reconnection_backoff {100};
+
+    static constexpr std::chrono::milliseconds c_max_reconnection_backoff {5'000};
+
+    //
+    // Timeout in seconds of a send to the collector.
+    //
+    static constexpr time_t c_send_timeout_s = 1;
+
+    //
+    // Path to the socket of the collector.
+    //
+    const std::filesystem::path m_socket_path;
+
+    //
+    // Component name and session identifier announced to the collector.
+    //
+    const std::string m_component_name;
+
+    const std::string m_session_id;
+
+    //
+    // Max size in bytes of the buffered records.
+    //
+    const std::uint64_t m_max_buffered_size_bytes;
+
+    //
+    // Flag for determining if batches are LZ4-compressed. Only set if the library supports it.
+    //
+    const bool m_compression_enabled;
+
+    //
+    // Frequency in milliseconds of the sender thread passes.
+    //
+    const std::uint32_t m_flush_frequency_ms;
+
+    //
+    // Payload and records count of the current batch.
+    //
+    std::string m_batch_payload;
+
+    std::uint32_t m_batch_records_count;
+
+    //
+    // Sealed frames waiting to be sent, in order.
+    //
+    std::deque<std::string> m_sealed_frames;
+
+    //
+    // Size in bytes of the current batch and the sealed frames.
+    //
+    std::uint64_t m_buffered_size_bytes;
+
+    //
+    // Count of records dropped because the buffer was full.
+    //
+    std::uint64_t m_dropped_records_count;
+
+    //
+    // Lock for the current batch, the sealed frames and their accounting.
+    //
+    mutable std::mutex m_buffer_lock;
+
+    //
+    // Condition variable for waking up the sender thread.
+    //
+    std::condition_variable m_sender_condition;
+
+    //
+    // Flag for signaling the sender thread to exit.
+    //
+    bool m_stop_requested;
+
+    //
+    // Lock for serializing the connection and the sends.
+    //
+    std::mutex m_send_lock;
+
+    //
+    // Socket connected to the collector. -1 when not connected.
+    //
+    int m_socket_descriptor;
+
+    //
+    // Backoff before the next connection attempt and the time at which it is due.
+    //
+    std::chrono::milliseconds m_reconnection_backoff;
+
+    std::chrono::steady_clock::time_point m_next_connection_attempt_time;
+
+    //
+    // Sender thread.
+    //
+    std::thread m_sender_thread;
+
+};
+
+} // namespace echo.
@@ -0,0 +1,91 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'title_router.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <algorithm>
+#include <stdexcept>
+#include <string_view>
+#include "title_router.hh"
+
+namespace echo
+{
+
+title_router::title_router(
+    const std::vector<title_route>& p_title_routes)
+    : m_slots{std::make_unique<std::atomic<std::uint64_t>[]>(c_slots_count)}
+{
+    for (const title_route& route : p_title_routes)
+    {
+        const bool valid_stream_name = !route.stream_name.empty() &&
+            std::all_of(route.stream_name.begin(), route.stream_name.end(), [](const char p_character)
+            {
+                return (p_character >= 'a' && p_character <= 'z') ||
+                    (p_character >= 'A' && p_character <= 'Z') ||
+                    (p_character >= '0' && p_character <= '9') ||
+                    p_character == '-' ||
+                    p_character == '_';
+            });
+
+        if (!valid_stream_name)
+        {
+            throw std::invalid_argument("The title route stream name '" + route.stream_name + "' is invalid.");
+        }
+
+        auto stream_name = std::find(m_stream_names.begin(), m_stream_names.end(), route.stream_name);
+
+        if (stream_name == m_stream_names.end())
+        {
+            if (m_stream_names.size() + 1u >= (std::uint64_t{1u} << (64u - c_stream_index_shift)))
+            {
+                throw std::invalid_argument("There are too many title route streams.");
+            }
+
+            stream_name = m_stream_names.insert(m_stream_names.end(), route.stream_name);
+        }
+
+        m_routes.push_back(compiled_route{
+            route.title_prefix,
+            static_cast<std::uint32_t>(stream_name - m_stream_names.begin()) + 1u});
+    }
+}
+
+auto
+title_router::get_stream_names() const -> const std::vector<std::string>&
+{
+    return m_stream_names;
+}
+
+auto
+title_router::match(
+    const char* p_title) const -> std::uint32_t
+{
+    if (p_title == nullptr)
+    {
+        return c_main_stream_index;
+    }
+
+    const std::string_view title {p_title};
+    std::uint32_t stream_index = c_main_stream_index;
+    std::size_t matched_prefix_size = 0u;
+
+    for (const compiled_route& route : m_routes)
+    {
+        //
+        // On equal prefixes the route declared first wins.
+        //
+        if (title.starts_with(route.m_title_prefix) &&
+            (stream_index == c_main_stream_index || route.m_title_prefix.size() > matched_prefix_size))
+        {
+            stream_index = route.m_stream_index;
+            matched_prefix_size = route.m_title_prefix.size();
+        }
+    }
+
+    return stream_index;
+}
+
+} // namespace echo.
@@ -0,0 +1,142 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'title_router.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include "logger_configuration.hh"
+
+namespace echo
+{
+
+//
+// Router of record titles to the segment streams of the title routes. Titles are matched
+// against the route prefixes once per title pointer; the result is cached in a fixed-size,
+// direct-mapped table keyed by a hash of the pointer, so routing a record costs a single
+// relaxed load unless its title is new or was evicted by another one. Each table entry packs
+// the title address and its stream index in one word, so it is never read torn.
+// Thread-safe class.
+//
+class title_router
+{
+
+public:
+
+    //
+    // Constructor. Throws if a stream name is invalid or there are too many streams.
+    //
+    explicit title_router(
+        const std::vector<title_route>& p_title_routes);
+
+    title_router(const title_router&) = delete;
+
+    title_router&
+    operator=(const title_router&) = delete;
+
+    //
+    // Gets the index of the stream of a title: the main stream index, or one past
+    // the position of its stream in the stream names.
+    //
+    inline
+    auto
+    route(
+        const char* p_title) const -> std::uint32_t
+    {
+        const std::uint64_t title_address = reinterpret_cast<std::uintptr_t>(p_title);
+        std::atomic<std::uint64_t>& slot = m_slots[((title_address * c_hash_multiplier) >> c_hash_shift) % c_slots_count];
+        const std::uint64_t entry = slot.load(std::memory_order_relaxed);
+
+        if ((entry & c_title_address_mask) == title_address)
+        {
+            return static_cast<std::uint32_t>(entry >> c_stream_index_shift);
+        }
+
+        const std::uint32_t stream_index = match(p_title);
+
+        if ((title_address & ~c_title_address_mask) == 0u)
+        {
+            slot.store((static_cast<std::uint64_t>(stream_index) << c_stream_index_shift) | title_address, std::memory_order_relaxed);
+        }
+
+        return stream_index;
+    }
+
+    //
+    // Gets the names of the routed streams, without duplicates, in order of first appearance.
+    //
+    auto
+    get_stream_names() const -> const std::vector<std::string>&;
+
+    //
+    // Index of the main stream of the session.
+    //
+    static constexpr std::uint32_t c_main_stream_index = 0u;
+
+private:
+
+    //
+    // Route matched by prefix.
+    //
+    struct compiled_route
+    {
+
+        std::string m_title_prefix;
+
+        std::uint32_t m_stream_index;
+
+    };
+
+    //
+    // Matches a title against the route prefixes; the longest matching prefix wins.
+    //
+    auto
+    match(
+        const char* p_title) const -> std::uint32_t;
+
+    //
+    // Count of slots of the cache table. Must be a power of two.
+    //
+    static constexpr std::uint64_t c_slots_count = 1024u;
+
+    //
+    // Multiplicative hash of the title addresses; the high bits index the table.
+    //
+    static constexpr std::uint64_t c_hash_multiplier = 0x9E3779B97F4A7C15u;
+
+    static constexpr std::uint32_t c_hash_shift = 54u;
+
+    //
+    // Layout of a table entry: the title address in the low 48 bits, as used by user space
+    // addresses, and the stream index in the high 16 bits. Titles beyond are never cached.
+    //
+    static constexpr std::uint32_t c_stream_index_shift = 48u;
+
+    static constexpr std::uint64_t c_title_address_mask = (std::uint64_t{1u} << c_stream_index_shift) - 1u;
+
+    //
+    // Routes by declaration order.
+    //
+    std::vector<compiled_route> m_routes;
+
+    //
+    // Names of the routed streams.
+    //
+    std::vector<std::string> m_stream_names;
+
+    //
+    // Slots of the cache table. An empty slot caches the null title in the main stream.
+    //
+    const std::unique_ptr<std::atomic<std::uint64_t>[]> m_slots;
+
+};
+
+} // namespace echo.
@@ -0,0 +1,320 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'trace_exporter.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <chrono>
+#include <charconv>
+#include <format>
+#include <fstream>
+#include <iterator>
+#include "trace_exporter.hh"
+#include "../utils/time_utilities.hh"
+
+namespace echo
+{
+
+trace_exporter::trace_exporter(
+    const std::string& p_session_id,
+    const std::filesystem::path& p_logging_session_directory_path,
+    const pid_t p_process_id)
+    : m_session_id{p_session_id},
+      m_logging_session_directory_path{p_logging_session_directory_path},
+      m_process_id{p_process_id},
+      m_calibration_tick{read_timestamp_counter()},
+      m_calibration_timestamp_ns{get_current_timestamp_ns()},
+      m_nanoseconds_per_tick{1.0},
+      m_trace_files_count{0u},
+      m_pointed_trace_file_size_bytes{0u},
+      m_stop_requested{false}
+{
+    //
+    // Can throw if the directory creation was not possible.
+    // Shared memory and shipping modes do not create it otherwise.
+    //
+    std::filesystem::create_directories(m_logging_session_directory_path);
+
+    //
+    // A continued session that only starts tracing now already has logs, and maybe trace files.
+    //
+    while (std::filesystem::exists(get_pointed_trace_file_path()))
+    {
+        ++m_trace_files_count;
+    }
+
+    //
+    // Rough first estimate of the counter frequency; every collection refines it.
+    //
+    const std::chrono::steady_clock::time_point calibration_start = std::chrono::steady_clock::now();
+    const std::uint64_t calibration_start_tick = read_timestamp_counter();
+
+    while (std::chrono::steady_clock::now() - calibration_start < std::chrono::milliseconds(1))
+    {}
+
+    const std::uint64_t elapsed_ticks = read_timestamp_counter() - calibration_start_tick;
+    const std::chrono::nanoseconds elapsed_time = std::chrono::steady_clock::now() - calibration_start;
+
+    if (elapsed_ticks != 0u)
+    {
+        m_nanoseconds_per_tick = static_cast<double>(elapsed_time.count()) / static_cast<double>(elapsed_ticks);
+    }
+
+    trace_recorder::start_tracing();
+
+    m_exporter_thread = std::thread(&trace_exporter::exporter_loop, this);
+}
+
+trace_exporter::~trace_exporter()
+{
+    {
+        std::scoped_lock<std::mutex> lock {m_stop_lock};
+        m_stop_requested = true;
+    }
+
+    m_stop_condition.notify_one();
+    m_exporter_thread.join();
+
+    trace_recorder::stop_tracing();
+
+    flush();
+}
+
+auto
+trace_exporter::flush() -> status_code
+{
+    std::scoped_lock<std::mutex> lock {m_export_lock};
+
+    return export_trace_events();
+}
+
+auto
+trace_exporter::exporter_loop() -> void
+{
+    std::unique_lock<std::mutex> lock {m_stop_lock};
+
+    while (!m_stop_requested)
+    {
+        lock.unlock();
+
+        flush();
+
+        lock.lock();
+
+        m_stop_condition.wait_for(
+            lock,
+            std::chrono::milliseconds(c_collection_interval_ms),
+            [this]()
+            {
+                return m_stop_requested;
+            });
+    }
+}
+
+auto
+trace_exporter::export_trace_events() -> status_code
+{
+    m_thread_trace_events.clear();
+
+    trace_recorder::collect(m_thread_trace_events);
+
+    if (m_thread_trace_events.empty())
+    {
+        return status::success;
+    }
+
+    //
+    // The longer the counter runs against the wall clock, the closer the estimate of its frequency.
+    //
+    const std::uint64_t elapsed_ticks = read_timestamp_counter() - m_calibration_tick;
+    const std::uint64_t current_timestamp_ns = get_current_timestamp_ns();
+
+    if (current_timestamp_ns - m_calibration_timestamp_ns >= 1'000'000'000u &&
+        elapsed_ticks != 0u)
+    {
+        m_nanoseconds_per_tick =
+            static_cast<double>(current_timestamp_ns - m_calibration_timestamp_ns) / static_cast<double>(elapsed_ticks);
+    }
+
+    std::string output;
+
+    for (const thread_trace_events& events : m_thread_trace_events)
+    {
+        const std::string thread_id_text = std::format(",\"tid\":{}", events.m_thread_id);
+
+        output.reserve(output.size() + events.m_trace_events.size() * c_estimated_trace_event_size_bytes);
+
+        for (const trace_event& event : events.m_trace_events)
+        {
+            append_trace_event(output, thread_id_text, event);
+        }
+
+        if (events.m_dropped_events_count != 0u)
+        {
+            //
+            // Surface the loss on the timeline of the thread instead of hiding it.
+            //
+            output += "{\"name\":\"echo dropped spans\",\"ph\":\"i\",\"s\":\"t\",\"ts\":";
+            append_microseconds(output, current_timestamp_ns);
+            std::format_to(
+                std::back_inserter(output),
+                ",\"pid\":{},\"tid\":{},\"args\":{{\"count\":{}}}}},\n",
+                m_process_id,
+                events.m_thread_id,
+                events.m_dropped_events_count);
+        }
+    }
+
+    if (m_pointed_trace_file_size_bytes >= c_max_trace_file_size_bytes)
+    {
+        ++m_trace_files_count;
+        m_pointed_trace_file_size_bytes = 0u;
+    }
+
+    std::ofstream file;
+    file.open(get_pointed_trace_file_path(), std::ios_base::app | std::ios_base::binary);
+
+    if (!file)
+    {
+        return status::file_write_failed;
+    }
+
+    if (m_pointed_trace_file_size_bytes == 0u)
+    {
+        //
+        // Every event ends with a comma, which the format tolerates before the end of the array.
+        //
+        file.write("[\n", 2);
+        m_pointed_trace_file_size_bytes = 2u;
+    }
+
+    file.write(output.data(), static_cast<std::streamsize>(output.size()));
+    file.flush();
+
+    if (!file)
+    {
+        return status::file_write_failed;
+    }
+
+    m_pointed_trace_file_size_bytes += output.size();
+
+    return status::success;
+}
+
+auto
+trace_exporter::append_trace_event(
+    std::string& p_output,
+    const std::string_view p_thread_id_text,
+    const trace_event& p_trace_event) -> void
+{
+    const std::uint64_t begin_timestamp_ns = convert_tick_to_timestamp_ns(p_trace_event.m_begin_tick);
+    const std::uint64_t end_timestamp_ns = convert_tick_to_timestamp_ns(p_trace_event.m_end_tick);
+
+    p_output.push_back('{');
+    p_output += get_rendered_call_site(p_trace_event);
+    p_output += ",\"ts\":";
+    append_microseconds(p_output, begin_timestamp_ns);
+    p_output += ",\"dur\":";
+    append_microseconds(p_output, end_timestamp_ns > begin_timestamp_ns ? end_timestamp_ns - begin_timestamp_ns : 0u);
+    p_output += p_thread_id_text;
+    p_output += "},\n";
+}
+
+auto
+trace_exporter::get_rendered_call_site(
+    const trace_event& p_trace_event) -> const std::string&
+{
+    const call_site_key key {
+        p_trace_event.m_title,
+        p_trace_event.m_source_location.function_name(),
+        p_trace_event.m_source_location.line()};
+
+    std::string& rendered_call_site = m_rendered_call_sites[key];
+
+    if (rendered_call_site.empty())
+    {
+        rendered_call_site += "\"name\":";
+        append_json_string(rendered_call_site, p_trace_event.m_title);
+        rendered_call_site += std::format(",\"cat\":\"echo\",\"ph\":\"X\",\"pid\":{},\"args\":{{\"file\":", m_process_id);
+        append_json_string(rendered_call_site, p_trace_event.m_source_location.file_name());
+        rendered_call_site += ",\"function\":";
+        append_json_string(rendered_call_site, p_trace_event.m_source_location.function_name());
+        rendered_call_site += std::format(",\"line\":{}}}", p_trace_event.m_source_location.line());
+    }
+
+    return rendered_call_site;
+}
+
+auto
+trace_exporter::convert_tick_to_timestamp_ns(
+    const std::uint64_t p_tick) const -> std::uint64_t
+{
+    //
+    // Counters of different cores can be slightly behind the calibration sample.
+    //
+    const double elapsed_ns =
+        static_cast<double>(static_cast<std::int64_t>(p_tick - m_calibration_tick)) * m_nanoseconds_per_tick;
+
+    return m_calibration_timestamp_ns + static_cast<std::uint64_t>(static_cast<std::int64_t>(elapsed_ns));
+}
+
+auto
+trace_exporter::append_json_string(
+    std::string& p_output,
+    const std::string_view p_string) -> void
+{
+    p_output.push_back('"');
+
+    for (const char character : p_string)
+    {
+        if (character == '"' ||
+            character == '\\')
+        {
+            p_output.push_back('\\');
+            p_output.push_back(character);
+        }
+        else if (static_cast<unsigned char>(character) < 0x20u)
+        {
+            std::format_to(std::back_inserter(p_output), "\\u{:04x}", static_cast<unsigned int>(character));
+        }
+        else
+        {
+            p_output.push_back(character);
+        }
+    }
+
+    p_output.push_back('"');
+}
+
+auto
+trace_exporter::append_microseconds(
+    std::string& p_output,
+    const std::uint64_t p_nanoseconds) -> void
+{
+    char digits[c_max_microseconds_size_bytes];
+    char* digits_end = std::to_chars(digits, digits + sizeof(digits), p_nanoseconds / 1'000u).ptr;
+    const std::uint32_t fraction = static_cast<std::uint32_t>(p_nanoseconds % 1'000u);
+
+    *digits_end++ = '.';
+    *digits_end++ = static_cast<char>('0' + fraction / 100u);
+    *digits_end++ = static_cast<char>('0' + fraction / 10u % 10u);
+    *digits_end++ = static_cast<char>('0' + fraction % 10u);
+
+    p_output.append(digits, digits_end);
+}
+
+auto
+trace_exporter::get_pointed_trace_file_path() const -> std::filesystem::path
+{
+    const std::string pointed_trace_file_name = std::format(
+        "trace_{}_{}.{}",
+        m_session_id,
+        m_trace_files_count,
+        c_trace_files_extension);
+
+    return m_logging_session_directory_path / pointed_trace_file_name;
+}
+
+} // namespace echo.
@@ -0,0 +1,254 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'trace_exporter.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <functional>
+#include <unordered_map>
+#include <unistd.h>
+#include <filesystem>
+#include <string_view>
+#include <condition_variable>
+#include "trace_recorder.hh"
+#include "../status/status.hh"
+
+namespace echo
+{
+
+//
+// Exporter writing the spans of the trace recorder to the logging session directory as
+// Chrome trace event JSON files, 'trace_<session>_<count>.json', which open in Perfetto or
+// chrome://tracing. Files rotate at the size of the logs files and are kept loadable at all
+// times: the closing bracket of the event array is optional in the format. Span timestamps
+// are calibrated against the wall clock, so they line up with the records of the session.
+// Records spans for as long as it is alive.
+// Thread-safe class.
+//
+class trace_exporter
+{
+
+public:
+
+    //
+    // Constructor. Starts recording spans and the exporter thread.
+    //
+    trace_exporter(
+        const std::string& p_session_id,
+        const std::filesystem::path& p_logging_session_directory_path,
+        const pid_t p_process_id);
+
+    //
+    // Destructor. Stops recording spans and exports the remaining ones.
+    //
+    ~trace_exporter();
+
+    trace_exporter(const trace_exporter&) = delete;
+
+    trace_exporter&
+    operator=(const trace_exporter&) = delete;
+
+    //
+    // Exports the spans recorded so far.
+    //
+    auto
+    flush() -> status_code;
+
+private:
+
+    //
+    // Call site of a span: its title and source location.
+    //
+    struct call_site_key
+    {
+
+        const char* m_title;
+
+        const char* m_function_name;
+
+        std::uint32_t m_line;
+
+        auto
+        operator==(const call_site_key&) const -> bool = default;
+
+    };
+
+    struct call_site_key_hash
+    {
+
+        auto
+        operator()(
+            const call_site_key& p_call_site_key) const -> std::size_t
+        {
+            return std::hash<const void*>{}(p_call_site_key.m_title) ^
+                (std::hash<const void*>{}(p_call_site_key.m_function_name) << 1u) ^
+                (static_cast<std::size_t>(p_call_site_key.m_line) << 32u);
+        }
+
+    };
+
+    //
+    // Exporter loop run by the exporter thread.
+    //
+    auto
+    exporter_loop() -> void;
+
+    //
+    // Collects the recorded spans and appends them to the trace file. Caller must hold the export lock.
+    //
+    auto
+    export_trace_events() -> status_code;
+
+    //
+    // Renders a span as a complete event.
+    //
+    auto
+    append_trace_event(
+        std::string& p_output,
+        const std::string_view p_thread_id_text,
+        const trace_event& p_trace_event) -> void;
+
+    //
+    // Gets the rendering of the fields of an event that only depend on its call site,
+    // rendering them on the first span of the call site.
+    //
+    auto
+    get_rendered_call_site(
+        const trace_event& p_trace_event) -> const std::string&;
+
+    //
+    // Converts a timestamp counter reading to a wall-clock timestamp in nanoseconds.
+    //
+    auto
+    convert_tick_to_timestamp_ns(
+        const std::uint64_t p_tick) const -> std::uint64_t;
+
+    //
+    // Appends a JSON string literal.
+    //
+    static
+    auto
+    append_json_string(
+        std::string& p_output,
+        const std::string_view p_string) -> void;
+
+    //
+    // Appends a nanoseconds quantity as fractional microseconds, the time unit of the format.
+    //
+    static
+    auto
+    append_microseconds(
+        std::string& p_output,
+        const std::uint64_t p_nanoseconds) -> void;
+
+    //
+    // Gets the path of the pointed trace file.
+    //
+    auto
+    get_pointed_trace_file_path() const -> std::filesystem::path;
+
+    //
+    // Interval in milliseconds between collections. Short enough for the per-thread
+    // buffers to absorb millions of spans per second without dropping.
+    //
+    static constexpr std::uint32_t c_collection_interval_ms = 10u;
+
+    //
+    // Size in bytes reserved per span when rendering; spans rarely take more.
+    //
+    static constexpr std::size_t c_estimated_trace_event_size_bytes = 256u;
+
+    //
+    // Max size in bytes of the rendering of a nanoseconds quantity as fractional microseconds.
+    //
+    static constexpr std::size_t c_max_microseconds_size_bytes = 24u;
+
+    //
+    // Size in bytes at which the trace file is rotated; the same as the logs files.
+    //
+    static constexpr std::uint64_t c_max_trace_file_size_bytes = 10u * 1024u * 1024u;
+
+    //
+    // Extension of the trace files.
+    //
+    static constexpr const char* c_trace_files_extension = "json";
+
+    //
+    // Logging session identifier.
+    //
+    const std::string m_session_id;
+
+    //
+    // Path to the directory where the trace files are stored.
+    //
+    const std::filesystem::path m_logging_session_directory_path;
+
+    //
+    // Process ID reported by the events.
+    //
+    const pid_t m_process_id;
+
+    //
+    // Timestamp counter and wall clock sampled together when the exporter started.
+    //
+    const std::uint64_t m_calibration_tick;
+
+    const std::uint64_t m_calibration_timestamp_ns;
+
+    //
+    // Nanoseconds per timestamp counter tick, refined on every collection.
+    //
+    double m_nanoseconds_per_tick;
+
+    //
+    // Count of the pointed trace file and its size in bytes.
+    //
+    std::uint32_t m_trace_files_count;
+
+    std::uint64_t m_pointed_trace_file_size_bytes;
+
+    //
+    // Rendered fields of every call site seen so far. Source locations and titles are
+    // expected to be valid for the lifetime of the program, so their addresses are stable.
+    //
+    std::unordered_map<call_site_key, std::string, call_site_key_hash> m_rendered_call_sites;
+
+    //
+    // Spans collected on the current pass.
+    //
+    std::vector<thread_trace_events> m_thread_trace_events;
+
+    //
+    // Lock for serializing exports.
+    //
+    std::mutex m_export_lock;
+
+    //
+    // Lock and condition variable for waking up the exporter thread on stop.
+    //
+    std::mutex m_stop_lock;
+
+    std::condition_variable m_stop_condition;
+
+    //
+    // Flag for signaling the exporter thread to exit.
+    //
+    bool m_stop_requested;
+
+    //
+    // Exporter thread.
+    //
+    std::thread m_exporter_thread;
+
+};
+
+} // namespace echo.
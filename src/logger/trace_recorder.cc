@@ -0,0 +1,168 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'trace_recorder.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <sys/syscall.h>
+#include "trace_recorder.hh"
+
+namespace echo
+{
+
+trace_buffer::trace_buffer(
+    const pid_t p_thread_id)
+    : m_thread_id{p_thread_id},
+      m_events{std::make_unique<trace_event[]>(c_capacity_events_count)},
+      m_write_position{0u},
+      m_read_position{0u},
+      m_cached_read_position{0u},
+      m_dropped_events_count{0u},
+      m_thread_exited{false}
+{}
+
+auto
+trace_buffer::collect(
+    std::vector<trace_event>& p_trace_events) -> void
+{
+    const std::uint64_t read_position = m_read_position.load(std::memory_order_relaxed);
+    const std::uint64_t write_position = m_write_position.load(std::memory_order_acquire);
+
+    for (std::uint64_t position = read_position; position != write_position; ++position)
+    {
+        p_trace_events.push_back(m_events[position & (c_capacity_events_count - 1u)]);
+    }
+
+    m_read_position.store(write_position, std::memory_order_release);
+}
+
+auto
+trace_buffer::get_thread_id() const -> pid_t
+{
+    return m_thread_id;
+}
+
+auto
+trace_buffer::take_dropped_events_count() -> std::uint64_t
+{
+    return m_dropped_events_count.exchange(0u, std::memory_order_relaxed);
+}
+
+auto
+trace_buffer::mark_thread_exited() -> void
+{
+    m_thread_exited.store(true, std::memory_order_release);
+}
+
+auto
+trace_buffer::is_drained() const -> bool
+{
+    return m_thread_exited.load(std::memory_order_acquire) &&
+        m_read_position.load(std::memory_order_relaxed) == m_write_position.load(std::memory_order_acquire);
+}
+
+auto
+trace_recorder::start_tracing() -> void
+{
+    get_tracing_users_count().fetch_add(1u, std::memory_order_relaxed);
+}
+
+auto
+trace_recorder::stop_tracing() -> void
+{
+    get_tracing_users_count().fetch_sub(1u, std::memory_order_relaxed);
+}
+
+auto
+trace_recorder::collect(
+    std::vector<thread_trace_events>& p_thread_trace_events) -> void
+{
+    std::scoped_lock<std::mutex> lock {get_thread_buffers_lock()};
+
+    std::vector<std::shared_ptr<trace_buffer>>& thread_buffers = get_registered_thread_buffers();
+
+    //
+    // The buffer of an exited thread is dropped on the pass after its last spans were collected.
+    //
+    std::erase_if(thread_buffers, [](const std::shared_ptr<trace_buffer>& p_trace_buffer)
+    {
+        return p_trace_buffer->is_drained();
+    });
+
+    for (const std::shared_ptr<trace_buffer>& thread_buffer : thread_buffers)
+    {
+        thread_trace_events events {thread_buffer->get_thread_id(), thread_buffer->take_dropped_events_count(), {}};
+
+        thread_buffer->collect(events.m_trace_events);
+
+        if (!events.m_trace_events.empty() ||
+            events.m_dropped_events_count != 0u)
+        {
+            p_thread_trace_events.push_back(std::move(events));
+        }
+    }
+}
+
+auto
+trace_recorder::prepare_fork() -> void
+{
+    get_thread_buffers_lock().lock();
+}
+
+auto
+trace_recorder::complete_fork_in_parent() -> void
+{
+    get_thread_buffers_lock().unlock();
+}
+
+auto
+trace_recorder::complete_fork_in_child() -> void
+{
+    get_registered_thread_buffers().clear();
+    get_tracing_users_count().store(0u, std::memory_order_relaxed);
+    get_thread_buffer() = nullptr;
+
+    get_thread_buffers_lock().unlock();
+}
+
+trace_recorder::thread_buffer_owner::~thread_buffer_owner()
+{
+    if (m_trace_buffer != nullptr)
+    {
+        m_trace_buffer->mark_thread_exited();
+    }
+}
+
+auto
+trace_recorder::register_thread_buffer() -> trace_buffer&
+{
+    thread_local thread_buffer_owner owner;
+
+    owner.m_trace_buffer = std::make_shared<trace_buffer>(static_cast<pid_t>(syscall(SYS_gettid)));
+
+    std::scoped_lock<std::mutex> lock {get_thread_buffers_lock()};
+
+    get_registered_thread_buffers().push_back(owner.m_trace_buffer);
+
+    return *owner.m_trace_buffer;
+}
+
+auto
+trace_recorder::get_thread_buffers_lock() -> std::mutex&
+{
+    static std::mutex thread_buffers_lock;
+
+    return thread_buffers_lock;
+}
+
+auto
+trace_recorder::get_registered_thread_buffers() -> std::vector<std::shared_ptr<trace_buffer>>&
+{
+    static std::vector<std::shared_ptr<trace_buffer>> registered_thread_buffers;
+
+    return registered_thread_buffers;
+}
+
+} // namespace echo.
@@ -0,0 +1,317 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'trace_recorder.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <vector>
+#include <cstdint>
+#include <unistd.h>
+#include <source_location>
+
+namespace echo
+{
+
+//
+// Span recorded by a thread, in timestamp counter ticks.
+//
+struct trace_event
+{
+
+    std::uint64_t m_begin_tick;
+
+    std::uint64_t m_end_tick;
+
+    const char* m_title;
+
+    std::source_location m_source_location;
+
+};
+
+//
+// Bounded single-producer single-consumer buffer of the spans of a thread.
+// The owner thread records and the trace exporter collects; spans recorded
+// while the buffer is full are dropped and counted.
+//
+class trace_buffer
+{
+
+public:
+
+    //
+    // Constructor.
+    //
+    explicit trace_buffer(
+        const pid_t p_thread_id);
+
+    trace_buffer(const trace_buffer&) = delete;
+
+    trace_buffer&
+    operator=(const trace_buffer&) = delete;
+
+    //
+    // Records a span. Only called by the owner thread.
+    //
+    inline
+    auto
+    record(
+        const trace_event& p_trace_event) -> void
+    {
+        const std::uint64_t write_position = m_write_position.load(std::memory_order_relaxed);
+
+        if (write_position - m_cached_read_position == c_capacity_events_count)
+        {
+            //
+            // Only look at the consumer's cache line when the buffer looks full.
+            //
+            m_cached_read_position = m_read_position.load(std::memory_order_acquire);
+
+            if (write_position - m_cached_read_position == c_capacity_events_count)
+            {
+                m_dropped_events_count.fetch_add(1u, std::memory_order_relaxed);
+
+                return;
+            }
+        }
+
+        m_events[write_position & (c_capacity_events_count - 1u)] = p_trace_event;
+        m_write_position.store(write_position + 1u, std::memory_order_release);
+    }
+
+    //
+    // Appends the spans recorded since the previous collection to the output vector.
+    // Only called by a single consumer at a time.
+    //
+    auto
+    collect(
+        std::vector<trace_event>& p_trace_events) -> void;
+
+    //
+    // Gets the kernel identifier of the owner thread.
+    //
+    auto
+    get_thread_id() const -> pid_t;
+
+    //
+    // Gets and resets the count of spans dropped because the buffer was full.
+    //
+    auto
+    take_dropped_events_count() -> std::uint64_t;
+
+    //
+    // Flags the owner thread as exited.
+    //
+    auto
+    mark_thread_exited() -> void;
+
+    //
+    // Determines whether the owner thread exited and every span was collected.
+    //
+    auto
+    is_drained() const -> bool;
+
+private:
+
+    //
+    // Count of spans held by the buffer. Must be a power of two.
+    //
+    static constexpr std::uint64_t c_capacity_events_count = 16u * 1024u;
+
+    //
+    // Kernel identifier of the owner thread.
+    //
+    const pid_t m_thread_id;
+
+    //
+    // Ring of spans.
+    //
+    const std::unique_ptr<trace_event[]> m_events;
+
+    //
+    // Positions of the next span to be recorded and collected.
+    //
+    alignas(64) std::atomic<std::uint64_t> m_write_position;
+
+    alignas(64) std::atomic<std::uint64_t> m_read_position;
+
+    //
+    // Position of the next span to be collected as last seen by the owner thread,
+    // kept off the cache line written by the consumer.
+    //
+    alignas(64) std::uint64_t m_cached_read_position;
+
+    //
+    // Count of spans dropped because the buffer was full.
+    //
+    std::atomic<std::uint64_t> m_dropped_events_count;
+
+    //
+    // Flag for determining whether the owner thread exited.
+    //
+    std::atomic<bool> m_thread_exited;
+
+};
+
+//
+// Spans collected from the buffer of a thread.
+//
+struct thread_trace_events
+{
+
+    pid_t m_thread_id;
+
+    std::uint64_t m_dropped_events_count;
+
+    std::vector<trace_event> m_trace_events;
+
+};
+
+//
+// Process-wide registry of the per-thread span buffers. Spans are only recorded while
+// at least one trace exporter is running; collections are serialized so that the
+// buffers only ever see a single consumer.
+// Thread-safe class.
+//
+class trace_recorder
+{
+
+public:
+
+    //
+    // Determines whether spans are being recorded.
+    //
+    static
+    inline
+    auto
+    is_tracing_enabled() -> bool
+    {
+        return get_tracing_users_count().load(std::memory_order_relaxed) != 0u;
+    }
+
+    //
+    // Starts recording spans on behalf of a trace exporter.
+    //
+    static
+    auto
+    start_tracing() -> void;
+
+    //
+    // Stops recording spans on behalf of a trace exporter.
+    // Recording goes on while any other exporter is running.
+    //
+    static
+    auto
+    stop_tracing() -> void;
+
+    //
+    // Records a span in the buffer of the calling thread.
+    //
+    static
+    inline
+    auto
+    record(
+        const trace_event& p_trace_event) -> void
+    {
+        trace_buffer*& buffer = get_thread_buffer();
+
+        if (buffer == nullptr)
+        {
+            buffer = &register_thread_buffer();
+        }
+
+        buffer->record(p_trace_event);
+    }
+
+    //
+    // Collects the spans recorded since the previous collection, per thread, and drops
+    // the buffers of the threads that exited once drained.
+    //
+    static
+    auto
+    collect(
+        std::vector<thread_trace_events>& p_thread_trace_events) -> void;
+
+    //
+    // Takes the registry lock right before a fork so that the child inherits a consistent registry.
+    //
+    static
+    auto
+    prepare_fork() -> void;
+
+    //
+    // Releases the registry lock in the parent process after a fork.
+    //
+    static
+    auto
+    complete_fork_in_parent() -> void;
+
+    //
+    // Resets the registry in the child process after a fork. The buffers of the parent are
+    // dropped and recording stops until a trace exporter of the child starts it again; the
+    // calling thread registers a new buffer, under its new thread identifier, on its next span.
+    //
+    static
+    auto
+    complete_fork_in_child() -> void;
+
+private:
+
+    //
+    // Per-thread owner of a buffer; flags it when the thread exits so that it can be dropped once drained.
+    //
+    struct thread_buffer_owner
+    {
+
+        ~thread_buffer_owner();
+
+        std::shared_ptr<trace_buffer> m_trace_buffer;
+
+    };
+
+    //
+    // Creates and registers the buffer of the calling thread.
+    //
+    static
+    auto
+    register_thread_buffer() -> trace_buffer&;
+
+    //
+    // Gets the buffer of the calling thread. Null until its first span.
+    //
+    static
+    inline
+    auto
+    get_thread_buffer() -> trace_buffer*&
+    {
+        thread_local trace_buffer* buffer = nullptr;
+
+        return buffer;
+    }
+
+    static
+    auto
+    get_tracing_users_count() -> std::atomic<std::uint32_t>&
+    {
+        static std::atomic<std::uint32_t> tracing_users_count {0u};
+
+        return tracing_users_count;
+    }
+
+    static
+    auto
+    get_thread_buffers_lock() -> std::mutex&;
+
+    static
+    auto
+    get_registered_thread_buffers() -> std::vector<std::shared_ptr<trace_buffer>>&;
+
+};
+
+} // namespace echo.
@@ -0,0 +1,79 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Logger
+// 'trace_span.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include "trace_recorder.hh"
+#include "../utils/time_utilities.hh"
+#include "title_and_source_location.hh"
+
+namespace echo
+{
+
+//
+// Scope timed for the trace of the logging session. Reads the timestamp counter when
+// created and when destroyed and records both, with the title and call site, into the
+// buffer of the calling thread; the trace exporter writes the spans out as Chrome trace
+// events. Costs a single relaxed load while tracing is disabled.
+// Expects that the title is valid for the lifetime of the program.
+//
+class trace_span
+{
+
+public:
+
+    //
+    // Constructor. Starts the span.
+    //
+    explicit trace_span(
+        title_and_source_location p_title_and_source_location)
+        : m_title{p_title_and_source_location.m_title},
+          m_source_location{p_title_and_source_location.m_source_location},
+          m_begin_tick{trace_recorder::is_tracing_enabled() ? read_timestamp_counter() : 0u}
+    {}
+
+    //
+    // Destructor. Ends and records the span.
+    //
+    ~trace_span()
+    {
+        if (m_begin_tick != 0u)
+        {
+            trace_recorder::record(trace_event{
+                m_begin_tick,
+                read_timestamp_counter(),
+                m_title,
+                m_source_location});
+        }
+    }
+
+    trace_span(const trace_span&) = delete;
+
+    trace_span&
+    operator=(const trace_span&) = delete;
+
+private:
+
+    //
+    // Title of the span.
+    //
+    const char* const m_title;
+
+    //
+    // Source location for the call place of the span.
+    //
+    const std::source_location m_source_location;
+
+    //
+    // Timestamp counter at the start of the span. Zero if tracing was disabled at the time.
+    //
+    const std::uint64_t m_begin_tick;
+
+};
+
+} // namespace echo.
@@ -123,5 +123,55 @@ status_code_definition(file_write_failed, 0x8'0000006);
 //
 status_code_definition(logging_incremental_search_failed, 0x8'0000007);
 
+//
+// Failed to append to a shared memory ring because it has no free space left.
+//
+status_code_definition(shared_memory_ring_full, 0x8'0000008);
+
+//
+// Failed to flush a file to stable storage.
+//
+status_code_definition(file_sync_failed, 0x8'0000009);
+
+//
+// Failed to write logs to disk; they are kept in memory until the disk recovers.
+//
+status_code_definition(logs_spilled_to_memory, 0x8'000000A);
+
+//
+// Failed to write logs to disk and the memory spill has no free space left.
+//
+status_code_definition(memory_spill_full, 0x8'000000B);
+
+//
+// Failed to ship a record because the shipping buffer has no free space left.
+//
+status_code_definition(shipping_buffer_full, 0x8'000000C);
+
+//
+// Failed to connect or send to a socket log collector.
+//
+status_code_definition(collector_connection_failed, 0x8'000000D);
+
+//
+// Failed to capture a record logged before initialization because the capture buffer has no free space left.
+//
+status_code_definition(pre_initialization_buffer_full, 0x8'000000E);
+
+//
+// Failed to capture a record logged before initialization because the logger is being initialized.
+//
+status_code_definition(pre_initialization_buffer_sealed, 0x8'000000F);
+
+//
+// Failed to queue an information record in async mode because the info lane has no free space left.
+//
+status_code_definition(info_lane_full, 0x8'0000010);
+
+//
+// Failed to write a call site report because call site profiling is not enabled.
+//
+status_code_definition(call_site_profiling_disabled, 0x8'0000011);
+
 } // namespace status.
 } // namespace echo.
\ No newline at end of file
@@ -0,0 +1,459 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Utils
+// 'hazard_pointer_domain.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <mutex>
+#include <atomic>
+#include <vector>
+#include <algorithm>
+#include <cstdint>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <linux/membarrier.h>
+
+namespace echo
+{
+
+//
+// Determines whether the process can issue asymmetric memory barriers through membarrier.
+// When supported, readers only need a compiler barrier and the reclaimer pays for a
+// process-wide barrier instead. Registration happens once, on the first call.
+// Thread-safe function.
+//
+inline
+auto
+is_asymmetric_fence_supported() -> bool
+{
+    static const bool asymmetric_fence_supported = []()
+    {
+        const long supported_commands = syscall(SYS_membarrier, MEMBARRIER_CMD_QUERY, 0, 0);
+
+        return supported_commands != -1 &&
+            (supported_commands & MEMBARRIER_CMD_PRIVATE_EXPEDITED) != 0 &&
+            syscall(SYS_membarrier, MEMBARRIER_CMD_REGISTER_PRIVATE_EXPEDITED, 0, 0) == 0;
+    }();
+
+    return asymmetric_fence_supported;
+}
+
+//
+// Process-wide hazard pointer domain for objects of type T.
+// Readers protect a pointer loaded from an atomic source for the lifetime of a guard;
+// writers replace the source and retire the previous object, which is deleted once
+// no reader protects it anymore. Hazard slots are kept per thread, so readers never
+// write to a shared cache line.
+//
+template<typename T>
+class hazard_pointer_domain
+{
+
+private:
+
+    //
+    // Count of nested guards per thread served by the record of the thread. Deeper guards
+    // borrow a spare record each.
+    //
+    static constexpr std::uint32_t c_slots_per_thread = 4u;
+
+    //
+    // Hazard slots owned by a single thread at a time.
+    //
+    struct alignas(64) thread_record
+    {
+
+        //
+        // Pointers protected by the owner thread.
+        //
+        std::atomic<T*> m_slots[c_slots_per_thread] {};
+
+        //
+        // Flag for determining whether a thread owns the record.
+        //
+        std::atomic<bool> m_in_use {true};
+
+        //
+        // Count of guards alive in the owner thread that use the record.
+        //
+        std::uint32_t m_depth {0u};
+
+        //
+        // Next record in the domain list.
+        //
+        thread_record* m_next {nullptr};
+
+    };
+
+    //
+    // Retired object and the ticket of its retirement.
+    //
+    struct retired_pointer
+    {
+
+        T* m_pointer;
+
+        std::uint64_t m_ticket;
+
+    };
+
+    //
+    // Per-thread owner of a record; hands it back to the domain when the thread exits.
+    //
+    struct thread_record_owner
+    {
+
+        ~thread_record_owner()
+        {
+            if (m_thread_record != nullptr)
+            {
+                m_thread_record->m_in_use.store(false, std::memory_order_release);
+            }
+        }
+
+        thread_record* m_thread_record = nullptr;
+
+    };
+
+public:
+
+    //
+    // Guard protecting a pointer from reclamation while it is alive.
+    //
+    class guard
+    {
+
+    public:
+
+        guard(
+            std::atomic<T*>* p_slot,
+            T* p_pointer,
+            thread_record* p_thread_record,
+            const bool p_borrowed_thread_record)
+            : m_slot{p_slot},
+              m_pointer{p_pointer},
+              m_thread_record{p_thread_record},
+              m_borrowed_thread_record{p_borrowed_thread_record}
+        {}
+
+        ~guard()
+        {
+            m_slot->store(nullptr, std::memory_order_release);
+            --m_thread_record->m_depth;
+
+            if (m_borrowed_thread_record)
+            {
+                m_thread_record->m_in_use.store(false, std::memory_order_release);
+            }
+        }
+
+        guard(const guard&) = delete;
+
+        guard&
+        operator=(const guard&) = delete;
+
+        auto
+        get() const -> T*
+        {
+            return m_pointer;
+        }
+
+        auto
+        operator->() const -> T*
+        {
+            return m_pointer;
+        }
+
+    private:
+
+        std::atomic<T*>* const m_slot;
+
+        T* const m_pointer;
+
+        thread_record* const m_thread_record;
+
+        //
+        // Flag for determining whether the record was borrowed for this guard alone.
+        //
+        const bool m_borrowed_thread_record;
+
+    };
+
+    //
+    // Loads and protects the pointer stored in the source.
+    // The protected pointer can be null.
+    //
+    static
+    auto
+    protect(
+        const std::atomic<T*>& p_source) -> guard
+    {
+        thread_record* record = get_thread_record();
+        const bool borrowed_thread_record = record->m_depth == c_slots_per_thread;
+
+        if (borrowed_thread_record)
+        {
+            //
+            // Nested deeper than the slots of the thread, e.g. by a log call from a subscriber
+            // callback; protect through a spare record, handed back when the guard goes away.
+            //
+            record = acquire_thread_record();
+        }
+
+        std::atomic<T*>& slot = record->m_slots[record->m_depth++];
+        T* pointer = p_source.load(std::memory_order_acquire);
+
+        while (true)
+        {
+            slot.store(pointer, std::memory_order_relaxed);
+
+            //
+            // Order the slot publication before the validating load. With asymmetric
+            // fences the reclaimer's membarrier provides the hardware ordering.
+            //
+            if (is_asymmetric_fence_supported())
+            {
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+            }
+            else
+            {
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+            }
+
+            T* const current_pointer = p_source.load(std::memory_order_acquire);
+
+            if (current_pointer == pointer)
+            {
+                break;
+            }
+
+            pointer = current_pointer;
+        }
+
+        return guard(&slot, pointer, record, borrowed_thread_record);
+    }
+
+    //
+    // Retires an object that is no longer reachable from any source and reclaims every
+    // retired object that is not protected. Returns the ticket of the retirement.
+    //
+    static
+    auto
+    retire(
+        T* p_pointer) -> std::uint64_t
+    {
+        std::uint64_t ticket = 0u;
+
+        {
+            std::scoped_lock<std::mutex> lock {get_retired_lock()};
+
+            ticket = get_next_retirement_ticket()++;
+            get_retired_pointers().push_back(retired_pointer{p_pointer, ticket});
+        }
+
+        reclaim();
+
+        return ticket;
+    }
+
+    //
+    // Determines whether the object of a retirement was deleted.
+    //
+    static
+    auto
+    is_reclaimed(
+        const std::uint64_t p_ticket) -> bool
+    {
+        std::scoped_lock<std::mutex> lock {get_retired_lock()};
+        const std::vector<retired_pointer>& retired_pointers = get_retired_pointers();
+
+        return std::none_of(retired_pointers.begin(), retired_pointers.end(), [p_ticket](const retired_pointer& p_retired_pointer)
+        {
+            return p_retired_pointer.m_ticket == p_ticket;
+        });
+    }
+
+    //
+    // Deletes every retired object that is not protected. Returns the count of objects still pending.
+    //
+    static
+    auto
+    reclaim() -> std::size_t
+    {
+        std::scoped_lock<std::mutex> lock {get_retired_lock()};
+        std::vector<retired_pointer>& retired_pointers = get_retired_pointers();
+
+        if (retired_pointers.empty())
+        {
+            return 0u;
+        }
+
+        if (is_asymmetric_fence_supported())
+        {
+            syscall(SYS_membarrier, MEMBARRIER_CMD_PRIVATE_EXPEDITED, 0, 0);
+        }
+        else
+        {
+            std::atomic_thread_fence(std::memory_order_seq_cst);
+        }
+
+        std::vector<T*> protected_pointers;
+
+        for (thread_record* record = get_thread_records_head().load(std::memory_order_acquire); record != nullptr; record = record->m_next)
+        {
+            for (const std::atomic<T*>& slot : record->m_slots)
+            {
+                T* const pointer = slot.load(std::memory_order_acquire);
+
+                if (pointer != nullptr)
+                {
+                    protected_pointers.push_back(pointer);
+                }
+            }
+        }
+
+        std::vector<retired_pointer> pending_pointers;
+
+        for (const retired_pointer& retired : retired_pointers)
+        {
+            if (std::find(protected_pointers.begin(), protected_pointers.end(), retired.m_pointer) != protected_pointers.end())
+            {
+                pending_pointers.push_back(retired);
+
+                continue;
+            }
+
+            delete retired.m_pointer;
+        }
+
+        retired_pointers.swap(pending_pointers);
+
+        return retired_pointers.size();
+    }
+
+    //
+    // Resets the domain in a child process right after a fork, where the calling thread is
+    // the only one left. The slots of the threads that did not survive the fork are cleared
+    // and their records released; the retired objects are forgotten without being deleted,
+    // since they can refer to threads that only exist in the parent. Expects that no thread
+    // was retiring or reclaiming when the process forked.
+    //
+    static
+    auto
+    reset_after_fork() -> void
+    {
+        thread_record* const calling_thread_record = get_thread_record();
+
+        for (thread_record* record = get_thread_records_head().load(std::memory_order_acquire); record != nullptr; record = record->m_next)
+        {
+            if (record == calling_thread_record)
+            {
+                continue;
+            }
+
+            for (std::atomic<T*>& slot : record->m_slots)
+            {
+                slot.store(nullptr, std::memory_order_relaxed);
+            }
+
+            record->m_depth = 0u;
+            record->m_in_use.store(false, std::memory_order_release);
+        }
+
+        get_retired_pointers().clear();
+    }
+
+private:
+
+    //
+    // Gets the record of the calling thread, taking over a released one or allocating a new one.
+    //
+    static
+    auto
+    get_thread_record() -> thread_record*
+    {
+        thread_local thread_record_owner owner;
+
+        if (owner.m_thread_record == nullptr)
+        {
+            owner.m_thread_record = acquire_thread_record();
+        }
+
+        return owner.m_thread_record;
+    }
+
+    //
+    // Takes over a released record or allocates a new one.
+    //
+    static
+    auto
+    acquire_thread_record() -> thread_record*
+    {
+        std::atomic<thread_record*>& head = get_thread_records_head();
+
+        for (thread_record* record = head.load(std::memory_order_acquire); record != nullptr; record = record->m_next)
+        {
+            bool in_use = false;
+
+            if (!record->m_in_use.load(std::memory_order_relaxed) &&
+                record->m_in_use.compare_exchange_strong(in_use, true, std::memory_order_acquire))
+            {
+                return record;
+            }
+        }
+
+        //
+        // Records are never freed; their count is bounded by the peak count of threads and deeply nested guards.
+        //
+        thread_record* record = new thread_record();
+        record->m_next = head.load(std::memory_order_relaxed);
+
+        while (!head.compare_exchange_weak(record->m_next, record, std::memory_order_release, std::memory_order_relaxed))
+        {}
+
+        return record;
+    }
+
+    static
+    auto
+    get_thread_records_head() -> std::atomic<thread_record*>&
+    {
+        static std::atomic<thread_record*> thread_records_head {nullptr};
+
+        return thread_records_head;
+    }
+
+    static
+    auto
+    get_retired_pointers() -> std::vector<retired_pointer>&
+    {
+        static std::vector<retired_pointer> retired_pointers;
+
+        return retired_pointers;
+    }
+
+    static
+    auto
+    get_next_retirement_ticket() -> std::uint64_t&
+    {
+        static std::uint64_t next_retirement_ticket = 0u;
+
+        return next_retirement_ticket;
+    }
+
+    static
+    auto
+    get_retired_lock() -> std::mutex&
+    {
+        static std::mutex retired_lock;
+
+        return retired_lock;
+    }
+
+};
+
+} // namespace echo.
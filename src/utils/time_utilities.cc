@@ -0,0 +1,111 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Utils
+// 'time_utilities.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <ctime>
+#include <cstdio>
+#include "time_utilities.hh"
+
+namespace echo
+{
+
+auto
+timestamp_to_string(
+    const std::uint64_t p_timestamp_ns,
+    const bool p_utc_enabled) -> std::string
+{
+    const std::time_t seconds = static_cast<std::time_t>(p_timestamp_ns / 1'000'000'000u);
+    const std::uint32_t microseconds = static_cast<std::uint32_t>((p_timestamp_ns % 1'000'000'000u) / 1'000u);
+
+    std::tm calendar_time {};
+
+    if (p_utc_enabled)
+    {
+        gmtime_r(&seconds, &calendar_time);
+    }
+    else
+    {
+        localtime_r(&seconds, &calendar_time);
+    }
+
+    char buffer[64];
+
+    std::snprintf(
+        buffer,
+        sizeof(buffer),
+        "%04d-%02d-%02d %02d:%02d:%02d.%06u",
+        calendar_time.tm_year + 1900,
+        calendar_time.tm_mon + 1,
+        calendar_time.tm_mday,
+        calendar_time.tm_hour,
+        calendar_time.tm_min,
+        calendar_time.tm_sec,
+        microseconds);
+
+    return std::string(buffer);
+}
+
+auto
+string_to_timestamp(
+    const std::string_view p_timestamp,
+    const bool p_utc_enabled) -> std::optional<std::uint64_t>
+{
+    const std::string timestamp {p_timestamp};
+    std::tm calendar_time {};
+    char separator = '\0';
+    int consumed_count = 0;
+
+    if (std::sscanf(
+            timestamp.c_str(),
+            "%4d-%2d-%2d%c%2d:%2d:%2d%n",
+            &calendar_time.tm_year,
+            &calendar_time.tm_mon,
+            &calendar_time.tm_mday,
+            &separator,
+            &calendar_time.tm_hour,
+            &calendar_time.tm_min,
+            &calendar_time.tm_sec,
+            &consumed_count) != 7 ||
+        (separator != ' ' && separator != 'T'))
+    {
+        return std::nullopt;
+    }
+
+    calendar_time.tm_year -= 1900;
+    calendar_time.tm_mon -= 1;
+    calendar_time.tm_isdst = -1;
+
+    const std::time_t seconds = p_utc_enabled ? timegm(&calendar_time) : mktime(&calendar_time);
+
+    if (seconds == static_cast<std::time_t>(-1))
+    {
+        return std::nullopt;
+    }
+
+    std::uint64_t fraction_ns = 0u;
+
+    if (static_cast<std::size_t>(consumed_count) < timestamp.size() &&
+        timestamp[consumed_count] == '.')
+    {
+        std::uint64_t scale = 100'000'000u;
+
+        for (std::size_t index = consumed_count + 1u; index < timestamp.size() && scale != 0u; ++index)
+        {
+            if (timestamp[index] < '0' || timestamp[index] > '9')
+            {
+                break;
+            }
+
+            fraction_ns += static_cast<std::uint64_t>(timestamp[index] - '0') * scale;
+            scale /= 10u;
+        }
+    }
+
+    return static_cast<std::uint64_t>(seconds) * 1'000'000'000u + fraction_ns;
+}
+
+} // namespace echo.
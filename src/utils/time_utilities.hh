@@ -0,0 +1,75 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Utils
+// 'time_utilities.hh'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace echo
+{
+
+//
+// Gets the current wall-clock time in nanoseconds since the epoch.
+// Thread-safe function.
+//
+inline
+auto
+get_current_timestamp_ns() -> std::uint64_t
+{
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+}
+
+//
+// Reads the CPU timestamp counter, a cheap monotonic tick count that has to be calibrated
+// against the wall clock before use. Falls back to the steady clock in nanoseconds on
+// architectures without an invariant counter exposed to user space.
+// Thread-safe function.
+//
+inline
+auto
+read_timestamp_counter() -> std::uint64_t
+{
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return static_cast<std::uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+#endif
+}
+
+//
+// Renders a nanoseconds timestamp as 'YYYY-MM-DD HH:MM:SS.ffffff'.
+// Uses UTC or local time depending on the specified flag.
+// Thread-safe function.
+//
+auto
+timestamp_to_string(
+    const std::uint64_t p_timestamp_ns,
+    const bool p_utc_enabled) -> std::string;
+
+//
+// Parses a 'YYYY-MM-DD HH:MM:SS[.ffffff]' timestamp into nanoseconds since the epoch.
+// The date and time may also be separated by a 'T'. Returns no value on malformed input.
+// Thread-safe function.
+//
+auto
+string_to_timestamp(
+    const std::string_view p_timestamp,
+    const bool p_utc_enabled) -> std::optional<std::uint64_t>;
+
+} // namespace echo.
@@ -0,0 +1,411 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Tests
+// 'log_completion_queue_test.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <mutex>
+#include <deque>
+#include <atomic>
+#include <chrono>
+#include <future>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <algorithm>
+#include <iostream>
+#include <coroutine>
+#include <exception>
+#include <filesystem>
+#include <functional>
+#include "../src/logger/logger.hh"
+#include "../src/logger/log_completion_queue.hh"
+
+namespace
+{
+
+//
+// Minimal executor: a run queue of coroutine handles drained by the thread that calls run.
+//
+class single_thread_executor
+{
+
+public:
+
+    auto
+    post(
+        std::coroutine_handle<> p_coroutine_handle) -> void
+    {
+        std::scoped_lock<std::mutex> lock {m_lock};
+
+        m_run_queue.push_back(p_coroutine_handle);
+    }
+
+    //
+    // Resumes the queued coroutines, in posting order, until the queue is empty.
+    //
+    auto
+    run() -> std::size_t
+    {
+        std::size_t resumed_count = 0u;
+
+        while (true)
+        {
+            std::coroutine_handle<> coroutine_handle;
+
+            {
+                std::scoped_lock<std::mutex> lock {m_lock};
+
+                if (m_run_queue.empty())
+                {
+                    return resumed_count;
+                }
+
+                coroutine_handle = m_run_queue.front();
+                m_run_queue.pop_front();
+            }
+
+            coroutine_handle.resume();
+            ++resumed_count;
+        }
+    }
+
+    auto
+    get_resume_callback() -> echo::resume_callback
+    {
+        return [this](std::coroutine_handle<> p_coroutine_handle)
+        {
+            post(p_coroutine_handle);
+        };
+    }
+
+private:
+
+    std::mutex m_lock;
+
+    std::deque<std::coroutine_handle<>> m_run_queue;
+
+};
+
+//
+// Coroutine started eagerly whose frame is destroyed once it completes.
+//
+struct detached_task
+{
+
+    struct promise_type
+    {
+
+        auto
+        get_return_object() -> detached_task
+        {
+            return {};
+        }
+
+        auto
+        initial_suspend() noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        auto
+        final_suspend() noexcept -> std::suspend_never
+        {
+            return {};
+        }
+
+        auto
+        return_void() -> void
+        {}
+
+        auto
+        unhandled_exception() -> void
+        {
+            std::terminate();
+        }
+
+    };
+
+};
+
+//
+// Statuses reported by the operation runners, and the status of an await not resumed yet.
+//
+constexpr echo::status_code c_flush_status = echo::status::success;
+
+constexpr echo::status_code c_durability_status = echo::status::fail;
+
+constexpr echo::status_code c_unset_status = 0xFFFF'FFFFu;
+
+//
+// Outcome of an awaiting coroutine.
+//
+struct await_result
+{
+
+    bool m_resumed = false;
+
+    echo::status_code m_status = c_unset_status;
+
+    std::thread::id m_resuming_thread_id;
+
+};
+
+//
+// Awaits an operation of a queue and records its outcome and the order of resumption.
+//
+auto
+await_operation(
+    echo::log_completion_queue& p_log_completion_queue,
+    const echo::completion_operation p_operation,
+    await_result& p_await_result,
+    std::vector<std::size_t>& p_resume_order,
+    const std::size_t p_index) -> detached_task
+{
+    p_await_result.m_status = co_await echo::log_completion_awaitable(p_log_completion_queue, p_operation);
+    p_await_result.m_resumed = true;
+    p_await_result.m_resuming_thread_id = std::this_thread::get_id();
+    p_resume_order.push_back(p_index);
+}
+
+auto
+await_flush(
+    echo::status_code& p_status,
+    bool& p_resumed) -> detached_task
+{
+    p_status = co_await echo::logger::flush_async();
+    p_resumed = true;
+}
+
+auto
+await_durable_log(
+    echo::status_code& p_status,
+    bool& p_resumed) -> detached_task
+{
+    p_status = co_await echo::logger::log_durable_async(echo::log_level::error, "Test", "durable record {}", 1);
+    p_resumed = true;
+}
+
+std::uint32_t g_failures_count = 0u;
+
+auto
+check(
+    const bool p_condition,
+    const char* p_description) -> void
+{
+    if (!p_condition)
+    {
+        ++g_failures_count;
+        std::cerr << "Failed: " << p_description << "\n";
+    }
+}
+
+//
+// Without a hook, coroutines resume inline on the completion thread with the status of their operation.
+//
+auto
+test_inline_resume() -> void
+{
+    std::atomic<std::uint32_t> runs_count {0u};
+    std::vector<await_result> results(2u);
+    std::vector<std::size_t> resume_order;
+
+    {
+        echo::log_completion_queue queue {[&runs_count](const echo::completion_operation p_operation)
+        {
+            ++runs_count;
+
+            return p_operation == echo::completion_operation::flush ? c_flush_status : c_durability_status;
+        }};
+
+        await_operation(queue, echo::completion_operation::flush, results[0u], resume_order, 0u);
+        await_operation(queue, echo::completion_operation::durability, results[1u], resume_order, 1u);
+    }
+
+    check(results[0u].m_resumed && results[1u].m_resumed, "inline: every coroutine resumed by the time the queue is destroyed");
+    check(results[0u].m_status == c_flush_status, "inline: flush status handed over");
+    check(results[1u].m_status == c_durability_status, "inline: durability status handed over");
+    check(results[0u].m_resuming_thread_id != std::this_thread::get_id(), "inline: resumed on the completion thread");
+    check(resume_order == std::vector<std::size_t>{0u, 1u}, "inline: resumed in submission order");
+}
+
+//
+// With a hook, coroutines are only resumed by their executor, after their operation ran, in submission order.
+//
+auto
+test_executor_resume() -> void
+{
+    single_thread_executor executor;
+    std::promise<void> first_run_started;
+    std::promise<void> first_run_released;
+    std::shared_future<void> first_run_release = first_run_released.get_future().share();
+    std::atomic<std::uint32_t> flush_runs_count {0u};
+    std::atomic<std::uint32_t> durability_runs_count {0u};
+    constexpr std::size_t requests_count = 6u;
+    std::vector<await_result> results(requests_count + 1u);
+    std::vector<std::size_t> resume_order;
+
+    {
+        echo::log_completion_queue queue {[&](const echo::completion_operation p_operation)
+        {
+            if (p_operation == echo::completion_operation::flush)
+            {
+                //
+                // The first run is held so that the next requests queue up behind it.
+                //
+                if (flush_runs_count++ == 0u)
+                {
+                    first_run_started.set_value();
+                    first_run_release.wait();
+                }
+
+                return c_flush_status;
+            }
+
+            ++durability_runs_count;
+
+            return c_durability_status;
+        }};
+
+        queue.set_resume_callback(executor.get_resume_callback());
+
+        await_operation(queue, echo::completion_operation::flush, results[0u], resume_order, 0u);
+        first_run_started.get_future().wait();
+
+        for (std::size_t index = 1u; index <= requests_count; ++index)
+        {
+            await_operation(
+                queue,
+                index % 2u == 0u ? echo::completion_operation::flush : echo::completion_operation::durability,
+                results[index],
+                resume_order,
+                index);
+        }
+
+        first_run_released.set_value();
+    }
+
+    check(resume_order.empty(), "executor: nothing resumed before the executor runs");
+    check(executor.run() == requests_count + 1u, "executor: every coroutine posted once");
+    check(flush_runs_count == 2u, "executor: queued flush requests served by a single run");
+    check(durability_runs_count == 1u, "executor: queued durability requests served by a single run");
+
+    std::vector<std::size_t> expected_resume_order;
+
+    for (std::size_t index = 0u; index <= requests_count; ++index)
+    {
+        expected_resume_order.push_back(index);
+
+        check(results[index].m_resuming_thread_id == std::this_thread::get_id(), "executor: resumed on the executor thread");
+        check(
+            results[index].m_status == (index % 2u == 0u ? c_flush_status : c_durability_status),
+            "executor: status of the awaited operation handed over");
+    }
+
+    check(resume_order == expected_resume_order, "executor: resumed in submission order");
+}
+
+//
+// Destroying a queue with pending requests completes them instead of dropping them.
+//
+auto
+test_pending_requests_at_destruction() -> void
+{
+    single_thread_executor executor;
+    constexpr std::size_t requests_count = 32u;
+    std::vector<await_result> results(requests_count);
+    std::vector<std::size_t> resume_order;
+
+    {
+        echo::log_completion_queue queue {[](const echo::completion_operation)
+        {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+            return c_flush_status;
+        }};
+
+        queue.set_resume_callback(executor.get_resume_callback());
+
+        for (std::size_t index = 0u; index < requests_count; ++index)
+        {
+            await_operation(queue, echo::completion_operation::flush, results[index], resume_order, index);
+        }
+    }
+
+    check(executor.run() == requests_count, "destruction: every pending request completed");
+    check(resume_order.size() == requests_count && std::is_sorted(resume_order.begin(), resume_order.end()), "destruction: resumed in submission order");
+}
+
+//
+// The logger awaitables go through the hook of the logger and report the status of their operation.
+//
+auto
+test_logger_awaitables() -> void
+{
+    single_thread_executor executor;
+    echo::status_code flush_status = c_unset_status;
+    echo::status_code durable_status = c_unset_status;
+    bool flush_resumed = false;
+    bool durable_resumed = false;
+
+    echo::logger::set_resume_callback(executor.get_resume_callback());
+
+    await_flush(flush_status, flush_resumed);
+
+    while (!flush_resumed)
+    {
+        executor.run();
+        std::this_thread::yield();
+    }
+
+    check(flush_status == echo::status::logger_not_initialized, "logger: flush before initialization reports it");
+
+    const std::filesystem::path logs_directory_path = std::filesystem::temp_directory_path() / "echo_logger_completion_queue_test";
+
+    echo::logger_configuration configuration;
+    configuration.logs_directory_path = logs_directory_path;
+    configuration.debug_mode_enabled = false;
+    configuration.async_mode_enabled = true;
+
+    echo::logger::initialize(&configuration);
+
+    flush_resumed = false;
+    await_flush(flush_status, flush_resumed);
+    await_durable_log(durable_status, durable_resumed);
+
+    while (!flush_resumed ||
+        !durable_resumed)
+    {
+        executor.run();
+        std::this_thread::yield();
+    }
+
+    check(flush_status == echo::status::success, "logger: flush succeeded");
+    check(durable_status == echo::status::success, "logger: durable write succeeded");
+
+    echo::logger::shutdown();
+    echo::logger::set_resume_callback({});
+
+    std::error_code error_code;
+    std::filesystem::remove_all(logs_directory_path, error_code);
+}
+
+} // namespace.
+
+//
+// Checks the resumption of coroutines awaiting the completion queue through a minimal executor.
+//
+int main()
+{
+    test_inline_resume();
+    test_executor_resume();
+    test_pending_requests_at_destruction();
+    test_logger_awaitables();
+
+    std::cout << "Failures: " << g_failures_count << "\n";
+
+    return g_failures_count == 0u ? 0 : 1;
+}
@@ -0,0 +1,139 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Tests
+// 'log_header_encoder_test.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <array>
+#include <random>
+#include <string>
+#include <format>
+#include <cstdint>
+#include <iostream>
+#include <unistd.h>
+#include <sys/syscall.h>
+#include <source_location>
+#include "../src/logger/log_header_encoder.hh"
+#include "../src/utils/time_utilities.hh"
+
+auto
+get_other_file_call_site() -> std::source_location;
+
+namespace
+{
+
+auto
+get_call_site() -> std::source_location
+{
+    return std::source_location::current();
+}
+
+//
+// Rendering of a record by the std::format call the encoder replaced.
+//
+auto
+format_reference_record(
+    const std::string& p_session_id,
+    const pid_t p_process_id,
+    const bool p_utc_enabled,
+    const std::uint64_t p_timestamp_ns,
+    const std::uint64_t p_sequence_number,
+    const echo::log_level p_log_level,
+    const std::source_location& p_source_location,
+    const char* p_title,
+    const char* p_message) -> std::string
+{
+    constexpr std::array<const char*, 4u> log_level_texts = {"Info", "Warning", "Error", "Critical"};
+
+    return std::format(
+        "[{}] ({}) PID={}, TID={}, Seq={}, ActivityID={}, File={}, Function={}, Line={}. <{}> [{}] {}\n",
+        echo::timestamp_to_string(p_timestamp_ns, p_utc_enabled),
+        p_session_id.c_str(),
+        p_process_id,
+        syscall(SYS_gettid),
+        p_sequence_number,
+        "123",
+        p_source_location.file_name(),
+        p_source_location.function_name(),
+        p_source_location.line(),
+        log_level_texts[static_cast<std::size_t>(p_log_level)],
+        p_title,
+        p_message);
+}
+
+} // namespace.
+
+//
+// Checks that the encoder renders records byte for byte as the std::format call it replaced,
+// including for call sites of different files sharing a single function name literal.
+//
+int main()
+{
+    const std::string session_id = "7f3e2a10-5b4c-4d8e-9f01-23456789abcd";
+    const pid_t process_id = getpid();
+    const std::array<std::source_location, 3u> call_sites = {
+        get_call_site(),
+        get_other_file_call_site(),
+        std::source_location::current()};
+    const std::array<const char*, 3u> titles = {"", "Main", "A rather long title of a component"};
+    const std::array<const char*, 3u> messages = {"", "Hello world", "Multi\nline message with {braces}"};
+
+    std::mt19937_64 random_engine {42u};
+    std::uint64_t mismatches_count = 0u;
+
+    for (const bool utc_enabled : {true, false})
+    {
+        const echo::log_header_encoder encoder {session_id, process_id, utc_enabled};
+        std::string record;
+
+        for (std::uint32_t iteration = 0u; iteration < 20'000u; ++iteration)
+        {
+            //
+            // Call sites alternate so that each one finds the cache slot taken by the other.
+            //
+            const std::source_location& call_site = call_sites[iteration % call_sites.size()];
+            const std::uint64_t timestamp_ns = random_engine() % 4'102'444'800'000'000'000u;
+            const std::uint64_t sequence_number = iteration % 7u == 0u ? random_engine() : iteration;
+            const echo::log_level log_level = static_cast<echo::log_level>(random_engine() % 4u);
+            const char* title = titles[random_engine() % titles.size()];
+            const char* message = messages[random_engine() % messages.size()];
+
+            encoder.encode(
+                record,
+                timestamp_ns,
+                sequence_number,
+                log_level,
+                call_site,
+                title,
+                message);
+
+            const std::string reference_record = format_reference_record(
+                session_id,
+                process_id,
+                utc_enabled,
+                timestamp_ns,
+                sequence_number,
+                log_level,
+                call_site,
+                title,
+                message);
+
+            if (record != reference_record &&
+                mismatches_count++ < 5u)
+            {
+                std::cerr << "Mismatch:\n  encoded:   " << record << "  reference: " << reference_record;
+            }
+        }
+    }
+
+    if (call_sites[0u].function_name() != call_sites[1u].function_name())
+    {
+        std::cout << "Function names of the two files were not merged; the shared literal case was not exercised.\n";
+    }
+
+    std::cout << "Mismatches: " << mismatches_count << "\n";
+
+    return mismatches_count == 0u ? 0 : 1;
+}
@@ -0,0 +1,30 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Tests
+// 'log_header_encoder_test_call_site.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <source_location>
+
+namespace
+{
+
+//
+// Same signature as the call site of the main test file, so that both function names are the
+// same literal once merged by the linker, while their file names differ in length.
+//
+auto
+get_call_site() -> std::source_location
+{
+    return std::source_location::current();
+}
+
+} // namespace.
+
+auto
+get_other_file_call_site() -> std::source_location
+{
+    return get_call_site();
+}
@@ -0,0 +1,225 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Tests
+// 'policy_logging_engine_test.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <unistd.h>
+#include <filesystem>
+#include "../src/logger/segment_reader.hh"
+#include "../src/logger/policy_logging_engine.hh"
+
+namespace
+{
+
+std::uint32_t g_failures_count = 0u;
+
+auto
+check(
+    const bool p_condition,
+    const char* p_description) -> void
+{
+    if (!p_condition)
+    {
+        ++g_failures_count;
+        std::cerr << "Failed: " << p_description << "\n";
+    }
+}
+
+//
+// Reads back every line of the segments of a logging session.
+//
+auto
+read_session_lines(
+    const std::filesystem::path& p_logging_session_directory_path) -> std::vector<std::string>
+{
+    std::vector<std::string> lines;
+
+    for (const std::filesystem::path& segment_path : echo::get_segment_paths(p_logging_session_directory_path))
+    {
+        std::ifstream segment {segment_path, std::ios::binary};
+        std::string line;
+
+        while (std::getline(segment, line))
+        {
+            lines.push_back(line);
+        }
+    }
+
+    return lines;
+}
+
+auto
+create_configuration(
+    const std::filesystem::path& p_logs_directory_path,
+    const bool p_async_mode_enabled) -> echo::logger_configuration
+{
+    echo::logger_configuration configuration;
+    configuration.logs_directory_path = p_logs_directory_path;
+    configuration.async_mode_enabled = p_async_mode_enabled;
+    configuration.minimum_log_level = echo::log_level::warning;
+
+    return configuration;
+}
+
+//
+// The minimal policy leaves the timestamp, activity and source location fields out of the
+// records, discards the records below the minimum level and numbers the others in order.
+//
+auto
+test_minimal_policy(
+    const std::filesystem::path& p_logs_directory_path) -> void
+{
+    constexpr std::uint64_t records_count = 100u;
+    std::filesystem::path logging_session_directory_path;
+
+    {
+        echo::policy_logging_engine<echo::minimal_engine_policy> engine {create_configuration(p_logs_directory_path, false)};
+
+        for (std::uint64_t record_index = 0u; record_index < records_count; ++record_index)
+        {
+            engine.log(echo::log_level::info, "Discarded", "record {}", record_index);
+            engine.log(echo::log_level::warning, "Minimal", "record {}", record_index);
+        }
+
+        check(echo::status::succeeded(engine.flush()), "minimal: flush succeeded");
+
+        logging_session_directory_path = engine.get_logging_session_directory_path();
+    }
+
+    const std::vector<std::string> lines = read_session_lines(logging_session_directory_path);
+
+    check(lines.size() == records_count, "minimal: records below the minimum level discarded");
+
+    for (std::uint64_t record_index = 0u; record_index < lines.size(); ++record_index)
+    {
+        const std::optional<echo::log_record_view> record = echo::parse_log_record(lines[record_index]);
+
+        check(record.has_value(), "minimal: record parsed");
+
+        if (!record.has_value())
+        {
+            continue;
+        }
+
+        check(record->m_timestamp.empty(), "minimal: no timestamp");
+        check(lines[record_index].find("ActivityID=") == std::string::npos, "minimal: no activity identifier");
+        check(lines[record_index].find("File=") == std::string::npos, "minimal: no source location");
+        check(record->m_sequence_number == record_index, "minimal: records numbered in order");
+        check(record->m_title == "Minimal", "minimal: title kept");
+        check(record->m_message == "record " + std::to_string(record_index), "minimal: message kept");
+    }
+}
+
+//
+// The full policy renders every field. In async mode the per-thread buffers are reused
+// across queued records without any of them being cut or mixed up.
+//
+auto
+test_full_policy_async(
+    const std::filesystem::path& p_logs_directory_path) -> void
+{
+    constexpr std::uint64_t records_count = 1000u;
+    std::filesystem::path logging_session_directory_path;
+
+    {
+        echo::policy_logging_engine<echo::full_engine_policy> engine {create_configuration(p_logs_directory_path, true)};
+
+        for (std::uint64_t record_index = 0u; record_index < records_count; ++record_index)
+        {
+            //
+            // Messages of growing and shrinking sizes in turn.
+            //
+            engine.log(echo::log_level::error, "Full", "record {} {}", record_index, std::string(record_index % 2u == 0u ? 200u : 1u, 'x'));
+        }
+
+        check(echo::status::succeeded(engine.flush()), "full: flush succeeded");
+
+        logging_session_directory_path = engine.get_logging_session_directory_path();
+    }
+
+    const std::vector<std::string> lines = read_session_lines(logging_session_directory_path);
+
+    check(lines.size() == records_count, "full: every record written");
+
+    for (std::uint64_t record_index = 0u; record_index < lines.size(); ++record_index)
+    {
+        const std::optional<echo::log_record_view> record = echo::parse_log_record(lines[record_index]);
+
+        check(record.has_value(), "full: record parsed");
+
+        if (!record.has_value())
+        {
+            continue;
+        }
+
+        check(!record->m_timestamp.empty(), "full: timestamp rendered");
+        check(lines[record_index].find("ActivityID=") != std::string::npos, "full: activity identifier rendered");
+        check(lines[record_index].find("File=") != std::string::npos, "full: source location rendered");
+        check(
+            record->m_message == "record " + std::to_string(record_index) + " " + std::string(record_index % 2u == 0u ? 200u : 1u, 'x'),
+            "full: message intact");
+    }
+}
+
+//
+// A relative logs directory is resolved once, so that later working directory changes do not move the session.
+//
+auto
+test_relative_logs_directory(
+    const std::filesystem::path& p_logs_directory_path) -> void
+{
+    const std::filesystem::path working_directory_path = std::filesystem::current_path();
+
+    std::filesystem::create_directories(p_logs_directory_path / "working");
+    std::filesystem::current_path(p_logs_directory_path / "working");
+
+    {
+        echo::policy_logging_engine<echo::minimal_engine_policy> engine {create_configuration("relative", false)};
+
+        std::filesystem::current_path(p_logs_directory_path);
+
+        engine.log(echo::log_level::critical, "Relative", "record");
+        engine.flush();
+
+        check(engine.get_logging_session_directory_path().is_absolute(), "relative: session directory path made absolute");
+        check(
+            engine.get_logging_session_directory_path().parent_path() == p_logs_directory_path / "working" / "relative",
+            "relative: session directory resolved against the initial working directory");
+        check(
+            read_session_lines(engine.get_logging_session_directory_path()).size() == 1u,
+            "relative: record written to the session directory");
+    }
+
+    std::filesystem::current_path(working_directory_path);
+}
+
+} // namespace.
+
+//
+// Checks the record layouts and the writes of the policy logging engine in sync and async modes.
+//
+int main()
+{
+    const std::filesystem::path logs_directory_path =
+        std::filesystem::temp_directory_path() / ("echo_policy_logging_engine_test-" + std::to_string(getpid()));
+
+    test_minimal_policy(logs_directory_path);
+    test_full_policy_async(logs_directory_path);
+    test_relative_logs_directory(logs_directory_path);
+
+    std::error_code error_code;
+    std::filesystem::remove_all(logs_directory_path, error_code);
+
+    std::cout << "Failures: " << g_failures_count << "\n";
+
+    return g_failures_count == 0u ? 0 : 1;
+}
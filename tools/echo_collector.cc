@@ -0,0 +1,68 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Tools
+// 'echo_collector.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <iostream>
+#include <thread>
+#include "../src/logger/shared_memory_collector.hh"
+
+namespace
+{
+
+//
+// Flag set by the termination signal handler.
+//
+volatile std::sig_atomic_t g_termination_requested = 0;
+
+auto
+handle_termination_signal(
+    [[maybe_unused]] int p_signal) -> void
+{
+    g_termination_requested = 1;
+}
+
+} // namespace.
+
+//
+// Drains the shared memory rings of every process logging in shared memory mode
+// under the given component name into one ordered set of segments.
+// Usage: echo_collector <component_name> <logs_directory_path> [collection_frequency_ms]
+//
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <component_name> <logs_directory_path> [collection_frequency_ms]\n";
+
+        return 1;
+    }
+
+    const std::uint32_t collection_frequency_ms = argc > 3 ? static_cast<std::uint32_t>(std::stoul(argv[3])) : 100u;
+
+    std::signal(SIGINT, handle_termination_signal);
+    std::signal(SIGTERM, handle_termination_signal);
+
+    echo::shared_memory_collector collector {argv[1], argv[2], collection_frequency_ms};
+
+    std::cout << "Collecting into " << collector.get_logging_session_directory_path().string() << "\n";
+
+    while (g_termination_requested == 0)
+    {
+        collector.collect();
+
+        std::this_thread::sleep_for(std::chrono::milliseconds(collection_frequency_ms));
+    }
+
+    //
+    // Write out every record still held back for ordering.
+    //
+    collector.stop();
+}
@@ -0,0 +1,227 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Tools
+// 'echo_merge.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <queue>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <filesystem>
+#include <string_view>
+#include "../src/logger/segment_reader.hh"
+
+namespace
+{
+
+//
+// Reader over the segments of one stream, e.g. every 'log_<session>_shard<index>_<count>.log'.
+// Records are ordered within a stream; lines that do not parse as a record header belong
+// to the record before them.
+//
+class stream_reader
+{
+
+public:
+
+    explicit stream_reader(
+        std::vector<std::filesystem::path> p_segment_paths)
+        : m_segment_paths{std::move(p_segment_paths)},
+          m_next_segment{0u}
+    {
+        read_line();
+    }
+
+    //
+    // Reads the next record of the stream. Returns false once the stream is exhausted.
+    //
+    auto
+    read_record() -> bool
+    {
+        m_record.clear();
+
+        if (!m_pending_line.has_value())
+        {
+            return false;
+        }
+
+        m_record = std::move(m_pending_line.value());
+        read_line();
+
+        while (m_pending_line.has_value() &&
+            !echo::parse_log_record(m_pending_line.value()).has_value())
+        {
+            m_record += m_pending_line.value();
+            read_line();
+        }
+
+        const std::optional<echo::log_record_view> record_view = echo::parse_log_record(m_record);
+
+        m_timestamp = record_view.has_value() ? std::string(record_view->m_timestamp) : std::string();
+        m_sequence_number = record_view.has_value() ? record_view->m_sequence_number.value_or(0u) : 0u;
+
+        return true;
+    }
+
+    auto
+    get_record() const -> const std::string&
+    {
+        return m_record;
+    }
+
+    auto
+    get_timestamp() const -> const std::string&
+    {
+        return m_timestamp;
+    }
+
+    auto
+    get_sequence_number() const -> std::uint64_t
+    {
+        return m_sequence_number;
+    }
+
+private:
+
+    //
+    // Reads the next line, including its line break, moving on to the next segment as needed.
+    //
+    auto
+    read_line() -> void
+    {
+        std::string line;
+
+        while (!std::getline(m_segment, line))
+        {
+            if (m_next_segment == m_segment_paths.size())
+            {
+                m_pending_line.reset();
+
+                return;
+            }
+
+            m_segment = std::ifstream(m_segment_paths[m_next_segment++], std::ios::binary);
+        }
+
+        m_pending_line = line + '\n';
+    }
+
+    std::vector<std::filesystem::path> m_segment_paths;
+
+    std::size_t m_next_segment;
+
+    std::ifstream m_segment;
+
+    std::optional<std::string> m_pending_line;
+
+    std::string m_record;
+
+    std::string m_timestamp;
+
+    std::uint64_t m_sequence_number = 0u;
+
+};
+
+//
+// Groups the segments of a session directory into streams by their name without the file count.
+//
+auto
+get_stream_segment_paths(
+    const std::filesystem::path& p_logging_session_directory_path) -> std::vector<std::vector<std::filesystem::path>>
+{
+    std::vector<std::vector<std::filesystem::path>> streams;
+    std::string current_stream;
+
+    //
+    // Segments come ordered by stream name first, then by file count.
+    //
+    for (std::filesystem::path& segment_path : echo::get_segment_paths(p_logging_session_directory_path))
+    {
+        const std::string stem = segment_path.stem().string();
+        const std::string stream = stem.substr(0u, stem.rfind('_'));
+
+        if (streams.empty() ||
+            stream != current_stream)
+        {
+            streams.emplace_back();
+            current_stream = stream;
+        }
+
+        streams.back().push_back(std::move(segment_path));
+    }
+
+    return streams;
+}
+
+} // namespace.
+
+//
+// Prints the records of a sharded logging session as a single stream ordered by timestamp,
+// breaking ties by the per-shard sequence number and then by shard.
+//
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <logging_session_directory_path>\n";
+
+        return 1;
+    }
+
+    std::vector<stream_reader> readers;
+
+    for (std::vector<std::filesystem::path>& segment_paths : get_stream_segment_paths(argv[1]))
+    {
+        readers.emplace_back(std::move(segment_paths));
+    }
+
+    //
+    // Timestamps are rendered with a fixed width, so they order lexicographically.
+    //
+    const auto is_later = [&readers](const std::size_t p_left, const std::size_t p_right)
+    {
+        const stream_reader& left = readers[p_left];
+        const stream_reader& right = readers[p_right];
+
+        if (left.get_timestamp() != right.get_timestamp())
+        {
+            return left.get_timestamp() > right.get_timestamp();
+        }
+
+        if (left.get_sequence_number() != right.get_sequence_number())
+        {
+            return left.get_sequence_number() > right.get_sequence_number();
+        }
+
+        return p_left > p_right;
+    };
+
+    std::priority_queue<std::size_t, std::vector<std::size_t>, decltype(is_later)> heads {is_later};
+
+    for (std::size_t stream = 0u; stream < readers.size(); ++stream)
+    {
+        if (readers[stream].read_record())
+        {
+            heads.push(stream);
+        }
+    }
+
+    while (!heads.empty())
+    {
+        const std::size_t stream = heads.top();
+        heads.pop();
+
+        std::cout << readers[stream].get_record();
+
+        if (readers[stream].read_record())
+        {
+            heads.push(stream);
+        }
+    }
+}
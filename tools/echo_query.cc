@@ -0,0 +1,381 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Tools
+// 'echo_query.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <atomic>
+#include <algorithm>
+#include <cctype>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <fcntl.h>
+#include <iostream>
+#include <optional>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <string_view>
+#include "../src/logger/segment_index.hh"
+#include "../src/logger/segment_reader.hh"
+#include "../src/utils/time_utilities.hh"
+
+namespace
+{
+
+//
+// Query filters. Unset filters match every record.
+//
+struct query_filters
+{
+
+    //
+    // Inclusive lower bound for record timestamps.
+    //
+    std::uint64_t m_from_timestamp_ns = 0u;
+
+    //
+    // Inclusive upper bound for record timestamps.
+    //
+    std::uint64_t m_to_timestamp_ns = std::numeric_limits<std::uint64_t>::max();
+
+    //
+    // Bitmap of the accepted levels.
+    //
+    std::uint32_t m_level_bitmap = std::numeric_limits<std::uint32_t>::max();
+
+    //
+    // Accepted title.
+    //
+    std::optional<std::string> m_title;
+
+    //
+    // Flag for interpreting timestamps as UTC.
+    //
+    bool m_utc_enabled = true;
+
+};
+
+//
+// Determines whether an index block may contain records matching the query.
+//
+auto
+block_may_match(
+    const echo::segment_index_block& p_block,
+    const query_filters& p_query,
+    const std::uint64_t p_title_bitmap) -> bool
+{
+    return p_block.m_max_timestamp_ns >= p_query.m_from_timestamp_ns &&
+        p_block.m_min_timestamp_ns <= p_query.m_to_timestamp_ns &&
+        (p_block.m_level_bitmap & p_query.m_level_bitmap) != 0u &&
+        (p_block.m_title_bitmap & p_title_bitmap) == p_title_bitmap;
+}
+
+//
+// Appends the records of a segment range that match the query to the output.
+//
+auto
+scan_range(
+    const std::string_view p_range,
+    const query_filters& p_query,
+    std::string& p_output) -> void
+{
+    std::size_t line_begin = 0u;
+
+    while (line_begin < p_range.size())
+    {
+        std::size_t line_end = p_range.find('\n', line_begin);
+        line_end = line_end == std::string_view::npos ? p_range.size() : line_end + 1u;
+
+        const std::string_view line = p_range.substr(line_begin, line_end - line_begin);
+        line_begin = line_end;
+
+        const std::optional<echo::log_record_view> record = echo::parse_log_record(line);
+
+        if (!record.has_value() ||
+            (p_query.m_level_bitmap & (1u << static_cast<std::uint8_t>(record->m_log_level))) == 0u ||
+            (p_query.m_title.has_value() && record->m_title != p_query.m_title.value()))
+        {
+            continue;
+        }
+
+        const std::optional<std::uint64_t> timestamp_ns = echo::string_to_timestamp(
+            record->m_timestamp,
+            p_query.m_utc_enabled);
+
+        if (!timestamp_ns.has_value() ||
+            timestamp_ns.value() < p_query.m_from_timestamp_ns ||
+            timestamp_ns.value() > p_query.m_to_timestamp_ns)
+        {
+            continue;
+        }
+
+        p_output.append(line);
+
+        if (!line.ends_with('\n'))
+        {
+            p_output.push_back('\n');
+        }
+    }
+}
+
+//
+// Runs the query over a single segment, reading only the indexed blocks that may match
+// plus any trailing range that the index does not cover yet.
+//
+auto
+query_segment(
+    const std::filesystem::path& p_segment_path,
+    const query_filters& p_query) -> std::string
+{
+    std::string output;
+
+    const int file_descriptor = open(p_segment_path.c_str(), O_RDONLY);
+
+    if (file_descriptor == -1)
+    {
+        return output;
+    }
+
+    struct stat file_status {};
+
+    if (fstat(file_descriptor, &file_status) == -1 ||
+        file_status.st_size == 0)
+    {
+        close(file_descriptor);
+
+        return output;
+    }
+
+    const std::size_t file_size = static_cast<std::size_t>(file_status.st_size);
+    void* mapping = mmap(nullptr, file_size, PROT_READ, MAP_PRIVATE, file_descriptor, 0);
+    close(file_descriptor);
+
+    if (mapping == MAP_FAILED)
+    {
+        return output;
+    }
+
+    const std::string_view segment {static_cast<const char*>(mapping), file_size};
+    const std::optional<std::vector<echo::segment_index_block>> blocks = echo::segment_index::read_blocks(p_segment_path);
+    const std::uint64_t title_bitmap = p_query.m_title.has_value() ?
+        echo::segment_index::get_title_bitmap(p_query.m_title->c_str()) :
+        0u;
+    std::size_t indexed_end = 0u;
+
+    if (blocks.has_value())
+    {
+        for (const echo::segment_index_block& block : blocks.value())
+        {
+            if (block.m_offset_bytes + block.m_size_bytes > file_size)
+            {
+                break;
+            }
+
+            if (block.m_offset_bytes > indexed_end)
+            {
+                //
+                // Range whose index entry was lost; it cannot be skipped.
+                //
+                scan_range(segment.substr(indexed_end, block.m_offset_bytes - indexed_end), p_query, output);
+            }
+
+            indexed_end = block.m_offset_bytes + block.m_size_bytes;
+
+            if (block_may_match(block, p_query, title_bitmap))
+            {
+                madvise(
+                    static_cast<char*>(mapping) + (block.m_offset_bytes & ~static_cast<std::uint64_t>(getpagesize() - 1)),
+                    block.m_size_bytes + (block.m_offset_bytes & static_cast<std::uint64_t>(getpagesize() - 1)),
+                    MADV_WILLNEED);
+
+                scan_range(
+                    segment.substr(block.m_offset_bytes, block.m_size_bytes),
+                    p_query,
+                    output);
+            }
+        }
+    }
+
+    //
+    // Records written after the last index entry, or segments written without an index.
+    //
+    scan_range(segment.substr(indexed_end), p_query, output);
+
+    munmap(mapping, file_size);
+
+    return output;
+}
+
+//
+// Parses a timestamp argument, either as nanoseconds since the epoch or as a calendar timestamp.
+//
+auto
+parse_timestamp_argument(
+    const std::string& p_argument,
+    const bool p_utc_enabled) -> std::optional<std::uint64_t>
+{
+    if (!p_argument.empty() &&
+        p_argument.find_first_not_of("0123456789") == std::string::npos)
+    {
+        return std::stoull(p_argument);
+    }
+
+    return echo::string_to_timestamp(p_argument, p_utc_enabled);
+}
+
+auto
+print_usage(
+    const char* p_program_name) -> void
+{
+    std::cerr << "Usage: " << p_program_name << " <logging_session_directory_path>"
+        << " [--from <timestamp>] [--to <timestamp>] [--level <level>]..."
+        << " [--title <title>] [--local-time] [--threads <count>]\n"
+        << "Timestamps are 'YYYY-MM-DD HH:MM:SS[.ffffff]' or nanoseconds since the epoch.\n";
+}
+
+} // namespace.
+
+//
+// Prints the records of a logging session that match a time range, levels and/or a title.
+//
+int main(int argc, char** argv)
+{
+    if (argc < 2)
+    {
+        print_usage(argv[0]);
+
+        return 1;
+    }
+
+    query_filters query;
+    std::optional<std::string> from_argument;
+    std::optional<std::string> to_argument;
+    std::uint32_t level_bitmap = 0u;
+    std::uint32_t threads_count = std::max(1u, std::thread::hardware_concurrency());
+
+    for (int index = 2; index < argc; ++index)
+    {
+        const std::string_view option = argv[index];
+
+        if (option == "--local-time")
+        {
+            query.m_utc_enabled = false;
+
+            continue;
+        }
+
+        if (index + 1 >= argc)
+        {
+            print_usage(argv[0]);
+
+            return 1;
+        }
+
+        const std::string value = argv[++index];
+
+        if (option == "--from")
+        {
+            from_argument = value;
+        }
+        else if (option == "--to")
+        {
+            to_argument = value;
+        }
+        else if (option == "--level")
+        {
+            //
+            // Accept any casing, e.g. 'error' for the rendered 'Error'.
+            //
+            std::string level_name = value;
+            std::transform(level_name.begin(), level_name.end(), level_name.begin(), [](unsigned char p_character) { return std::tolower(p_character); });
+            if (!level_name.empty())
+            {
+                level_name[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(level_name[0])));
+            }
+
+            const std::optional<echo::log_level> level = echo::string_to_log_level(level_name);
+
+            if (!level.has_value())
+            {
+                std::cerr << "Unknown level '" << value << "'.\n";
+
+                return 1;
+            }
+
+            level_bitmap |= 1u << static_cast<std::uint8_t>(level.value());
+        }
+        else if (option == "--title")
+        {
+            query.m_title = value;
+        }
+        else if (option == "--threads")
+        {
+            threads_count = std::max(1u, static_cast<std::uint32_t>(std::stoul(value)));
+        }
+        else
+        {
+            print_usage(argv[0]);
+
+            return 1;
+        }
+    }
+
+    if (level_bitmap != 0u)
+    {
+        query.m_level_bitmap = level_bitmap;
+    }
+
+    for (auto [argument, bound] : {std::pair{&from_argument, &query.m_from_timestamp_ns}, std::pair{&to_argument, &query.m_to_timestamp_ns}})
+    {
+        if (!argument->has_value())
+        {
+            continue;
+        }
+
+        const std::optional<std::uint64_t> timestamp_ns = parse_timestamp_argument(argument->value(), query.m_utc_enabled);
+
+        if (!timestamp_ns.has_value())
+        {
+            std::cerr << "Invalid timestamp '" << argument->value() << "'.\n";
+
+            return 1;
+        }
+
+        *bound = timestamp_ns.value();
+    }
+
+    const std::vector<std::filesystem::path> segment_paths = echo::get_segment_paths(argv[1]);
+    std::vector<std::string> results(segment_paths.size());
+    std::atomic<std::size_t> next_segment {0u};
+    std::vector<std::thread> workers;
+
+    //
+    // Segments are independent; scan them in parallel and print the results in segment order.
+    //
+    for (std::uint32_t worker = 0u; worker < std::min<std::size_t>(threads_count, segment_paths.size()); ++worker)
+    {
+        workers.emplace_back([&]()
+        {
+            for (std::size_t segment = next_segment++; segment < segment_paths.size(); segment = next_segment++)
+            {
+                results[segment] = query_segment(segment_paths[segment], query);
+            }
+        });
+    }
+
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+
+    for (const std::string& result : results)
+    {
+        std::cout << result;
+    }
+}
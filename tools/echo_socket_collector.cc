@@ -0,0 +1,65 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Tools
+// 'echo_socket_collector.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <chrono>
+#include <csignal>
+#include <iostream>
+#include <thread>
+#include "../src/logger/socket_log_collector.hh"
+
+namespace
+{
+
+//
+// Flag set by the termination signal handler.
+//
+volatile std::sig_atomic_t g_termination_requested = 0;
+
+auto
+handle_termination_signal(
+    [[maybe_unused]] int p_signal) -> void
+{
+    g_termination_requested = 1;
+}
+
+} // namespace.
+
+//
+// Reference collector for the socket log shipping sink. Receives the batches shipped by
+// every process configured with the given socket and writes each logging session into
+// the standard segment layout under the logs directory, readable by echo_query and echo_merge.
+// Usage: echo_socket_collector <socket_path> <logs_directory_path>
+//
+int main(int argc, char** argv)
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: " << argv[0] << " <socket_path> <logs_directory_path>\n";
+
+        return 1;
+    }
+
+    std::signal(SIGINT, handle_termination_signal);
+    std::signal(SIGTERM, handle_termination_signal);
+
+    echo::socket_log_collector collector {argv[1], argv[2]};
+
+    std::cout << "Collecting from " << argv[1] << " into " << argv[2] << "\n";
+
+    std::thread collection_thread {&echo::socket_log_collector::run, &collector};
+
+    while (g_termination_requested == 0)
+    {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }
+
+    collector.stop();
+    collection_thread.join();
+
+    std::cout << "Collected " << collector.get_collected_records_count() << " records.\n";
+}
@@ -0,0 +1,1130 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Tools
+// 'echo_stress.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <charconv>
+#include <iostream>
+#include <optional>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <algorithm>
+#include <filesystem>
+#include <string_view>
+#include "../src/logger/logger.hh"
+#include "../src/logger/segment_reader.hh"
+
+namespace
+{
+
+//
+// Load and logger settings of a stress run.
+//
+struct stress_options
+{
+
+    //
+    // Duration of the load in seconds.
+    //
+    std::uint32_t m_duration_s = 10u;
+
+    //
+    // Count of producer threads.
+    //
+    std::uint32_t m_threads_count = 4u;
+
+    //
+    // Records per second per thread. Zero runs unthrottled.
+    //
+    std::uint32_t m_rate_per_thread = 0u;
+
+    //
+    // Bounds of the uniformly distributed payload size in bytes.
+    //
+    std::uint32_t m_min_message_size_bytes = 16u;
+
+    std::uint32_t m_max_message_size_bytes = 256u;
+
+    //
+    // Relative weight of each level, indexed by level.
+    //
+    std::array<std::uint32_t, 4u> m_level_weights = {70u, 20u, 8u, 2u};
+
+    //
+    // Interval in seconds between progress reports.
+    //
+    std::uint32_t m_report_interval_s = 1u;
+
+    //
+    // Directory for the logs. A temporary directory is used and removed if not set.
+    //
+    std::optional<std::filesystem::path> m_logs_directory_path;
+
+    //
+    // Logger modes under test.
+    //
+    bool m_sharded_mode_enabled = false;
+
+    bool m_direct_io_enabled = false;
+
+    bool m_segment_index_enabled = true;
+
+    bool m_async_mode_enabled = false;
+
+    //
+    // Level at and above which each record waits for a sync covering it. Unset keeps every record buffered.
+    //
+    std::optional<echo::log_level> m_durable_log_level;
+
+    //
+    // Count of shards in sharded mode. Zero creates one per CPU core.
+    //
+    std::uint32_t m_shards_count = 0u;
+
+    //
+    // Shard counts of a scaling run; the load runs once per count, in sharded mode.
+    //
+    std::vector<std::uint32_t> m_swept_shards_counts;
+
+    //
+    // Runs the load once with buffered writes and once with direct I/O to compare their page cache footprint.
+    //
+    bool m_page_cache_comparison_enabled = false;
+
+};
+
+//
+// Latency histogram with 16 linear sub-buckets per power of two of nanoseconds.
+// Written by a single producer thread and merged once the load stops.
+//
+class latency_histogram
+{
+
+public:
+
+    auto
+    record(
+        const std::uint64_t p_latency_ns) -> void
+    {
+        ++m_buckets[get_bucket_index(p_latency_ns)];
+        ++m_samples_count;
+        m_max_latency_ns = std::max(m_max_latency_ns, p_latency_ns);
+    }
+
+    auto
+    merge(
+        const latency_histogram& p_other) -> void
+    {
+        for (std::size_t bucket_index = 0u; bucket_index < c_buckets_count; ++bucket_index)
+        {
+            m_buckets[bucket_index] += p_other.m_buckets[bucket_index];
+        }
+
+        m_samples_count += p_other.m_samples_count;
+        m_max_latency_ns = std::max(m_max_latency_ns, p_other.m_max_latency_ns);
+    }
+
+    //
+    // Gets the upper bound of the bucket holding the given percentile.
+    //
+    auto
+    get_percentile_ns(
+        const double p_percentile) const -> std::uint64_t
+    {
+        const std::uint64_t target_samples_count = static_cast<std::uint64_t>(p_percentile / 100.0 * static_cast<double>(m_samples_count));
+        std::uint64_t samples_count = 0u;
+
+        for (std::size_t bucket_index = 0u; bucket_index < c_buckets_count; ++bucket_index)
+        {
+            samples_count += m_buckets[bucket_index];
+
+            if (samples_count > target_samples_count)
+            {
+                return std::min(get_bucket_upper_bound_ns(bucket_index), m_max_latency_ns);
+            }
+        }
+
+        return m_max_latency_ns;
+    }
+
+    auto
+    get_max_latency_ns() const -> std::uint64_t
+    {
+        return m_max_latency_ns;
+    }
+
+    auto
+    get_samples_count() const -> std::uint64_t
+    {
+        return m_samples_count;
+    }
+
+private:
+
+    static constexpr std::size_t c_sub_buckets_count = 16u;
+
+    static constexpr std::size_t c_buckets_count = 64u * c_sub_buckets_count;
+
+    static
+    auto
+    get_bucket_index(
+        const std::uint64_t p_latency_ns) -> std::size_t
+    {
+        if (p_latency_ns < c_sub_buckets_count)
+        {
+            return static_cast<std::size_t>(p_latency_ns);
+        }
+
+        const std::size_t magnitude = 63u - static_cast<std::size_t>(__builtin_clzll(p_latency_ns));
+        const std::size_t sub_bucket = static_cast<std::size_t>(p_latency_ns >> (magnitude - 4u)) & (c_sub_buckets_count - 1u);
+
+        return (magnitude - 3u) * c_sub_buckets_count + sub_bucket;
+    }
+
+    static
+    auto
+    get_bucket_upper_bound_ns(
+        const std::size_t p_bucket_index) -> std::uint64_t
+    {
+        if (p_bucket_index < c_sub_buckets_count)
+        {
+            return p_bucket_index;
+        }
+
+        const std::size_t magnitude = p_bucket_index / c_sub_buckets_count + 3u;
+        const std::uint64_t sub_bucket = p_bucket_index % c_sub_buckets_count;
+
+        return ((c_sub_buckets_count + sub_bucket + 1u) << (magnitude - 4u)) - 1u;
+    }
+
+    std::array<std::uint64_t, c_buckets_count> m_buckets {};
+
+    std::uint64_t m_samples_count = 0u;
+
+    std::uint64_t m_max_latency_ns = 0u;
+
+};
+
+//
+// State of a producer thread.
+//
+struct producer
+{
+
+    //
+    // Count of records logged.
+    //
+    std::atomic<std::uint64_t> m_records_count {0u};
+
+    //
+    // Count of log calls that threw.
+    //
+    std::uint64_t m_failed_records_count = 0u;
+
+    //
+    // Latency of the log calls.
+    //
+    latency_histogram m_latency_histogram;
+
+    //
+    // Latency of the log calls of durable records, including the wait for their sync.
+    //
+    latency_histogram m_durable_latency_histogram;
+
+};
+
+//
+// Outcome of reading the logs back.
+//
+struct verification_result
+{
+
+    std::uint64_t m_records_count = 0u;
+
+    std::uint64_t m_lost_records_count = 0u;
+
+    std::uint64_t m_duplicated_records_count = 0u;
+
+    std::uint64_t m_out_of_order_records_count = 0u;
+
+    std::uint64_t m_malformed_records_count = 0u;
+
+};
+
+//
+// Outcome of a stress run.
+//
+struct stress_result
+{
+
+    std::uint64_t m_records_count = 0u;
+
+    std::uint64_t m_failed_records_count = 0u;
+
+    std::uint64_t m_shed_records_count = 0u;
+
+    latency_histogram m_latency_histogram;
+
+    latency_histogram m_durable_latency_histogram;
+
+    //
+    // Peak growth of the cached and dirty bytes of the system page cache while the load ran.
+    //
+    std::int64_t m_peak_cached_growth_bytes = 0;
+
+    std::int64_t m_peak_dirty_growth_bytes = 0;
+
+    //
+    // Size of the segments written and the part of it left in the page cache.
+    //
+    std::uint64_t m_segments_size_bytes = 0u;
+
+    std::uint64_t m_segments_resident_bytes = 0u;
+
+    verification_result m_verification;
+
+    //
+    // Determines whether every record was accounted for.
+    //
+    auto
+    is_verified() const -> bool
+    {
+        //
+        // Shed records are accounted for by their lane; only unaccounted losses fail the run.
+        //
+        return m_verification.m_lost_records_count == m_shed_records_count &&
+            m_verification.m_duplicated_records_count == 0u &&
+            m_verification.m_out_of_order_records_count == 0u &&
+            m_verification.m_malformed_records_count == 0u;
+    }
+
+};
+
+//
+// Title of the records produced by the stress run.
+//
+constexpr const char* c_stress_title = "Stress";
+
+//
+// Gets the resident set size of the process in bytes.
+//
+auto
+get_resident_set_size_bytes() -> std::uint64_t
+{
+    std::ifstream statm {"/proc/self/statm"};
+    std::uint64_t total_pages = 0u;
+    std::uint64_t resident_pages = 0u;
+
+    statm >> total_pages >> resident_pages;
+
+    return resident_pages * static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+}
+
+//
+// Page cache counters of the system in bytes, as reported by /proc/meminfo.
+//
+struct page_cache_sample
+{
+
+    std::uint64_t m_cached_bytes = 0u;
+
+    std::uint64_t m_dirty_bytes = 0u;
+
+};
+
+auto
+get_page_cache_sample() -> page_cache_sample
+{
+    std::ifstream meminfo {"/proc/meminfo"};
+    page_cache_sample sample;
+    std::string field;
+    std::string unit;
+    std::uint64_t value_kib = 0u;
+
+    while (meminfo >> field >> value_kib)
+    {
+        std::getline(meminfo, unit);
+
+        if (field == "Cached:")
+        {
+            sample.m_cached_bytes = value_kib * 1024u;
+        }
+        else if (field == "Dirty:")
+        {
+            sample.m_dirty_bytes = value_kib * 1024u;
+        }
+    }
+
+    return sample;
+}
+
+//
+// Gets the size of a file and the part of it resident in the page cache, in bytes.
+//
+auto
+get_file_residency_bytes(
+    const std::filesystem::path& p_file_path,
+    std::uint64_t& p_resident_bytes) -> std::uint64_t
+{
+    p_resident_bytes = 0u;
+
+    const int file_descriptor = open(p_file_path.c_str(), O_RDONLY | O_CLOEXEC);
+
+    if (file_descriptor == -1)
+    {
+        return 0u;
+    }
+
+    std::error_code error_code;
+    const std::uint64_t size_bytes = std::filesystem::file_size(p_file_path, error_code);
+
+    if (error_code || size_bytes == 0u)
+    {
+        close(file_descriptor);
+
+        return 0u;
+    }
+
+    //
+    // Mapping the file does not fault its pages in; mincore only reports those already cached.
+    //
+    void* const mapping = mmap(nullptr, size_bytes, PROT_READ, MAP_SHARED, file_descriptor, 0);
+    close(file_descriptor);
+
+    if (mapping == MAP_FAILED)
+    {
+        return size_bytes;
+    }
+
+    const std::uint64_t page_size_bytes = static_cast<std::uint64_t>(sysconf(_SC_PAGESIZE));
+    std::vector<unsigned char> resident_pages((size_bytes + page_size_bytes - 1u) / page_size_bytes);
+
+    if (mincore(mapping, size_bytes, resident_pages.data()) == 0)
+    {
+        for (std::size_t page_index = 0u; page_index < resident_pages.size(); ++page_index)
+        {
+            if ((resident_pages[page_index] & 1u) != 0u)
+            {
+                p_resident_bytes += std::min(page_size_bytes, size_bytes - page_index * page_size_bytes);
+            }
+        }
+    }
+
+    munmap(mapping, size_bytes);
+
+    return size_bytes;
+}
+
+//
+// Logs records at the configured rate until the stop flag is set.
+//
+auto
+run_producer(
+    const std::uint32_t p_thread_index,
+    const stress_options& p_options,
+    const std::string& p_payload,
+    const std::atomic<bool>& p_stop_requested,
+    producer& p_producer) -> void
+{
+    std::mt19937_64 random_engine {p_thread_index + 1u};
+    std::uniform_int_distribution<std::uint32_t> size_distribution {p_options.m_min_message_size_bytes, p_options.m_max_message_size_bytes};
+    std::discrete_distribution<std::uint32_t> level_distribution {p_options.m_level_weights.begin(), p_options.m_level_weights.end()};
+    const std::chrono::nanoseconds interval {p_options.m_rate_per_thread != 0u ? 1'000'000'000u / p_options.m_rate_per_thread : 0u};
+    std::chrono::steady_clock::time_point next_record_time = std::chrono::steady_clock::now();
+    std::uint64_t record_number = 0u;
+
+    while (!p_stop_requested.load(std::memory_order_relaxed))
+    {
+        if (interval.count() != 0)
+        {
+            std::this_thread::sleep_until(next_record_time);
+            next_record_time += interval;
+        }
+
+        const std::string_view payload {p_payload.data(), size_distribution(random_engine)};
+        const echo::log_level level = static_cast<echo::log_level>(level_distribution(random_engine));
+        const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+        try
+        {
+            echo::logger::log(level, c_stress_title, "t={} n={} {}", p_thread_index, record_number, payload);
+        }
+        catch (const std::exception& p_exception)
+        {
+            ++p_producer.m_failed_records_count;
+        }
+
+        const std::uint64_t latency_ns = static_cast<std::uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start_time).count());
+
+        p_producer.m_latency_histogram.record(latency_ns);
+
+        if (p_options.m_durable_log_level.has_value() &&
+            level >= p_options.m_durable_log_level.value())
+        {
+            p_producer.m_durable_latency_histogram.record(latency_ns);
+        }
+
+        ++record_number;
+        p_producer.m_records_count.store(record_number, std::memory_order_relaxed);
+    }
+}
+
+//
+// Reports the percentiles of a latency histogram on one line.
+//
+auto
+print_latency(
+    const std::string_view p_label,
+    const latency_histogram& p_latency_histogram) -> void
+{
+    std::cout << p_label
+        << " p50=" << p_latency_histogram.get_percentile_ns(50.0) << "ns"
+        << " p90=" << p_latency_histogram.get_percentile_ns(90.0) << "ns"
+        << " p99=" << p_latency_histogram.get_percentile_ns(99.0) << "ns"
+        << " p99.9=" << p_latency_histogram.get_percentile_ns(99.9) << "ns"
+        << " max=" << p_latency_histogram.get_max_latency_ns() << "ns\n";
+}
+
+//
+// Reads every segment back and checks that each record of each thread appears exactly
+// once and in order within its stream. Async mode only keeps the order within a priority lane.
+//
+auto
+verify_logs(
+    const std::filesystem::path& p_logs_directory_path,
+    const std::vector<std::uint64_t>& p_produced_records_counts,
+    const bool p_async_mode_enabled) -> verification_result
+{
+    verification_result result;
+    std::vector<std::vector<bool>> seen_records(p_produced_records_counts.size());
+
+    for (std::size_t thread_index = 0u; thread_index < p_produced_records_counts.size(); ++thread_index)
+    {
+        seen_records[thread_index].resize(p_produced_records_counts[thread_index], false);
+    }
+
+    for (const std::filesystem::directory_entry& session_directory : std::filesystem::directory_iterator(p_logs_directory_path))
+    {
+        if (!session_directory.is_directory())
+        {
+            continue;
+        }
+
+        std::string current_stream;
+        std::vector<std::array<std::optional<std::uint64_t>, echo::c_priority_lanes_count>> last_record_numbers;
+
+        for (const std::filesystem::path& segment_path : echo::get_segment_paths(session_directory.path()))
+        {
+            //
+            // Segments come ordered by stream, then by count; order only holds within a stream.
+            //
+            const std::string stem = segment_path.stem().string();
+            const std::string stream = stem.substr(0u, stem.rfind('_'));
+
+            if (stream != current_stream)
+            {
+                current_stream = stream;
+                last_record_numbers.assign(p_produced_records_counts.size(), {});
+            }
+
+            std::ifstream segment {segment_path, std::ios::binary};
+            std::string line;
+
+            while (std::getline(segment, line))
+            {
+                const std::optional<echo::log_record_view> record = echo::parse_log_record(line);
+                std::uint32_t thread_index = 0u;
+                std::uint64_t record_number = 0u;
+
+                if (!record.has_value() ||
+                    record->m_title != c_stress_title)
+                {
+                    ++result.m_malformed_records_count;
+
+                    continue;
+                }
+
+                const std::string_view message = record->m_message;
+                const std::size_t record_number_begin = message.find(" n=");
+
+                if (!message.starts_with("t=") ||
+                    record_number_begin == std::string_view::npos ||
+                    std::from_chars(message.data() + 2u, message.data() + record_number_begin, thread_index).ec != std::errc{} ||
+                    std::from_chars(message.data() + record_number_begin + 3u, message.data() + message.size(), record_number).ec != std::errc{} ||
+                    thread_index >= seen_records.size() ||
+                    record_number >= seen_records[thread_index].size())
+                {
+                    ++result.m_malformed_records_count;
+
+                    continue;
+                }
+
+                ++result.m_records_count;
+
+                if (seen_records[thread_index][record_number])
+                {
+                    ++result.m_duplicated_records_count;
+                }
+
+                seen_records[thread_index][record_number] = true;
+
+                std::optional<std::uint64_t>& last_record_number = last_record_numbers[thread_index][
+                    p_async_mode_enabled ? static_cast<std::size_t>(echo::get_priority_lane(record->m_log_level)) : 0u];
+
+                if (last_record_number.has_value() &&
+                    record_number <= last_record_number.value())
+                {
+                    ++result.m_out_of_order_records_count;
+                }
+
+                last_record_number = record_number;
+            }
+        }
+    }
+
+    for (const std::vector<bool>& thread_seen_records : seen_records)
+    {
+        result.m_lost_records_count += static_cast<std::uint64_t>(std::count(thread_seen_records.begin(), thread_seen_records.end(), false));
+    }
+
+    return result;
+}
+
+//
+// Runs the load against a logger initialized for it in the given directory, reports its
+// progress and outcome, and reads the logs back.
+//
+auto
+run_stress(
+    const stress_options& p_options,
+    const std::filesystem::path& p_logs_directory_path) -> stress_result
+{
+    std::filesystem::create_directories(p_logs_directory_path);
+
+    echo::logger_configuration configuration;
+    configuration.debug_mode_enabled = false;
+    configuration.component_name = "echo_stress";
+    configuration.logs_directory_path = p_logs_directory_path;
+    configuration.sharded_mode_enabled = p_options.m_sharded_mode_enabled;
+    configuration.shards_count = p_options.m_shards_count;
+    configuration.async_mode_enabled = p_options.m_async_mode_enabled;
+    configuration.direct_io_enabled = p_options.m_direct_io_enabled;
+    configuration.segment_index_enabled = p_options.m_segment_index_enabled;
+    configuration.durable_log_level = p_options.m_durable_log_level;
+
+    echo::logger::initialize(&configuration);
+
+    std::string payload(p_options.m_max_message_size_bytes, '\0');
+
+    for (std::size_t index = 0u; index < payload.size(); ++index)
+    {
+        payload[index] = static_cast<char>('a' + index % 26u);
+    }
+
+    stress_result result;
+    const page_cache_sample initial_page_cache_sample = get_page_cache_sample();
+    std::vector<producer> producers(p_options.m_threads_count);
+    std::vector<std::thread> producer_threads;
+    std::atomic<bool> stop_requested {false};
+    const std::chrono::steady_clock::time_point start_time = std::chrono::steady_clock::now();
+
+    for (std::uint32_t thread_index = 0u; thread_index < p_options.m_threads_count; ++thread_index)
+    {
+        producer_threads.emplace_back(
+            run_producer,
+            thread_index,
+            std::cref(p_options),
+            std::cref(payload),
+            std::cref(stop_requested),
+            std::ref(producers[thread_index]));
+    }
+
+    std::uint64_t previous_records_count = 0u;
+
+    for (std::uint32_t elapsed_s = 0u; elapsed_s < p_options.m_duration_s; )
+    {
+        const std::uint32_t report_interval_s = std::min(p_options.m_report_interval_s, p_options.m_duration_s - elapsed_s);
+        std::this_thread::sleep_until(start_time + std::chrono::seconds(elapsed_s + report_interval_s));
+        elapsed_s += report_interval_s;
+
+        std::uint64_t records_count = 0u;
+
+        for (const producer& current_producer : producers)
+        {
+            records_count += current_producer.m_records_count.load(std::memory_order_relaxed);
+        }
+
+        //
+        // Other processes move the system counters too; runs on a quiet host compare best.
+        //
+        const page_cache_sample page_cache_sample = get_page_cache_sample();
+        const std::int64_t cached_growth_bytes =
+            static_cast<std::int64_t>(page_cache_sample.m_cached_bytes) - static_cast<std::int64_t>(initial_page_cache_sample.m_cached_bytes);
+        const std::int64_t dirty_growth_bytes =
+            static_cast<std::int64_t>(page_cache_sample.m_dirty_bytes) - static_cast<std::int64_t>(initial_page_cache_sample.m_dirty_bytes);
+
+        result.m_peak_cached_growth_bytes = std::max(result.m_peak_cached_growth_bytes, cached_growth_bytes);
+        result.m_peak_dirty_growth_bytes = std::max(result.m_peak_dirty_growth_bytes, dirty_growth_bytes);
+
+        std::cout << "t=" << elapsed_s << "s records=" << records_count
+            << " rate=" << (records_count - previous_records_count) / report_interval_s << "/s"
+            << " rss=" << get_resident_set_size_bytes() / 1024u << "KiB"
+            << " cached=" << (cached_growth_bytes >= 0 ? "+" : "") << cached_growth_bytes / 1024 << "KiB"
+            << " dirty=" << (dirty_growth_bytes >= 0 ? "+" : "") << dirty_growth_bytes / 1024 << "KiB\n" << std::flush;
+
+        previous_records_count = records_count;
+    }
+
+    stop_requested.store(true, std::memory_order_relaxed);
+
+    for (std::thread& producer_thread : producer_threads)
+    {
+        producer_thread.join();
+    }
+
+    //
+    // Lane counters are read once every queued record is written out; shutting down
+    // hands the records buffered by the other modes over to the filesystem.
+    //
+    echo::logger::flush();
+
+    const std::array<echo::priority_lane_statistics, echo::c_priority_lanes_count> lane_statistics =
+        echo::logger::get_priority_lane_statistics();
+
+    echo::logger::shutdown();
+
+    std::vector<std::uint64_t> produced_records_counts;
+
+    for (const producer& current_producer : producers)
+    {
+        result.m_latency_histogram.merge(current_producer.m_latency_histogram);
+        result.m_durable_latency_histogram.merge(current_producer.m_durable_latency_histogram);
+        produced_records_counts.push_back(current_producer.m_records_count.load(std::memory_order_relaxed));
+        result.m_records_count += produced_records_counts.back();
+        result.m_failed_records_count += current_producer.m_failed_records_count;
+    }
+
+    print_latency("latency", result.m_latency_histogram);
+
+    if (p_options.m_durable_log_level.has_value())
+    {
+        //
+        // Durable records share their syncs; the wait reflects the group commit under the mixed load.
+        //
+        std::cout << "durable records=" << result.m_durable_latency_histogram.get_samples_count()
+            << " rate=" << result.m_durable_latency_histogram.get_samples_count() / std::max(p_options.m_duration_s, 1u) << "/s"
+            << " total_rate=" << result.m_records_count / std::max(p_options.m_duration_s, 1u) << "/s\n";
+
+        print_latency("durable latency", result.m_durable_latency_histogram);
+    }
+
+    if (p_options.m_async_mode_enabled)
+    {
+        constexpr std::array<std::string_view, echo::c_priority_lanes_count> lane_names = {"urgent", "warning", "info"};
+
+        for (std::size_t lane_index = 0u; lane_index < echo::c_priority_lanes_count; ++lane_index)
+        {
+            const echo::priority_lane_statistics& statistics = lane_statistics[lane_index];
+
+            std::cout << "lane " << lane_names[lane_index]
+                << " written=" << statistics.m_written_records_count
+                << " shed=" << statistics.m_shed_records_count
+                << " mean_delay=" << (statistics.m_written_records_count != 0u ? statistics.m_total_latency_ns / statistics.m_written_records_count : 0u) << "ns"
+                << " max_delay=" << statistics.m_max_latency_ns << "ns\n";
+
+            result.m_shed_records_count += statistics.m_shed_records_count;
+        }
+    }
+
+    //
+    // Residency is measured before the logs are read back, which pulls them into the page cache.
+    //
+    for (const std::filesystem::directory_entry& session_directory : std::filesystem::directory_iterator(p_logs_directory_path))
+    {
+        if (!session_directory.is_directory())
+        {
+            continue;
+        }
+
+        for (const std::filesystem::path& segment_path : echo::get_segment_paths(session_directory.path()))
+        {
+            std::uint64_t resident_bytes = 0u;
+
+            result.m_segments_size_bytes += get_file_residency_bytes(segment_path, resident_bytes);
+            result.m_segments_resident_bytes += resident_bytes;
+        }
+    }
+
+    std::cout << "page_cache peak_cached_growth=" << result.m_peak_cached_growth_bytes / 1024 << "KiB"
+        << " peak_dirty_growth=" << result.m_peak_dirty_growth_bytes / 1024 << "KiB"
+        << " segments=" << result.m_segments_size_bytes / 1024u << "KiB"
+        << " resident=" << result.m_segments_resident_bytes / 1024u << "KiB\n";
+
+    result.m_verification = verify_logs(p_logs_directory_path, produced_records_counts, p_options.m_async_mode_enabled);
+
+    std::cout << "verified records=" << result.m_verification.m_records_count
+        << " lost=" << result.m_verification.m_lost_records_count
+        << " duplicated=" << result.m_verification.m_duplicated_records_count
+        << " out_of_order=" << result.m_verification.m_out_of_order_records_count
+        << " malformed=" << result.m_verification.m_malformed_records_count
+        << " shed=" << result.m_shed_records_count
+        << " failed_calls=" << result.m_failed_records_count << "\n";
+
+    return result;
+}
+
+//
+// Parses a comma-separated list of counts such as '1,2,4,8'.
+//
+auto
+parse_counts(
+    const std::string& p_argument) -> std::optional<std::vector<std::uint32_t>>
+{
+    std::vector<std::uint32_t> counts;
+    std::string_view remaining_argument = p_argument;
+
+    while (!remaining_argument.empty())
+    {
+        const std::size_t entry_end = std::min(remaining_argument.find(','), remaining_argument.size());
+        std::uint32_t count = 0u;
+
+        if (std::from_chars(remaining_argument.data(), remaining_argument.data() + entry_end, count).ec != std::errc{} ||
+            count == 0u)
+        {
+            return std::nullopt;
+        }
+
+        counts.push_back(count);
+        remaining_argument.remove_prefix(std::min(entry_end + 1u, remaining_argument.size()));
+    }
+
+    if (counts.empty())
+    {
+        return std::nullopt;
+    }
+
+    return counts;
+}
+
+//
+// Names of the levels, indexed by level.
+//
+constexpr std::array<std::string_view, 4u> c_level_names = {"info", "warning", "error", "critical"};
+
+//
+// Parses a level name such as 'critical'.
+//
+auto
+parse_log_level(
+    const std::string_view p_argument) -> std::optional<echo::log_level>
+{
+    const auto level_name = std::find(c_level_names.begin(), c_level_names.end(), p_argument);
+
+    if (level_name == c_level_names.end())
+    {
+        return std::nullopt;
+    }
+
+    return static_cast<echo::log_level>(level_name - c_level_names.begin());
+}
+
+//
+// Parses a level mix such as 'info=70,warning=20,error=8,critical=2'.
+//
+auto
+parse_level_weights(
+    const std::string& p_argument) -> std::optional<std::array<std::uint32_t, 4u>>
+{
+    std::array<std::uint32_t, 4u> level_weights {};
+    std::string_view remaining_argument = p_argument;
+
+    while (!remaining_argument.empty())
+    {
+        const std::size_t entry_end = std::min(remaining_argument.find(','), remaining_argument.size());
+        const std::string_view entry = remaining_argument.substr(0u, entry_end);
+        const std::size_t separator = entry.find('=');
+        remaining_argument.remove_prefix(std::min(entry_end + 1u, remaining_argument.size()));
+
+        const std::optional<echo::log_level> level = parse_log_level(entry.substr(0u, separator));
+
+        if (separator == std::string_view::npos ||
+            !level.has_value() ||
+            std::from_chars(entry.data() + separator + 1u, entry.data() + entry.size(), level_weights[static_cast<std::size_t>(level.value())]).ec != std::errc{})
+        {
+            return std::nullopt;
+        }
+    }
+
+    if (std::all_of(level_weights.begin(), level_weights.end(), [](const std::uint32_t p_weight) { return p_weight == 0u; }))
+    {
+        return std::nullopt;
+    }
+
+    return level_weights;
+}
+
+auto
+print_usage(
+    const char* p_program_name) -> void
+{
+    std::cerr << "Usage: " << p_program_name
+        << " [--duration <seconds>] [--threads <count>] [--rate <records_per_second_per_thread>]"
+        << " [--min-size <bytes>] [--max-size <bytes>] [--levels <info=70,warning=20,error=8,critical=2>]"
+        << " [--report-interval <seconds>] [--directory <path>] [--sharded] [--async] [--direct-io] [--no-index]"
+        << " [--shards <count>] [--shards-sweep <count,count,...>] [--durable <info|warning|error|critical>]"
+        << " [--page-cache-comparison]\n";
+}
+
+} // namespace.
+
+//
+// Drives a configurable load against the logger for a set duration, reporting throughput and
+// RSS over time, then reads every segment back to verify that no records were lost or
+// duplicated and that each thread's records are in order. A shards sweep repeats the run in
+// sharded mode for every shard count and summarizes how throughput and latency scale.
+// A durable level makes its records wait for a sync, reporting their latency apart. A page
+// cache comparison runs the load with buffered writes and with direct I/O and reports the
+// page cache footprint of each next to its throughput.
+// Exits with 1 if verification fails.
+//
+int main(int argc, char** argv)
+{
+    stress_options options;
+
+    for (int index = 1; index < argc; ++index)
+    {
+        const std::string_view option = argv[index];
+
+        if (option == "--sharded" || option == "--async" || option == "--direct-io" || option == "--no-index" || option == "--page-cache-comparison")
+        {
+            options.m_sharded_mode_enabled |= option == "--sharded";
+            options.m_async_mode_enabled |= option == "--async";
+            options.m_direct_io_enabled |= option == "--direct-io";
+            options.m_segment_index_enabled &= option != "--no-index";
+            options.m_page_cache_comparison_enabled |= option == "--page-cache-comparison";
+
+            continue;
+        }
+
+        if (index + 1 >= argc)
+        {
+            print_usage(argv[0]);
+
+            return 1;
+        }
+
+        const std::string value = argv[++index];
+
+        try
+        {
+            if (option == "--duration")
+            {
+                options.m_duration_s = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else if (option == "--threads")
+            {
+                options.m_threads_count = std::max(1u, static_cast<std::uint32_t>(std::stoul(value)));
+            }
+            else if (option == "--rate")
+            {
+                options.m_rate_per_thread = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else if (option == "--min-size")
+            {
+                options.m_min_message_size_bytes = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else if (option == "--max-size")
+            {
+                options.m_max_message_size_bytes = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else if (option == "--report-interval")
+            {
+                options.m_report_interval_s = std::max(1u, static_cast<std::uint32_t>(std::stoul(value)));
+            }
+            else if (option == "--directory")
+            {
+                options.m_logs_directory_path = value;
+            }
+            else if (option == "--shards")
+            {
+                options.m_shards_count = static_cast<std::uint32_t>(std::stoul(value));
+            }
+            else if (option == "--shards-sweep")
+            {
+                const std::optional<std::vector<std::uint32_t>> shards_counts = parse_counts(value);
+
+                if (!shards_counts.has_value())
+                {
+                    std::cerr << "Invalid shard counts '" << value << "'.\n";
+
+                    return 1;
+                }
+
+                options.m_swept_shards_counts = shards_counts.value();
+            }
+            else if (option == "--durable")
+            {
+                options.m_durable_log_level = parse_log_level(value);
+
+                if (!options.m_durable_log_level.has_value())
+                {
+                    std::cerr << "Invalid durable level '" << value << "'.\n";
+
+                    return 1;
+                }
+            }
+            else if (option == "--levels")
+            {
+                const std::optional<std::array<std::uint32_t, 4u>> level_weights = parse_level_weights(value);
+
+                if (!level_weights.has_value())
+                {
+                    std::cerr << "Invalid level mix '" << value << "'.\n";
+
+                    return 1;
+                }
+
+                options.m_level_weights = level_weights.value();
+            }
+            else
+            {
+                print_usage(argv[0]);
+
+                return 1;
+            }
+        }
+        catch (const std::exception& p_exception)
+        {
+            print_usage(argv[0]);
+
+            return 1;
+        }
+    }
+
+    if (options.m_min_message_size_bytes > options.m_max_message_size_bytes)
+    {
+        std::cerr << "The min size must not exceed the max size.\n";
+
+        return 1;
+    }
+
+    if (options.m_page_cache_comparison_enabled &&
+        !options.m_swept_shards_counts.empty())
+    {
+        std::cerr << "A page cache comparison and a shards sweep cannot be combined.\n";
+
+        return 1;
+    }
+
+    const bool temporary_directory = !options.m_logs_directory_path.has_value();
+    const std::filesystem::path logs_directory_path = options.m_logs_directory_path.value_or(
+        std::filesystem::temp_directory_path() / ("echo_stress-" + std::to_string(getpid())));
+
+    bool verified = true;
+
+    if (options.m_page_cache_comparison_enabled)
+    {
+        std::vector<std::pair<std::string_view, stress_result>> comparison_results;
+
+        for (const bool direct_io_enabled : {false, true})
+        {
+            stress_options comparison_options = options;
+            comparison_options.m_direct_io_enabled = direct_io_enabled;
+
+            //
+            // The dirty pages of the previous run are written back so that both modes start from the same baseline.
+            //
+            sync();
+
+            const std::string_view mode_name = direct_io_enabled ? "direct_io" : "buffered";
+
+            std::cout << "mode=" << mode_name << "\n";
+
+            comparison_results.emplace_back(
+                mode_name,
+                run_stress(comparison_options, logs_directory_path / mode_name));
+        }
+
+        for (const auto& [mode_name, result] : comparison_results)
+        {
+            std::cout << "comparison mode=" << mode_name
+                << " rate=" << result.m_records_count / std::max(options.m_duration_s, 1u) << "/s"
+                << " p99=" << result.m_latency_histogram.get_percentile_ns(99.0) << "ns"
+                << " peak_cached_growth=" << result.m_peak_cached_growth_bytes / 1024 << "KiB"
+                << " peak_dirty_growth=" << result.m_peak_dirty_growth_bytes / 1024 << "KiB"
+                << " segments=" << result.m_segments_size_bytes / 1024u << "KiB"
+                << " resident=" << result.m_segments_resident_bytes / 1024u << "KiB"
+                << " verified=" << (result.is_verified() ? "yes" : "no") << "\n";
+
+            verified = verified && result.is_verified();
+        }
+    }
+    else if (options.m_swept_shards_counts.empty())
+    {
+        verified = run_stress(options, logs_directory_path).is_verified();
+    }
+    else
+    {
+        std::vector<std::pair<std::uint32_t, stress_result>> sweep_results;
+
+        for (const std::uint32_t shards_count : options.m_swept_shards_counts)
+        {
+            stress_options sweep_options = options;
+            sweep_options.m_sharded_mode_enabled = true;
+            sweep_options.m_shards_count = shards_count;
+
+            std::cout << "shards=" << shards_count << "\n";
+
+            sweep_results.emplace_back(
+                shards_count,
+                run_stress(sweep_options, logs_directory_path / ("shards" + std::to_string(shards_count))));
+        }
+
+        //
+        // Throughput and call latency per shard count, relative to the first one.
+        //
+        const double base_rate = static_cast<double>(sweep_results.front().second.m_records_count) / std::max(options.m_duration_s, 1u);
+
+        for (const auto& [shards_count, result] : sweep_results)
+        {
+            const double rate = static_cast<double>(result.m_records_count) / std::max(options.m_duration_s, 1u);
+
+            std::cout << "sweep shards=" << shards_count
+                << " rate=" << static_cast<std::uint64_t>(rate) << "/s"
+                << " speedup=" << (base_rate > 0.0 ? rate / base_rate : 0.0)
+                << " p50=" << result.m_latency_histogram.get_percentile_ns(50.0) << "ns"
+                << " p99=" << result.m_latency_histogram.get_percentile_ns(99.0) << "ns"
+                << " p99.9=" << result.m_latency_histogram.get_percentile_ns(99.9) << "ns";
+
+            if (options.m_durable_log_level.has_value())
+            {
+                std::cout << " durable_p99=" << result.m_durable_latency_histogram.get_percentile_ns(99.0) << "ns";
+            }
+
+            std::cout << " verified=" << (result.is_verified() ? "yes" : "no") << "\n";
+
+            verified = verified && result.is_verified();
+        }
+    }
+
+    if (temporary_directory)
+    {
+        std::filesystem::remove_all(logs_directory_path);
+    }
+
+    return verified ? 0 : 1;
+}
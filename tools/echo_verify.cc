@@ -0,0 +1,398 @@
+// ****************************************************
+// Echo Logger C++ Library
+// Tools
+// 'echo_verify.cc'
+// Author: jcjuarez
+// This source code is licensed under the MIT license.
+// ****************************************************
+
+#include <map>
+#include <tuple>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <fstream>
+#include <iostream>
+#include <optional>
+#include <algorithm>
+#include <filesystem>
+#include <string_view>
+#include "../src/logger/segment_reader.hh"
+#include "../src/logger/sequence_ledger.hh"
+#include "../src/logger/disk_flush_manager.hh"
+
+namespace
+{
+
+//
+// Max count of gap ranges printed per sequence space.
+//
+constexpr std::size_t c_max_printed_gaps_count = 20u;
+
+//
+// Sequence numbers seen in a sequence space: a whole session, or a single shard for sharded streams.
+//
+struct sequence_space
+{
+
+    std::vector<std::uint64_t> m_sequence_numbers;
+
+    //
+    // Numbers the writer of the space handed out and never wrote, from its ledger, and whether
+    // the ledger was found and closed by the writer.
+    //
+    std::vector<echo::retired_sequence_range> m_retired_ranges;
+
+    bool m_ledger_found = false;
+
+    bool m_ledger_closed = false;
+
+    //
+    // Records of a thread and priority lane whose sequence number is lower than the one before them.
+    //
+    std::uint64_t m_reordered_records_count = 0u;
+
+};
+
+//
+// Results of the check of a sequence space.
+//
+struct sequence_space_report
+{
+
+    std::uint64_t m_duplicated_records_count = 0u;
+
+    std::uint64_t m_missing_records_count = 0u;
+
+    std::vector<std::pair<std::uint64_t, std::uint64_t>> m_gaps;
+
+    //
+    // Missing numbers accounted for by the ledger, by retirement reason.
+    //
+    std::map<echo::sequence_retirement_reason, std::uint64_t> m_retired_records_counts;
+
+    //
+    // Numbers found in the records even though the ledger retired them.
+    //
+    std::uint64_t m_retired_written_records_count = 0u;
+
+};
+
+//
+// Gets the name under which the numbers retired for a reason are reported.
+//
+auto
+get_retirement_reason_name(
+    const echo::sequence_retirement_reason p_reason) -> std::string_view
+{
+    switch (p_reason)
+    {
+        case echo::sequence_retirement_reason::unused_block_tail:
+        {
+            return "unused block tails";
+        }
+        case echo::sequence_retirement_reason::evicted:
+        {
+            return "evicted by the flight recorder";
+        }
+        case echo::sequence_retirement_reason::shed:
+        {
+            return "shed by the info lane";
+        }
+        case echo::sequence_retirement_reason::abandoned:
+        {
+            return "abandoned before being appended";
+        }
+        default:
+        {
+            return "unknown";
+        }
+    }
+}
+
+//
+// Finds the duplicated and missing sequence numbers of a space. Missing numbers retired by the
+// ledger of the writer were never meant to be written and are not losses.
+//
+auto
+check_sequence_space(
+    sequence_space& p_sequence_space) -> sequence_space_report
+{
+    sequence_space_report report;
+    std::vector<std::uint64_t>& sequence_numbers = p_sequence_space.m_sequence_numbers;
+    std::vector<echo::retired_sequence_range>& retired_ranges = p_sequence_space.m_retired_ranges;
+
+    std::sort(sequence_numbers.begin(), sequence_numbers.end());
+    std::sort(retired_ranges.begin(), retired_ranges.end(), [](const echo::retired_sequence_range& p_left, const echo::retired_sequence_range& p_right)
+    {
+        return p_left.m_first_sequence_number < p_right.m_first_sequence_number;
+    });
+
+    for (const echo::retired_sequence_range& range : retired_ranges)
+    {
+        const auto first_written = std::lower_bound(sequence_numbers.begin(), sequence_numbers.end(), range.m_first_sequence_number);
+        const auto end_written = std::lower_bound(first_written, sequence_numbers.end(), range.m_first_sequence_number + range.m_records_count);
+
+        report.m_retired_written_records_count += static_cast<std::uint64_t>(end_written - first_written);
+    }
+
+    std::size_t retired_range_index = 0u;
+
+    const auto add_gap = [&](const std::uint64_t p_first, const std::uint64_t p_last)
+    {
+        std::uint64_t first_missing = p_first;
+
+        while (retired_range_index < retired_ranges.size() &&
+            retired_ranges[retired_range_index].m_first_sequence_number <= p_last)
+        {
+            const echo::retired_sequence_range& range = retired_ranges[retired_range_index];
+            const std::uint64_t range_last = range.m_first_sequence_number + range.m_records_count - 1u;
+
+            if (range.m_records_count == 0u ||
+                range_last < first_missing)
+            {
+                ++retired_range_index;
+
+                continue;
+            }
+
+            if (range.m_first_sequence_number > first_missing)
+            {
+                report.m_missing_records_count += range.m_first_sequence_number - first_missing;
+                report.m_gaps.emplace_back(first_missing, range.m_first_sequence_number - 1u);
+            }
+
+            const std::uint64_t covered_first = std::max(first_missing, range.m_first_sequence_number);
+            const std::uint64_t covered_last = std::min(p_last, range_last);
+
+            report.m_retired_records_counts[range.m_reason] += covered_last - covered_first + 1u;
+            first_missing = covered_last + 1u;
+
+            if (range_last > p_last)
+            {
+                //
+                // The range goes on into the next gap.
+                //
+                break;
+            }
+
+            ++retired_range_index;
+        }
+
+        if (first_missing <= p_last)
+        {
+            report.m_missing_records_count += p_last - first_missing + 1u;
+            report.m_gaps.emplace_back(first_missing, p_last);
+        }
+    };
+
+    std::uint64_t expected_sequence_number = 0u;
+
+    for (std::size_t index = 0u; index < sequence_numbers.size(); ++index)
+    {
+        const std::uint64_t sequence_number = sequence_numbers[index];
+
+        if (index != 0u &&
+            sequence_number == sequence_numbers[index - 1u])
+        {
+            ++report.m_duplicated_records_count;
+
+            continue;
+        }
+
+        if (sequence_number != expected_sequence_number)
+        {
+            add_gap(expected_sequence_number, sequence_number - 1u);
+        }
+
+        expected_sequence_number = sequence_number + 1u;
+    }
+
+    return report;
+}
+
+} // namespace.
+
+//
+// Checks the sequence numbers of the records of a logging session directory and reports the
+// gaps, duplicates and reordered records of every sequence space. Numbers retired in the ledger
+// of the writer, such as the unused tails of the blocks of threads, the records evicted by
+// the flight recorder or shed by the info lane, and the shard records abandoned before being
+// appended, are not gaps. Exits with 2 if any problem is found.
+//
+int main(int argc, char** argv)
+{
+    if (argc != 2)
+    {
+        std::cerr << "Usage: " << argv[0] << " <logging_session_directory_path>\n";
+
+        return 1;
+    }
+
+    //
+    // Spaces by session identifier and, for sharded streams, by stream.
+    //
+    std::map<std::pair<std::string, std::string>, sequence_space> sequence_spaces;
+    std::map<std::tuple<std::string, std::uint64_t, std::size_t>, std::uint64_t> last_sequence_numbers;
+    std::string current_stream;
+    std::uint64_t unsequenced_records_count = 0u;
+
+    for (const std::filesystem::path& segment_path : echo::get_segment_paths(argv[1]))
+    {
+        //
+        // Segments come ordered by stream, then by count; order only holds within a stream.
+        //
+        const std::string stem = segment_path.stem().string();
+        const std::string stream = stem.substr(0u, stem.rfind('_'));
+        const bool sharded_stream = stream.find("_shard") != std::string::npos;
+
+        if (stream != current_stream)
+        {
+            current_stream = stream;
+            last_sequence_numbers.clear();
+        }
+
+        std::ifstream segment {segment_path, std::ios::binary};
+        std::string line;
+
+        while (std::getline(segment, line))
+        {
+            const std::optional<echo::log_record_view> record = echo::parse_log_record(line);
+
+            if (!record.has_value())
+            {
+                //
+                // Continuation line of a multi-line message.
+                //
+                continue;
+            }
+
+            if (!record->m_sequence_number.has_value())
+            {
+                ++unsequenced_records_count;
+
+                continue;
+            }
+
+            sequence_space& space = sequence_spaces[{
+                std::string(record->m_session_id),
+                sharded_stream ? stream : std::string()}];
+
+            space.m_sequence_numbers.push_back(record->m_sequence_number.value());
+
+            //
+            // Async mode lets urgent records overtake queued ones, so order is checked per lane.
+            //
+            const auto [last_sequence_number, first_record] = last_sequence_numbers.try_emplace(
+                {std::string(record->m_session_id), record->m_thread_id.value_or(0u), static_cast<std::size_t>(echo::get_priority_lane(record->m_log_level))},
+                record->m_sequence_number.value());
+
+            if (!first_record &&
+                record->m_sequence_number.value() < last_sequence_number->second)
+            {
+                ++space.m_reordered_records_count;
+            }
+
+            last_sequence_number->second = record->m_sequence_number.value();
+        }
+    }
+
+    //
+    // Ledgers are named 'log_<session>.seq', after the writer of the session whose numbers they account for,
+    // or 'log_<session>_shard<index>.seq' for the numbers of a shard.
+    //
+    std::error_code error_code;
+
+    for (const std::filesystem::directory_entry& entry : std::filesystem::directory_iterator(argv[1], error_code))
+    {
+        const std::string stem = entry.path().stem().string();
+
+        if (entry.path().extension() != std::string(".") + echo::sequence_ledger::c_ledger_files_extension ||
+            !stem.starts_with("log_"))
+        {
+            continue;
+        }
+
+        const bool sharded_stream = stem.find("_shard") != std::string::npos;
+
+        const auto space = sequence_spaces.find({
+            stem.substr(4u, sharded_stream ? stem.find('_', 4u) - 4u : std::string::npos),
+            sharded_stream ? stem : std::string()});
+        const std::optional<std::vector<echo::retired_sequence_range>> ranges = echo::sequence_ledger::read_ranges(entry.path());
+
+        if (space == sequence_spaces.end() ||
+            !ranges.has_value())
+        {
+            continue;
+        }
+
+        space->second.m_ledger_found = true;
+
+        for (const echo::retired_sequence_range& range : ranges.value())
+        {
+            if (range.m_reason == echo::sequence_retirement_reason::writer_closed)
+            {
+                space->second.m_ledger_closed = true;
+
+                continue;
+            }
+
+            space->second.m_retired_ranges.push_back(range);
+        }
+    }
+
+    bool problems_found = false;
+
+    for (auto& [space_key, space] : sequence_spaces)
+    {
+        const sequence_space_report report = check_sequence_space(space);
+        const auto& [session_id, stream] = space_key;
+
+        std::cout << "Session " << session_id;
+
+        if (!stream.empty())
+        {
+            std::cout << ", stream " << stream;
+        }
+
+        std::cout << "\n  Records: " << space.m_sequence_numbers.size()
+            << ", sequence numbers " << space.m_sequence_numbers.front() << " to " << space.m_sequence_numbers.back()
+            << "\n  Gaps: " << report.m_gaps.size() << " (" << report.m_missing_records_count << " records)"
+            << "\n  Duplicates: " << report.m_duplicated_records_count
+            << "\n  Reordered: " << space.m_reordered_records_count
+            << "\n  Retired and written: " << report.m_retired_written_records_count << "\n";
+
+        if (space.m_ledger_found)
+        {
+            std::cout << "  Ledger: " << (space.m_ledger_closed ? "closed" : "not closed; the session did not shut down cleanly") << "\n";
+        }
+
+        for (const auto& [reason, retired_records_count] : report.m_retired_records_counts)
+        {
+            std::cout << "  Retired, " << get_retirement_reason_name(reason) << ": " << retired_records_count << " records\n";
+        }
+
+        for (std::size_t gap_index = 0u; gap_index < std::min(report.m_gaps.size(), c_max_printed_gaps_count); ++gap_index)
+        {
+            std::cout << "    Missing " << report.m_gaps[gap_index].first << " to " << report.m_gaps[gap_index].second << "\n";
+        }
+
+        if (report.m_gaps.size() > c_max_printed_gaps_count)
+        {
+            std::cout << "    ...\n";
+        }
+
+        problems_found = problems_found ||
+            !report.m_gaps.empty() ||
+            report.m_duplicated_records_count != 0u ||
+            space.m_reordered_records_count != 0u ||
+            report.m_retired_written_records_count != 0u;
+    }
+
+    if (unsequenced_records_count != 0u)
+    {
+        std::cout << "Records without a sequence number: " << unsequenced_records_count << "\n";
+    }
+
+    return problems_found ? 2 : 0;
+}